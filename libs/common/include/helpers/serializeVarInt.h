@@ -0,0 +1,39 @@
+// Copyright (C) 2005 - 2021 Settlers Freaks (sf-team at siedler25.org)
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "s25util/Serializer.h"
+#include <cstdint>
+#include <stdexcept>
+
+namespace helpers {
+
+/// Push an unsigned value using 7 bits per byte and the highest bit as the continuation flag.
+/// Small values (< 128) need only 1 byte, the maximum is 5 bytes
+inline void pushVarUInt(Serializer& ser, uint32_t value)
+{
+    while(value >= 0x80u)
+    {
+        ser.PushUnsignedChar(static_cast<uint8_t>(value | 0x80u));
+        value >>= 7;
+    }
+    ser.PushUnsignedChar(static_cast<uint8_t>(value));
+}
+
+/// Pop a value stored by pushVarUInt
+inline uint32_t popVarUInt(Serializer& ser)
+{
+    uint32_t result = 0;
+    for(unsigned shift = 0; shift < 32; shift += 7)
+    {
+        const uint8_t curByte = ser.PopUnsignedChar();
+        result |= static_cast<uint32_t>(curByte & 0x7Fu) << shift;
+        if(!(curByte & 0x80u))
+            return result;
+    }
+    throw std::range_error("Invalid variable length integer");
+}
+
+} // namespace helpers
@@ -26,6 +26,7 @@ namespace folders {
     constexpr auto loadScreens = "<RTTR_GAME>/GFX/PICS";
     constexpr auto loadScreensMissions = "<RTTR_GAME>/GFX/PICS/MISSION";
     constexpr auto logs = "<RTTR_USERDATA>/LOGS";
+    constexpr auto mapsCache = "<RTTR_USERDATA>/MAPS/CACHE"; // downloaded maps by checksum
     constexpr auto mapsCampaign = "<RTTR_GAME>/DATA/MAPS";
     constexpr auto mapsContinents = "<RTTR_GAME>/DATA/MAPS2";
     constexpr auto mapsNew = "<RTTR_GAME>/DATA/MAPS4";
@@ -0,0 +1,371 @@
+// Copyright (C) 2005 - 2021 Settlers Freaks (sf-team at siedler25.org)
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "RTTR_Version.h"
+#include "RttrConfig.h"
+#include "ai/AIMatch.h"
+#include "helpers/MaxEnumValue.h"
+#include "helpers/format.hpp"
+#include "ogl/glAllocator.h"
+#include "gameTypes/GameSettingTypes.h"
+#include "libsiedler2/libsiedler2.h"
+#include "s25util/LocaleHelper.h"
+#include "s25util/Log.h"
+#include "s25util/System.h"
+#include "s25util/strAlgos.h"
+#include <boost/filesystem.hpp>
+#include <boost/nowide/args.hpp>
+#include <boost/nowide/fstream.hpp>
+#include <boost/nowide/iostream.hpp>
+#include <boost/process/args.hpp>
+#include <boost/process/child.hpp>
+#include <boost/program_options.hpp>
+#include <algorithm>
+#include <array>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+namespace bfs = boost::filesystem;
+namespace bnw = boost::nowide;
+namespace bp = boost::process;
+namespace po = boost::program_options;
+
+namespace {
+
+std::string GetProgramDescription()
+{
+    std::stringstream s;
+    s << rttr::version::GetTitle() << " AI tournament v" << rttr::version::GetVersion() << "-"
+      << rttr::version::GetRevision() << "\n"
+      << "Compiled with " << System::getCompilerName() << " for " << System::getOSName();
+    return s.str();
+}
+
+/// Column names of the statistic values in the order of StatisticType
+constexpr std::array<const char*, helpers::NumEnumValues_v<StatisticType>> statisticNames = {
+  {"country", "buildings", "inhabitants", "merchandise", "military", "gold", "productivity", "vanquished",
+   "tournament"}};
+
+/// A single game of the tournament
+struct Match
+{
+    unsigned id;
+    AIMatchConfig config;
+};
+
+struct TournamentConfig
+{
+    std::vector<Match> matches;
+    unsigned numWorkers = 1;
+    bfs::path resultPath, statisticPath;
+};
+
+AI::Info ParseAI(const std::string& name)
+{
+    const std::string lowerName = s25util::toLower(name);
+    if(lowerName == "dummy")
+        return AI::Info(AI::Type::Dummy);
+    if(lowerName == "easy")
+        return AI::Info(AI::Type::Default, AI::Level::Easy);
+    if(lowerName == "medium")
+        return AI::Info(AI::Type::Default, AI::Level::Medium);
+    if(lowerName == "hard")
+        return AI::Info(AI::Type::Default, AI::Level::Hard);
+    throw std::runtime_error(helpers::format("Unknown AI: %1%", name));
+}
+
+std::string GetAIName(const AI::Info& ai)
+{
+    if(ai.type == AI::Type::Dummy)
+        return "dummy";
+    switch(ai.level)
+    {
+        case AI::Level::Easy: return "easy";
+        case AI::Level::Medium: return "medium";
+        case AI::Level::Hard: return "hard";
+    }
+    return "unknown";
+}
+
+GameObjective ParseObjective(const std::string& name)
+{
+    const std::string lowerName = s25util::toLower(name);
+    if(lowerName == "none")
+        return GameObjective::None;
+    if(lowerName == "conquer")
+        return GameObjective::Conquer3_4;
+    if(lowerName == "domination")
+        return GameObjective::TotalDomination;
+    throw std::runtime_error(helpers::format("Unknown objective: %1%", name));
+}
+
+/// Create the config of the tournament from the parsed options. Throws on invalid values
+TournamentConfig GetTournamentConfig(const po::variables_map& options)
+{
+    if(!options.count("map"))
+        throw std::runtime_error("No map given");
+
+    std::vector<AI::Info> players;
+    if(options.count("ai"))
+    {
+        for(const std::string& ai : options["ai"].as<std::vector<std::string>>())
+            players.push_back(ParseAI(ai));
+    } else
+        players.assign(2, ParseAI("hard"));
+    if(players.size() < 2u)
+        throw std::runtime_error("At least 2 AIs are required");
+
+    AIMatchConfig baseConfig;
+    baseConfig.players = players;
+    baseConfig.ggs.objective = ParseObjective(options["objective"].as<std::string>());
+    baseConfig.maxGF = options["max-gf"].as<unsigned>();
+    baseConfig.nwfLength = options["nwf-length"].as<unsigned>();
+    baseConfig.statisticInterval = options["statistic-interval"].as<unsigned>();
+    if(baseConfig.nwfLength == 0u)
+        throw std::runtime_error("The NWF length must be positive");
+
+    TournamentConfig cfg;
+    const unsigned numGames = options["games"].as<unsigned>();
+    const uint64_t seed = options["seed"].as<uint64_t>();
+    for(const std::string& map : options["map"].as<std::vector<std::string>>())
+    {
+        if(!bfs::is_regular_file(map))
+            throw std::runtime_error(helpers::format("Map %1% does not exist", map));
+        for(unsigned i = 0; i < numGames; i++)
+        {
+            Match match{static_cast<unsigned>(cfg.matches.size()), baseConfig};
+            match.config.mapPath = map;
+            match.config.seed = seed + match.id;
+            cfg.matches.push_back(match);
+        }
+    }
+
+    cfg.numWorkers = options["jobs"].as<unsigned>();
+    if(cfg.numWorkers == 0u)
+        cfg.numWorkers = std::max(1u, std::thread::hardware_concurrency());
+    cfg.numWorkers = std::min<unsigned>(cfg.numWorkers, cfg.matches.size());
+    cfg.resultPath = options["output"].as<std::string>();
+    cfg.statisticPath = cfg.resultPath.parent_path() / (cfg.resultPath.stem().string() + "_statistic.csv");
+    return cfg;
+}
+
+bfs::path GetPartPath(const bfs::path& path, unsigned worker)
+{
+    return path.string() + ".part" + std::to_string(worker);
+}
+
+std::string FormatWinners(const AIMatchResult& result)
+{
+    if(result.winners.empty())
+        return "none";
+    std::string names;
+    for(const unsigned playerId : result.winners)
+        names += (names.empty() ? "" : "+") + std::to_string(playerId);
+    return names;
+}
+
+/// Play every numWorkers-th match starting at the worker index and write the results without headers
+bool RunWorker(const TournamentConfig& cfg, unsigned worker)
+{
+    bnw::ofstream resultFile(GetPartPath(cfg.resultPath, worker));
+    bnw::ofstream statisticFile(GetPartPath(cfg.statisticPath, worker));
+    if(!resultFile || !statisticFile)
+    {
+        LOG.write("Worker %1%: Could not open output files\n", LogTarget::Stderr) % worker;
+        return false;
+    }
+    for(unsigned i = worker; i < cfg.matches.size(); i += cfg.numWorkers)
+    {
+        const Match& match = cfg.matches[i];
+        const boost::optional<AIMatchResult> result = playAIMatch(match.config);
+        if(!result)
+        {
+            LOG.write("Worker %1%: Failed to load map %2%\n", LogTarget::Stderr) % worker % match.config.mapPath;
+            return false;
+        }
+        for(unsigned playerId = 0; playerId < result->players.size(); playerId++)
+        {
+            const AIMatchResult::Player& player = result->players[playerId];
+            resultFile << match.id << "," << match.config.mapPath.filename().string() << "," << match.config.seed
+                       << "," << playerId << "," << GetAIName(player.ai) << "," << result->isWinner(playerId) << ","
+                       << (player.defeatGF ? std::to_string(*player.defeatGF) : "") << "," << result->numGFs << ","
+                       << result->getGFsPerSecond() << "\n";
+            for(unsigned step = 0; step < player.statistic.size(); step++)
+            {
+                statisticFile << match.id << "," << playerId << "," << step * result->statisticInterval;
+                for(const uint32_t value : player.statistic[step])
+                    statisticFile << "," << value;
+                statisticFile << "\n";
+            }
+        }
+        resultFile.flush();
+        statisticFile.flush();
+        LOG.write("Match %1%/%2% on %3% finished after %4% GFs (%5% GF/s). Winner: %6%\n") % (match.id + 1)
+          % cfg.matches.size() % match.config.mapPath.filename() % result->numGFs
+          % static_cast<unsigned>(result->getGFsPerSecond())
+          % FormatWinners(*result);
+    }
+    return true;
+}
+
+/// Write the header followed by the parts written by the workers and remove the parts
+bool MergeParts(const bfs::path& path, const std::string& header, unsigned numWorkers)
+{
+    bnw::ofstream file(path);
+    if(!file)
+        return false;
+    file << header << "\n";
+    for(unsigned worker = 0; worker < numWorkers; worker++)
+    {
+        const bfs::path partPath = GetPartPath(path, worker);
+        {
+            bnw::ifstream part(partPath);
+            if(!part)
+                return false;
+            file << part.rdbuf();
+        }
+        bfs::remove(partPath);
+    }
+    return true;
+}
+
+int RunTournament(const TournamentConfig& cfg, const std::vector<std::string>& args)
+{
+    LOG.write("Playing %1% matches in %2% worker processes\n") % cfg.matches.size() % cfg.numWorkers;
+    bool success = true;
+    if(cfg.numWorkers == 1u)
+        success = RunWorker(cfg, 0);
+    else
+    {
+        // Each worker process plays its share of the matches with its own global game state
+        const bfs::path exePath = System::getExecutablePath();
+        std::vector<bp::child> workers;
+        for(unsigned worker = 0; worker < cfg.numWorkers; worker++)
+        {
+            std::vector<std::string> workerArgs = args;
+            workerArgs.push_back("--worker");
+            workerArgs.push_back(std::to_string(worker));
+            workers.emplace_back(exePath, bp::args(workerArgs));
+        }
+        for(bp::child& worker : workers)
+        {
+            worker.wait();
+            success &= worker.exit_code() == 0;
+        }
+    }
+    if(!success)
+    {
+        LOG.write("Some matches could not be played\n", LogTarget::Stderr);
+        return 1;
+    }
+
+    std::string statisticHeader = "match,player,gf";
+    for(const char* name : statisticNames)
+        statisticHeader += std::string(",") + name;
+    if(!MergeParts(cfg.resultPath, "match,map,seed,player,ai,winner,defeat_gf,num_gfs,gfs_per_second",
+                   cfg.numWorkers)
+       || !MergeParts(cfg.statisticPath, statisticHeader, cfg.numWorkers))
+    {
+        LOG.write("Could not write the results\n", LogTarget::Stderr);
+        return 1;
+    }
+    LOG.write("Results written to %1% and %2%\n") % cfg.resultPath % cfg.statisticPath;
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    bnw::args _(argc, argv);
+
+    po::options_description desc("Options");
+    // clang-format off
+    desc.add_options()
+        ("help,h", "Show help")
+        ("version", "Show version information and exit")
+        ("map,m", po::value<std::vector<std::string>>()->composing(),
+            "Map to play on. Can be given multiple times")
+        ("ai", po::value<std::vector<std::string>>()->multitoken()->composing(),
+            "AIs of the players, one per player: dummy, easy, medium or hard. Defaults to 2 hard AIs")
+        ("games,n", po::value<unsigned>()->default_value(10), "Number of games per map")
+        ("seed", po::value<uint64_t>()->default_value(1),
+            "Seed of the first game. The following games use the next seeds")
+        ("max-gf", po::value<unsigned>()->default_value(100000), "Stop a game without winner after this many GFs")
+        ("objective", po::value<std::string>()->default_value("none"),
+            "Objective of the games: none (last one standing), conquer (3/4 of the land) or domination")
+        ("nwf-length", po::value<unsigned>()->default_value(5),
+            "GFs between network frames in which the commands of the AIs are executed")
+        ("statistic-interval", po::value<unsigned>()->default_value(0),
+            "GFs between samples of the statistic values. 0 for the interval of the ingame statistics")
+        ("jobs,j", po::value<unsigned>()->default_value(0),
+            "Number of worker processes playing games in parallel. 0 to use one per core")
+        ("output,o", po::value<std::string>()->default_value("tournament.csv"),
+            "CSV file for the results. The statistic curves are written to <name>_statistic.csv")
+        ;
+    // clang-format on
+    po::options_description hiddenDesc;
+    hiddenDesc.add_options()("worker", po::value<unsigned>(), "Index of the worker process");
+    po::options_description allDesc;
+    allDesc.add(desc).add(hiddenDesc);
+
+    po::variables_map options;
+    try
+    {
+        po::store(po::parse_command_line(argc, argv, allDesc), options);
+        po::notify(options);
+        // Catch the generic stdlib exception as hidden visibility messes up boost typeinfo on OSX
+    } catch(const std::exception& e)
+    {
+        bnw::cerr << "Error: " << e.what() << "\n\n";
+        bnw::cerr << desc << "\n";
+        return 1;
+    }
+
+    if(options.count("help"))
+    {
+        bnw::cout << desc << "\n";
+        return 0;
+    }
+    if(options.count("version"))
+    {
+        bnw::cout << GetProgramDescription() << std::endl;
+        return 0;
+    }
+
+    TournamentConfig cfg;
+    try
+    {
+        cfg = GetTournamentConfig(options);
+    } catch(const std::exception& e)
+    {
+        bnw::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+
+    const bool isWorker = options.count("worker") > 0;
+    if(!isWorker)
+        LOG.write("%1%\n\n", LogTarget::Stdout) % GetProgramDescription();
+    if(!LocaleHelper::init())
+        return 1;
+    if(!RTTRCONFIG.Init())
+        return 1;
+    libsiedler2::setAllocator(new GlAllocator);
+
+    int result;
+    try
+    {
+        if(isWorker)
+            result = RunWorker(cfg, options["worker"].as<unsigned>()) ? 0 : 1;
+        else
+            result = RunTournament(cfg, std::vector<std::string>(argv + 1, argv + argc));
+    } catch(const std::exception& e)
+    {
+        LOG.write("An exception occurred: %1%\n", LogTarget::Stderr) % e.what();
+        result = 1;
+    }
+    libsiedler2::setAllocator(nullptr);
+    return result;
+}
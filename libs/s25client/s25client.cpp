@@ -18,6 +18,7 @@
 #include "helpers/format.hpp"
 #include "mygettext/mygettext.h"
 #include "ogl/glAllocator.h"
+#include "random/randomIO.h"
 #include "libsiedler2/libsiedler2.h"
 #include "s25util/LocaleHelper.h"
 #include "s25util/Log.h"
@@ -369,8 +370,9 @@ bool InitDirectories()
 
     // diverse dirs anlegen
     const std::array<std::string, 10> dirs = {
-      {s25::folders::config, s25::folders::mapsOwn, s25::folders::logs, s25::folders::mapsPlayed, s25::folders::replays,
-       s25::folders::save, s25::folders::assetsUserOverrides, s25::folders::screenshots, s25::folders::playlists}};
+      {s25::folders::config, s25::folders::mapsOwn, s25::folders::logs, s25::folders::mapsPlayed,
+       s25::folders::mapsCache, s25::folders::replays, s25::folders::save, s25::folders::assetsUserOverrides,
+       s25::folders::screenshots, s25::folders::playlists}};
 
     if(!MigrateFilesAndDirectories())
         return false;
@@ -521,6 +523,7 @@ int main(int argc, char** argv)
         ("map,m", po::value<std::string>(),"Map to load")
         ("version", "Show version information and exit")
         ("convert-sounds", "Convert sounds and exit")
+        ("print-random-log", po::value<std::string>(), "Print a binary random log saved on an async and exit")
         ;
     // clang-format on
     po::positional_options_description positionalOptions;
@@ -549,6 +552,19 @@ int main(int argc, char** argv)
         bnw::cout << GetProgramDescription() << std::endl;
         return 0;
     }
+    if(options.count("print-random-log"))
+    {
+        try
+        {
+            for(const RandomEntry& entry : loadRandomLogBinary(options["print-random-log"].as<std::string>()))
+                bnw::cout << entry << '\n';
+        } catch(const std::exception& e)
+        {
+            bnw::cerr << "Error: " << e.what() << "\n";
+            return 1;
+        }
+        return 0;
+    }
 
     int result;
     try
@@ -6,8 +6,6 @@
 #include "EventManager.h"
 #include "FileChecksum.h"
 #include "Game.h"
-#include "GameObject.h"
-#include "random/Random.h"
 #include "s25util/Serializer.h"
 #include <ostream>
 
@@ -45,7 +43,8 @@ unsigned AsyncChecksum::getHash() const
 
 AsyncChecksum AsyncChecksum::create(const Game& game)
 {
-    return AsyncChecksum(RANDOM.GetChecksum(), GameObject::GetNumObjs(), GameObject::GetObjIDCounter(),
+    const GameContext& context = game.context_;
+    return AsyncChecksum(context.GetRandom().GetChecksum(), context.GetNumObjs(), context.GetObjIDCounter(),
                          game.em_->GetNumActiveEvents(), game.em_->GetEventInstanceCtr());
 }
 
@@ -3,6 +3,7 @@
 // SPDX-License-Identifier: GPL-2.0-or-later
 
 #include "FileChecksum.h"
+#include <boost/crc.hpp>
 #include <boost/nowide/fstream.hpp>
 
 uint32_t CalcChecksumOfFile(const boost::filesystem::path& path)
@@ -28,3 +29,26 @@ uint32_t CalcChecksumOfBuffer(const uint8_t* buffer, size_t size)
         checksum += buffer[i];
     return checksum;
 }
+
+uint32_t CalcCRC32OfFile(const boost::filesystem::path& path)
+{
+    boost::nowide::ifstream file(path, std::ios::binary);
+    if(!file)
+        return 0;
+
+    boost::crc_32_type crc;
+    char buffer[4096];
+    while(file.read(buffer, sizeof(buffer)) || file.gcount() > 0)
+        crc.process_bytes(buffer, static_cast<size_t>(file.gcount()));
+    return crc.checksum();
+}
+
+uint32_t CalcCRC32OfBuffer(const uint8_t* buffer, size_t size)
+{
+    if(!buffer || size == 0)
+        return 0;
+
+    boost::crc_32_type crc;
+    crc.process_bytes(buffer, size);
+    return crc.checksum();
+}
@@ -19,3 +19,19 @@ inline uint32_t CalcChecksumOfBuffer(const T& buffer)
 {
     return CalcChecksumOfBuffer(buffer.data(), buffer.size());
 }
+
+/// CRC32 of the content which, unlike the checksum above, depends on the order of the bytes.
+/// Used to identify files by their content, e.g. in the map cache
+uint32_t CalcCRC32OfFile(const boost::filesystem::path& path);
+uint32_t CalcCRC32OfBuffer(const uint8_t* buffer, size_t size);
+
+inline uint32_t CalcCRC32OfBuffer(const char* buffer, size_t size)
+{
+    return CalcCRC32OfBuffer(reinterpret_cast<const uint8_t*>(buffer), size);
+}
+
+template<typename T>
+inline uint32_t CalcCRC32OfBuffer(const T& buffer)
+{
+    return CalcCRC32OfBuffer(buffer.data(), buffer.size());
+}
@@ -30,4 +30,6 @@ void FramesInfoClient::Clear()
     FramesInfo::Clear();
     forcePauseStart = UsedClock::time_point();
     forcePauseLen = milliseconds32_t::zero();
+    numForcePauses = 0;
+    sumForcePauseLen = milliseconds32_t::zero();
 }
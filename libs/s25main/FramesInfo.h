@@ -4,13 +4,15 @@
 
 #pragma once
 
+#include "Clock.h"
 #include <chrono>
 
 /// Struct that stores information about the frames, like GF status...
 struct FramesInfo
 {
     using milliseconds32_t = std::chrono::duration<uint32_t, std::milli>; //-V:milliseconds32_t:813
-    using UsedClock = std::chrono::steady_clock;
+    /// The global clock, which can be replaced, e.g. to simulate a network game with a deterministic time
+    using UsedClock = Clock;
 
     FramesInfo();
     void Clear();
@@ -38,4 +40,7 @@ struct FramesInfoClient : public FramesInfo
     /// Force pause the game (start TS and length) e.g. to compensate for lags
     UsedClock::time_point forcePauseStart;
     milliseconds32_t forcePauseLen;
+    /// Number of forced pauses since the start and their total length
+    unsigned numForcePauses;
+    milliseconds32_t sumForcePauseLen;
 };
@@ -23,7 +23,14 @@ Game::Game(GlobalGameSettings settings, std::unique_ptr<EventManager> em, const
     : ggs_(std::move(settings)), em_(std::move(em)), world_(players, ggs_, *em_), started_(false), finished_(false)
 {}
 
-Game::~Game() = default;
+Game::~Game()
+{
+    // Destroy all game objects while this game is the current one so they are removed from its context
+    const GameContextScope contextScope(context_);
+    aiPlayers_.clear();
+    world_.Unload();
+    em_->Clear();
+}
 
 void Game::Start(bool startFromSave)
 {
@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include "GameContext.h"
 #include "GlobalGameSettings.h"
 #include "world/GameWorld.h"
 #include <boost/ptr_container/ptr_vector.hpp>
@@ -19,6 +20,9 @@ public:
     Game(GlobalGameSettings settings, std::unique_ptr<EventManager> em, const std::vector<PlayerInfo>& players);
     ~Game();
 
+    /// Simulation state of this game. Declared first as it becomes the current context on construction and must
+    /// outlive all game objects. Make it current (see GameContextScope) when running multiple games in one thread
+    GameContext context_;
     const GlobalGameSettings ggs_;
     std::unique_ptr<EventManager> em_;
     GameWorld world_;
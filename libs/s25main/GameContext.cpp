@@ -0,0 +1,40 @@
+// Copyright (C) 2005 - 2021 Settlers Freaks (sf-team at siedler25.org)
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "GameContext.h"
+
+thread_local GameContext* GameContext::curContext_ = nullptr;
+thread_local GameContext* GameContext::lastContext_ = nullptr;
+
+GameContext::GameContext() : prevContext_(lastContext_)
+{
+    if(prevContext_)
+        prevContext_->nextContext_ = this;
+    lastContext_ = this;
+    MakeCurrent();
+}
+
+GameContext::~GameContext()
+{
+    // Don't leave a dangling pointer but fall back to the previous game, e.g. the outer one in nested scopes
+    if(curContext_ == this)
+        curContext_ = prevContext_;
+    if(prevContext_)
+        prevContext_->nextContext_ = nextContext_;
+    if(nextContext_)
+        nextContext_->prevContext_ = prevContext_;
+    if(lastContext_ == this)
+        lastContext_ = prevContext_;
+}
+
+GameContext& GameContext::GetDefault()
+{
+    static GameContext defaultContext{DefaultTag{}};
+    return defaultContext;
+}
+
+UsedRandom& getCurrentRandom()
+{
+    return GameContext::Current().GetRandom();
+}
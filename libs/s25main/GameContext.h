@@ -0,0 +1,77 @@
+// Copyright (C) 2005 - 2021 Settlers Freaks (sf-team at siedler25.org)
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "random/Random.h"
+
+class GameWorld;
+
+/// State of a simulation which is not part of the world itself: The world used by the game objects, the object
+/// counters and the RNG. Each Game owns one so multiple games can be simulated in one process.
+///
+/// Code which has no access to its game (GameObjects, the RANDOM macros) uses the current context of the calling
+/// thread. A new context becomes the current one of the thread creating it. When the current context is destroyed the
+/// one created before it in the same thread (if still alive) becomes current again. If there is none a process-wide
+/// default context is used.
+class GameContext
+{
+    friend class GameContextScope;
+    friend class GameObject;
+
+public:
+    GameContext();
+    ~GameContext();
+    GameContext(const GameContext&) = delete;
+    GameContext& operator=(const GameContext&) = delete;
+
+    /// Return the current context of the calling thread
+    static GameContext& Current() { return curContext_ ? *curContext_ : GetDefault(); }
+    /// Make this the current context of the calling thread
+    void MakeCurrent() { curContext_ = this; }
+
+    GameWorld* GetWorld() const { return world_; }
+    UsedRandom& GetRandom() { return random_; }
+    const UsedRandom& GetRandom() const { return random_; }
+    /// Return the number of objects alive
+    unsigned GetNumObjs() const { return objCounter_; }
+    /// Return the number of objects created
+    unsigned GetObjIDCounter() const { return objIdCounter_; }
+
+private:
+    struct DefaultTag
+    {};
+    explicit GameContext(DefaultTag) {}
+    static GameContext& GetDefault();
+
+    static thread_local GameContext* curContext_;
+    /// Last created context of the thread which is still alive
+    static thread_local GameContext* lastContext_;
+
+    /// Contexts created before and after this one in the same thread which are still alive
+    GameContext* prevContext_ = nullptr;
+    GameContext* nextContext_ = nullptr;
+
+    GameWorld* world_ = nullptr;
+    unsigned objIdCounter_ = 0; /// Objekt-ID-Counter (number of objects created)
+    unsigned objCounter_ = 0;   /// Objekt-Counter (number of objects alive)
+    UsedRandom random_;
+};
+
+/// Makes the given context the current one for the lifetime of this object and restores the previous one afterwards.
+/// Used to switch between multiple games running in the same thread
+class GameContextScope
+{
+public:
+    explicit GameContextScope(GameContext& context) : prevContext_(GameContext::curContext_)
+    {
+        context.MakeCurrent();
+    }
+    ~GameContextScope() { GameContext::curContext_ = prevContext_; }
+    GameContextScope(const GameContextScope&) = delete;
+    GameContextScope& operator=(const GameContextScope&) = delete;
+
+private:
+    GameContext* prevContext_;
+};
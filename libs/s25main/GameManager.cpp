@@ -200,6 +200,10 @@ GameManager& getGlobalGameManager()
 {
     return *globalGameManager;
 }
+GameManager* tryGetGlobalGameManager()
+{
+    return globalGameManager;
+}
 void setGlobalGameManager(GameManager* gameManager)
 {
     globalGameManager = gameManager;
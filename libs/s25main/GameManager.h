@@ -50,6 +50,8 @@ private:
 };
 
 GameManager& getGlobalGameManager();
+/// Return the global game manager or nullptr when running without one, e.g. in tests
+GameManager* tryGetGlobalGameManager();
 void setGlobalGameManager(GameManager* gameManager);
 
 #define GAMEMANAGER getGlobalGameManager()
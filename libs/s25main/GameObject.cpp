@@ -9,31 +9,25 @@
 #include "world/GameWorld.h"
 #include <iostream>
 
-/**
- *  Objekt-ID-Counter.
- */
-unsigned GameObject::objIdCounter_ = 0;
-unsigned GameObject::objCounter_ = 0;
+const GameObject::CurrentWorld GameObject::world{};
 
-GameWorld* GameObject::world = nullptr;
-
-GameObject::GameObject() : objId(++objIdCounter_)
+GameObject::GameObject() : objId(++GameContext::Current().objIdCounter_)
 {
     // ein Objekt mehr
-    ++objCounter_;
+    ++GameContext::Current().objCounter_;
 }
 
 GameObject::GameObject(SerializedGameData& sgd, const unsigned obj_id) : objId(obj_id)
 {
     // ein Objekt mehr
-    ++objCounter_;
+    ++GameContext::Current().objCounter_;
     sgd.AddObject(this);
 }
 
 GameObject::GameObject(const GameObject& go) : objId(go.objId)
 {
     // ein Objekt mehr
-    ++objCounter_;
+    ++GameContext::Current().objCounter_;
 }
 
 void GameObject::Destroy() {}
@@ -43,7 +37,7 @@ GameObject::~GameObject()
     // RTTR_Assert(!world || !GetEvMgr().ObjectHasEvents(*this));
     RTTR_Assert(!world || !GetEvMgr().IsObjectInKillList(*this));
     // ein Objekt weniger
-    --objCounter_;
+    --GameContext::Current().objCounter_;
 }
 
 EventManager& GameObject::GetEvMgr()
@@ -58,18 +52,19 @@ void GameObject::SendPostMessage(unsigned player, std::unique_ptr<PostMsg> msg)
 
 void GameObject::DetachWorld(GameWorld* gameWorld)
 {
-    if(world == gameWorld)
-        world = nullptr;
+    GameContext& context = GameContext::Current();
+    if(context.world_ == gameWorld)
+        context.world_ = nullptr;
 }
 
 GameWorld* GameObject::GetWorld()
 {
-    return world;
+    return world.get();
 }
 
 void GameObject::AttachWorld(GameWorld* gameWorld)
 {
-    world = gameWorld;
+    GameContext::Current().world_ = gameWorld;
 }
 
 std::string GameObject::ToString() const
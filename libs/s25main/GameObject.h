@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include "GameContext.h"
 #include "commonDefines.h"
 #include "gameTypes/GO_Type.h"
 #include <memory>
@@ -49,7 +50,7 @@ protected:
 private:
     unsigned objId; /// unique ID
 
-    // Static members
+    // Static members, all refer to the current game context
 public:
     /// Get world pointer
     static GameWorld* GetWorld();
@@ -58,29 +59,35 @@ public:
     /// Remove the world from all game objects
     static void DetachWorld(GameWorld* gameWorld);
     /// Return the number of objects alive
-    static unsigned GetNumObjs() { return objCounter_; }
+    static unsigned GetNumObjs() { return GameContext::Current().GetNumObjs(); }
     /// Gibt Obj-ID-Counter zurück
-    static unsigned GetObjIDCounter() { return objIdCounter_; }
+    static unsigned GetObjIDCounter() { return GameContext::Current().GetObjIDCounter(); }
     /// Reset the object counter and the object ID counter to 0
     static void ResetCounters()
     {
-        objIdCounter_ = 0;
-        objCounter_ = 0;
+        GameContext& context = GameContext::Current();
+        context.objIdCounter_ = 0;
+        context.objCounter_ = 0;
     }
     /// Set the objIdCounter to the given value and resets the object counter to 1 (noNodeObj)
     static void ResetCounters(unsigned objIdCounter)
     {
-        objIdCounter_ = objIdCounter;
-        objCounter_ = 1;
+        GameContext& context = GameContext::Current();
+        context.objIdCounter_ = objIdCounter;
+        context.objCounter_ = 1;
     }
 
 protected:
+    /// Behaves like a pointer to the world of the current game context
+    struct CurrentWorld
+    {
+        GameWorld* get() const { return GameContext::Current().GetWorld(); }
+        GameWorld* operator->() const { return get(); }
+        GameWorld& operator*() const { return *get(); }
+        operator GameWorld*() const { return get(); }
+    };
     /// Zugriff auf übrige Spielwelt
-    static GameWorld* world;
-
-private:
-    static unsigned objIdCounter_; /// Objekt-ID-Counter (number of objects created)
-    static unsigned objCounter_;   /// Objekt-Counter (number of objects alive)
+    static const CurrentWorld world;
 };
 
 /// Calls destroy on a GameObject and then deletes it setting the ptr to nullptr
@@ -5,7 +5,6 @@
 #include "IngameMinimap.h"
 #include "FOWObjects.h"
 #include "GamePlayer.h"
-#include "RttrForeachPt.h"
 #include "world/GameWorldBase.h"
 #include "world/GameWorldViewer.h"
 #include "gameData/MinimapConsts.h"
@@ -14,22 +13,24 @@
 
 IngameMinimap::IngameMinimap(const GameWorldViewer& gwv)
     : Minimap(gwv.GetWorld().GetSize()), gwv(gwv), nodes_updated(GetMapSize().x * GetMapSize().y, false),
-      dos(GetMapSize().x * GetMapSize().y, DrawnObject::Invalid), territory(true), houses(true), roads(true)
+      layers(GetMapSize().x * GetMapSize().y), territory(true), houses(true), roads(true)
 {
     CreateMapTexture();
 }
 
 unsigned IngameMinimap::CalcPixelColor(const MapPoint pt, const unsigned t)
 {
-    unsigned color = 0;
+    const unsigned idx = GetMMIdx(pt);
+    NodeLayers& node = layers[idx];
 
     Visibility visibility = gwv.GetVisibility(pt);
 
     if(visibility == Visibility::Invisible)
     {
-        dos[GetMMIdx(pt)] = DrawnObject::Invisible;
         // Man sieht nichts --> schwarz
-        return 0xFF000000;
+        SetDrawnObject(idx, DrawnObject::Invisible);
+        node.owner = 0;
+        node.fow = false;
     } else
     {
         DrawnObject drawn_object = DrawnObject::Invalid;
@@ -41,47 +42,34 @@ unsigned IngameMinimap::CalcPixelColor(const MapPoint pt, const unsigned t)
         FoW_Type fot = FoW_Type::Nothing;
         if(!fow)
         {
-            const MapNode& node = gwv.GetNode(pt);
-            owner = node.owner;
-            if(node.obj)
-                noType = node.obj->GetType();
+            const MapNode& mapNode = gwv.GetNode(pt);
+            owner = mapNode.owner;
+            if(mapNode.obj)
+                noType = mapNode.obj->GetType();
         } else
         {
-            const FoWNode& node = gwv.GetYoungestFOWNode(pt);
-            owner = node.owner;
-            if(node.object)
-                fot = node.object->GetType();
+            const FoWNode& fowNode = gwv.GetYoungestFOWNode(pt);
+            owner = fowNode.owner;
+            if(fowNode.object)
+                fot = fowNode.object->GetType();
         }
 
         // Baum an dieser Stelle?
         if((!fow && noType == NodalObjectType::Tree) || (fow && fot == FoW_Type::Tree)) //-V807
         {
-            color = VaryBrightness(TREE_COLOR, VARY_TREE_COLOR);
-            drawn_object = DrawnObject::Terrain;
-            // Ggf. mit Spielerfarbe
-            if(owner)
-            {
-                drawn_object = DrawnObject::Player;
-                if(territory)
-                    color = CombineWithPlayerColor(color, owner);
-            }
+            node.terrainColor[t] = VaryBrightness(TREE_COLOR, VARY_TREE_COLOR);
+            drawn_object = owner ? DrawnObject::Player : DrawnObject::Terrain;
         }
         // Granit an dieser Stelle?
         else if((!fow && noType == NodalObjectType::Granite) || (fow && fot == FoW_Type::Granite))
         {
-            color = VaryBrightness(GRANITE_COLOR, VARY_GRANITE_COLOR);
-            drawn_object = DrawnObject::Terrain;
-            // Ggf. mit Spielerfarbe
-            if(owner)
-            {
-                drawn_object = DrawnObject::Player;
-                if(territory)
-                    color = CombineWithPlayerColor(color, owner);
-            }
+            node.terrainColor[t] = VaryBrightness(GRANITE_COLOR, VARY_GRANITE_COLOR);
+            drawn_object = owner ? DrawnObject::Player : DrawnObject::Terrain;
         }
         // Ansonsten die jeweilige Terrainfarbe nehmen
         else
         {
+            node.terrainColor[t] = CalcTerrainColor(pt, t);
             // Ggf. Spielerfarbe mit einberechnen, falls das von einem Spieler ein Territorium ist
             if(owner)
             {
@@ -95,37 +83,59 @@ unsigned IngameMinimap::CalcPixelColor(const MapPoint pt, const unsigned t)
                 // ansonsten normales Territorium?
                 else
                     drawn_object = DrawnObject::Player;
-
-                if(drawn_object == DrawnObject::Buidling && houses)
-                    color = BUILDING_COLOR;
-                /// Roads?
-                else if(drawn_object == DrawnObject::Road && roads)
-                    color = ROAD_COLOR;
-                // ansonsten normales Territorium?
-                else if(territory)
-                    // Normales Terrain und Spielerfarbe berechnen
-                    color = CombineWithPlayerColor(CalcTerrainColor(pt, t), owner);
-                else
-                    // Normales Terrain berechnen
-                    color = CalcTerrainColor(pt, t);
             } else
-            {
-                // Normales Terrain berechnen
-                color = CalcTerrainColor(pt, t);
                 drawn_object = DrawnObject::Terrain;
-            }
         }
 
-        // Bei FOW die Farben abdunkeln
-        if(fow)
-            color = MakeColor(0xFF, GetRed(color) / 2, GetGreen(color) / 2, GetBlue(color) / 2);
-
-        dos[GetMMIdx(pt)] = drawn_object;
+        SetDrawnObject(idx, drawn_object);
+        node.owner = owner;
+        node.fow = fow;
     }
 
+    return ComposeColor(node, t);
+}
+
+unsigned IngameMinimap::ComposeColor(const NodeLayers& node, const unsigned t) const
+{
+    if(node.drawnObject == DrawnObject::Invisible)
+        return 0xFF000000;
+
+    unsigned color;
+    if(node.drawnObject == DrawnObject::Buidling && houses)
+        color = BUILDING_COLOR;
+    else if(node.drawnObject == DrawnObject::Road && roads)
+        color = ROAD_COLOR;
+    else if(node.owner && territory)
+        color = CombineWithPlayerColor(node.terrainColor[t], node.owner);
+    else
+        color = node.terrainColor[t];
+
+    // Bei FOW die Farben abdunkeln
+    if(node.fow)
+        color = MakeColor(0xFF, GetRed(color) / 2, GetGreen(color) / 2, GetBlue(color) / 2);
     return color;
 }
 
+void IngameMinimap::SetDrawnObject(const unsigned idx, const DrawnObject drawnObject)
+{
+    NodeLayers& node = layers[idx];
+    if(node.drawnObject == drawnObject)
+        return;
+    if(node.drawnObject != DrawnObject::Invalid)
+    {
+        // Swap with the last node of the list to remove it in O(1)
+        std::vector<unsigned>& oldList = nodesByObject[static_cast<unsigned>(node.drawnObject)];
+        const unsigned lastIdx = oldList.back();
+        oldList[node.listPos] = lastIdx;
+        layers[lastIdx].listPos = node.listPos;
+        oldList.pop_back();
+    }
+    std::vector<unsigned>& newList = nodesByObject[static_cast<unsigned>(drawnObject)];
+    node.listPos = static_cast<unsigned>(newList.size());
+    newList.push_back(idx);
+    node.drawnObject = drawnObject;
+}
+
 /**
  *  Calculate the normal terrain color for a given point and triangle
  */
@@ -244,24 +254,31 @@ void IngameMinimap::UpdateAll()
 void IngameMinimap::UpdateAll(const DrawnObject drawn_object)
 {
     map.beginUpdate();
-    // Gesamte Karte neu berechnen
-    RTTR_FOREACH_PT(MapPoint, GetMapSize())
+    RecomposeNodes(nodesByObject[static_cast<unsigned>(drawn_object)]);
+    // for DrawnObject::Player also update the not drawn buildings and roads as there is only the player territory
+    // visible
+    if(drawn_object == DrawnObject::Player)
     {
+        if(!houses)
+            RecomposeNodes(nodesByObject[static_cast<unsigned>(DrawnObject::Buidling)]);
+        if(!roads)
+            RecomposeNodes(nodesByObject[static_cast<unsigned>(DrawnObject::Road)]);
+    }
+    map.endUpdate();
+}
+
+void IngameMinimap::RecomposeNodes(const std::vector<unsigned>& nodeIdxs)
+{
+    const MapExtent mapSize = GetMapSize();
+    for(const unsigned idx : nodeIdxs)
+    {
+        const MapPoint pt(idx % mapSize.x, idx / mapSize.x);
         for(unsigned t = 0; t < 2; ++t)
         {
-            if(dos[GetMMIdx(pt)] == drawn_object
-               || (drawn_object == DrawnObject::Player && // for DrawnObject::Player check for not drawn buildings or
-                                                          // roads as there is only the player territory visible
-                   ((dos[GetMMIdx(pt)] == DrawnObject::Buidling && !houses)
-                    || (dos[GetMMIdx(pt)] == DrawnObject::Road && !roads))))
-            {
-                unsigned color = CalcPixelColor(pt, t);
-                DrawPoint texPos((pt.x * 2 + t + (pt.y & 1)) % (GetMapSize().x * 2), pt.y);
-                map.updatePixel(texPos, libsiedler2::ColorBGRA(color));
-            }
+            DrawPoint texPos((pt.x * 2 + t + (pt.y & 1)) % (mapSize.x * 2), pt.y);
+            map.updatePixel(texPos, libsiedler2::ColorBGRA(ComposeColor(layers[idx], t)));
         }
     }
-    map.endUpdate();
 }
 
 void IngameMinimap::ToggleTerritory()
@@ -6,6 +6,7 @@
 
 #include "Minimap.h"
 #include "gameTypes/MapTypes.h"
+#include <array>
 #include <vector>
 
 class GameWorldViewer;
@@ -31,7 +32,23 @@ class IngameMinimap : public Minimap
         Road       /// Straße
     };
 
-    std::vector<DrawnObject> dos;
+    /// Cached layers of a node from which the final pixel color is composed.
+    /// Allows toggling territory, houses and roads without querying the world again
+    struct NodeLayers
+    {
+        /// Color of the terrain (including trees and granite) for both triangles without player color
+        std::array<unsigned, 2> terrainColor = {};
+        /// Owner of the node (player + 1) or 0 if none
+        unsigned char owner = 0;
+        DrawnObject drawnObject = DrawnObject::Invalid;
+        bool fow = false;
+        /// Position of the node in the list of nodesByObject for its drawn object
+        unsigned listPos = 0;
+    };
+
+    std::vector<NodeLayers> layers;
+    /// Indices of all nodes per drawn object, so toggling a layer only recomposes the affected nodes
+    std::array<std::vector<unsigned>, static_cast<unsigned>(DrawnObject::Road) + 1> nodesByObject;
 
     /// Einzelne Dinge anzeigen oder nicht anzeigen
     bool territory; /// Länder der Spieler
@@ -55,6 +72,12 @@ public:
 protected:
     /// Berechnet die Farbe für einen bestimmten Pixel der Minimap (t = Terrain1 oder 2)
     unsigned CalcPixelColor(MapPoint pt, unsigned t) override;
+    /// Compose the pixel color for the given triangle from the cached layers respecting the current toggles
+    unsigned ComposeColor(const NodeLayers& node, unsigned t) const;
+    /// Set the drawn object of the node with the given index and move it to the matching list of nodesByObject
+    void SetDrawnObject(unsigned idx, DrawnObject drawnObject);
+    /// Update the pixels of the given nodes from their cached layers
+    void RecomposeNodes(const std::vector<unsigned>& nodeIdxs);
     /// Berechnet für einen bestimmten Punkt und ein Dreieck die normale Terrainfarbe
     unsigned CalcTerrainColor(MapPoint pt, unsigned t);
     /// Prüft ob an einer Stelle eine Straße gezeichnet werden muss
@@ -64,6 +87,7 @@ protected:
     /// Zusätzliche Dinge, die die einzelnen Maps vor dem Zeichenvorgang zu tun haben
     /// in dem Falle: Karte aktualisieren
     void BeforeDrawing() override;
-    /// Alle Punkte Updaten, bei denen das DrawnObject gleich dem übergebenen drawn_object ist
+    /// Alle Punkte Updaten, bei denen das DrawnObject gleich dem übergebenen drawn_object ist.
+    /// Only recomposes the cached layers of those nodes, the world is not queried
     void UpdateAll(DrawnObject drawn_object);
 };
@@ -867,10 +867,17 @@ void Loader::fillCaches()
     {
         // generate mega texture
         stp->pack();
+        logger_.writeToFile("Packed %1% bitmaps into %2% shared textures (%3%%% used)\n") % stp->getNumBitmaps()
+          % stp->getNumPages() % static_cast<unsigned>(stp->getOccupancy() * 100);
     } else
         stp.reset();
 }
 
+bool Loader::addToSharedTextures(glSmartBitmap& bmp)
+{
+    return stp && stp->insert(bmp);
+}
+
 /**
  *  Extrahiert eine Textur aus den Daten.
  */
@@ -95,6 +95,11 @@ public:
               const libsiedler2::ArchivItem_Palette* palette = nullptr);
 
     void fillCaches();
+    /// Put a bitmap not cached by fillCaches onto the shared textures if those are enabled.
+    /// Return false if the bitmap has to use its own texture
+    bool addToSharedTextures(glSmartBitmap& bmp);
+    /// Texture packer of the shared textures or nullptr if disabled
+    glTexturePacker* getTexturePacker() { return stp.get(); }
     static std::unique_ptr<glArchivItem_Bitmap> ExtractTexture(const glArchivItem_Bitmap& srcImg, const Rect& rect);
     static std::unique_ptr<libsiedler2::Archiv> ExtractAnimatedTexture(const glArchivItem_Bitmap& srcImg,
                                                                        const Rect& rect, uint8_t start_index,
@@ -13,12 +13,13 @@ void NWFPlayerInfo::checkLagging()
     isLagging = commands.empty();
 }
 
-void NWFInfo::init(unsigned nextNWF, unsigned cmdDelay)
+void NWFInfo::init(unsigned nextNWF, unsigned cmdDelay, unsigned numExecutedNWFs)
 {
     if(cmdDelay < 1u)
         throw std::runtime_error("Command delay must be at least 1");
     nextNWF_ = nextNWF;
     cmdDelay_ = cmdDelay;
+    numExecutedNWFs_ = numExecutedNWFs;
     playerInfos_.clear();
     while(!serverInfos_.empty())
         serverInfos_.pop();
@@ -50,7 +51,7 @@ bool NWFInfo::addPlayerCmds(unsigned playerId, const PlayerGameCommands& cmds)
     // cmdDelay*2 pending commands.
     if(it->commands.size() >= 2 * cmdDelay_)
         return false;
-    it->commands.push(cmds);
+    it->commands.push_back(cmds);
     return true;
 }
 
@@ -116,12 +117,13 @@ void NWFInfo::execute(FramesInfo& info)
     {
         if(player.commands.empty())
             throw std::runtime_error("Cannot execute NWF if not ready");
-        player.commands.pop();
+        player.commands.pop_front();
     }
 
     info.gf_length = FramesInfo::milliseconds32_t(serverInfo.newGFLen);
     info.nwf_length = serverInfo.nextNWF - serverInfo.gf;
     nextNWF_ = serverInfo.nextNWF;
+    ++numExecutedNWFs_;
 }
 
 unsigned NWFInfo::getLastNWF() const
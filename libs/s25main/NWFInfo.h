@@ -5,6 +5,7 @@
 #pragma once
 
 #include "network/PlayerGameCommands.h"
+#include <deque>
 #include <queue>
 #include <vector>
 
@@ -26,7 +27,8 @@ struct NWFPlayerInfo
     /// Player Id
     unsigned id;
     bool isLagging;
-    std::queue<PlayerGameCommands> commands;
+    /// Received commands for the next NWFs, front is for the next NWF
+    std::deque<PlayerGameCommands> commands;
 
     explicit NWFPlayerInfo(unsigned playerId) : id(playerId), isLagging(false) {}
     /// Set isLagging flag to commands.empty()
@@ -38,13 +40,13 @@ class NWFInfo
 {
     std::queue<NWFServerInfo> serverInfos_;
     std::vector<NWFPlayerInfo> playerInfos_;
-    unsigned nextNWF_, cmdDelay_;
+    unsigned nextNWF_, cmdDelay_, numExecutedNWFs_;
 
 public:
-    NWFInfo() : nextNWF_(0), cmdDelay_(1) {}
+    NWFInfo() : nextNWF_(0), cmdDelay_(1), numExecutedNWFs_(0) {}
     /// Has to be called on game start with the first server info. Command delay is the number of NWS a command is sent
-    /// in advance (>=1)
-    void init(unsigned nextNWF, unsigned cmdDelay);
+    /// in advance (>=1). When joining a running game numExecutedNWFs is the number of NWFs executed before nextNWF
+    void init(unsigned nextNWF, unsigned cmdDelay, unsigned numExecutedNWFs = 0);
 
     /// Add an active player with the given id
     void addPlayer(unsigned playerId);
@@ -71,4 +73,8 @@ public:
     unsigned getLastNWF() const;
     /// Number of NWFs a command is sent in advance (>= 1)
     unsigned getCmdDelay() const { return cmdDelay_; }
+    /// Number of NWFs executed since the game start which is also the index of the next NWF
+    unsigned getNumExecutedNWFs() const { return numExecutedNWFs_; }
+    /// Number of NWFs for which the server info is known and which are not yet executed
+    unsigned getNumServerInfos() const { return serverInfos_.size(); }
 };
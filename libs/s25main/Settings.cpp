@@ -11,6 +11,7 @@
 #include "files.h"
 #include "helpers/strUtils.h"
 #include "languages.h"
+#include "random/Random.h"
 #include "gameData/const_gui_ids.h"
 #include "libsiedler2/ArchivItem_Ini.h"
 #include "libsiedler2/ArchivItem_Text.h"
@@ -75,6 +76,8 @@ void Settings::LoadDefaults()
     global.use_upnp = 2;
     global.smartCursor = true;
     global.debugMode = false;
+    global.asyncLogDepth = UsedRandom::defaultHistorySize;
+    global.aiTimeBudget = 0;
     // }
 
     // video
@@ -216,6 +219,14 @@ void Settings::Load()
         global.use_upnp = iniGlobal->getValueI("use_upnp");
         global.smartCursor = (iniGlobal->getValue("smartCursor").empty() || iniGlobal->getValueI("smartCursor") != 0);
         global.debugMode = (iniGlobal->getValueI("debugMode") != 0);
+        if(iniGlobal->getValue("asyncLogDepth").empty())
+            global.asyncLogDepth = UsedRandom::defaultHistorySize;
+        else
+            global.asyncLogDepth = iniGlobal->getValueI("asyncLogDepth");
+        if(iniGlobal->getValue("aiTimeBudget").empty())
+            global.aiTimeBudget = 0;
+        else
+            global.aiTimeBudget = iniGlobal->getValueI("aiTimeBudget");
 
         // };
 
@@ -394,6 +405,8 @@ void Settings::Save()
     iniGlobal->setValue("use_upnp", global.use_upnp);
     iniGlobal->setValue("smartCursor", global.smartCursor ? 1 : 0);
     iniGlobal->setValue("debugMode", global.debugMode ? 1 : 0);
+    iniGlobal->setValue("asyncLogDepth", global.asyncLogDepth);
+    iniGlobal->setValue("aiTimeBudget", global.aiTimeBudget);
     // };
 
     // video
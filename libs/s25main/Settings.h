@@ -55,6 +55,10 @@ public:
         unsigned use_upnp;
         bool smartCursor;
         bool debugMode;
+        /// Number of RNG invocations recorded for the async log
+        unsigned asyncLogDepth;
+        /// Time in microseconds each AI may use per GF, work exceeding it is continued in later GFs. 0 = unlimited
+        unsigned aiTimeBudget;
     } global;
 
     struct
@@ -491,6 +491,11 @@ void Window::DrawLine(DrawPoint pt1, DrawPoint pt2, unsigned short width, unsign
     VIDEODRIVER.GetRenderer()->DrawLine(pt1, pt2, width, color);
 }
 
+void Window::DrawPrimitives(const DrawList& list, DrawPoint offset)
+{
+    VIDEODRIVER.GetRenderer()->DrawPrimitives(list, offset);
+}
+
 void Window::Msg_PaintBefore()
 {
     animations_.update(VIDEODRIVER.GetTickCount());
@@ -43,6 +43,7 @@ class ctrlText;
 class ctrlTimer;
 class ctrlVarDeepening;
 class ctrlVarText;
+class DrawList;
 class glArchivItem_Bitmap;
 class glFont;
 class ITexture;
@@ -201,6 +202,8 @@ public:
     static void DrawRectangle(const Rect& rect, unsigned color);
     /// Zeichnet eine Linie
     static void DrawLine(DrawPoint pt1, DrawPoint pt2, unsigned short width, unsigned color);
+    /// Draw all recorded primitives of the list relative to the given position in one batch
+    static void DrawPrimitives(const DrawList& list, DrawPoint offset);
 
     // GUI-Notify-Messages
 
@@ -28,7 +28,7 @@
 
 WindowManager::WindowManager()
     : cursor_(Cursor::Hand), disable_mouse(false), lastMousePos(Position::Invalid()), curRenderSize(0, 0),
-      lastLeftClickTime(0), lastLeftClickPos(0, 0)
+      lastLeftClickTime(0), lastLeftClickPos(0, 0), windowsDrawTime_(0)
 {}
 
 WindowManager::~WindowManager() = default;
@@ -75,6 +75,7 @@ void WindowManager::Draw()
     curDesktop->Draw();
     curDesktop->Msg_PaintAfter();
 
+    const auto windowsStartTime = std::chrono::steady_clock::now();
     // First close all marked windows
     CloseMarkedIngameWnds();
     for(auto& wnd : windows)
@@ -90,6 +91,7 @@ void WindowManager::Draw()
 
     DrawToolTip();
     DrawCursor();
+    windowsDrawTime_ = std::chrono::steady_clock::now() - windowsStartTime;
 }
 
 /**
@@ -7,6 +7,7 @@
 #include "Point.h"
 #include "driver/VideoDriverLoaderInterface.h"
 #include "s25util/Singleton.h"
+#include <chrono>
 #include <list>
 #include <memory>
 #include <string>
@@ -42,6 +43,8 @@ public:
 
     /// Zeichnet Desktop und alle Fenster.
     void Draw();
+    /// CPU time spent on drawing the ingame windows, tooltip and cursor in the last frame
+    std::chrono::steady_clock::duration GetWindowsDrawTime() const { return windowsDrawTime_; }
     /// liefert ob der aktuelle Desktop den Focus besitzt oder nicht.
     bool IsDesktopActive();
 
@@ -150,6 +153,8 @@ private:
     // Für Doppelklick merken:
     unsigned lastLeftClickTime; /// Zeit des letzten Links-Klicks
     Position lastLeftClickPos;  /// Position beim letzten Links-Klick
+
+    std::chrono::steady_clock::duration windowsDrawTime_;
 };
 
 #define WINDOWMANAGER WindowManager::inst()
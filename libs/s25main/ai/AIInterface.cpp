@@ -18,7 +18,6 @@
 #include "nodeObjs/noTree.h"
 #include "gameData/TerrainDesc.h"
 #include <limits>
-#include <numeric>
 
 class noRoadNode;
 
@@ -125,24 +124,24 @@ int AIInterface::GetResourceRating(const MapPoint pt, AIResource res) const
             if(GetSurfaceResource(pt) == AISurfaceResource::Wood)
                 return RES_RADIUS[res];
             else if(IsBuildingOnNode(pt, BuildingType::Woodcutter))
-                return -40;
+                return -RES_BUILDING_RATING;
             else if(IsBuildingOnNode(pt, BuildingType::Forester))
-                return 40;
+                return RES_BUILDING_RATING;
             break;
         case AIResource::Stones:
             if(GetSurfaceResource(pt) == AISurfaceResource::Stones)
                 return RES_RADIUS[res];
             if(IsBuildingOnNode(pt, BuildingType::Quarry)) //penalize quarry already here
-                return -40;
+                return -RES_BUILDING_RATING;
             break;
         case AIResource::Plantspace:
             if(GetSurfaceResource(pt) == AISurfaceResource::Nothing
                && gwb.GetDescription().get(gwb.GetNode(pt).t1).IsVital())
                 return RES_RADIUS[res];
             else if(IsBuildingOnNode(pt, BuildingType::Forester))
-                return -40;
+                return -RES_BUILDING_RATING;
             else if(IsBuildingOnNode(pt, BuildingType::Farm))
-                return -20;
+                return -RES_BUILDING_RATING / 2;
             break;
         case AIResource::Borderland:
             if(IsOwnTerritory(pt) && !IsBorder(pt))
@@ -152,8 +151,9 @@ int AIInterface::GetResourceRating(const MapPoint pt, AIResource res) const
                 const auto& desc = gwb.GetDescription();
                 const auto& node = gwb.GetNode(pt);
 
-               if(gwb.IsOfTerrain(pt, [](const TerrainDesc& desc) { return desc.kind == TerrainKind::Mountain; }))
-                    return RES_RADIUS[res] *8; // give mountain terrain a boost to encourage AI growth near by
+                // give mountain terrain a boost to encourage AI growth near by
+                if(gwb.IsOfTerrain(pt, [](const TerrainDesc& desc) { return desc.kind == TerrainKind::Mountain; }))
+                    return RES_RADIUS[res] * RES_MOUNTAIN_FACTOR;
                 if(desc.get(node.t1).Is(ETerrain::Walkable) || desc.get(node.t2).Is(ETerrain::Walkable))
                     return RES_RADIUS[res];
                 
@@ -171,64 +171,6 @@ int AIInterface::GetResourceRating(const MapPoint pt, AIResource res) const
     return 0;
 }
 
-int AIInterface::CalcResourceValue(const MapPoint pt, AIResource res, helpers::OptionalEnum<Direction> direction,
-                                   int lastval) const
-{
-    const unsigned resRadius = RES_RADIUS[res];
-    if(!direction) // calculate complete value from scratch (3n^2+3n+1)
-    {
-        std::vector<MapPoint> pts = gwb.GetPointsInRadiusWithCenter(pt, resRadius);
-        return std::accumulate(pts.begin(), pts.end(), 0, [this, res](int lhs, const auto& curPt) {
-            return lhs + this->GetResourceRating(curPt, res);
-        });
-    } else // calculate different nodes only (4n+2 ?anyways much faster)
-    {
-        const auto iDirection = rttr::enum_cast(*direction);
-        int returnVal = lastval;
-        // add new points
-        // first: go radius steps towards direction-1
-        MapPoint tmpPt(pt);
-        for(unsigned i = 0; i < resRadius; i++)
-            tmpPt = gwb.GetNeighbour(tmpPt, *direction - 1u);
-        // then clockwise around at radius distance to get all new points
-        for(unsigned i = iDirection + 1u; i < iDirection + 3u; ++i)
-        {
-            int numSteps = resRadius;
-            // add 1 extra step on the second side we check to complete the side
-            if(i == iDirection + 2u)
-                ++numSteps;
-            for(MapCoord r2 = 0; r2 < numSteps; ++r2)
-            {
-                returnVal += GetResourceRating(tmpPt, res);
-                tmpPt = gwb.GetNeighbour(tmpPt, convertToDirection(i));
-            }
-        }
-        // now substract old points not in range of new point
-        // go to old center point:
-        tmpPt = pt;
-        tmpPt = gwb.GetNeighbour(tmpPt, *direction + 3u);
-        // next: go to the first old point we have to substract
-        for(unsigned i = 0; i < RES_RADIUS[res]; i++)
-            tmpPt = gwb.GetNeighbour(tmpPt, *direction + 2u);
-        // now clockwise around at radius distance to remove all old points
-        for(int i = iDirection + 4; i < iDirection + 6; ++i)
-        {
-            int numSteps = resRadius;
-            if(i == iDirection + 5)
-                ++numSteps;
-            for(MapCoord r2 = 0; r2 < numSteps; ++r2)
-            {
-                returnVal -= GetResourceRating(tmpPt, res);
-                tmpPt = gwb.GetNeighbour(tmpPt, convertToDirection(i));
-            }
-        }
-        return returnVal;
-    }
-    // if(returnval<0&&lastval>=0&&res==AIResource::Borderland)
-    // LOG.write(("AIInterface::CalcResourceValue - warning: negative returnvalue direction %i oldval %i\n", direction,
-    // lastval);
-}
-
 bool AIInterface::FindFreePathForNewRoad(MapPoint start, MapPoint target, std::vector<Direction>* route /*= nullptr*/,
                                          unsigned* length /*= nullptr*/) const
 {
@@ -238,6 +180,15 @@ bool AIInterface::FindFreePathForNewRoad(MapPoint start, MapPoint target, std::v
                                                                  nullptr, (void*)&boat);
 }
 
+bool AIInterface::FindFreePathForNewRoadToAny(MapPoint start, const std::vector<MapPoint>& targets,
+                                              const FP_Target_Reached_Callback& onTargetReached) const
+{
+    bool boat = false;
+    return gwb.GetFreePathFinder().FindPathToAnyAlternatingConditions(
+      start, targets, false, 100, IsPointOK_RoadPath, IsPointOK_RoadPathEvenStep, nullptr, (void*)&boat,
+      onTargetReached);
+}
+
 bool AIInterface::CalcBQSumDifference(const MapPoint pt1, const MapPoint pt2) const
 {
     return GetBuildingQuality(pt2) < GetBuildingQuality(pt1);
@@ -262,6 +213,12 @@ bool AIInterface::FindPathOnRoads(const noRoadNode& start, const noRoadNode& tar
         return gwb.GetRoadPathFinder().PathExists(start, target, false);
 }
 
+std::vector<unsigned> AIInterface::FindPathLengthsOnRoads(const noRoadNode& start,
+                                                          const std::vector<const noRoadNode*>& targets) const
+{
+    return gwb.GetRoadPathFinder().FindPathLengths(start, targets);
+}
+
 const nobHQ* AIInterface::GetHeadquarter() const
 {
     return gwb.GetSpecObj<nobHQ>(player_.GetHQPos());
@@ -9,7 +9,7 @@
 #include "NodalObjectTypes.h"
 #include "ai/AIResource.h"
 #include "factories/GameCommandFactory.h"
-#include "helpers/OptionalEnum.h"
+#include "pathfinding/FreePathFinder.h"
 #include "world/GameWorldBase.h"
 #include "gameTypes/ChatDestination.h"
 #include "gameTypes/Direction.h"
@@ -46,10 +46,6 @@ public:
     AISubSurfaceResource GetSubsurfaceResource(MapPoint pt) const;
     /// Return the resource on top on a given spot (wood, stones, nothing)
     AISurfaceResource GetSurfaceResource(MapPoint pt) const;
-    /// Calculate the surface resource value on a given spot (wood/ stones/ farmland)
-    /// when given a direction and lastvalue the calculation will be much faster O(n) vs O(n^2)
-    int CalcResourceValue(MapPoint pt, AIResource res, helpers::OptionalEnum<Direction> direction = boost::none,
-                          int lastval = 0xffff) const;
     /// Calculate the resource value for a given point
     int GetResourceRating(MapPoint pt, AIResource res) const;
     /// Test whether a given point is part of the border or not
@@ -87,8 +83,16 @@ public:
     /// Tries to find a free path for a road and return length and the route
     bool FindFreePathForNewRoad(MapPoint start, MapPoint target, std::vector<Direction>* route = nullptr,
                                 unsigned* length = nullptr) const;
+    /// Searches free paths for a new road from start to all targets at once. See
+    /// FreePathFinder::FindPathToAnyAlternatingConditions
+    bool FindFreePathForNewRoadToAny(MapPoint start, const std::vector<MapPoint>& targets,
+                                     const FP_Target_Reached_Callback& onTargetReached) const;
     /// Tries to find a route from start to target, returning length of that route if it exists
     bool FindPathOnRoads(const noRoadNode& start, const noRoadNode& target, unsigned* length = nullptr) const;
+    /// Returns the lengths of the routes from start to each of the targets, std::numeric_limits<unsigned>::max() if
+    /// there is none
+    std::vector<unsigned> FindPathLengthsOnRoads(const noRoadNode& start,
+                                                 const std::vector<const noRoadNode*>& targets) const;
     /// Checks if it is allowed to build catapults
     bool CanBuildCatapult() const { return player_.CanBuildCatapult(); }
     /// checks if the player is allowed to build the building type (lua maybe later addon?)
@@ -0,0 +1,171 @@
+// Copyright (C) 2005 - 2021 Settlers Freaks (sf-team at siedler25.org)
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "AIMatch.h"
+#include "EventManager.h"
+#include "Game.h"
+#include "GameCommand.h"
+#include "GameInterface.h"
+#include "GamePlayer.h"
+#include "PlayerInfo.h"
+#include "ai/AIPlayer.h"
+#include "factories/AIFactory.h"
+#include "helpers/EnumRange.h"
+#include "random/Random.h"
+#include "world/GameWorld.h"
+#include "world/MapLoader.h"
+#include "gameData/GameConsts.h"
+#include "s25util/colors.h"
+#include <algorithm>
+#include <cstdlib>
+
+namespace {
+/// Records the events relevant for the result of the match
+class MatchObserver final : public GameInterface
+{
+public:
+    MatchObserver(const EventManager& em, AIMatchResult& result) : em(em), result(result) {}
+
+    void GI_PlayerDefeated(unsigned playerId) override { result.players[playerId].defeatGF = em.GetCurrentGF(); }
+    void GI_Winner(unsigned playerId) override { result.winners = {playerId}; }
+    void GI_TeamWinner(unsigned playerMask) override
+    {
+        result.winners.clear();
+        for(unsigned i = 0; i < result.players.size(); i++)
+        {
+            if(playerMask & (1u << i))
+                result.winners.push_back(i);
+        }
+    }
+
+    // Nothing to show
+    void GI_UpdateMinimap(MapPoint) override {}
+    void GI_FlagDestroyed(MapPoint) override {}
+    void GI_TreatyOfAllianceChanged(unsigned) override {}
+    void GI_WindowClosed(Window*) override {}
+    void GI_StartRoadBuilding(MapPoint, bool) override {}
+    void GI_CancelRoadBuilding() override {}
+    void GI_BuildRoad() override {}
+
+private:
+    const EventManager& em;
+    AIMatchResult& result;
+};
+
+/// Return the remaining players if all of them are allied, i.e. the game is decided
+std::vector<unsigned> getRemainingTeam(const GameWorld& world)
+{
+    std::vector<unsigned> alivePlayers;
+    for(unsigned i = 0; i < world.GetNumPlayers(); i++)
+    {
+        if(!world.GetPlayer(i).IsDefeated())
+            alivePlayers.push_back(i);
+    }
+    for(const unsigned i : alivePlayers)
+    {
+        for(const unsigned j : alivePlayers)
+        {
+            if(i != j && !world.GetPlayer(i).IsAlly(j))
+                return {};
+        }
+    }
+    return alivePlayers;
+}
+
+void sampleStatistic(const GameWorld& world, AIMatchResult& result)
+{
+    for(unsigned i = 0; i < result.players.size(); i++)
+    {
+        const GamePlayer& player = world.GetPlayer(i);
+        AIMatchResult::StatisticValues values;
+        for(const auto type : helpers::EnumRange<StatisticType>{})
+            values[type] = player.GetStatisticCurrentValue(type);
+        result.players[i].statistic.push_back(values);
+    }
+}
+} // namespace
+
+bool AIMatchResult::isWinner(unsigned playerId) const
+{
+    return std::find(winners.begin(), winners.end(), playerId) != winners.end();
+}
+
+double AIMatchResult::getGFsPerSecond() const
+{
+    const auto seconds = std::chrono::duration_cast<std::chrono::duration<double>>(duration).count();
+    return (seconds > 0) ? numGFs / seconds : 0.;
+}
+
+boost::optional<AIMatchResult> playAIMatch(const AIMatchConfig& config)
+{
+    const unsigned numPlayers = config.players.size();
+    std::vector<PlayerInfo> players(numPlayers);
+    for(unsigned i = 0; i < numPlayers; i++)
+    {
+        players[i].ps = PlayerState::AI;
+        players[i].aiInfo = config.players[i];
+        players[i].name = "AI " + std::to_string(i + 1);
+        players[i].color = PLAYER_COLORS[i % PLAYER_COLORS.size()];
+    }
+
+    Game game(config.ggs, /*startGF*/ 0, players);
+    RANDOM.Init(config.seed);
+    // The AIs use the C random numbers
+    srand(static_cast<unsigned>(config.seed));
+    GameWorld& world = game.world_;
+    for(unsigned i = 0; i < numPlayers; i++)
+        world.GetPlayer(i).MakeStartPacts();
+    MapLoader loader(world);
+    if(!loader.Load(config.mapPath))
+        return boost::none;
+    world.SetupResources();
+    world.InitAfterLoad();
+
+    AIMatchResult result;
+    for(const AI::Info& ai : config.players)
+        result.players.push_back(AIMatchResult::Player{ai, boost::none, {}});
+    constexpr unsigned GFsIn30s = std::chrono::duration<unsigned>(30) / SPEED_GF_LENGTHS[referenceSpeed];
+    result.statisticInterval = config.statisticInterval ? config.statisticInterval : GFsIn30s;
+    MatchObserver observer(*game.em_, result);
+    world.SetGameInterface(&observer);
+
+    // Created after the world is set up like in a real game
+    for(unsigned i = 0; i < numPlayers; i++)
+        game.AddAIPlayer(AIFactory::Create(config.players[i], i, world));
+    game.Start(false);
+    sampleStatistic(world, result);
+
+    std::vector<std::vector<gc::GameCommandPtr>> pendingGCs(numPlayers);
+    const auto startTime = std::chrono::steady_clock::now();
+    unsigned curGF = game.em_->GetCurrentGF();
+    while(curGF < config.maxGF && !game.IsGameFinished() && result.winners.empty())
+    {
+        const bool isNWF = curGF % config.nwfLength == 0;
+        if(isNWF)
+        {
+            for(AIPlayer& ai : game.aiPlayers_)
+            {
+                for(const gc::GameCommandPtr& gc : pendingGCs[ai.GetPlayerId()])
+                    gc->Execute(world, ai.GetPlayerId());
+                pendingGCs[ai.GetPlayerId()] = ai.FetchGameCommands();
+            }
+        }
+        for(AIPlayer& ai : game.aiPlayers_)
+            ai.RunGF(curGF, isNWF);
+        game.RunGF();
+        curGF = game.em_->GetCurrentGF();
+
+        if(curGF % result.statisticInterval == 0)
+            sampleStatistic(world, result);
+        // Without an objective the game is won when only allied players are left
+        const bool anyDefeated = std::any_of(result.players.begin(), result.players.end(),
+                                             [](const AIMatchResult::Player& player) { return !!player.defeatGF; });
+        if(anyDefeated && result.winners.empty())
+            result.winners = getRemainingTeam(world);
+    }
+    result.duration = std::chrono::steady_clock::now() - startTime;
+    result.numGFs = curGF;
+    world.SetGameInterface(nullptr);
+    return result;
+}
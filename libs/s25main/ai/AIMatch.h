@@ -0,0 +1,59 @@
+// Copyright (C) 2005 - 2021 Settlers Freaks (sf-team at siedler25.org)
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "GlobalGameSettings.h"
+#include "helpers/EnumArray.h"
+#include "gameTypes/AIInfo.h"
+#include "gameTypes/StatisticTypes.h"
+#include <boost/filesystem/path.hpp>
+#include <boost/optional.hpp>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+/// Settings of a game played only by AIs without any client or server
+struct AIMatchConfig
+{
+    boost::filesystem::path mapPath;
+    /// AI of each player
+    std::vector<AI::Info> players;
+    GlobalGameSettings ggs;
+    /// Seed of the game RNG and of the random numbers used by the AIs
+    uint64_t seed = 0;
+    /// Stop the match after this many GFs
+    unsigned maxGF = 100000;
+    /// Number of GFs between network frames. Commands of the AIs are executed in the network frame after the one they
+    /// were issued in like in a network game
+    unsigned nwfLength = 5;
+    /// Number of GFs between two samples of the statistic values. Defaults to the statistic update interval
+    unsigned statisticInterval = 0;
+};
+
+struct AIMatchResult
+{
+    using StatisticValues = helpers::EnumArray<uint32_t, StatisticType>;
+    struct Player
+    {
+        AI::Info ai;
+        /// GF at which the player was defeated if he was
+        boost::optional<unsigned> defeatGF;
+        /// Current statistic values sampled at GF 0 and then every statisticInterval GFs
+        std::vector<StatisticValues> statistic;
+    };
+    std::vector<Player> players;
+    /// Players which won the game. Empty if the game was stopped before someone won
+    std::vector<unsigned> winners;
+    unsigned numGFs = 0;
+    unsigned statisticInterval = 0;
+    std::chrono::steady_clock::duration duration{};
+
+    bool isWinner(unsigned playerId) const;
+    double getGFsPerSecond() const;
+};
+
+/// Play a game as fast as possible with AIs on all player slots till a player or team won or maxGF is reached.
+/// Return none if the map could not be loaded
+boost::optional<AIMatchResult> playAIMatch(const AIMatchConfig& config);
@@ -6,12 +6,13 @@
 
 #include "helpers/EnumArray.h"
 #include "s25util/warningSuppression.h"
+#include <cstdint>
 
 // Note: This enums are constructed for performance and easy conversion.
 // AIResource must be contiguous and it is assumed that only valid enumerators are used
 
 /// Resources stored on AI nodes. Starts with all values from AIResource in that order!
-enum class AINodeResource
+enum class AINodeResource : uint8_t
 {
     Gold,
     Ironore,
@@ -97,3 +98,16 @@ constexpr helpers::EnumArray<unsigned, AIResource> SUPPRESS_UNUSED RES_RADIUS =
   3, // Plantspace
   8, // Borderland
 };
+
+/// Absolute rating of a node with a building consuming or producing the resource (e.g. a woodcutter for wood)
+constexpr int RES_BUILDING_RATING = 40;
+/// Factor by which the rating of mountains is boosted for the borderland
+constexpr int RES_MOUNTAIN_FACTOR = 8;
+
+/// Maximum absolute value of AIInterface::GetResourceRating for the resource
+constexpr int getMaxResourceRating(AIResource res)
+{
+    const int factor = (res == AIResource::Borderland) ? RES_MOUNTAIN_FACTOR : 1;
+    const int rating = static_cast<int>(RES_RADIUS[res]) * factor;
+    return (rating > RES_BUILDING_RATING) ? rating : RES_BUILDING_RATING;
+}
@@ -89,13 +89,15 @@ void AIConstruction::AddBuildJob(std::unique_ptr<BuildJob> job, bool front)
 
 }*/
 
-void AIConstruction::ExecuteJobs(unsigned limit)
+bool AIConstruction::ExecuteJobs(unsigned& limit)
 {
+    const AIScheduler& scheduler = aijh.GetScheduler();
     unsigned i = 0; // count up to limit
     unsigned initconjobs = std::min<unsigned>(connectJobs.size(), 5);
     unsigned initbuildjobs = std::min<unsigned>(buildJobs.size(), 5);
+    bool isBudgetLeft = true;
 
-    for(; i < limit && !connectJobs.empty() && i < initconjobs;
+    for(; isBudgetLeft && i < limit && !connectJobs.empty() && i < initconjobs;
         i++) // go through list, until limit is reached or list empty or when every entry has been checked
     {
         auto job = std::move(connectJobs.front());
@@ -106,17 +108,20 @@ void AIConstruction::ExecuteJobs(unsigned limit)
         {
             connectJobs.push_back(std::move(job));
         }
+        isBudgetLeft = !scheduler.isBudgetUsedUp();
     }
   
-    for(; i < limit && !buildJobs.empty() && i < initconjobs + initbuildjobs; i++)
+    for(; isBudgetLeft && i < limit && !buildJobs.empty() && i < initconjobs + initbuildjobs; i++)
     {
         auto job = GetBuildJob();
         job->ExecuteJob();
         if(job->GetState() != JobState::Finished
            && job->GetState() != JobState::Failed) // couldnt do job? -> move to back of list
             buildJobs.push_back(std::move(job));
-        
+        isBudgetLeft = !scheduler.isBudgetUsedUp();
     }
+    limit -= i;
+    return isBudgetLeft || limit == 0;
 }
 
 void AIConstruction::SetFlagsAlongRoad(const noRoadNode& roadNode, Direction dir)
@@ -257,8 +262,6 @@ bool AIConstruction::MilitaryBuildingWantsRoad(const nobMilitary& milbld)
 bool AIConstruction::ConnectFlagToRoadSytem(const noFlag* flag, std::vector<Direction>& route,
                                             unsigned maxSearchRadius /*= 14*/)
 {
-    // TODO: the method can get really bad runtimes ... Optimize?
-
     // Radius in which to look for worthy flags
     // const unsigned short maxSearchRadius = 10;
 
@@ -284,68 +287,74 @@ bool AIConstruction::ConnectFlagToRoadSytem(const noFlag* flag, std::vector<Dire
     std ::cout << "FindFlagsNum:" << flags.size() << std ::endl;
 #endif
 
-    const noFlag* shortest = nullptr;
-    unsigned shortestLength = 99999;
-    std ::vector<Direction> tmpRoute;
-
-    // test every flag ...
-    for(const noFlag* curFlag : flags)
-    {
-        tmpRoute.clear();
-        unsigned length;
-        // the flag should not be at a military building!
-        if(aii.gwb.IsMilitaryBuildingOnNode(aii.gwb.GetNeighbour(curFlag->GetPos(), Direction ::NorthWest), true))
-            continue;
-        // Is there a path to this flag at all
-        if(!aii.FindFreePathForNewRoad(flag->GetPos(), curFlag->GetPos(), &tmpRoute, &length))
-            continue;
-
-        // If so, see if this path is as short as possible to the "higher" goal (general camp at the moment)
-        unsigned maxNonFlagPts = 0;
-        // check for non-flag points on planned route: more than 2 nonflaggable spaces on the route -> not really valid
-        // path
-        unsigned curNonFlagPts = 0;
-        MapPoint tmpPos = flag->GetPos();
-
-
-        for(auto j : tmpRoute)
-        {
-            tmpPos = aii.gwb.GetNeighbour(tmpPos, j);
-            RTTR_Assert(aii.GetBuildingQuality(tmpPos) == aijh.GetAINode(tmpPos).bq);
-            if(aii.GetBuildingQuality(tmpPos) == BuildingQuality ::Nothing)
-                curNonFlagPts++;
-            else
-            {
-                if(maxNonFlagPts < curNonFlagPts)
-                    maxNonFlagPts = curNonFlagPts;
-                curNonFlagPts = 0;
-            }
-        }
-        if(maxNonFlagPts > 2) 
-            continue;
+    // the flag should not be at a military building!
+    helpers::erase_if(flags, [this](const noFlag* curFlag) {
+        return aii.gwb.IsMilitaryBuildingOnNode(aii.gwb.GetNeighbour(curFlag->GetPos(), Direction ::NorthWest), true);
+    });
+    if(flags.empty())
+        return false;
 
-        // Find path from current flag to target. If the current flag IS the target then we have already a path with
-        // distance = 0
-        unsigned distance = 0;
-        bool pathFound = curFlag == targetFlag || aii.FindPathOnRoads(*curFlag, *targetFlag, &distance);
+    // Distances of all flags to the "higher" goal (general camp at the moment) and to our flag in one search each.
+    // If the current flag IS the target then we have already a path with distance = 0
+    const std::vector<const noRoadNode*> flagNodes(flags.begin(), flags.end());
+    const std::vector<unsigned> targetDistances = aii.FindPathLengthsOnRoads(*targetFlag, flagNodes);
+    const std::vector<unsigned> ownDistances = aii.FindPathLengthsOnRoads(*flag, flagNodes);
 
-        // Unfortunately, the chosen flag has no connection to a camp, too bad!
-        if(!pathFound)
+    std::vector<const noFlag*> candidates;
+    std::vector<MapPoint> candidatePositions;
+    std::vector<unsigned> candidateDistances;
+    for(unsigned i = 0; i < flags.size(); i++)
+    {
+        // Unfortunately, the flag has no connection to a camp, too bad!
+        if(targetDistances[i] == std::numeric_limits<unsigned>::max())
             continue;
-
         // Are we already connected to the flag? Once is enough!
-        if(aii.FindPathOnRoads(*curFlag, *flag))
+        if(ownDistances[i] != std::numeric_limits<unsigned>::max())
             continue;
-
-        // shorter than the last one? To take! Weight existing route higher (2) so that construction routes are as short
-        // as possible are preferred for routes of similar length
-        if(2 * length + distance + 10 * maxNonFlagPts < shortestLength)
-        {
-            shortest = curFlag;
-            shortestLength = 2 * length + distance + 10 * maxNonFlagPts;
-            route = tmpRoute;
-        }
+        candidates.push_back(flags[i]);
+        candidatePositions.push_back(flags[i]->GetPos());
+        candidateDistances.push_back(targetDistances[i]);
     }
+    if(candidates.empty())
+        return false;
+    const unsigned minDistance = *std::min_element(candidateDistances.begin(), candidateDistances.end());
+
+    const noFlag* shortest = nullptr;
+    unsigned shortestLength = 99999;
+
+    // Search the free paths to all candidates at once. They are found in order of increasing length
+    aii.FindFreePathForNewRoadToAny(
+      flag->GetPos(), candidatePositions, [&](const unsigned idx, const std::vector<Direction>& tmpRoute) {
+          unsigned maxNonFlagPts = 0;
+          // check for non-flag points on planned route: more than 2 nonflaggable spaces on the route -> not really
+          // valid path
+          unsigned curNonFlagPts = 0;
+          MapPoint tmpPos = flag->GetPos();
+          for(auto j : tmpRoute)
+          {
+              tmpPos = aii.gwb.GetNeighbour(tmpPos, j);
+              RTTR_Assert(aii.GetBuildingQuality(tmpPos) == aijh.GetAINode(tmpPos).bq);
+              if(aii.GetBuildingQuality(tmpPos) == BuildingQuality ::Nothing)
+                  curNonFlagPts++;
+              else
+              {
+                  if(maxNonFlagPts < curNonFlagPts)
+                      maxNonFlagPts = curNonFlagPts;
+                  curNonFlagPts = 0;
+              }
+          }
+          // shorter than the last one? To take! Weight existing route higher (2) so that construction routes are as
+          // short as possible are preferred for routes of similar length
+          const unsigned length = 2 * tmpRoute.size() + candidateDistances[idx] + 10 * maxNonFlagPts;
+          if(maxNonFlagPts <= 2 && length < shortestLength)
+          {
+              shortest = candidates[idx];
+              shortestLength = length;
+              route = tmpRoute;
+          }
+          // Routes found later are at least as long, so they can only be better if they are shorter than this
+          return (shortestLength <= minDistance) ? 0u : (shortestLength - minDistance - 1) / 2;
+      });
 
     if(shortest)
     {
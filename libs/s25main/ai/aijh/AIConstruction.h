@@ -76,7 +76,9 @@ public:
 
     bool CanStillConstructHere(MapPoint pt) const;
 
-    void ExecuteJobs(unsigned limit);
+    /// Execute up to limit connect & construction jobs, reducing limit by the number executed.
+    /// Returns false if it stopped early because the time budget of the AI is used up
+    bool ExecuteJobs(unsigned& limit);
     /// Set flags along the road starting at the given node in the given direction
     void SetFlagsAlongRoad(const noRoadNode& roadNode, Direction dir);
     /// To be called after a new construction site was added
@@ -7,18 +7,21 @@
 #include "ai/AIResource.h"
 #include "world/NodeMapBase.h"
 #include "gameTypes/BuildingQuality.h"
+#include <cstdint>
 
 namespace AIJH {
+/// Information of the AI about a node. Packed into 4 bytes as every AI keeps one for each node of the map
 struct Node
 {
     BuildingQuality bq;
-    AINodeResource res; // TODO: Fixup to keep in sync
-    bool owned;
-    bool reachable;
-    char failed_penalty; // when a node was marked reachable, but building failed, this field is >0
-    bool border;
-    bool farmed;
+    AINodeResource res;     // TODO: Fixup to keep in sync
+    uint8_t failed_penalty; // when a node was marked reachable, but building failed, this field is >0
+    bool owned : 1;
+    bool reachable : 1;
+    bool border : 1;
+    bool farmed : 1;
 };
+static_assert(sizeof(Node) == 4, "Node should be packed");
 
 /// Map of AINodes
 using AIMap = NodeMapBase<Node>;
@@ -17,6 +17,7 @@
 #include "buildings/nobHQ.h"
 #include "buildings/nobMilitary.h"
 #include "buildings/nobUsual.h"
+#include "enum_cast.hpp"
 #include "helpers/MaxEnumValue.h"
 #include "helpers/containerUtils.h"
 #include "network/GameClient.h"
@@ -27,7 +28,6 @@
 #include "notifications/ResourceNote.h"
 #include "notifications/RoadNote.h"
 #include "notifications/ShipNote.h"
-#include "pathfinding/PathConditionRoad.h"
 #include "nodeObjs/noAnimal.h"
 #include "nodeObjs/noFlag.h"
 #include "nodeObjs/noShip.h"
@@ -40,12 +40,26 @@
 #include "gameData/ToolConsts.h"
 #include <algorithm>
 #include <array>
+#include <future>
 #include <memory>
 #include <random>
 #include <stdexcept>
 #include <type_traits>
+#include <utility>
 
 namespace {
+/// Ids of the work items run by the scheduler
+enum class AITask : unsigned
+{
+    Jobs,
+    Attack,
+    MilUpgrade,
+    SeaAttack,
+    CheckProduction,
+    AdjustSettings,
+    PlanBuildings
+};
+
 void HandleBuildingNote(AIEventManager& eventMgr, const BuildingNote& note)
 {
     std::unique_ptr<AIEvent::Base> ev;
@@ -112,6 +126,19 @@ void HandleShipNote(AIEventManager& eventMgr, const ShipNote& note)
     if(note.type == ShipNote::Constructed)
         eventMgr.AddAIEvent(std::make_unique<AIEvent::Location>(AIEvent::EventType::ShipBuilt, note.pos));
 }
+
+/// True if a building (of any size) or a harbor can be placed with that BQ
+bool isBuildingPlace(const BuildingQuality bq)
+{
+    return (bq >= BuildingQuality::Hut && bq <= BuildingQuality::Castle) || bq == BuildingQuality::Harbor;
+}
+
+/// True if the object is a building or something which is counted like one (building site, fire, ...)
+bool isBuildingLike(const NodalObjectType nob)
+{
+    return nob == NodalObjectType::Building || nob == NodalObjectType::Buildingsite || nob == NodalObjectType::Extension
+           || nob == NodalObjectType::Fire || nob == NodalObjectType::CharburnerPile;
+}
 } // namespace
 
 namespace AIJH {
@@ -132,6 +159,10 @@ Subscription recordBQsToUpdate(const GameWorldBase& gw, std::vector<MapPoint>& b
             // Owner changes border, which changes where buildings can be placed next to it
             // And as flags are need for buildings we need range 2 (e.g. range 1 is flag, range 2 building)
             gw.CheckPointsInRadius(note.pos, 2, addToBqsToUpdate, true);
+        } else if(note.type == NodeNote::ObjRemoved)
+        {
+            // The node and the extensions of a big building no longer count as buildings, even if the BQ stays
+            gw.CheckPointsInRadius(note.pos, 1, addToBqsToUpdate, true);
         }
     });
 }
@@ -163,7 +194,8 @@ static auto createResourceMaps(const AIInterface& aii, const AIMap& aiMap)
 }
 
 AIPlayerJH::AIPlayerJH(const unsigned char playerId, const GameWorldBase& gwb, const AI::Level level)
-    : AIPlayer(playerId, gwb, level), UpgradeBldPos(MapPoint::Invalid()), resourceMaps(createResourceMaps(aii, aiMap)),
+    : AIPlayer(playerId, gwb, level), UpgradeBldPos(MapPoint::Invalid()), reachability(gwb, playerId, aiMap),
+      resourceMaps(createResourceMaps(aii, aiMap)),
       isInitGfCompleted(false), defeated(player.IsDefeated()), bldPlanner(std::make_unique<BuildingPlanner>(*this)),
       construction(std::make_unique<AIConstruction>(*this))
 {
@@ -261,9 +293,14 @@ void AIPlayerJH::RunGF(const unsigned gf, bool gfisnwf)
     {
         helpers::makeUnique(nodesWithOutdatedBQ, MapPointLess());
         for(const MapPoint pt : nodesWithOutdatedBQ)
+        {
             aiMap[pt].bq = aii.GetBuildingQuality(pt);
+            UpdateBuildingPlace(pt);
+        }
         nodesWithOutdatedBQ.clear();
     }
+    // Changes made by the last GF or by commands executed since
+    ApplyReachabilityChanges();
 
     bldPlanner->Update(gf, *this);
 
@@ -273,57 +310,86 @@ void AIPlayerJH::RunGF(const unsigned gf, bool gfisnwf)
     // LOG.write(("ai doing stuff %i \n",playerId);
     if(gf % 100 == 0)
         bldPlanner->UpdateBuildingsWanted(*this);
-    ExecuteAIJob();
+
+    // Queue the work due in this GF. Work left over from previous GFs is continued first and not queued twice
+    scheduler.add(rttr::enum_cast(AITask::Jobs), [this, eventQuota = 10u, jobQuota = GetJobQuota()]() mutable {
+        return ExecuteAIJob(eventQuota, jobQuota);
+    });
 
     if((gf + playerId * 17) % attack_interval == 0)
     {
         // CheckExistingMilitaryBuildings();
-        TryToAttack();
+        scheduler.add(rttr::enum_cast(AITask::Attack), [this]() {
+            TryToAttack();
+            return true;
+        });
     }
     if(((gf + playerId * 17) % 73 == 0) && (level != AI::Level::Easy))
     {
-        MilUpgradeOptim();
+        scheduler.add(rttr::enum_cast(AITask::MilUpgrade), [this]() {
+            MilUpgradeOptim();
+            return true;
+        });
     }
 
     if((gf + 41 + playerId * 17) % attack_interval == 0)
     {
         if(ggs.getSelection(AddonId::SEA_ATTACK) < 2) // not deactivated by addon? -> go ahead
-            TrySeaAttack();
+        {
+            scheduler.add(rttr::enum_cast(AITask::SeaAttack), [this]() {
+                TrySeaAttack();
+                return true;
+            });
+        }
     }
 
     if((gf + playerId * 13) % 1500 == 0)
     {
-        CheckExpeditions();
-        CheckForester();
-        CheckGranitMine();
+        scheduler.add(rttr::enum_cast(AITask::CheckProduction), [this]() {
+            CheckExpeditions();
+            CheckForester();
+            CheckGranitMine();
+            return true;
+        });
     }
 
     if((gf + playerId * 11) % 150 == 0)
     {
-        AdjustSettings();
-        // check for useless sawmills
-        const std::list<nobUsual*>& sawMills = aii.GetBuildings(BuildingType::Sawmill);
-        if(sawMills.size() > 3)
-        {
-            int burns = 0;
-            for(const nobUsual* sawmill : sawMills)
-            {
-                if(sawmill->GetProductivity() < 1 && sawmill->HasWorker() && sawmill->GetNumWares(0) < 1
-                   && (sawMills.size() - burns) > 3 && !sawmill->AreThereAnyOrderedWares())
-                {
-                    aii.DestroyBuilding(sawmill);
-                    RemoveUnusedRoad(*sawmill->GetFlag(), Direction::NorthWest, true);
-                    burns++;
-                }
-            }
-        }
+        scheduler.add(rttr::enum_cast(AITask::AdjustSettings), [this]() {
+            AdjustSettings();
+            DestroyUselessSawmills();
+            return true;
+        });
     }
 
     if((gf + playerId * 7) % build_interval == 0) // plan new buildings
     {
-        CheckForUnconnectedBuildingSites();
-        CheckForUnconnectedBuildings();
-        PlanNewBuildings(gf);
+        scheduler.add(rttr::enum_cast(AITask::PlanBuildings), [this, gf]() {
+            CheckForUnconnectedBuildingSites();
+            CheckForUnconnectedBuildings();
+            PlanNewBuildings(gf);
+            return true;
+        });
+    }
+
+    scheduler.run();
+}
+
+void AIPlayerJH::DestroyUselessSawmills()
+{
+    const std::list<nobUsual*>& sawMills = aii.GetBuildings(BuildingType::Sawmill);
+    if(sawMills.size() <= 3)
+        return;
+    int burns = 0;
+    for(const nobUsual* sawmill : sawMills)
+    {
+        if(sawmill->GetProductivity() < 1 && sawmill->HasWorker() && sawmill->GetNumWares(0) < 1
+           && (sawMills.size() - burns) > 3 && !sawmill->AreThereAnyOrderedWares())
+        {
+            aii.DestroyBuilding(sawmill);
+            RemoveUnusedRoad(*sawmill->GetFlag(), Direction::NorthWest, true);
+            burns++;
+        }
     }
 }
 
@@ -582,81 +648,25 @@ AINodeResource AIPlayerJH::CalcResource(MapPoint pt)
 
 void AIPlayerJH::InitReachableNodes()
 {
-    std::queue<MapPoint> toCheck;
-
-    // Alle auf not reachable setzen
-    RTTR_FOREACH_PT(MapPoint, aiMap.GetSize())
-    {
-        Node& node = aiMap[pt];
-        node.reachable = false;
-        node.failed_penalty = 0;
-        const auto* myFlag = gwb.GetSpecObj<noFlag>(pt);
-        if(myFlag && myFlag->GetPlayer() == playerId)
-        {
-            node.reachable = true;
-            toCheck.push(pt);
-        }
-    }
-
-    IterativeReachableNodeChecker(toCheck);
+    reachability.init();
 }
 
-void AIPlayerJH::IterativeReachableNodeChecker(std::queue<MapPoint> toCheck)
+void AIPlayerJH::UpdateReachableNodes(const std::vector<MapPoint>& pts)
 {
-    // TODO auch mal bootswege bauen können
-
-    PathConditionRoad<GameWorldBase> roadPathChecker(gwb, false);
-    while(!toCheck.empty())
-    {
-        // Reachable coordinate
-        MapPoint curPt = toCheck.front();
-
-        // Coordinates to test around this reachable coordinate
-        for(const MapPoint curNeighbour : aiMap.GetNeighbours(curPt))
-        {
-            Node& node = aiMap[curNeighbour];
-
-            // already reached, don't test again
-            if(node.reachable)
-                continue;
-
-            // Test whether point is reachable; yes->add to check list
-            if(roadPathChecker.IsNodeOk(curNeighbour))
-            {
-                if(node.failed_penalty == 0)
-                {
-                    node.reachable = true;
-                    toCheck.push(curNeighbour);
-                } else
-                {
-                    node.failed_penalty--;
-                }
-            }
-        }
-        toCheck.pop();
-    }
+    reachability.addChangedPoints(pts);
 }
 
-void AIPlayerJH::UpdateReachableNodes(const std::vector<MapPoint>& pts)
+void AIPlayerJH::ApplyReachabilityChanges()
 {
-    std::queue<MapPoint> toCheck;
-
-    for(const MapPoint& curPt : pts)
-    {
-        const auto* flag = gwb.GetSpecObj<noFlag>(curPt);
-        if(flag && flag->GetPlayer() == playerId)
-        {
-            aiMap[curPt].reachable = true;
-            toCheck.push(curPt);
-        } else
-            aiMap[curPt].reachable = false;
-    }
-    IterativeReachableNodeChecker(toCheck);
+    if(reachability.hasChanges())
+        reachability.update();
 }
 
 void AIPlayerJH::InitNodes()
 {
     aiMap.Resize(gwb.GetSize());
+    buildingPlaces.Resize(gwb.GetSize());
+    buildingPlacesOrBuildings.Resize(gwb.GetSize());
 
     InitReachableNodes();
 
@@ -669,9 +679,17 @@ void AIPlayerJH::InitNodes()
         node.owned = aii.IsOwnTerritory(pt);
         node.border = aii.IsBorder(pt);
         node.farmed = false;
+        UpdateBuildingPlace(pt);
     }
 }
 
+void AIPlayerJH::UpdateBuildingPlace(const MapPoint pt)
+{
+    const bool isPlace = isBuildingPlace(aii.GetBuildingQualityAnyOwner(pt));
+    buildingPlaces.set(pt, isPlace ? 1 : 0);
+    buildingPlacesOrBuildings.set(pt, (isPlace || isBuildingLike(gwb.GetNO(pt)->GetType())) ? 1 : 0);
+}
+
 void AIPlayerJH::UpdateNodesAround(const MapPoint pt, unsigned radius)
 {
     std::vector<MapPoint> pts = gwb.GetPointsInRadius(pt, radius);
@@ -688,22 +706,26 @@ void AIPlayerJH::UpdateNodesAround(const MapPoint pt, unsigned radius)
 
 void AIPlayerJH::InitResourceMaps()
 {
+    // Each map only reads the world and writes its own data, so initialize them concurrently
+    std::vector<std::future<void>> initResults;
     for(auto& resMap : resourceMaps)
-        resMap.init();
+        initResults.push_back(std::async(std::launch::async, [&resMap]() { resMap.init(); }));
+    // Wait for all and pass on exceptions
+    for(auto& initResult : initResults)
+        initResult.get();
 }
 
 void AIPlayerJH::SetFarmedNodes(const MapPoint pt, bool set, unsigned radius)
 {
     // Radius in dem Bauplatz für Felder blockiert wird
     aiMap[pt].farmed = set;
-    std::vector<MapPoint> pts = gwb.GetPointsInRadius(pt, radius);
-    for(const MapPoint& curPt : pts)
-        aiMap[curPt].farmed = set;
+    gwb.VisitPointsInRadius(pt, radius, [this, set](const MapPoint curPt, unsigned) { aiMap[curPt].farmed = set; });
 }
 
 MapPoint AIPlayerJH::FindBestPosition(const MapPoint& pt, AIResource res, BuildingQuality size, unsigned radius,
                                       int minimum)
 {
+    ApplyReachabilityChanges();
     resourceMaps[res].updateAround(pt, radius);
 
     if(res != AIResource::Fish)
@@ -728,6 +750,7 @@ MapPoint AIPlayerJH::FindBestPosition(const MapPoint& pt, AIResource res, Buildi
 MapPoint AIPlayerJH::FindBestPositionRanged(const MapPoint& pt, AIResource res, BuildingQuality size, unsigned radius,
     int minimum, int maximum)
 {
+    ApplyReachabilityChanges();
     resourceMaps[res].updateAround(pt, radius);
 
     if(res != AIResource::Fish)
@@ -748,57 +771,27 @@ MapPoint AIPlayerJH::FindBestPositionRanged(const MapPoint& pt, AIResource res,
     return waterpt;
 }
 
-void AIPlayerJH::ExecuteAIJob()
+unsigned AIPlayerJH::GetJobQuota() const
 {
-    // Check whether current job is finished...
-    /*if (currentJob)
-    {
-        if (currentJob->GetStatus() == JobState::Finished)
-        {
-            delete currentJob;
-            currentJob = 0;
-        }
-    }
-
-    // ... or it failed
-    if (currentJob)
-    {
-        if (currentJob->GetStatus() == JobState::Failed)
-        {
-            // TODO fehlerbehandlung?
-            //std::cout << "Job failed." << std::endl;
-            delete currentJob;
-            currentJob = 0;
-        }
-    }*/
-    unsigned quota = 10; // limit the amount of events to handle
-    while(eventManager.EventAvailable()
-          && quota) // handle all new events - some will add new orders but they can all be handled instantly
-    {
-        quota--;
-        currentJob = std::make_unique<EventJob>(*this, eventManager.GetEvent());
-        currentJob->ExecuteJob();
-    }
     // how many construction & connect jobs the ai will attempt every gf, the ai gets new orders from events and every
     // 200 gf
-    quota = (aii.GetStorehouses().size() + aii.GetMilitaryBuildings().size()) * 1;
-    if(quota > 40)
-        quota = 40;
+    return std::min<unsigned>(aii.GetStorehouses().size() + aii.GetMilitaryBuildings().size(), 40);
+}
 
-    construction->ExecuteJobs(quota); // try to execute up to quota connect & construction jobs
-    /*
-    // if no current job available, take next one! events first, then constructions
-    if (!currentJob)
+bool AIPlayerJH::ExecuteAIJob(unsigned& eventQuota, unsigned& jobQuota)
+{
+    // handle new events up to the quota - some will add new orders but they can all be handled instantly
+    while(eventManager.EventAvailable() && eventQuota)
     {
-        if (construction->BuildJobAvailable())
-        {
-            currentJob = construction->GetBuildJob();
-        }
-    }
-    // Something to do? Do it!
-    if (currentJob)
+        eventQuota--;
+        currentJob = std::make_unique<EventJob>(*this, eventManager.GetEvent());
         currentJob->ExecuteJob();
-        */
+        if(scheduler.isBudgetUsedUp())
+            return false;
+    }
+    // All changes by the events are applied at once before the jobs look for positions
+    ApplyReachabilityChanges();
+    return construction->ExecuteJobs(jobQuota); // try to execute up to quota connect & construction jobs
 }
 
 void AIPlayerJH::DistributeGoodsByBlocking(const GoodType good, unsigned limit)
@@ -1001,6 +994,7 @@ MapPoint AIPlayerJH::SimpleFindPosition(const MapPoint& pt, BuildingQuality size
 
 MapPoint AIPlayerJH::FindPositionForBuildingAround(BuildingType type, const MapPoint& around)
 {
+    ApplyReachabilityChanges();
     constexpr unsigned searchRadius = 11;
     MapPoint foundPos = MapPoint::Invalid();
     switch(type)
@@ -1381,8 +1375,6 @@ void AIPlayerJH::HandleTreeChopped(const MapPoint pt)
 {
     // std::cout << "Tree chopped." << std::endl;
 
-    aiMap[pt].reachable = true;
-
     UpdateNodesAround(pt, 3);
 
     int random = rand();
@@ -1697,9 +1689,10 @@ void AIPlayerJH::TryToAttack()
         }
     }
 
-    // shuffle everything but headquarters and harbors without any troops in them
+    // shuffle everything but headquarters and harbors without any troops in them. Seeded by rand() so games
+    // with a fixed seed are reproducible
     std::shuffle(potentialTargets.begin() + hq_or_harbor_without_soldiers, potentialTargets.end(),
-                 std::mt19937(std::random_device()()));
+                 std::mt19937(rand()));
 
     // check for each potential attacking target the number of available attacking soldiers
     for(const nobBaseMilitary* target : potentialTargets)
@@ -1812,7 +1805,7 @@ void AIPlayerJH::TrySeaAttack()
             // \n",gwb.GetHarborPoint(i).x,gwb.GetHarborPoint(i).y);
         }
     }
-    auto prng = std::mt19937(std::random_device()());
+    auto prng = std::mt19937(rand());
     // any undefendedTargets? -> pick one by random
     if(!undefendedTargets.empty())
     {
@@ -1948,6 +1941,15 @@ const AIResourceMap& AIPlayerJH::GetResMap(AIResource res) const
     return resourceMaps[res];
 }
 
+size_t AIPlayerJH::GetMemoryUsage() const
+{
+    size_t result = prodOfComponents(aiMap.GetSize()) * sizeof(Node) + reachability.getMemoryUsage()
+                    + buildingPlaces.getMemoryUsage() + buildingPlacesOrBuildings.getMemoryUsage();
+    for(const AIResourceMap& resMap : resourceMaps)
+        result += resMap.getMemoryUsage();
+    return result;
+}
+
 void AIPlayerJH::SendAIEvent(std::unique_ptr<AIEvent::Base> ev)
 {
     eventManager.AddAIEvent(std::move(ev));
@@ -2467,53 +2469,18 @@ void AIPlayerJH::ExecuteLuaConstructionOrder(const MapPoint pt, BuildingType bt,
 }
 
 /// returns the percentage*100 of possible normal+ building places
-unsigned AIPlayerJH::BQsurroundcheck(const MapPoint pt, unsigned range, bool includeexisting, unsigned limit)
+unsigned AIPlayerJH::BQsurroundcheck(const MapPoint pt, unsigned range, bool includeexisting)
 {
     unsigned maxvalue = 6 * (2 << (range - 1)) - 5; // 1,7,19,43,91,... = 6*2^range -5
     unsigned count = 0;
     RTTR_Assert(aii.GetBuildingQuality(pt) == GetAINode(pt).bq);
-    if((aii.GetBuildingQuality(pt) >= BuildingQuality::Hut && aii.GetBuildingQuality(pt) <= BuildingQuality::Castle)
-       || aii.GetBuildingQuality(pt) == BuildingQuality::Harbor)
-    {
+    if(isBuildingPlace(aii.GetBuildingQuality(pt)))
         count++;
-    }
-    NodalObjectType nob = gwb.GetNO(pt)->GetType();
-    if(includeexisting)
-    {
-        if(nob == NodalObjectType::Building || nob == NodalObjectType::Buildingsite || nob == NodalObjectType::Extension
-           || nob == NodalObjectType::Fire || nob == NodalObjectType::CharburnerPile)
-            count++;
-    }
-    // first count all the possible building places
-    for(MapCoord tx = gwb.GetXA(pt, Direction::West), r = 1; r <= range;
-        tx = gwb.GetXA(MapPoint(tx, pt.y), Direction::West), ++r)
-    {
-        MapPoint t2(tx, pt.y);
-        for(unsigned i = 2; i < 8; ++i)
-        {
-            for(MapCoord r2 = 0; r2 < r; t2 = gwb.GetNeighbour(t2, convertToDirection(i)), ++r2)
-            {
-                if(limit && ((count * 100) / maxvalue) > limit)
-                    return ((count * 100) / maxvalue);
-                // point can be used for a building
-                if((aii.GetBuildingQualityAnyOwner(t2) >= BuildingQuality::Hut
-                    && aii.GetBuildingQualityAnyOwner(t2) <= BuildingQuality::Castle)
-                   || aii.GetBuildingQualityAnyOwner(t2) == BuildingQuality::Harbor)
-                {
-                    count++;
-                    continue;
-                }
-                if(includeexisting)
-                {
-                    nob = gwb.GetNO(t2)->GetType();
-                    if(nob == NodalObjectType::Building || nob == NodalObjectType::Buildingsite
-                       || nob == NodalObjectType::Extension || nob == NodalObjectType::Fire
-                       || nob == NodalObjectType::CharburnerPile)
-                        count++;
-                }
-            }
-        }
-    }
+    if(includeexisting && isBuildingLike(gwb.GetNO(pt)->GetType()))
+        count++;
+    // then all the possible building places around it
+    const RadiusSumMap& places = includeexisting ? buildingPlacesOrBuildings : buildingPlaces;
+    count += static_cast<unsigned>(places.getSum(pt, range) - places[pt]);
     // LOG.write(("bqcheck at %i,%i r%u result: %u,%u \n",pt,range,count,maxvalue);
     return ((count * 100) / maxvalue);
 }
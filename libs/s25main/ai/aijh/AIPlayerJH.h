@@ -7,13 +7,15 @@
 #include "ai/AIEventManager.h"
 #include "ai/AIPlayer.h"
 #include "ai/aijh/AIMap.h"
+#include "ai/aijh/AIReachability.h"
 #include "ai/aijh/AIResourceMap.h"
+#include "ai/aijh/AIScheduler.h"
 #include "helpers/OptionalEnum.h"
+#include "world/RadiusSumMap.h"
 #include "gameTypes/MapCoordinates.h"
 #include <boost/container/static_vector.hpp>
 #include <list>
 #include <memory>
-#include <queue>
 
 class noFlag;
 class noShip;
@@ -49,6 +51,9 @@ public:
     unsigned GetEventNum() const;
     unsigned GetBuildJobNum() const;
     unsigned GetConnectJobNum() const;
+    /// Scheduler running the jobs and periodic tasks within the time budget per GF
+    AIScheduler& GetScheduler() { return scheduler; }
+    const AIScheduler& GetScheduler() const { return scheduler; }
 
     void RunGF(unsigned gf, bool gfisnwf) override;
     void OnChatMessage(unsigned sendPlayerId, ChatDestination, const std::string& msg) override;
@@ -61,6 +66,8 @@ public:
     unsigned CalcMilSettings();
     /// military & tool production settings
     void AdjustSettings();
+    /// Destroys unproductive sawmills if there are more than 3
+    void DestroyUselessSawmills();
     /// return number of seaIds with at least 2 harbor spots
     unsigned GetNumAIRelevantSeaIds() const;
 
@@ -68,6 +75,8 @@ public:
 
     int GetResMapValue(MapPoint pt, AIResource res) const;
     const AIResourceMap& GetResMap(AIResource res) const;
+    /// Return the number of bytes used for the information about the map nodes (AI nodes, resource maps, ...)
+    size_t GetMemoryUsage() const;
 
     Node& GetAINode(const MapPoint pt) { return aiMap[pt]; }
     const Node& GetAINode(const MapPoint pt) const { return aiMap[pt]; }
@@ -77,7 +86,8 @@ public:
         return std::max<unsigned>(6u, aii.GetMilitaryBuildings().size() / 5u);
     }
     /// returns the percentage*100 of possible normal building places
-    unsigned BQsurroundcheck(MapPoint pt, unsigned range, bool includeexisting, unsigned limit = 0);
+    /// (and existing buildings if includeexisting is set) in the range around pt
+    unsigned BQsurroundcheck(MapPoint pt, unsigned range, bool includeexisting);
     /// returns list entry of the building the ai uses for troop upgrades
     int UpdateUpgradeBuilding();
     /// returns amount of good/people stored in warehouses right now
@@ -88,8 +98,11 @@ public:
 
     void SendAIEvent(std::unique_ptr<AIEvent::Base> ev);
 
-    /// Executes a job form the job queue
-    void ExecuteAIJob();
+    /// Number of connect & construction jobs to execute per GF
+    unsigned GetJobQuota() const;
+    /// Executes events and jobs from the job queues up to the given quotas which are reduced accordingly.
+    /// Returns false if it stopped because the time budget is used up
+    bool ExecuteAIJob(unsigned& eventQuota, unsigned& jobQuota);
     /// Tries to build a bld of the given type at that point.
     /// If front is true, then the job is enqueued at the front, else the back
     /// If searchPosition is true, then the point is searched for a good position (around that pt) otherwise the point
@@ -115,11 +128,13 @@ public:
     void SetGatheringForUpgradeWarehouse(nobBaseWarehouse* upgradewarehouse);
     /// Initializes the nodes on start of the game
     void InitNodes();
+    /// Update the building place maps at the given point after its BQ or object changed
+    void UpdateBuildingPlace(MapPoint pt);
     /// Updates the nodes around a position
     void UpdateNodesAround(MapPoint pt, unsigned radius);
     /// Returns the resource on a specific point
     AINodeResource CalcResource(MapPoint pt);
-    /// Initialize the resource maps
+    /// Initialize the resource maps, each in its own thread
     void InitResourceMaps();
     /// Initialize the Store and Military building lists (only required when loading games but the AI doesnt know
     /// whether its a load game or new game so this runs when the ai starts in both cases)
@@ -190,8 +205,11 @@ public:
     void SaveResourceMapsToFile();
 
     void InitReachableNodes();
-    void IterativeReachableNodeChecker(std::queue<MapPoint> toCheck);
+    /// Remember that the reachability at the given points might have changed. Applied by ApplyReachabilityChanges
     void UpdateReachableNodes(const std::vector<MapPoint>& pts);
+    /// Update the reachable nodes for all changes since the last call in one pass
+    void ApplyReachabilityChanges();
+    const AIReachability& GetReachability() const { return reachability; }
 
     /// disconnects 'inland' military buildings from road system(and sends out soldiers), sets stop gold, uses the
     /// upgrade building (order new private, kick out general)
@@ -232,8 +250,15 @@ private:
     std::list<MapPoint> milBuildingSites;
     /// Nodes containing some information about every map node
     AIMap aiMap;
+    /// Keeps the reachable flag of the nodes up to date
+    AIReachability reachability;
     /// Resource maps, containing a rating for every map point concerning a resource
     helpers::EnumArray<AIResourceMap, AIResource> resourceMaps;
+    /// 1 for every node on which a building can be placed (by any player), used to count them in a radius
+    RadiusSumMap buildingPlaces;
+    /// Like buildingPlaces but also 1 for nodes with an existing building, building site, ...
+    /// Kept up to date via the BQ and ObjRemoved notes
+    RadiusSumMap buildingPlacesOrBuildings;
 
     unsigned attack_interval;
     unsigned build_interval;
@@ -243,6 +268,7 @@ private:
     AIEventManager eventManager;
     std::unique_ptr<BuildingPlanner> bldPlanner;
     std::unique_ptr<AIConstruction> construction;
+    AIScheduler scheduler;
 
     Subscription subBuilding, subExpedition, subResource, subRoad, subShip, subBQ;
     std::vector<MapPoint> nodesWithOutdatedBQ;
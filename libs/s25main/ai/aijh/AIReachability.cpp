@@ -0,0 +1,203 @@
+// Copyright (C) 2005 - 2021 Settlers Freaks (sf-team at siedler25.org)
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "AIReachability.h"
+#include "RttrForeachPt.h"
+#include "helpers/containerUtils.h"
+#include "pathfinding/PathConditionRoad.h"
+#include "world/GameWorldBase.h"
+#include "nodeObjs/noFlag.h"
+#include <algorithm>
+#include <limits>
+
+namespace AIJH {
+
+AIReachability::AIReachability(const GameWorldBase& gwb, unsigned char playerId, AIMap& aiMap)
+    : gwb(gwb), playerId(playerId), aiMap(aiMap)
+{}
+
+void AIReachability::init()
+{
+    const unsigned numNodes = prodOfComponents(aiMap.GetSize());
+    isSource_.assign(numNodes, false);
+    visitedBy_.assign(numNodes, 0);
+    curSearchId_ = 0;
+    changedPts_.clear();
+    numNodesTouched_ = numNodes;
+
+    std::vector<MapPoint> toCheck;
+    RTTR_FOREACH_PT(MapPoint, aiMap.GetSize())
+    {
+        Node& node = aiMap[pt];
+        node.failed_penalty = 0;
+        node.reachable = hasOwnFlag(pt);
+        if(node.reachable)
+        {
+            isSource_[aiMap.GetIdx(pt)] = true;
+            toCheck.push_back(pt);
+        }
+    }
+    floodReachable(toCheck);
+}
+
+void AIReachability::addChangedPoints(const std::vector<MapPoint>& pts)
+{
+    changedPts_.insert(changedPts_.end(), pts.begin(), pts.end());
+}
+
+void AIReachability::addChangedPoint(const MapPoint pt)
+{
+    changedPts_.push_back(pt);
+}
+
+void AIReachability::update()
+{
+    numNodesTouched_ = 0;
+    if(changedPts_.empty())
+        return;
+    helpers::makeUnique(changedPts_, MapPointLess());
+    numNodesTouched_ = changedPts_.size();
+
+    // Every changed point starts at most 7 searches. Start over before the ids overflow
+    if(curSearchId_ >= std::numeric_limits<unsigned>::max() - 7 * changedPts_.size())
+    {
+        std::fill(visitedBy_.begin(), visitedBy_.end(), 0);
+        curSearchId_ = 0;
+    }
+    firstSearchIdOfUpdate_ = curSearchId_ + 1;
+
+    // Reachable nodes which might have lost their connection to a flag
+    std::vector<MapPoint> toCheckConnection;
+    // Reachable nodes from which new nodes might be reachable
+    std::vector<MapPoint> toCheck;
+    for(const MapPoint pt : changedPts_)
+    {
+        Node& node = aiMap[pt];
+        const unsigned idx = aiMap.GetIdx(pt);
+        const bool wasSource = isSource_[idx];
+        isSource_[idx] = hasOwnFlag(pt);
+        if(isSource_[idx])
+        {
+            node.reachable = true;
+            toCheck.push_back(pt);
+        } else if(!isPassable(pt))
+        {
+            if(node.reachable)
+            {
+                node.reachable = false;
+                for(const MapPoint nb : aiMap.GetNeighbours(pt))
+                {
+                    if(aiMap[nb].reachable)
+                        toCheckConnection.push_back(nb);
+                }
+            }
+        } else if(node.reachable)
+        {
+            if(wasSource)
+                toCheckConnection.push_back(pt);
+            toCheck.push_back(pt);
+        } else
+        {
+            for(const MapPoint nb : aiMap.GetNeighbours(pt))
+            {
+                if(aiMap[nb].reachable)
+                    toCheck.push_back(nb);
+            }
+        }
+    }
+
+    // Removals first so no node is made reachable from a node which is about to be disconnected
+    for(const MapPoint pt : toCheckConnection)
+        checkStillReachable(pt);
+
+    helpers::erase_if(toCheck, [this](const MapPoint pt) { return !aiMap[pt].reachable; });
+    floodReachable(toCheck);
+    changedPts_.clear();
+}
+
+bool AIReachability::hasOwnFlag(const MapPoint pt) const
+{
+    const auto* flag = gwb.GetSpecObj<noFlag>(pt);
+    return flag && flag->GetPlayer() == playerId;
+}
+
+bool AIReachability::isPassable(const MapPoint pt) const
+{
+    return PathConditionRoad<GameWorldBase>(gwb, false).IsNodeOk(pt);
+}
+
+void AIReachability::checkStillReachable(const MapPoint start)
+{
+    // Nodes visited in this update are either unreachable now or known to be connected to a flag
+    if(!aiMap[start].reachable || visitedBy_[aiMap.GetIdx(start)] >= firstSearchIdOfUpdate_)
+        return;
+
+    const unsigned searchId = ++curSearchId_;
+    std::vector<MapPoint>& visited = searchBuffer_;
+    visited.clear();
+    visited.push_back(start);
+    visitedBy_[aiMap.GetIdx(start)] = searchId;
+    // Stop as soon as a flag or a node known to be connected is found
+    for(unsigned i = 0; i < visited.size(); i++)
+    {
+        const MapPoint curPt = visited[i];
+        numNodesTouched_++;
+        if(isSource_[aiMap.GetIdx(curPt)])
+            return;
+        for(const MapPoint nb : aiMap.GetNeighbours(curPt))
+        {
+            if(!aiMap[nb].reachable)
+                continue;
+            unsigned& nbVisitedBy = visitedBy_[aiMap.GetIdx(nb)];
+            if(nbVisitedBy == searchId)
+                continue;
+            if(nbVisitedBy >= firstSearchIdOfUpdate_)
+                return;
+            nbVisitedBy = searchId;
+            visited.push_back(nb);
+        }
+    }
+    // No flag found -> The whole area is cut off
+    for(const MapPoint pt : visited)
+        aiMap[pt].reachable = false;
+}
+
+void AIReachability::floodReachable(std::vector<MapPoint>& toCheck)
+{
+    // TODO auch mal bootswege bauen können
+    for(unsigned i = 0; i < toCheck.size(); i++)
+    {
+        numNodesTouched_++;
+        for(const MapPoint curNeighbour : aiMap.GetNeighbours(toCheck[i]))
+        {
+            Node& node = aiMap[curNeighbour];
+
+            // already reached, don't test again
+            if(node.reachable)
+                continue;
+
+            // Test whether point is reachable; yes->add to check list
+            if(isPassable(curNeighbour))
+            {
+                if(node.failed_penalty == 0)
+                {
+                    node.reachable = true;
+                    toCheck.push_back(curNeighbour);
+                } else
+                {
+                    node.failed_penalty--;
+                }
+            }
+        }
+    }
+    toCheck.clear();
+}
+
+size_t AIReachability::getMemoryUsage() const
+{
+    return isSource_.size() / 8u + visitedBy_.size() * sizeof(unsigned)
+           + (changedPts_.capacity() + searchBuffer_.capacity()) * sizeof(MapPoint);
+}
+
+} // namespace AIJH
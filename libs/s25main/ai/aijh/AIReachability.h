@@ -0,0 +1,60 @@
+// Copyright (C) 2005 - 2021 Settlers Freaks (sf-team at siedler25.org)
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "ai/aijh/AIMap.h"
+#include "gameTypes/MapCoordinates.h"
+#include <cstddef>
+#include <vector>
+
+class GameWorldBase;
+
+namespace AIJH {
+
+/// Keeps AIMap::reachable up to date: A node is reachable if it can be connected by road to a flag of the player.
+/// Changes are collected and applied in a single pass which only visits the nodes around the changed ones
+class AIReachability
+{
+public:
+    AIReachability(const GameWorldBase& gwb, unsigned char playerId, AIMap& aiMap);
+
+    /// Calculate the reachability of all nodes from scratch. Resets the failed penalties and pending changes
+    void init();
+    /// Remember that the passability or flags at the given points (may) have changed
+    void addChangedPoints(const std::vector<MapPoint>& pts);
+    void addChangedPoint(MapPoint pt);
+    bool hasChanges() const { return !changedPts_.empty(); }
+    /// Apply all remembered changes
+    void update();
+
+    /// Number of nodes looked at by the last call to init or update
+    unsigned getNumNodesTouched() const { return numNodesTouched_; }
+    /// Return the number of bytes used for the per-node state
+    size_t getMemoryUsage() const;
+
+private:
+    bool hasOwnFlag(MapPoint pt) const;
+    bool isPassable(MapPoint pt) const;
+    /// Check if the reachable nodes connected to the start can still reach a flag. Mark them unreachable if not
+    void checkStillReachable(MapPoint start);
+    /// Mark all nodes reachable from the reachable nodes in toCheck. Empties toCheck
+    void floodReachable(std::vector<MapPoint>& toCheck);
+
+    const GameWorldBase& gwb;
+    const unsigned char playerId;
+    AIMap& aiMap;
+    /// Node has a flag of the player (as of the last update)
+    std::vector<bool> isSource_;
+    std::vector<MapPoint> changedPts_;
+    /// Id of the search a node was last visited by
+    std::vector<unsigned> visitedBy_;
+    std::vector<MapPoint> searchBuffer_;
+    unsigned curSearchId_ = 0;
+    /// First search id of the current update. Visits by older searches are ignored
+    unsigned firstSearchIdOfUpdate_ = 0;
+    unsigned numNodesTouched_ = 0;
+};
+
+} // namespace AIJH
@@ -8,7 +8,12 @@
 #include "ai/aijh/AIMap.h"
 #include "buildings/noBuildingSite.h"
 #include "buildings/nobUsual.h"
+#include "helpers/EnumRange.h"
+#include "helpers/containerUtils.h"
 #include "gameData/TerrainDesc.h"
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
 
 namespace AIJH {
 
@@ -29,6 +34,24 @@ static constexpr bool isDiminishable(AIResource res)
     return false;
 }
 
+/// Number of points in the radius, which is the number of ratings summed up for a value in the map
+static constexpr int numPointsInRadius(unsigned radius)
+{
+    return static_cast<int>(3 * radius * (radius + 1) + 1);
+}
+
+static constexpr bool valuesFitIntoMaps()
+{
+    for(const auto res : helpers::EnumRange<AIResource>{})
+    {
+        if(RES_RADIUS[res] > RadiusSumMap::maxRadius || getMaxResourceRating(res) > std::numeric_limits<int8_t>::max()
+           || numPointsInRadius(RES_RADIUS[res]) * getMaxResourceRating(res) > std::numeric_limits<int16_t>::max())
+            return false;
+    }
+    return true;
+}
+static_assert(valuesFitIntoMaps(), "Resource ratings and values must fit into the maps");
+
 AIResourceMap::AIResourceMap(const AIResource res, bool isInfinite, const AIInterface& aii, const AIMap& aiMap)
     : res(res), isInfinite(isInfinite), isDiminishableResource(isDiminishable(res)), resRadius(RES_RADIUS[res]),
       aii(aii), aiMap(aiMap)
@@ -41,11 +64,20 @@ void AIResourceMap::init()
     const MapExtent mapSize = aiMap.GetSize();
 
     map.Resize(mapSize);
+    ratings.Resize(mapSize);
+    numTilesX = (mapSize.x + tileSize - 1) / tileSize;
+    tileMaxValues.clear();
+    tileMaxValues.resize(numTilesX * ((mapSize.y + tileSize - 1) / tileSize), 0);
+    isTileMaxOutdated.clear();
+    isTileMaxOutdated.resize(tileMaxValues.size(), false);
     // Calculate value for each point.
     // This is quite expensive so do just for the diminishable resources to sort out ones where there will never be
     // anything, which allows an optimization when calculating the value which must always be done on demand
     if(isDiminishableResource)
     {
+        // Every rating is part of the values of all points in its radius, so get each only once and sum them up
+        RTTR_FOREACH_PT(MapPoint, mapSize)
+            setRating(pt);
         RTTR_FOREACH_PT(MapPoint, mapSize)
         {
             bool isValid = true;
@@ -60,7 +92,7 @@ void AIResourceMap::init()
             {
                 isValid = aii.gwb.IsOfTerrain(pt, [](const TerrainDesc& desc) { return desc.Is(ETerrain::Mineable); });
             }
-            map[pt] = isValid ? aii.CalcResourceValue(pt, res) : 0;
+            setValue(pt, isValid ? ratings.getSum(pt, resRadius) : 0);
         }
     }
 }
@@ -73,47 +105,182 @@ void AIResourceMap::updateAround(const MapPoint& pt, int radius)
         updateAroundReplinishable(pt, radius);
 }
 
+namespace {
+/// floor(y / 2) for negative values too
+constexpr int floorHalf(int y)
+{
+    return (y - (y & 1)) / 2;
+}
+
+/// Return the index at which the point at the given offset in axial coordinates is visited by
+/// MapBase::VisitPointsInRadius: The center, then each ring starting at West and going NE, E, SE, SW, W, NW
+unsigned getVisitIndex(int dq, int dr)
+{
+    const int d = std::max({std::abs(dq), std::abs(dr), std::abs(dq + dr)});
+    if(d == 0)
+        return 0;
+    int ringIdx;
+    if(dr == -d && dq >= 0 && dq < d)
+        ringIdx = d + dq;
+    else if(dq == d && dr < 0)
+        ringIdx = 3 * d + dr;
+    else if(dq + dr == d && dr >= 0 && dr < d)
+        ringIdx = 3 * d + dr;
+    else if(dr == d && dq <= 0 && dq > -d)
+        ringIdx = 4 * d - dq;
+    else if(dq == -d && dr > 0)
+        ringIdx = 6 * d - dr;
+    else
+        ringIdx = -dr;
+    return 1u + 3u * d * (d - 1) + ringIdx;
+}
+
+/// Set result to the distinct tile coordinates of all coordinates within radius of the center
+void getTileCoords(int center, int radius, int mapSize, unsigned tileSize, std::vector<unsigned>& result)
+{
+    result.clear();
+    for(int i = center - radius; i <= center + radius; ++i)
+    {
+        const unsigned tileCoord = static_cast<unsigned>((i + mapSize) % mapSize) / tileSize;
+        if(!helpers::contains(result, tileCoord))
+            result.push_back(tileCoord);
+    }
+}
+} // namespace
+
+bool AIResourceMap::isRadiusWrapping(unsigned radius) const
+{
+    // Points are visited multiple times when the radius wraps around the map, so the visit order is hard to get
+    return 2 * radius + 1 > map.GetWidth() || 2 * radius + 1 > map.GetHeight();
+}
+
+void AIResourceMap::collectSearchTiles(const MapPoint& pt, unsigned radius, int minimum) const
+{
+    searchTiles.clear();
+    getTileCoords(pt.x, radius, map.GetWidth(), tileSize, searchTilesX);
+    getTileCoords(pt.y, radius, map.GetHeight(), tileSize, searchTilesY);
+    for(const unsigned tx : searchTilesX)
+    {
+        for(const unsigned ty : searchTilesY)
+        {
+            const unsigned tileIdx = ty * numTilesX + tx;
+            const int tileMax = getTileMax(tileIdx);
+            if(tileMax >= minimum)
+                searchTiles.emplace_back(tileMax, tileIdx);
+        }
+    }
+}
+
+void AIResourceMap::addCandidates(const MapPoint& pt, unsigned radius, unsigned tileIdx, int minimum,
+                                  int maximum) const
+{
+    const int width = map.GetWidth(), height = map.GetHeight();
+    const int n = static_cast<int>(radius);
+    const int q0 = pt.x - floorHalf(pt.y);
+    const MapCoord xStart = (tileIdx % numTilesX) * tileSize;
+    const MapCoord yStart = (tileIdx / numTilesX) * tileSize;
+    const MapCoord xEnd = std::min<int>(xStart + tileSize, width), yEnd = std::min<int>(yStart + tileSize, height);
+    for(MapPoint curPt(xStart, yStart); curPt.y < yEnd; ++curPt.y)
+    {
+        // Offset to the center in [-radius, radius] (if in range) which is unique as the radius doesn't wrap
+        int dy = (curPt.y - pt.y + height) % height;
+        if(dy > n)
+            dy -= height;
+        if(dy < -n)
+            continue;
+        for(curPt.x = xStart; curPt.x < xEnd; ++curPt.x)
+        {
+            const int value = map[curPt];
+            if(value < minimum || value > maximum)
+                continue;
+            int dx = (curPt.x - pt.x + width) % width;
+            if(dx > n)
+                dx -= width;
+            if(dx < -n)
+                continue;
+            const int dq = pt.x + dx - floorHalf(pt.y + dy) - q0;
+            if(std::abs(dq) > n || std::abs(dq + dy) > n)
+                continue;
+            candidates.push_back({value, getVisitIndex(dq, dy), curPt});
+        }
+    }
+}
+
 MapPoint AIResourceMap::findBestPosition(const MapPoint& pt, BuildingQuality size, unsigned radius, int minimum) const
 {
-    MapPoint best = MapPoint::Invalid();
-    int best_value = (minimum == std::numeric_limits<int>::min()) ? minimum : minimum - 1;
+    // Values must be greater than this
+    const int minValue = (minimum == std::numeric_limits<int>::min()) ? minimum : minimum - 1;
+    if(isRadiusWrapping(radius))
+        return findBestPositionByScan(pt, size, radius, minValue);
 
-    std::vector<MapPoint> pts = aii.gwb.GetPointsInRadiusWithCenter(pt, radius);
-    for(const MapPoint& curPt : pts)
+    // All tiles which may contain a better point, best one first
+    collectSearchTiles(pt, radius, minValue + 1);
+    std::sort(searchTiles.begin(), searchTiles.end(),
+              [](const auto& lhs, const auto& rhs) { return lhs.first > rhs.first; });
+
+    candidates.clear();
+    for(unsigned i = 0; i < searchTiles.size(); ++i)
     {
-        const unsigned idx = map.GetIdx(curPt);
-        if(map[idx] > best_value)
+        addCandidates(pt, radius, searchTiles[i].second, minValue + 1, std::numeric_limits<int>::max());
+        // Candidates better than the best value of the remaining tiles can be decided now:
+        // Check them from best to worst (first visited on equal values) and take the first valid one
+        const int remainingMax = (i + 1 < searchTiles.size()) ? searchTiles[i + 1].first : minValue;
+        std::sort(candidates.begin(), candidates.end(), [](const Candidate& lhs, const Candidate& rhs) {
+            return lhs.value < rhs.value || (lhs.value == rhs.value && lhs.visitIdx > rhs.visitIdx);
+        });
+        while(!candidates.empty() && candidates.back().value > remainingMax)
         {
-            if(res == AIResource::Fish) // fish ignore building site checks since it needs to find land to build on near by, this only returns water which cant be built on
-            {
-                // check fishery near by
-                if(aii.isBuildingNearby(BuildingType::Fishery, curPt, 10))
-                    continue;
-            } else
-            {
-                if(!aiMap[idx].reachable || !aiMap[idx].owned || aiMap[idx].farmed)
-                    continue;
-                RTTR_Assert(aii.GetBuildingQuality(curPt)
-                            == aiMap[curPt].bq); // Temporary, to check if aiMap is correctly update, see below
-                if(!canUseBq(aii.GetBuildingQuality(curPt), size)) // map[idx].bq; TODO: Update nodes BQ and use that
-                    continue;
-                if(res == AIResource::Borderland && aii.gwb.IsOnRoad(aii.gwb.GetNeighbour(curPt, Direction::SouthEast)))
-                    continue;
-                // dont build next to empty harborspots
-                if(aii.isHarborPosClose(curPt, 2, true))
-                    continue;
-            }
-            best = curPt;
-            best_value = map[idx];
-            // TODO: calculate "perfect" rating and instantly return if we got that already
+            if(isValidPosition(candidates.back().pt, size))
+                return candidates.back().pt;
+            candidates.pop_back();
         }
     }
+    return MapPoint::Invalid();
+}
+
+MapPoint AIResourceMap::findBestPositionByScan(const MapPoint& pt, BuildingQuality size, unsigned radius,
+                                               int minValue) const
+{
+    MapPoint best = MapPoint::Invalid();
+    int best_value = minValue;
+
+    aii.gwb.VisitPointsInRadius(
+      pt, radius,
+      [&](const MapPoint curPt, unsigned) {
+          const int value = map[curPt];
+          if(value > best_value && isValidPosition(curPt, size))
+          {
+              best = curPt;
+              best_value = value;
+          }
+      },
+      true);
 
     return best;
 }
 
+bool AIResourceMap::isValidPosition(const MapPoint& pt, BuildingQuality size) const
+{
+    if(res == AIResource::Fish) // fish ignore building site checks since it needs to find land to build on near by,
+                                // this only returns water which cant be built on
+    {
+        // check fishery near by
+        return !aii.isBuildingNearby(BuildingType::Fishery, pt, 10);
+    }
+    const Node& node = aiMap[pt];
+    if(!node.reachable || !node.owned || node.farmed)
+        return false;
+    RTTR_Assert(aii.GetBuildingQuality(pt) == node.bq); // Temporary, to check if aiMap is correctly update, see below
+    if(!canUseBq(aii.GetBuildingQuality(pt), size)) // map[idx].bq; TODO: Update nodes BQ and use that
+        return false;
+    if(res == AIResource::Borderland && aii.gwb.IsOnRoad(aii.gwb.GetNeighbour(pt, Direction::SouthEast)))
+        return false;
+    // dont build next to empty harborspots
+    return !aii.isHarborPosClose(pt, 2, true);
+}
+
 MapPoint AIResourceMap::findBestPositionRanged(const MapPoint& pt, BuildingQuality size, unsigned radius, int minimum,
-    int maximum) const
+                                               int maximum) const
 {
     MapPoint best = MapPoint::Invalid();
     int targetValue = 0;
@@ -133,50 +300,48 @@ MapPoint AIResourceMap::findBestPositionRanged(const MapPoint& pt, BuildingQuali
     }
 
     int diff = maximum;
-    std::vector<MapPoint> pts = aii.gwb.GetPointsInRadiusWithCenter(pt, radius);
-    for(const MapPoint& curPt : pts)
-    {
-        const unsigned idx = map.GetIdx(curPt);
-        if(map[idx] >= minimum && map[idx] <= maximum)
+    // Called for each point with a value in the range in the order of VisitPointsInRadius
+    const auto checkPoint = [&](const MapPoint curPt, const int value) {
+        if(res == AIResource::Fish) // fish ignore building site checks since it needs to find land to build on near
+                                    // by, this only returns water which cant be built on
+            return;
+        if(value == targetValue || abs(value - targetValue) < diff)
         {
-
-            if(res == AIResource::Fish) // fish ignore building site checks since it needs to find land to build on near
-                                        // by, this only returns water which cant be built on
-            {
-                // check fishery near by
-                if(aii.isBuildingNearby(BuildingType::Fishery, curPt, 10))
-                    continue;
-            } else
-            {
-                if(map[idx] == targetValue || abs(map[idx] - targetValue) < diff)
-                {
-                    // check position validity
-                    if(!aiMap[idx].reachable || !aiMap[idx].owned || aiMap[idx].farmed)
-                        continue;
-                    RTTR_Assert(aii.GetBuildingQuality(curPt)
-                                == aiMap[curPt].bq); // Temporary, to check if aiMap is correctly update, see below
-                    if(!canUseBq(aii.GetBuildingQuality(curPt), size)) // map[idx].bq; TODO: Update nodes BQ and use that
-                        continue;
-                    if(res == AIResource::Borderland && aii.gwb.IsOnRoad(aii.gwb.GetNeighbour(curPt, Direction::SouthEast)))
-                        continue;
-                    // dont build next to empty harborspots
-                    if(aii.isHarborPosClose(curPt, 2, true))
-                        continue;
-
-                    best = curPt;
-                    diff = abs(map[idx] - targetValue);
-                }
-            }
-            
+            if(!isValidPosition(curPt, size))
+                return;
+            best = curPt;
+            diff = abs(value - targetValue);
         }
+    };
+    if(isRadiusWrapping(radius))
+    {
+        aii.gwb.VisitPointsInRadius(
+          pt, radius,
+          [&](const MapPoint curPt, unsigned) {
+              const int value = map[curPt];
+              if(value >= minimum && value <= maximum)
+                  checkPoint(curPt, value);
+          },
+          true);
+        return best;
     }
 
+    // Only the points in the range matter, so skip the tiles where all values are too low
+    collectSearchTiles(pt, radius, minimum);
+    candidates.clear();
+    for(const auto& tile : searchTiles)
+        addCandidates(pt, radius, tile.second, minimum, maximum);
+    std::sort(candidates.begin(), candidates.end(),
+              [](const Candidate& lhs, const Candidate& rhs) { return lhs.visitIdx < rhs.visitIdx; });
+    for(const Candidate& candidate : candidates)
+        checkPoint(candidate.pt, candidate.value);
+
     return best;
 }
 
 void AIResourceMap::avoidPosition(const MapPoint& pt)
 {
-    map[pt] = -40;
+    setValue(pt, -40);
 }
 
 void AIResourceMap::updateAroundDiminishable(const MapPoint& pt, const int radius)
@@ -184,88 +349,74 @@ void AIResourceMap::updateAroundDiminishable(const MapPoint& pt, const int radiu
     if(isInfinite)
         return;
 
-    bool lastCircleValueCalculated = false;
-    bool lastValueCalculated = false;
-    // to avoid having to calculate a value twice and still move left on the same level without any problems we use this
-    // variable to remember the first calculation we did in the circle.
-    int circleStartValue = 0;
-
-    for(MapCoord tx = aii.gwb.GetXA(pt, Direction::West), r = 1; r <= radius;
-        tx = aii.gwb.GetXA(MapPoint(tx, pt.y), Direction::West), ++r)
-    {
-        MapPoint curPt(tx, pt.y);
-        for(const auto curDir : helpers::enumRange(Direction::NorthEast))
-        {
-            for(MapCoord step = 0; step < r; ++step, curPt = aiMap.GetNeighbour(curPt, curDir))
-            {
-                int& resMapVal = map[curPt];
-                // only do a complete calculation for the first point or when moving outward and the last value is
-                // unknown
-                if((r < 2 || !lastCircleValueCalculated) && step < 1 && curDir == Direction::NorthEast && resMapVal)
-                {
-                    resMapVal = aii.CalcResourceValue(curPt, res);
-                    circleStartValue = resMapVal;
-                    lastCircleValueCalculated = true;
-                    lastValueCalculated = true;
-                } else if(!resMapVal) // was there ever anything? if not skip it!
-                {
-                    if(step < 1 && curDir == Direction::NorthEast)
-                        lastCircleValueCalculated = false;
-                    lastValueCalculated = false;
-                } else if(step < 1 && curDir == Direction::NorthEast) // circle not yet started? -> last direction was
-                                                                      // outward (left=0)
-                {
-                    resMapVal = aii.CalcResourceValue(curPt, res, Direction::West, circleStartValue);
-                    circleStartValue = resMapVal;
-                } else if(lastValueCalculated)
-                {
-                    if(step > 0) // we moved direction i%6
-                        resMapVal = aii.CalcResourceValue(curPt, res, curDir, resMapVal);
-                    else // last step was the previous direction
-                        resMapVal = aii.CalcResourceValue(curPt, res, curDir - 1u, resMapVal);
-                } else
-                {
-                    resMapVal = aii.CalcResourceValue(curPt, res);
-                    lastValueCalculated = true;
-                }
-            }
-        }
-    }
+    refreshRatings(pt, radius + resRadius);
+    aiMap.VisitPointsInRadius(pt, radius, [this](const MapPoint curPt, unsigned) {
+        // was there ever anything? if not skip it!
+        if(map[curPt])
+            setValue(curPt, ratings.getSum(curPt, resRadius));
+    });
 }
 
 void AIResourceMap::updateAroundReplinishable(const MapPoint& pt, const int radius)
 {
-    // to avoid having to calculate a value twice and still move left on the same level without any problems we use this
-    // variable to remember the first calculation we did in the circle.
-    int circleStartValue = 0;
+    refreshRatings(pt, radius + resRadius);
+    aiMap.VisitPointsInRadius(
+      pt, radius, [this](const MapPoint curPt, unsigned) { setValue(curPt, ratings.getSum(curPt, resRadius)); });
+}
 
-    int resValue = 0;
-    for(MapCoord tx = aii.gwb.GetXA(pt, Direction::West), r = 1; r <= radius;
-        tx = aii.gwb.GetXA(MapPoint(tx, pt.y), Direction::West), ++r)
+void AIResourceMap::setValue(const MapPoint& pt, int value)
+{
+    RTTR_Assert(value >= std::numeric_limits<int16_t>::min() && value <= std::numeric_limits<int16_t>::max());
+    int16_t& curValue = map[pt];
+    const unsigned tileIdx = getTileIdx(pt);
+    if(value >= tileMaxValues[tileIdx])
+        tileMaxValues[tileIdx] = value;
+    else if(curValue == tileMaxValues[tileIdx])
+        isTileMaxOutdated[tileIdx] = true;
+    curValue = static_cast<int16_t>(value);
+}
+
+unsigned AIResourceMap::getTileIdx(const MapPoint& pt) const
+{
+    return (pt.y / tileSize) * numTilesX + pt.x / tileSize;
+}
+
+int AIResourceMap::getTileMax(unsigned tileIdx) const
+{
+    if(isTileMaxOutdated[tileIdx])
     {
-        MapPoint curPt(tx, pt.y);
-        for(const auto curDir : helpers::enumRange(Direction::NorthEast))
+        const MapCoord xStart = (tileIdx % numTilesX) * tileSize;
+        const MapCoord yStart = (tileIdx / numTilesX) * tileSize;
+        const MapCoord xEnd = std::min<unsigned>(xStart + tileSize, map.GetWidth());
+        const MapCoord yEnd = std::min<unsigned>(yStart + tileSize, map.GetHeight());
+        int maxValue = std::numeric_limits<int>::min();
+        for(MapPoint pt(xStart, yStart); pt.y < yEnd; ++pt.y)
         {
-            for(MapCoord step = 0; step < r; ++step, curPt = aii.gwb.GetNeighbour(curPt, curDir))
-            {
-                if(r == 1 && step == 0 && curDir == Direction::NorthEast)
-                {
-                    // only do a complete calculation for the first point!
-                    resValue = aii.CalcResourceValue(curPt, res);
-                    circleStartValue = resValue;
-                } else if(step == 0 && curDir == Direction::NorthEast)
-                {
-                    // circle not yet started? -> last direction was outward
-                    resValue = aii.CalcResourceValue(curPt, res, Direction::West, circleStartValue);
-                    circleStartValue = resValue;
-                } else if(step > 0) // we moved direction i%6
-                    resValue = aii.CalcResourceValue(curPt, res, curDir, resValue);
-                else // last step was the previous direction
-                    resValue = aii.CalcResourceValue(curPt, res, curDir - 1u, resValue);
-                map[curPt] = resValue;
-            }
+            for(pt.x = xStart; pt.x < xEnd; ++pt.x)
+                maxValue = std::max<int>(maxValue, map[pt]);
         }
+        tileMaxValues[tileIdx] = maxValue;
+        isTileMaxOutdated[tileIdx] = false;
     }
+    return tileMaxValues[tileIdx];
+}
+
+size_t AIResourceMap::getMemoryUsage() const
+{
+    return prodOfComponents(map.GetSize()) * sizeof(int16_t) + ratings.getMemoryUsage()
+           + tileMaxValues.size() * sizeof(int) + isTileMaxOutdated.size() / 8u;
+}
+
+void AIResourceMap::refreshRatings(const MapPoint& pt, unsigned radius)
+{
+    aiMap.VisitPointsInRadius(pt, radius, [this](const MapPoint curPt, unsigned) { setRating(curPt); }, true);
+}
+
+void AIResourceMap::setRating(const MapPoint& pt)
+{
+    const int rating = aii.GetResourceRating(pt, res);
+    RTTR_Assert(std::abs(rating) <= getMaxResourceRating(res));
+    ratings.set(pt, rating);
 }
 
 } // namespace AIJH
@@ -7,8 +7,13 @@
 #include "AIMap.h"
 #include "ai/AIResource.h"
 #include "world/NodeMapBase.h"
+#include "world/RadiusSumMap.h"
 #include "gameTypes/BuildingQuality.h"
 #include "gameTypes/BuildingType.h"
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
 
 class AIInterface;
 namespace AIJH {
@@ -26,11 +31,13 @@ public:
 
     /// Finds the best position for a specific resource in an area using the resource maps,
     /// satisfying the minimum value, returns false if no such position is found
+    /// On equal values the point visited first by MapBase::VisitPointsInRadius is returned
     MapPoint findBestPosition(const MapPoint& pt, BuildingQuality size, unsigned radius, int minimum) const;
 
     /// Finds the best position for a specific resource in an area using the resource maps,
     /// value returned should be within range specified
-    MapPoint findBestPositionRanged(const MapPoint& pt, BuildingQuality size, unsigned radius, int minimum,int maximum) const;
+    MapPoint findBestPositionRanged(const MapPoint& pt, BuildingQuality size, unsigned radius, int minimum,
+                                    int maximum) const;
 
     /// Marks a position to be avoided.
     /// Only has an effect on diminishable resources where this blocks this point forever
@@ -38,11 +45,36 @@ public:
 
     int operator[](const MapPoint& pt) const { return map[pt]; }
 
+    /// Return whether findBestPosition may return the point for a building of the given size
+    bool isValidPosition(const MapPoint& pt, BuildingQuality size) const;
+
+    /// Return the number of bytes used by the map
+    size_t getMemoryUsage() const;
+
 private:
+    /// Nodes per row and column of the tiles for which the maximum value is stored
+    static constexpr unsigned tileSize = 8;
+
+    void setValue(const MapPoint& pt, int value);
+    unsigned getTileIdx(const MapPoint& pt) const;
+    /// Return the maximum value of the tile. Recalculates it if a value was lowered
+    int getTileMax(unsigned tileIdx) const;
+    /// True if the radius around a point covers some points multiple times
+    bool isRadiusWrapping(unsigned radius) const;
+    /// Set searchTiles to the tiles within the (not wrapping) radius which may contain values of at least minimum
+    void collectSearchTiles(const MapPoint& pt, unsigned radius, int minimum) const;
+    /// Add the points of the tile within the (not wrapping) radius with a value in [minimum, maximum] to candidates
+    void addCandidates(const MapPoint& pt, unsigned radius, unsigned tileIdx, int minimum, int maximum) const;
+    /// Find the best position by checking every point in the radius in the order of VisitPointsInRadius
+    MapPoint findBestPositionByScan(const MapPoint& pt, BuildingQuality size, unsigned radius, int minValue) const;
     /// Update algorithm for resources which cannot be regrown
     void updateAroundDiminishable(const MapPoint& pt, int radius);
     /// Update algorithm for resources which can be replenished
     void updateAroundReplinishable(const MapPoint& pt, int radius);
+    /// Get the current rating of all points in the radius
+    void refreshRatings(const MapPoint& pt, unsigned radius);
+    /// Store the current rating of the point
+    void setRating(const MapPoint& pt);
 
     /// Which resource is stored in the map and radius of affected nodes
     const AIResource res;
@@ -50,7 +82,27 @@ private:
     const bool isDiminishableResource;
     const unsigned resRadius;
 
-    NodeMapBase<int> map;
+    /// Sum of the ratings in the resource radius. The ratings and the radius are small enough to use 16 bit
+    NodeMapBase<int16_t> map;
+    /// Rating of each point (see AIInterface::GetResourceRating and getMaxResourceRating) from which the values in map
+    /// are summed up
+    RadiusSumMap ratings;
+    /// Upper bound of the values per tile to skip tiles which can't contain a better position.
+    /// Exact unless marked outdated after lowering a value
+    mutable std::vector<int> tileMaxValues;
+    mutable std::vector<bool> isTileMaxOutdated;
+    unsigned numTilesX = 0;
+    struct Candidate
+    {
+        int value;
+        /// Index at which MapBase::VisitPointsInRadius visits the point
+        unsigned visitIdx;
+        MapPoint pt;
+    };
+    /// Buffers for the searches, kept to avoid allocations for each search
+    mutable std::vector<std::pair<int, unsigned>> searchTiles;
+    mutable std::vector<unsigned> searchTilesX, searchTilesY;
+    mutable std::vector<Candidate> candidates;
     const AIInterface& aii;
     const AIMap& aiMap;
 };
@@ -0,0 +1,56 @@
+// Copyright (C) 2005 - 2021 Settlers Freaks (sf-team at siedler25.org)
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "AIScheduler.h"
+#include <algorithm>
+
+namespace AIJH {
+
+bool AIScheduler::add(unsigned id, Task task)
+{
+    if(isQueued(id))
+        return false;
+    tasks_.push_back(Entry{id, std::move(task)});
+    return true;
+}
+
+bool AIScheduler::isQueued(unsigned id) const
+{
+    return std::any_of(tasks_.begin(), tasks_.end(), [id](const Entry& entry) { return entry.id == id; });
+}
+
+void AIScheduler::run()
+{
+    const Clock::time_point startTime = Clock::now();
+    deadline_ = (budget_.count() == 0) ? Clock::time_point::max() : startTime + budget_;
+
+    while(!tasks_.empty())
+    {
+        // The task stays in the queue while running so it is not added again by itself or other tasks.
+        // References to deque elements stay valid on push_back
+        if(!tasks_.front().task())
+            break;
+        tasks_.pop_front();
+        if(isBudgetUsedUp())
+            break;
+    }
+
+    const Clock::duration duration = Clock::now() - startTime;
+    deadline_ = Clock::time_point::max();
+    stats_.numRuns++;
+    stats_.timeUsed += duration;
+    if(budget_.count() != 0 && duration > budget_)
+    {
+        stats_.numOverruns++;
+        stats_.maxOverrun = std::max<Clock::duration>(stats_.maxOverrun, duration - budget_);
+    }
+    stats_.maxBacklog = std::max(stats_.maxBacklog, getBacklog());
+}
+
+bool AIScheduler::isBudgetUsedUp() const
+{
+    return deadline_ != Clock::time_point::max() && Clock::now() >= deadline_;
+}
+
+} // namespace AIJH
@@ -0,0 +1,67 @@
+// Copyright (C) 2005 - 2021 Settlers Freaks (sf-team at siedler25.org)
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "Clock.h"
+#include <chrono>
+#include <deque>
+#include <functional>
+
+namespace AIJH {
+
+/// Runs the work of an AI in steps limited by a time budget per GF.
+/// Work which does not fit into the budget of a GF is continued in the following GFs
+class AIScheduler
+{
+public:
+    /// The global clock, which can be replaced, e.g. to run tests with a deterministic time
+    using Clock = ::Clock;
+    /// Does (a part of) the work and returns true when done or false when it has to be continued in a later run.
+    /// Should return false as soon as the budget is used up (see isBudgetUsedUp) and there is more to do
+    using Task = std::function<bool()>;
+
+    struct Stats
+    {
+        /// Number of runs and of runs which took longer than the budget
+        unsigned numRuns = 0, numOverruns = 0;
+        /// Largest time a run took longer than the budget
+        Clock::duration maxOverrun{};
+        /// Total time spent in all runs
+        Clock::duration timeUsed{};
+        /// Largest number of tasks left after a run
+        unsigned maxBacklog = 0;
+    };
+
+    /// Set the budget per run. Zero means unlimited, i.e. all tasks are run to completion
+    void setBudget(std::chrono::microseconds budget) { budget_ = budget; }
+    std::chrono::microseconds getBudget() const { return budget_; }
+
+    /// Add a task with the given id to the end of the queue unless a task with the same id is already queued.
+    /// Return true if it was added
+    bool add(unsigned id, Task task);
+    bool isQueued(unsigned id) const;
+    /// Run the queued tasks in order till all are done or the budget is used up.
+    /// The first task is always run to guarantee progress
+    void run();
+    /// True if the budget of the current run is used up
+    bool isBudgetUsedUp() const;
+
+    /// Number of tasks waiting to be run
+    unsigned getBacklog() const { return tasks_.size(); }
+    const Stats& getStats() const { return stats_; }
+
+private:
+    struct Entry
+    {
+        unsigned id;
+        Task task;
+    };
+    std::deque<Entry> tasks_;
+    std::chrono::microseconds budget_{0};
+    Clock::time_point deadline_ = Clock::time_point::max();
+    Stats stats_;
+};
+
+} // namespace AIJH
@@ -220,7 +220,7 @@ void BuildJob::TryToBuild()
                     if(type != BuildingType::Fortress
                        && aiInterface.GetBuildingQuality(foundPos) != BuildingQuality::Mine
                        && aiInterface.GetBuildingQuality(foundPos) > BUILDING_SIZE[type]
-                       && aijh.BQsurroundcheck(foundPos, 6, true, 10) < 10)
+                       && aijh.BQsurroundcheck(foundPos, 6, true) < 10)
                     {
                         // more than 80% is unbuildable in range 7 -> upgrade
                         for(BuildingType bld : BuildingProperties::militaryBldTypes)
@@ -12,6 +12,7 @@
 #include "addons/const_addons.h"
 #include "nobBaseWarehouse.h"
 #include "notifications/BuildingNote.h"
+#include "notifications/NodeNote.h"
 #include "world/GameWorld.h"
 #include "nodeObjs/noExtension.h"
 #include "nodeObjs/noFlag.h"
@@ -73,6 +74,7 @@ void noBaseBuilding::Destroy()
 {
     DestroyAllRoads();
     world->GetNotifications().publish(BuildingNote(BuildingNote::Destroyed, player, pos, bldType_));
+    world->GetNotifications().publish(NodeNote(NodeNote::ObjRemoved, pos));
 
     if(world->GetGameInterface())
         world->GetGameInterface()->GI_UpdateMinimap(pos);
@@ -312,7 +312,6 @@ void dskBenchmark::finishTest()
 
 void dskBenchmark::createGame()
 {
-    RANDOM.Init(42);
     std::vector<PlayerInfo> players;
     PlayerInfo p;
     p.ps = PlayerState::Occupied;
@@ -323,6 +322,7 @@ void dskBenchmark::createGame()
     p.color = PLAYER_COLORS[1];
     players.push_back(p);
     game_ = std::make_shared<Game>(GlobalGameSettings(), 0u, players);
+    RANDOM.Init(42);
     GameWorld& world = game_->world_;
     try
     {
@@ -68,6 +68,7 @@
 #include "ogl/SoundEffectItem.h"
 #include "ogl/glArchivItem_Bitmap_Player.h"
 #include "ogl/glFont.h"
+#include "ogl/glTexturePacker.h"
 #include "pathfinding/FindPathForRoad.h"
 #include "postSystem/PostBox.h"
 #include "postSystem/PostMsg.h"
@@ -93,7 +94,8 @@ enum
     ID_btOptions,
     ID_btConstructionAid,
     ID_btPost,
-    ID_txtNumMsg
+    ID_txtNumMsg,
+    ID_txtFrameTimes
 };
 }
 
@@ -103,7 +105,8 @@ dskGameInterface::dskGameInterface(std::shared_ptr<Game> game, std::shared_ptr<c
       worldViewer(playerIdx, const_cast<Game&>(*game_).world_),
       gwv(worldViewer, Position(0, 0), VIDEODRIVER.GetRenderSize()), cbb(*LOADER.GetPaletteN("pal5")),
       actionwindow(nullptr), roadwindow(nullptr), minimap(worldViewer), isScrolling(false), zoomLvl(ZOOM_DEFAULT_INDEX),
-      isCheatModeOn(false)
+      isCheatModeOn(false), frameTimesSum_(), numTimedFrames_(0),
+      lastFrameTimesUpdate_(GameWorldView::DrawTimes::clock::now())
 {
     road.mode = RoadBuildMode::Disabled;
     road.point = MapPoint(0, 0);
@@ -130,6 +133,12 @@ dskGameInterface::dskGameInterface(std::shared_ptr<Game> game, std::shared_ptr<c
     barPos += DrawPoint(18, 24);
 
     AddText(ID_txtNumMsg, barPos, "", COLOR_YELLOW, FontStyle::CENTER | FontStyle::VCENTER, SmallFont);
+    // Show where the frame time goes below the fps
+    if(GetCtrl<ctrlText>(fpsDisplayId))
+    {
+        AddText(ID_txtFrameTimes, DrawPoint(800, SmallFont->getHeight()), "", COLOR_YELLOW, FontStyle::RIGHT,
+                SmallFont);
+    }
 
     const_cast<Game&>(*game_).world_.SetGameInterface(this);
 
@@ -953,8 +962,52 @@ void dskGameInterface::OnBuildingNote(const BuildingNote& note)
     }
 }
 
+void dskGameInterface::UpdateFrameTimes()
+{
+    auto* txtFrameTimes = GetCtrl<ctrlText>(ID_txtFrameTimes);
+    if(!txtFrameTimes)
+        return;
+    const GameWorldView::DrawTimes& drawTimes = gwv.GetDrawTimes();
+    frameTimesSum_.terrain += drawTimes.terrain;
+    frameTimesSum_.objects += drawTimes.objects;
+    frameTimesSum_.figures += drawTimes.figures;
+    // Windows of the last frame as they are drawn after this
+    frameTimesSum_.gui += drawTimes.gui + WINDOWMANAGER.GetWindowsDrawTime();
+    ++numTimedFrames_;
+
+    const auto now = GameWorldView::DrawTimes::clock::now();
+    if(now - lastFrameTimesUpdate_ < std::chrono::seconds(1))
+        return;
+    const auto avgMs = [this](GameWorldView::DrawTimes::clock::duration sum) {
+        return std::chrono::duration<double, std::milli>(sum).count() / numTimedFrames_;
+    };
+    std::string text = helpers::format("Terrain %.1f / Objects %.1f / Figures %.1f / GUI %.1f ms, %u texture binds",
+                                       avgMs(frameTimesSum_.terrain), avgMs(frameTimesSum_.objects),
+                                       avgMs(frameTimesSum_.figures), avgMs(frameTimesSum_.gui),
+                                       VIDEODRIVER.GetNumTextureBinds());
+    if(const glTexturePacker* packer = LOADER.getTexturePacker())
+    {
+        text += helpers::format(", %u shared textures (%u%% used)", packer->getNumPages(),
+                                static_cast<unsigned>(packer->getOccupancy() * 100));
+    }
+    txtFrameTimes->SetText(text);
+    frameTimesSum_ = GameWorldView::DrawTimes();
+    numTimedFrames_ = 0;
+    lastFrameTimesUpdate_ = now;
+}
+
 void dskGameInterface::Run()
 {
+    // After rejoining a game drawing the world would only slow down catching up with the others
+    if(GAMECLIENT.IsCatchingUp())
+    {
+        LargeFont->Draw(DrawPoint(VIDEODRIVER.GetRenderSize() / 2u),
+                        helpers::format(_("Catching up with the game: GF %1%"), GAMECLIENT.GetGFNumber()),
+                        FontStyle::CENTER, COLOR_YELLOW);
+        messenger.Draw();
+        return;
+    }
+
     // Reset draw counter of the trees before drawing
     noTree::ResetDrawCounter();
 
@@ -963,6 +1016,7 @@ void dskGameInterface::Run()
     bool drawMouse = WINDOWMANAGER.FindWindowAtPos(VIDEODRIVER.GetMousePos()) == nullptr;
     gwv.Draw(road, actionwindow != nullptr ? actionwindow->GetSelectedPt() : MapPoint::Invalid(), drawMouse,
              &water_percent);
+    UpdateFrameTimes();
 
     // Indicate that the game is paused by darkening the screen (dark semi-transparent overlay)
     if(GAMECLIENT.IsPaused())
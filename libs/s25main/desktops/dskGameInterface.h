@@ -136,6 +136,8 @@ private:
     void StartScrolling(const Position& mousePos);
 
     void ShowPersistentWindowsAfterSwitch();
+    /// Add the times of the last frame to the averages and update the display once per second
+    void UpdateFrameTimes();
 
     PostBox& GetPostBox();
     std::shared_ptr<const Game> game_;
@@ -165,4 +167,9 @@ private:
     bool isCheatModeOn;
     std::string curCheatTxt;
     Subscription evBld;
+
+    /// Frame times summed up since the last display update
+    GameWorldView::DrawTimes frameTimesSum_;
+    unsigned numTimedFrames_;
+    GameWorldView::DrawTimes::clock::time_point lastFrameTimesUpdate_;
 };
@@ -30,7 +30,8 @@ using SwapIntervalExt_t = int(int);
 SwapIntervalExt_t* wglSwapIntervalEXT = nullptr;
 
 VideoDriverWrapper::VideoDriverWrapper()
-    : videodriver(nullptr, nullptr), renderer_(nullptr), enableMouseWarping(true), texture_current(0)
+    : videodriver(nullptr, nullptr), renderer_(nullptr), enableMouseWarping(true), texture_current(0),
+      curFrameTextureBinds_(0), lastFrameTextureBinds_(0)
 {}
 
 VideoDriverWrapper::~VideoDriverWrapper()
@@ -224,6 +225,7 @@ void VideoDriverWrapper::BindTexture(unsigned t)
     {
         texture_current = t;
         glBindTexture(GL_TEXTURE_2D, t);
+        curFrameTextureBinds_++;
     }
 }
 
@@ -261,6 +263,8 @@ void VideoDriverWrapper::SwapBuffers()
     FrameCounter::clock::time_point now = FrameCounter::clock::now();
     frameLimiter_->update(now);
     frameCtr_->update(now);
+    lastFrameTextureBinds_ = curFrameTextureBinds_;
+    curFrameTextureBinds_ = 0;
 }
 
 void VideoDriverWrapper::ClearScreen()
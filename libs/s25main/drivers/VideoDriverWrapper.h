@@ -48,6 +48,8 @@ public:
     unsigned GenerateTexture();
     void BindTexture(unsigned t);
     void DeleteTexture(unsigned t);
+    /// Number of times the bound texture was changed during the last frame
+    unsigned GetNumTextureBinds() const { return lastFrameTextureBinds_; }
 
     IRenderer* GetRenderer() { return renderer_.get(); }
 
@@ -114,6 +116,7 @@ private:
 
     std::vector<unsigned> texture_list;
     unsigned texture_current;
+    unsigned curFrameTextureBinds_, lastFrameTextureBinds_;
 };
 
 #define VIDEODRIVER VideoDriverWrapper::inst()
@@ -22,5 +22,7 @@ void MapInfo::Clear()
     luaData.Clear();
     mapChecksum = 0;
     luaChecksum = 0;
+    mapHash = 0;
+    luaHash = 0;
     savegame.reset();
 }
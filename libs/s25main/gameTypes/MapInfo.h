@@ -33,6 +33,8 @@ public:
     CompressedData luaData;
     /// Checksum of map data
     unsigned mapChecksum, luaChecksum;
+    /// CRC32 of map data, identifies the files in the map cache
+    unsigned mapHash, luaHash;
     /// Savegame (set if type == MAP_SAVEGAME)
     std::unique_ptr<Savegame> savegame;
 };
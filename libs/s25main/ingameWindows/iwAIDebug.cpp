@@ -180,6 +180,9 @@ void iwAIDebug::Msg_PaintBefore()
     ss << "Jobs to do: " << printer->ai->GetNumJobs() << std::endl
        << "Evt: " << printer->ai->GetEventNum() << " Bld: " << printer->ai->GetBuildJobNum()
        << " Con: " << printer->ai->GetConnectJobNum() << std::endl;
+    const AIJH::AIScheduler& scheduler = printer->ai->GetScheduler();
+    ss << "Tasks: " << scheduler.getBacklog() << " (max " << scheduler.getStats().maxBacklog
+       << ") Overruns: " << scheduler.getStats().numOverruns << "/" << scheduler.getStats().numRuns << std::endl;
     const auto* bj = dynamic_cast<const AIJH::BuildJob*>(currentJob);
     const auto* ej = dynamic_cast<const AIJH::EventJob*>(currentJob);
 
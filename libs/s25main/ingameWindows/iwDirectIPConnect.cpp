@@ -11,6 +11,7 @@
 #include "controls/ctrlEdit.h"
 #include "controls/ctrlOptionGroup.h"
 #include "controls/ctrlText.h"
+#include "desktops/dskGameLoader.h"
 #include "desktops/dskHostGame.h"
 #include "drivers/VideoDriverWrapper.h"
 #include "network/GameClient.h"
@@ -21,7 +22,7 @@
 #include "s25util/colors.h"
 
 iwDirectIPConnect::iwDirectIPConnect(ServerType server_type)
-    : IngameWindow(CGI_DIRECTIPCONNECT, IngameWindow::posLastOrCenter, Extent(300, 285), _("Join Game"),
+    : IngameWindow(CGI_DIRECTIPCONNECT, IngameWindow::posLastOrCenter, Extent(300, 315), _("Join Game"),
                    LOADER.GetImageN("resource", 41), true),
       server_type(server_type)
 {
@@ -58,6 +59,9 @@ iwDirectIPConnect::iwDirectIPConnect(ServerType server_type)
     // "Zurück"
     AddTextButton(8, DrawPoint(155, 240), Extent(125, 22), TextureColor::Red1, _("Back"), NormalFont);
 
+    // Join a spectator relay
+    AddTextButton(13, DrawPoint(20, 270), Extent(260, 22), TextureColor::Green2, _("Watch game"), NormalFont);
+
     host->SetFocus();
     host->SetText(SETTINGS.server.last_ip);
     port->SetText(SETTINGS.server.localPort);
@@ -108,7 +112,8 @@ void iwDirectIPConnect::Msg_ButtonClick(const unsigned ctrl_id)
 {
     switch(ctrl_id)
     {
-        case 7: // "Verbinden"
+        case 7:  // "Verbinden"
+        case 13: // Watch
         {
             auto* edtHost = GetCtrl<ctrlEdit>(1);
             auto* edtPort = GetCtrl<ctrlEdit>(3);
@@ -130,13 +135,23 @@ void iwDirectIPConnect::Msg_ButtonClick(const unsigned ctrl_id)
             SetStatus(_("Connecting with Host..."), COLOR_RED);
 
             GAMECLIENT.Stop();
-            if(!GAMECLIENT.Connect(edtHost->GetText(), edtPw->GetText(), server_type, *port, false,
-                                   SETTINGS.server.ipv6))
+            bool connected;
+            if(ctrl_id == 13)
+                connected = GAMECLIENT.Spectate(edtHost->GetText(), *port, SETTINGS.server.ipv6);
+            else
+            {
+                connected = GAMECLIENT.Connect(edtHost->GetText(), edtPw->GetText(), server_type, *port, false,
+                                               SETTINGS.server.ipv6);
+            }
+            if(!connected)
             {
                 // Text auf "Verbindung fehlgeschlagen" setzen und Button aktivieren
                 SetStatus(_("Connection failed!"), COLOR_RED);
             } else
-                GetCtrl<ctrlButton>(ctrl_id)->SetEnabled(false);
+            {
+                GetCtrl<ctrlButton>(7)->SetEnabled(false);
+                GetCtrl<ctrlButton>(13)->SetEnabled(false);
+            }
         }
         break;
         case 8:
@@ -203,6 +218,13 @@ void iwDirectIPConnect::CI_Error(const ClientError ce)
 {
     SetStatus(ClientErrorToStr(ce), COLOR_RED);
     GetCtrl<ctrlButton>(7)->SetEnabled();
+    GetCtrl<ctrlButton>(13)->SetEnabled();
+}
+
+void iwDirectIPConnect::CI_GameLoading(std::shared_ptr<Game> game)
+{
+    // Spectators skip the lobby
+    WINDOWMANAGER.Switch(std::make_unique<dskGameLoader>(std::move(game)));
 }
 
 void iwDirectIPConnect::CI_NextConnectState(const ConnectState cs)
@@ -216,6 +238,12 @@ void iwDirectIPConnect::CI_NextConnectState(const ConnectState cs)
 
         case ConnectState::Finished: // Wir wurden verbunden
         {
+            // Spectators wait for the game to be loaded
+            if(GAMECLIENT.IsSpectating())
+            {
+                SetStatus(_("Loading game..."), COLOR_YELLOW);
+                break;
+            }
             std::unique_ptr<ILobbyClient> lobbyClient;
             if(server_type == ServerType::Lobby)
                 lobbyClient = std::make_unique<RttrLobbyClient>(LOBBYCLIENT);
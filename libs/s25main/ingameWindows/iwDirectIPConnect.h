@@ -30,4 +30,5 @@ private:
 
     void CI_Error(ClientError ce) override;
     void CI_NextConnectState(ConnectState cs) override;
+    void CI_GameLoading(std::shared_ptr<Game> game) override;
 };
@@ -9,6 +9,7 @@
 #include "controls/ctrlMultiSelectGroup.h"
 #include "controls/ctrlOptionGroup.h"
 #include "controls/ctrlText.h"
+#include "enum_cast.hpp"
 #include "iwHelp.h"
 #include "ogl/FontStyle.h"
 #include "gameData/const_gui_ids.h"
@@ -149,9 +150,33 @@ void iwMerchandiseStatistics::Draw_()
     if(IsMinimized())
         return;
 
-    DrawRectangles();
-    DrawAxis();
-    DrawStatistic();
+    if(UpdateShownData())
+    {
+        graph_.clear();
+        DrawRectangles();
+        DrawAxis();
+        DrawStatistic();
+    }
+    DrawPrimitives(graph_, GetDrawPos());
+}
+
+bool iwMerchandiseStatistics::UpdateShownData()
+{
+    // Collect everything the graph depends on and compare it to the currently shown values
+    curData_.clear();
+    curData_.push_back(rttr::enum_cast(currentTime));
+    const GamePlayer::Statistic& stat = player.GetStatistic(currentTime);
+    curData_.push_back(stat.currentIndex);
+    for(unsigned it : GetCtrl<ctrlMultiSelectGroup>(22)->GetSelection())
+    {
+        curData_.push_back(it);
+        for(unsigned i = 0; i < NUM_STAT_STEPS; ++i)
+            curData_.push_back(stat.merchandiseData[it - 1][i]);
+    }
+    if(curData_ == shownData_)
+        return false;
+    std::swap(curData_, shownData_);
+    return true;
 }
 
 // TODO
@@ -160,14 +185,14 @@ void iwMerchandiseStatistics::DrawStatistic()
     // Ein paar benötigte Werte...
     const int sizeX = 180;
     const int sizeY = 80;
-    const DrawPoint topLeft = GetPos() + DrawPoint(34, 64);
+    const DrawPoint topLeft(34, 64);
     const int stepX = sizeX / NUM_STAT_STEPS; // 6
 
     // Aktive Buttons holen (Achtung ID == BarColor + 1)
     const std::set<unsigned>& active = GetCtrl<ctrlMultiSelectGroup>(22)->GetSelection();
 
     // Statistik holen
-    const GamePlayer::Statistic stat = player.GetStatistic(currentTime);
+    const GamePlayer::Statistic& stat = player.GetStatistic(currentTime);
 
     // Maximalwert suchen
     unsigned short max = 1;
@@ -204,7 +229,7 @@ void iwMerchandiseStatistics::DrawStatistic()
                              / max;
             if(i != 0)
             {
-                DrawLine(drawPos, previous, 2, BarColors[it - 1]);
+                graph_.addLine(drawPos, previous, 2, BarColors[it - 1]);
             }
             previous = drawPos;
         }
@@ -217,12 +242,11 @@ void iwMerchandiseStatistics::DrawRectangles()
     const Extent size(30, 4);
     const DrawPoint step(31, 35);
 
-    const DrawPoint pos = GetDrawPos();
     DrawPoint curOffset(17, 187);
 
     for(unsigned i = 0; i < 14; ++i)
     {
-        DrawRectangle(Rect(pos + curOffset, size), BarColors[i]);
+        graph_.addRect(Rect(curOffset, size), BarColors[i]);
         if(i == 6)
         {
             curOffset.x = 17;
@@ -237,20 +261,20 @@ void iwMerchandiseStatistics::DrawAxis()
     // Ein paar benötigte Werte...
     const int sizeX = 180;
     const int sizeY = 80;
-    const DrawPoint topLeft = GetPos() + DrawPoint(34, 64);
+    const DrawPoint topLeft(34, 64);
     const DrawPoint topLeftRel(37, 64);
+    const unsigned axisColor = MakeColor(255, 88, 44, 16);
 
     // X-Achse, horizontal, war irgendwie zu lang links :S
-    DrawLine(topLeft + DrawPoint(6, sizeY + 2), // bisschen tiefer, damit man nulllinien noch sieht
-             topLeft + DrawPoint(sizeX, sizeY + 1), 1, MakeColor(255, 88, 44, 16));
+    graph_.addLine(topLeft + DrawPoint(6, sizeY + 2), // bisschen tiefer, damit man nulllinien noch sieht
+                   topLeft + DrawPoint(sizeX, sizeY + 1), 1, axisColor);
 
     // Y-Achse, vertikal
-    DrawLine(topLeft + DrawPoint(sizeX, 0), topLeft + DrawPoint(sizeX, sizeY + 5), 1, MakeColor(255, 88, 44, 16));
+    graph_.addLine(topLeft + DrawPoint(sizeX, 0), topLeft + DrawPoint(sizeX, sizeY + 5), 1, axisColor);
 
     // Striche an der Y-Achse
-    DrawLine(topLeft + DrawPoint(sizeX - 3, 0), topLeft + DrawPoint(sizeX + 4, 0), 1, MakeColor(255, 88, 44, 16));
-    DrawLine(topLeft + DrawPoint(sizeX - 3, sizeY / 2), topLeft + DrawPoint(sizeX + 4, sizeY / 2), 1,
-             MakeColor(255, 88, 44, 16));
+    graph_.addLine(topLeft + DrawPoint(sizeX - 3, 0), topLeft + DrawPoint(sizeX + 4, 0), 1, axisColor);
+    graph_.addLine(topLeft + DrawPoint(sizeX - 3, sizeY / 2), topLeft + DrawPoint(sizeX + 4, sizeY / 2), 1, axisColor);
 
     // Striche an der X-Achse + Beschriftung
     // Zunächst die 0, die haben alle
@@ -262,36 +286,31 @@ void iwMerchandiseStatistics::DrawAxis()
     {
         case StatisticTime::T15Minutes:
             // -15
-            DrawLine(topLeft + DrawPoint(6, sizeY + 2), topLeft + DrawPoint(6, sizeY + 4), 1,
-                     MakeColor(255, 88, 44, 16));
+            graph_.addLine(topLeft + DrawPoint(6, sizeY + 2), topLeft + DrawPoint(6, sizeY + 4), 1, axisColor);
             timeAnnotations[0]->SetPos(topLeftRel + DrawPoint(6, sizeY + 6));
             timeAnnotations[0]->SetText("-15");
             timeAnnotations[0]->SetVisible(true);
 
             // -12
-            DrawLine(topLeft + DrawPoint(40, sizeY + 2), topLeft + DrawPoint(40, sizeY + 4), 1,
-                     MakeColor(255, 88, 44, 16));
+            graph_.addLine(topLeft + DrawPoint(40, sizeY + 2), topLeft + DrawPoint(40, sizeY + 4), 1, axisColor);
             timeAnnotations[1]->SetPos(topLeftRel + DrawPoint(40, sizeY + 6));
             timeAnnotations[1]->SetText("-12");
             timeAnnotations[1]->SetVisible(true);
 
             // -9
-            DrawLine(topLeft + DrawPoint(75, sizeY + 2), topLeft + DrawPoint(75, sizeY + 4), 1,
-                     MakeColor(255, 88, 44, 16));
+            graph_.addLine(topLeft + DrawPoint(75, sizeY + 2), topLeft + DrawPoint(75, sizeY + 4), 1, axisColor);
             timeAnnotations[2]->SetPos(topLeftRel + DrawPoint(75, sizeY + 6));
             timeAnnotations[2]->SetText("-9");
             timeAnnotations[2]->SetVisible(true);
 
             // -6
-            DrawLine(topLeft + DrawPoint(110, sizeY + 2), topLeft + DrawPoint(110, sizeY + 4), 1,
-                     MakeColor(255, 88, 44, 16));
+            graph_.addLine(topLeft + DrawPoint(110, sizeY + 2), topLeft + DrawPoint(110, sizeY + 4), 1, axisColor);
             timeAnnotations[3]->SetPos(topLeftRel + DrawPoint(110, sizeY + 6));
             timeAnnotations[3]->SetText("-6");
             timeAnnotations[3]->SetVisible(true);
 
             // -3
-            DrawLine(topLeft + DrawPoint(145, sizeY + 2), topLeft + DrawPoint(145, sizeY + 4), 1,
-                     MakeColor(255, 88, 44, 16));
+            graph_.addLine(topLeft + DrawPoint(145, sizeY + 2), topLeft + DrawPoint(145, sizeY + 4), 1, axisColor);
             timeAnnotations[4]->SetPos(topLeftRel + DrawPoint(145, sizeY + 6));
             timeAnnotations[4]->SetText("-3");
             timeAnnotations[4]->SetVisible(true);
@@ -300,72 +319,62 @@ void iwMerchandiseStatistics::DrawAxis()
             break;
         case StatisticTime::T1Hour:
             // -60
-            DrawLine(topLeft + DrawPoint(6, sizeY + 2), topLeft + DrawPoint(6, sizeY + 4), 1,
-                     MakeColor(255, 88, 44, 16));
+            graph_.addLine(topLeft + DrawPoint(6, sizeY + 2), topLeft + DrawPoint(6, sizeY + 4), 1, axisColor);
             timeAnnotations[0]->SetPos(topLeftRel + DrawPoint(6, sizeY + 6));
             timeAnnotations[0]->SetText("-60");
             timeAnnotations[0]->SetVisible(true);
 
             // -50
-            DrawLine(topLeft + DrawPoint(35, sizeY + 2), topLeft + DrawPoint(35, sizeY + 4), 1,
-                     MakeColor(255, 88, 44, 16));
+            graph_.addLine(topLeft + DrawPoint(35, sizeY + 2), topLeft + DrawPoint(35, sizeY + 4), 1, axisColor);
             timeAnnotations[1]->SetPos(topLeftRel + DrawPoint(35, sizeY + 6));
             timeAnnotations[1]->SetText("-50");
             timeAnnotations[1]->SetVisible(true);
 
             // -40
-            DrawLine(topLeft + DrawPoint(64, sizeY + 2), topLeft + DrawPoint(64, sizeY + 4), 1,
-                     MakeColor(255, 88, 44, 16));
+            graph_.addLine(topLeft + DrawPoint(64, sizeY + 2), topLeft + DrawPoint(64, sizeY + 4), 1, axisColor);
             timeAnnotations[2]->SetPos(topLeftRel + DrawPoint(64, sizeY + 6));
             timeAnnotations[2]->SetText("-40");
             timeAnnotations[2]->SetVisible(true);
 
             // -30
-            DrawLine(topLeft + DrawPoint(93, sizeY + 2), topLeft + DrawPoint(93, sizeY + 4), 1,
-                     MakeColor(255, 88, 44, 16));
+            graph_.addLine(topLeft + DrawPoint(93, sizeY + 2), topLeft + DrawPoint(93, sizeY + 4), 1, axisColor);
             timeAnnotations[3]->SetPos(topLeftRel + DrawPoint(93, sizeY + 6));
             timeAnnotations[3]->SetText("-30");
             timeAnnotations[3]->SetVisible(true);
 
             // -20
-            DrawLine(topLeft + DrawPoint(122, sizeY + 2), topLeft + DrawPoint(122, sizeY + 4), 1,
-                     MakeColor(255, 88, 44, 16));
+            graph_.addLine(topLeft + DrawPoint(122, sizeY + 2), topLeft + DrawPoint(122, sizeY + 4), 1, axisColor);
             timeAnnotations[4]->SetPos(topLeftRel + DrawPoint(122, sizeY + 6));
             timeAnnotations[4]->SetText("-20");
             timeAnnotations[4]->SetVisible(true);
 
             // -10
-            DrawLine(topLeft + DrawPoint(151, sizeY + 2), topLeft + DrawPoint(151, sizeY + 4), 1,
-                     MakeColor(255, 88, 44, 16));
+            graph_.addLine(topLeft + DrawPoint(151, sizeY + 2), topLeft + DrawPoint(151, sizeY + 4), 1, axisColor);
             timeAnnotations[5]->SetPos(topLeftRel + DrawPoint(151, sizeY + 6));
             timeAnnotations[5]->SetText("-10");
             timeAnnotations[5]->SetVisible(true);
             break;
         case StatisticTime::T4Hours:
             // -240
-            DrawLine(topLeft + DrawPoint(6, sizeY + 2), topLeft + DrawPoint(6, sizeY + 4), 1,
-                     MakeColor(255, 88, 44, 16));
+            graph_.addLine(topLeft + DrawPoint(6, sizeY + 2), topLeft + DrawPoint(6, sizeY + 4), 1, axisColor);
             timeAnnotations[0]->SetPos(topLeftRel + DrawPoint(6, sizeY + 6));
             timeAnnotations[0]->SetText("-240");
             timeAnnotations[0]->SetVisible(true);
 
             // -180
-            DrawLine(topLeft + DrawPoint(49, sizeY + 2), topLeft + DrawPoint(49, sizeY + 4), 1,
-                     MakeColor(255, 88, 44, 16));
+            graph_.addLine(topLeft + DrawPoint(49, sizeY + 2), topLeft + DrawPoint(49, sizeY + 4), 1, axisColor);
             timeAnnotations[1]->SetPos(topLeftRel + DrawPoint(49, sizeY + 6));
             timeAnnotations[1]->SetText("-180");
             timeAnnotations[1]->SetVisible(true);
 
             // -120
-            DrawLine(topLeft + DrawPoint(93, sizeY + 2), topLeft + DrawPoint(93, sizeY + 4), 1,
-                     MakeColor(255, 88, 44, 16));
+            graph_.addLine(topLeft + DrawPoint(93, sizeY + 2), topLeft + DrawPoint(93, sizeY + 4), 1, axisColor);
             timeAnnotations[2]->SetPos(topLeftRel + DrawPoint(93, sizeY + 6));
             timeAnnotations[2]->SetText("-120");
             timeAnnotations[2]->SetVisible(true);
 
             // -60
-            DrawLine(topLeft + DrawPoint(136, sizeY + 2), topLeft + DrawPoint(136, sizeY + 4), 1,
-                     MakeColor(255, 88, 44, 16));
+            graph_.addLine(topLeft + DrawPoint(136, sizeY + 2), topLeft + DrawPoint(136, sizeY + 4), 1, axisColor);
             timeAnnotations[3]->SetPos(topLeftRel + DrawPoint(136, sizeY + 6));
             timeAnnotations[3]->SetText("-60");
             timeAnnotations[3]->SetVisible(true);
@@ -375,29 +384,25 @@ void iwMerchandiseStatistics::DrawAxis()
             break;
         case StatisticTime::T16Hours:
             // -960
-            DrawLine(topLeft + DrawPoint(6, sizeY + 2), topLeft + DrawPoint(6, sizeY + 4), 1,
-                     MakeColor(255, 88, 44, 16));
+            graph_.addLine(topLeft + DrawPoint(6, sizeY + 2), topLeft + DrawPoint(6, sizeY + 4), 1, axisColor);
             timeAnnotations[0]->SetPos(topLeftRel + DrawPoint(6, sizeY + 6));
             timeAnnotations[0]->SetText("-960");
             timeAnnotations[0]->SetVisible(true);
 
             // -720
-            DrawLine(topLeft + DrawPoint(49, sizeY + 2), topLeft + DrawPoint(49, sizeY + 4), 1,
-                     MakeColor(255, 88, 44, 16));
+            graph_.addLine(topLeft + DrawPoint(49, sizeY + 2), topLeft + DrawPoint(49, sizeY + 4), 1, axisColor);
             timeAnnotations[1]->SetPos(topLeftRel + DrawPoint(49, sizeY + 6));
             timeAnnotations[1]->SetText("-720");
             timeAnnotations[1]->SetVisible(true);
 
             // -480
-            DrawLine(topLeft + DrawPoint(93, sizeY + 2), topLeft + DrawPoint(93, sizeY + 4), 1,
-                     MakeColor(255, 88, 44, 16));
+            graph_.addLine(topLeft + DrawPoint(93, sizeY + 2), topLeft + DrawPoint(93, sizeY + 4), 1, axisColor);
             timeAnnotations[2]->SetPos(topLeftRel + DrawPoint(93, sizeY + 6));
             timeAnnotations[2]->SetText("-480");
             timeAnnotations[2]->SetVisible(true);
 
             // -240
-            DrawLine(topLeft + DrawPoint(136, sizeY + 2), topLeft + DrawPoint(136, sizeY + 4), 1,
-                     MakeColor(255, 88, 44, 16));
+            graph_.addLine(topLeft + DrawPoint(136, sizeY + 2), topLeft + DrawPoint(136, sizeY + 4), 1, axisColor);
             timeAnnotations[3]->SetPos(topLeftRel + DrawPoint(136, sizeY + 6));
             timeAnnotations[3]->SetText("-240");
             timeAnnotations[3]->SetVisible(true);
@@ -5,7 +5,10 @@
 #pragma once
 
 #include "IngameWindow.h"
+#include "ogl/DrawList.h"
 #include "gameTypes/StatisticTypes.h"
+#include <cstdint>
+#include <vector>
 
 class ctrlText;
 class GamePlayer;
@@ -18,6 +21,8 @@ public:
     ~iwMerchandiseStatistics() override;
 
 private:
+    /// Return true if the shown values changed and the graph must be recreated
+    bool UpdateShownData();
     /// Malt die bunten Kästchen über den Buttons
     void DrawRectangles();
     /// Zeichnet das Achsensystem
@@ -38,6 +43,11 @@ private:
     // Maximalwert der y-Achse
     ctrlText* maxValue;
 
+    /// Axis, colored boxes and statistic lines relative to the window position
+    DrawList graph_;
+    /// Values the graph was created from and buffer for the current values
+    std::vector<uint32_t> shownData_, curData_;
+
     // Durchgereichte Methoden vom Window
     void Draw_() override;
     void Msg_OptionGroupChange(unsigned ctrl_id, unsigned selection) override;
@@ -12,6 +12,7 @@
 #include "controls/ctrlButton.h"
 #include "controls/ctrlOptionGroup.h"
 #include "controls/ctrlText.h"
+#include "enum_cast.hpp"
 #include "iwHelp.h"
 #include "network/GameClient.h"
 #include "ogl/FontStyle.h"
@@ -253,25 +254,55 @@ void iwStatistics::Draw_()
     if(IsMinimized())
         return;
 
-    // Die farbigen Boxen unter den Spielerportraits malen
-    unsigned short startX = 126 - numPlayingPlayers * 17;
-    DrawPoint drawPt = GetDrawPos() + DrawPoint(startX, 68);
-    for(unsigned i = 0; i < gwv.GetWorld().GetNumPlayers(); ++i)
+    if(UpdateShownData())
     {
-        const GamePlayer& player = gwv.GetWorld().GetPlayer(i);
-        if(!player.isUsed())
-            continue;
+        graph_.clear();
+        // Die farbigen Boxen unter den Spielerportraits malen
+        unsigned short startX = 126 - numPlayingPlayers * 17;
+        DrawPoint drawPt(startX, 68);
+        for(unsigned i = 0; i < gwv.GetWorld().GetNumPlayers(); ++i)
+        {
+            const GamePlayer& player = gwv.GetWorld().GetPlayer(i);
+            if(!player.isUsed())
+                continue;
 
-        if(activePlayers[i])
-            DrawRectangle(Rect(drawPt, Extent(34, 12)), player.color);
-        drawPt.x += 34;
-    }
+            if(activePlayers[i])
+                graph_.addRect(Rect(drawPt, Extent(34, 12)), player.color);
+            drawPt.x += 34;
+        }
 
-    // Koordinatenachsen malen
-    DrawAxis();
+        // Koordinatenachsen malen
+        DrawAxis();
+
+        // Statistiklinien malen
+        DrawStatistic(currentView);
+    }
+    DrawPrimitives(graph_, GetDrawPos());
+}
 
-    // Statistiklinien malen
-    DrawStatistic(currentView);
+bool iwStatistics::UpdateShownData()
+{
+    // Collect everything the graph depends on and compare it to the currently shown values
+    curData_.clear();
+    curData_.push_back(rttr::enum_cast(currentView));
+    curData_.push_back(rttr::enum_cast(currentTime));
+    curData_.push_back(SETTINGS.ingame.scale_statistics ? 1 : 0);
+    const GameWorldBase& world = gwv.GetWorld();
+    for(unsigned p = 0; p < world.GetNumPlayers(); ++p)
+    {
+        if(!activePlayers[p])
+            continue;
+        const GamePlayer& player = world.GetPlayer(p);
+        const GamePlayer::Statistic& stat = player.GetStatistic(currentTime);
+        curData_.push_back(p);
+        curData_.push_back(player.color);
+        curData_.push_back(stat.currentIndex);
+        curData_.insert(curData_.end(), stat.data[currentView].begin(), stat.data[currentView].end());
+    }
+    if(curData_ == shownData_)
+        return false;
+    std::swap(curData_, shownData_);
+    return true;
 }
 
 void iwStatistics::DrawStatistic(StatisticType type)
@@ -318,7 +349,7 @@ void iwStatistics::DrawStatistic(StatisticType type)
         minValue->SetText(std::to_string(min));
 
     // Statistiklinien zeichnen
-    const DrawPoint topLeft = GetPos() + DrawPoint(34, 124);
+    const DrawPoint topLeft(34, 124);
     DrawPoint previousPos(0, 0);
 
     for(unsigned p = 0; p < world.GetNumPlayers(); ++p)
@@ -338,7 +369,7 @@ void iwStatistics::DrawStatistic(StatisticType type)
             else
                 curPos.y -= (curStatVal * size.y) / max;
             if(i != 0)
-                DrawLine(curPos, previousPos, 2, world.GetPlayer(p).color);
+                graph_.addLine(curPos, previousPos, 2, world.GetPlayer(p).color);
             previousPos = curPos;
         }
     }
@@ -349,20 +380,20 @@ void iwStatistics::DrawAxis()
     // Ein paar benötigte Werte...
     const int sizeX = 180;
     const int sizeY = 80;
-    const DrawPoint topLeft = GetPos() + DrawPoint(34, 124);
+    const DrawPoint topLeft(34, 124);
     const DrawPoint topLeftRel(37, 124);
+    const unsigned axisColor = MakeColor(255, 88, 44, 16);
 
     // X-Achse, horizontal, war irgendwie zu lang links :S
-    DrawLine(topLeft + DrawPoint(6, sizeY + 2), // bisschen tiefer, damit man nulllinien noch sieht
-             topLeft + DrawPoint(sizeX, sizeY + 1), 1, MakeColor(255, 88, 44, 16));
+    graph_.addLine(topLeft + DrawPoint(6, sizeY + 2), // bisschen tiefer, damit man nulllinien noch sieht
+                   topLeft + DrawPoint(sizeX, sizeY + 1), 1, axisColor);
 
     // Y-Achse, vertikal
-    DrawLine(topLeft + DrawPoint(sizeX, 0), topLeft + DrawPoint(sizeX, sizeY + 5), 1, MakeColor(255, 88, 44, 16));
+    graph_.addLine(topLeft + DrawPoint(sizeX, 0), topLeft + DrawPoint(sizeX, sizeY + 5), 1, axisColor);
 
     // Striche an der Y-Achse
-    DrawLine(topLeft + DrawPoint(sizeX - 3, 0), topLeft + DrawPoint(sizeX + 4, 0), 1, MakeColor(255, 88, 44, 16));
-    DrawLine(topLeft + DrawPoint(sizeX - 3, sizeY / 2), topLeft + DrawPoint(sizeX + 4, sizeY / 2), 1,
-             MakeColor(255, 88, 44, 16));
+    graph_.addLine(topLeft + DrawPoint(sizeX - 3, 0), topLeft + DrawPoint(sizeX + 4, 0), 1, axisColor);
+    graph_.addLine(topLeft + DrawPoint(sizeX - 3, sizeY / 2), topLeft + DrawPoint(sizeX + 4, sizeY / 2), 1, axisColor);
 
     // Striche an der X-Achse + Beschriftung
     // Zunächst die 0, die haben alle
@@ -374,36 +405,31 @@ void iwStatistics::DrawAxis()
     {
         case StatisticTime::T15Minutes:
             // -15
-            DrawLine(topLeft + DrawPoint(6, sizeY + 2), topLeft + DrawPoint(6, sizeY + 4), 1,
-                     MakeColor(255, 88, 44, 16));
+            graph_.addLine(topLeft + DrawPoint(6, sizeY + 2), topLeft + DrawPoint(6, sizeY + 4), 1, axisColor);
             timeAnnotations[0]->SetPos(topLeftRel + DrawPoint(6, sizeY + 6));
             timeAnnotations[0]->SetText("-15");
             timeAnnotations[0]->SetVisible(true);
 
             // -12
-            DrawLine(topLeft + DrawPoint(40, sizeY + 2), topLeft + DrawPoint(40, sizeY + 4), 1,
-                     MakeColor(255, 88, 44, 16));
+            graph_.addLine(topLeft + DrawPoint(40, sizeY + 2), topLeft + DrawPoint(40, sizeY + 4), 1, axisColor);
             timeAnnotations[1]->SetPos(topLeftRel + DrawPoint(40, sizeY + 6));
             timeAnnotations[1]->SetText("-12");
             timeAnnotations[1]->SetVisible(true);
 
             // -9
-            DrawLine(topLeft + DrawPoint(75, sizeY + 2), topLeft + DrawPoint(75, sizeY + 4), 1,
-                     MakeColor(255, 88, 44, 16));
+            graph_.addLine(topLeft + DrawPoint(75, sizeY + 2), topLeft + DrawPoint(75, sizeY + 4), 1, axisColor);
             timeAnnotations[2]->SetPos(topLeftRel + DrawPoint(75, sizeY + 6));
             timeAnnotations[2]->SetText("-9");
             timeAnnotations[2]->SetVisible(true);
 
             // -6
-            DrawLine(topLeft + DrawPoint(110, sizeY + 2), topLeft + DrawPoint(110, sizeY + 4), 1,
-                     MakeColor(255, 88, 44, 16));
+            graph_.addLine(topLeft + DrawPoint(110, sizeY + 2), topLeft + DrawPoint(110, sizeY + 4), 1, axisColor);
             timeAnnotations[3]->SetPos(topLeftRel + DrawPoint(110, sizeY + 6));
             timeAnnotations[3]->SetText("-6");
             timeAnnotations[3]->SetVisible(true);
 
             // -3
-            DrawLine(topLeft + DrawPoint(145, sizeY + 2), topLeft + DrawPoint(145, sizeY + 4), 1,
-                     MakeColor(255, 88, 44, 16));
+            graph_.addLine(topLeft + DrawPoint(145, sizeY + 2), topLeft + DrawPoint(145, sizeY + 4), 1, axisColor);
             timeAnnotations[4]->SetPos(topLeftRel + DrawPoint(145, sizeY + 6));
             timeAnnotations[4]->SetText("-3");
             timeAnnotations[4]->SetVisible(true);
@@ -412,72 +438,62 @@ void iwStatistics::DrawAxis()
             break;
         case StatisticTime::T1Hour:
             // -60
-            DrawLine(topLeft + DrawPoint(6, sizeY + 2), topLeft + DrawPoint(6, sizeY + 4), 1,
-                     MakeColor(255, 88, 44, 16));
+            graph_.addLine(topLeft + DrawPoint(6, sizeY + 2), topLeft + DrawPoint(6, sizeY + 4), 1, axisColor);
             timeAnnotations[0]->SetPos(topLeftRel + DrawPoint(6, sizeY + 6));
             timeAnnotations[0]->SetText("-60");
             timeAnnotations[0]->SetVisible(true);
 
             // -50
-            DrawLine(topLeft + DrawPoint(35, sizeY + 2), topLeft + DrawPoint(35, sizeY + 4), 1,
-                     MakeColor(255, 88, 44, 16));
+            graph_.addLine(topLeft + DrawPoint(35, sizeY + 2), topLeft + DrawPoint(35, sizeY + 4), 1, axisColor);
             timeAnnotations[1]->SetPos(topLeftRel + DrawPoint(35, sizeY + 6));
             timeAnnotations[1]->SetText("-50");
             timeAnnotations[1]->SetVisible(true);
 
             // -40
-            DrawLine(topLeft + DrawPoint(64, sizeY + 2), topLeft + DrawPoint(64, sizeY + 4), 1,
-                     MakeColor(255, 88, 44, 16));
+            graph_.addLine(topLeft + DrawPoint(64, sizeY + 2), topLeft + DrawPoint(64, sizeY + 4), 1, axisColor);
             timeAnnotations[2]->SetPos(topLeftRel + DrawPoint(64, sizeY + 6));
             timeAnnotations[2]->SetText("-40");
             timeAnnotations[2]->SetVisible(true);
 
             // -30
-            DrawLine(topLeft + DrawPoint(93, sizeY + 2), topLeft + DrawPoint(93, sizeY + 4), 1,
-                     MakeColor(255, 88, 44, 16));
+            graph_.addLine(topLeft + DrawPoint(93, sizeY + 2), topLeft + DrawPoint(93, sizeY + 4), 1, axisColor);
             timeAnnotations[3]->SetPos(topLeftRel + DrawPoint(93, sizeY + 6));
             timeAnnotations[3]->SetText("-30");
             timeAnnotations[3]->SetVisible(true);
 
             // -20
-            DrawLine(topLeft + DrawPoint(122, sizeY + 2), topLeft + DrawPoint(122, sizeY + 4), 1,
-                     MakeColor(255, 88, 44, 16));
+            graph_.addLine(topLeft + DrawPoint(122, sizeY + 2), topLeft + DrawPoint(122, sizeY + 4), 1, axisColor);
             timeAnnotations[4]->SetPos(topLeftRel + DrawPoint(122, sizeY + 6));
             timeAnnotations[4]->SetText("-20");
             timeAnnotations[4]->SetVisible(true);
 
             // -10
-            DrawLine(topLeft + DrawPoint(151, sizeY + 2), topLeft + DrawPoint(151, sizeY + 4), 1,
-                     MakeColor(255, 88, 44, 16));
+            graph_.addLine(topLeft + DrawPoint(151, sizeY + 2), topLeft + DrawPoint(151, sizeY + 4), 1, axisColor);
             timeAnnotations[5]->SetPos(topLeftRel + DrawPoint(151, sizeY + 6));
             timeAnnotations[5]->SetText("-10");
             timeAnnotations[5]->SetVisible(true);
             break;
         case StatisticTime::T4Hours:
             // -240
-            DrawLine(topLeft + DrawPoint(6, sizeY + 2), topLeft + DrawPoint(6, sizeY + 4), 1,
-                     MakeColor(255, 88, 44, 16));
+            graph_.addLine(topLeft + DrawPoint(6, sizeY + 2), topLeft + DrawPoint(6, sizeY + 4), 1, axisColor);
             timeAnnotations[0]->SetPos(topLeftRel + DrawPoint(6, sizeY + 6));
             timeAnnotations[0]->SetText("-240");
             timeAnnotations[0]->SetVisible(true);
 
             // -180
-            DrawLine(topLeft + DrawPoint(49, sizeY + 2), topLeft + DrawPoint(49, sizeY + 4), 1,
-                     MakeColor(255, 88, 44, 16));
+            graph_.addLine(topLeft + DrawPoint(49, sizeY + 2), topLeft + DrawPoint(49, sizeY + 4), 1, axisColor);
             timeAnnotations[1]->SetPos(topLeftRel + DrawPoint(49, sizeY + 6));
             timeAnnotations[1]->SetText("-180");
             timeAnnotations[1]->SetVisible(true);
 
             // -120
-            DrawLine(topLeft + DrawPoint(93, sizeY + 2), topLeft + DrawPoint(93, sizeY + 4), 1,
-                     MakeColor(255, 88, 44, 16));
+            graph_.addLine(topLeft + DrawPoint(93, sizeY + 2), topLeft + DrawPoint(93, sizeY + 4), 1, axisColor);
             timeAnnotations[2]->SetPos(topLeftRel + DrawPoint(93, sizeY + 6));
             timeAnnotations[2]->SetText("-120");
             timeAnnotations[2]->SetVisible(true);
 
             // -60
-            DrawLine(topLeft + DrawPoint(136, sizeY + 2), topLeft + DrawPoint(136, sizeY + 4), 1,
-                     MakeColor(255, 88, 44, 16));
+            graph_.addLine(topLeft + DrawPoint(136, sizeY + 2), topLeft + DrawPoint(136, sizeY + 4), 1, axisColor);
             timeAnnotations[3]->SetPos(topLeftRel + DrawPoint(136, sizeY + 6));
             timeAnnotations[3]->SetText("-60");
             timeAnnotations[3]->SetVisible(true);
@@ -487,29 +503,25 @@ void iwStatistics::DrawAxis()
             break;
         case StatisticTime::T16Hours:
             // -960
-            DrawLine(topLeft + DrawPoint(6, sizeY + 2), topLeft + DrawPoint(6, sizeY + 4), 1,
-                     MakeColor(255, 88, 44, 16));
+            graph_.addLine(topLeft + DrawPoint(6, sizeY + 2), topLeft + DrawPoint(6, sizeY + 4), 1, axisColor);
             timeAnnotations[0]->SetPos(topLeftRel + DrawPoint(6, sizeY + 6));
             timeAnnotations[0]->SetText("-960");
             timeAnnotations[0]->SetVisible(true);
 
             // -720
-            DrawLine(topLeft + DrawPoint(49, sizeY + 2), topLeft + DrawPoint(49, sizeY + 4), 1,
-                     MakeColor(255, 88, 44, 16));
+            graph_.addLine(topLeft + DrawPoint(49, sizeY + 2), topLeft + DrawPoint(49, sizeY + 4), 1, axisColor);
             timeAnnotations[1]->SetPos(topLeftRel + DrawPoint(49, sizeY + 6));
             timeAnnotations[1]->SetText("-720");
             timeAnnotations[1]->SetVisible(true);
 
             // -480
-            DrawLine(topLeft + DrawPoint(93, sizeY + 2), topLeft + DrawPoint(93, sizeY + 4), 1,
-                     MakeColor(255, 88, 44, 16));
+            graph_.addLine(topLeft + DrawPoint(93, sizeY + 2), topLeft + DrawPoint(93, sizeY + 4), 1, axisColor);
             timeAnnotations[2]->SetPos(topLeftRel + DrawPoint(93, sizeY + 6));
             timeAnnotations[2]->SetText("-480");
             timeAnnotations[2]->SetVisible(true);
 
             // -240
-            DrawLine(topLeft + DrawPoint(136, sizeY + 2), topLeft + DrawPoint(136, sizeY + 4), 1,
-                     MakeColor(255, 88, 44, 16));
+            graph_.addLine(topLeft + DrawPoint(136, sizeY + 2), topLeft + DrawPoint(136, sizeY + 4), 1, axisColor);
             timeAnnotations[3]->SetPos(topLeftRel + DrawPoint(136, sizeY + 6));
             timeAnnotations[3]->SetText("-240");
             timeAnnotations[3]->SetVisible(true);
@@ -5,7 +5,10 @@
 #pragma once
 
 #include "IngameWindow.h"
+#include "ogl/DrawList.h"
 #include "gameTypes/StatisticTypes.h"
+#include <cstdint>
+#include <vector>
 
 class ctrlText;
 class GameWorldViewer;
@@ -27,10 +30,16 @@ private:
     std::vector<ctrlText*> timeAnnotations;
     std::vector<bool> activePlayers;
     unsigned numPlayingPlayers;
+    /// Axis, player boxes and statistic lines relative to the window position
+    DrawList graph_;
+    /// Values the graph was created from and buffer for the current values
+    std::vector<uint32_t> shownData_, curData_;
 
     void Msg_ButtonClick(unsigned ctrl_id) override;
     void Draw_() override;
     void Msg_OptionGroupChange(unsigned ctrl_id, unsigned selection) override;
+    /// Return true if the shown values changed and the graph must be recreated
+    bool UpdateShownData();
     void DrawStatistic(StatisticType type);
     void DrawAxis();
 };
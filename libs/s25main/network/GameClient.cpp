@@ -21,6 +21,7 @@
 #include "SerializedGameData.h"
 #include "Settings.h"
 #include "ai/AIPlayer.h"
+#include "ai/aijh/AIPlayerJH.h"
 #include "drivers/VideoDriverWrapper.h"
 #include "factories/AIFactory.h"
 #include "files.h"
@@ -31,6 +32,8 @@
 #include "network/ClientInterface.h"
 #include "network/GameMessages.h"
 #include "network/GameServer.h"
+#include "network/MapCache.h"
+#include "network/MemoryConnection.h"
 #include "ogl/FontStyle.h"
 #include "ogl/glArchivItem_Bitmap.h"
 #include "ogl/glFont.h"
@@ -50,10 +53,29 @@
 #include "s25util/fileFuncs.h"
 #include "s25util/strFuncs.h"
 #include "s25util/utf8.h"
+#include "s25util/tmpFile.h"
 #include <boost/filesystem.hpp>
 #include <helpers/chronoIO.h>
 #include <memory>
 
+namespace {
+MapCache getMapCache()
+{
+    return MapCache(RTTRCONFIG.ExpandPath(s25::folders::mapsCache));
+}
+
+/// Mond malen to show that loading or saving is in progress. Skipped when running without a window, e.g. in tests
+void drawMoon()
+{
+    if(!VIDEODRIVER.IsLoaded())
+        return;
+    Position moonPos = VIDEODRIVER.GetMousePos();
+    moonPos.y -= 40;
+    LOADER.GetImageN("resource", 33)->DrawFull(moonPos);
+    VIDEODRIVER.SwapBuffers();
+}
+} // namespace
+
 void GameClient::ClientConfig::Clear()
 {
     server.clear();
@@ -102,14 +124,44 @@ bool GameClient::Connect(const std::string& server, const std::string& password,
         return false;
     }
 
+    OnConnected();
+    return true;
+}
+
+bool GameClient::ConnectLocal(std::shared_ptr<MemoryConnection> connection, const std::string& password,
+                              ServerType servertyp, bool host)
+{
+    Stop();
+
+    clientconfig.password = password;
+    clientconfig.servertyp = servertyp;
+    clientconfig.isHost = host;
+
+    mainPlayer.setMemoryConnection(std::move(connection));
+    OnConnected();
+    return true;
+}
+
+void GameClient::OnConnected()
+{
     state = ClientState::Connect;
+    // A running game only lets us in again with the token of the player we were
+    if(!rejoinInfo_.token.empty() && rejoinInfo_.server == clientconfig.server && rejoinInfo_.port == clientconfig.port)
+        mainPlayer.sendMsgAsync(new GameMessage_RejoinToken(rejoinInfo_.token));
 
     if(ci)
         ci->CI_NextConnectState(ConnectState::WaitForAnswer);
 
     // Es wird kein Replay abgespielt, sondern dies ist ein richtiges Spiel
     replayMode = false;
+}
 
+bool GameClient::Spectate(const std::string& server, unsigned short port, bool use_ipv6)
+{
+    // Relays accept spectators regardless of the type of the game
+    if(!Connect(server, "", ServerType::Direct, port, false, use_ipv6))
+        return false;
+    isSpectating_ = true;
     return true;
 }
 
@@ -128,37 +180,52 @@ void GameClient::Run()
     if(state == ClientState::Stopped)
         return;
 
-    SocketSet set;
-
-    // erstmal auf Daten überprüfen
-    set.Clear();
+    // Multiple games might be run in this thread, e.g. in tests
+    boost::optional<GameContextScope> contextScope;
+    if(game)
+        contextScope.emplace(game->context_);
 
-    // zum set hinzufügen
-    set.Add(mainPlayer.socket);
-    if(set.Select(0, 0) > 0)
+    if(mainPlayer.hasMemoryConnection())
     {
-        // nachricht empfangen
-        if(!mainPlayer.receiveMsgs())
+        if(mainPlayer.hasReceivedData() && !mainPlayer.receiveMsgs())
         {
-            LOG.write("Receiving Message from server failed\n");
+            LOG.write("Connection to server lost\n");
             ServerLost();
         }
-    }
+    } else
+    {
+        SocketSet set;
 
-    // nun auf Fehler prüfen
-    set.Clear();
+        // erstmal auf Daten überprüfen
+        set.Clear();
 
-    // zum set hinzufügen
-    set.Add(mainPlayer.socket);
+        // zum set hinzufügen
+        set.Add(mainPlayer.socket);
+        if(set.Select(0, 0) > 0)
+        {
+            // nachricht empfangen
+            if(!mainPlayer.receiveMsgs())
+            {
+                LOG.write("Receiving Message from server failed\n");
+                ServerLost();
+            }
+        }
 
-    // auf fehler prüfen
-    if(set.Select(0, 2) > 0)
-    {
-        if(set.InSet(mainPlayer.socket))
+        // nun auf Fehler prüfen
+        set.Clear();
+
+        // zum set hinzufügen
+        set.Add(mainPlayer.socket);
+
+        // auf fehler prüfen
+        if(set.Select(0, 2) > 0)
         {
-            // Server ist weg
-            LOG.write("Error on socket to server\n");
-            ServerLost();
+            if(set.InSet(mainPlayer.socket))
+            {
+                // Server ist weg
+                LOG.write("Error on socket to server\n");
+                ServerLost();
+            }
         }
     }
 
@@ -168,7 +235,12 @@ void GameClient::Run()
         if(nwfInfo->isReady())
             OnGameStart();
     } else if(state == ClientState::Game)
-        ExecuteGameFrame();
+    {
+        if(isCatchingUp_)
+            CatchUp();
+        else
+            ExecuteGameFrame();
+    }
 
     // maximal 10 Pakete verschicken
     mainPlayer.sendMsgs(10);
@@ -192,6 +264,15 @@ void GameClient::Stop()
     if(IsHost())
         GAMESERVER.Stop();
 
+    // Keep the data received so far to continue the transfer when connecting again
+    if(state == ClientState::Connect && mapTransfer_)
+    {
+        MapCache mapCache = getMapCache();
+        mapCache.storePartial(mapTransfer_->mapHash, mapinfo.mapData.data, mapTransfer_->numMapBytes);
+        mapCache.storePartial(mapTransfer_->luaHash, mapinfo.luaData.data, mapTransfer_->numLuaBytes);
+    }
+    mapTransfer_.reset();
+
     framesinfo.Clear();
     clientconfig.Clear();
     mapinfo.Clear();
@@ -208,6 +289,8 @@ void GameClient::Stop()
 
     // clear jump target
     skiptogf = 0;
+    resyncNWF_ = 0;
+    isResyncing_ = isCatchingUp_ = isSpectating_ = false;
 
     // Consistency check: No game, no lobby remaining
     RTTR_Assert(!game);
@@ -240,11 +323,7 @@ void GameClient::StartGame(const unsigned random_init)
 {
     RTTR_Assert(state == ClientState::Config || (state == ClientState::Stopped && replayMode));
 
-    // Mond malen
-    Position moonPos = VIDEODRIVER.GetMousePos();
-    moonPos.y -= 40;
-    LOADER.GetImageN("resource", 33)->DrawFull(moonPos);
-    VIDEODRIVER.SwapBuffers();
+    drawMoon();
 
     // Start in pause mode
     framesinfo.isPaused = true;
@@ -253,9 +332,6 @@ void GameClient::StartGame(const unsigned random_init)
     framesinfo.gf_length = SPEED_GF_LENGTHS[gameLobby->getSettings().speed];
     framesinfo.gfLengthReq = framesinfo.gf_length;
 
-    // Random-Generator initialisieren
-    RANDOM.Init(random_init);
-
     if(!IsReplayModeOn() && mapinfo.savegame && !mapinfo.savegame->Load(mapinfo.filepath, SaveGameDataToLoad::All))
     {
         OnError(ClientError::InvalidMap);
@@ -268,6 +344,9 @@ void GameClient::StartGame(const unsigned random_init)
     game =
       std::make_shared<Game>(std::move(gameLobby->getSettings()), startGF,
                              std::vector<PlayerInfo>(gameLobby->getPlayers().begin(), gameLobby->getPlayers().end()));
+    // Random-Generator initialisieren. Belongs to the context of the game, so do this after creating it
+    RANDOM.SetHistorySize(SETTINGS.global.asyncLogDepth);
+    RANDOM.Init(random_init);
     if(!IsReplayModeOn())
     {
         for(unsigned id = 0; id < gameLobby->getNumPlayers(); id++)
@@ -311,7 +390,8 @@ void GameClient::StartGame(const unsigned random_init)
     // Update visual settings
     ResetVisualSettings();
 
-    if(!replayMode)
+    // The replay would need to start at the beginning of the game
+    if(!replayMode && !isResyncing_)
     {
         RTTR_Assert(!replayinfo);
         StartReplayRecording(random_init);
@@ -329,7 +409,7 @@ void GameClient::GameLoaded()
 
     if(replayMode)
         OnGameStart();
-    else
+    else if(!isResyncing_ && !isSpectating_)
     {
         // Notify server that we are ready
         if(IsHost())
@@ -405,6 +485,14 @@ bool GameClient::OnGameMessage(const GameMessage_Player_List& msg)
 
     for(unsigned i = 0; i < gameLobby->getNumPlayers(); ++i)
         gameLobby->getPlayer(i) = msg.playerInfos[i];
+    // Spectators watch from the view of the first player
+    if(isSpectating_ && state == ClientState::Connect)
+    {
+        const auto itPlayer =
+          helpers::find_if(msg.playerInfos, [](const JoinPlayerInfo& info) { return info.isUsed(); });
+        if(itPlayer != msg.playerInfos.end())
+            mainPlayer.playerId = static_cast<unsigned>(itPlayer - msg.playerInfos.begin());
+    }
 
     if(state != ClientState::Config)
     {
@@ -432,6 +520,29 @@ bool GameClient::OnGameMessage(const GameMessage_Player_Name& msg)
 /// @param message  Nachricht, welche ausgeführt wird
 bool GameClient::OnGameMessage(const GameMessage_Player_New& msg)
 {
+    if(state == ClientState::Loading || state == ClientState::Loaded || state == ClientState::Game)
+    {
+        // A player rejoined the game and takes over from the AI
+        if(msg.player >= GetNumPlayers())
+            return true;
+        GamePlayer& player = GetPlayer(msg.player);
+        player.ps = PlayerState::Occupied;
+        if(IsHost())
+        {
+            auto it = helpers::find_if(game->aiPlayers_,
+                                       [id = msg.player](const auto& ai) { return ai.GetPlayerId() == id; });
+            if(it != game->aiPlayers_.end())
+                game->aiPlayers_.erase(it);
+        }
+        if(msg.player == GetPlayerId() && !isSpectating_)
+        {
+            isResyncing_ = false;
+            SystemChat(_("You rejoined the game."));
+        }
+        if(ci)
+            ci->CI_NewPlayer(msg.player);
+        return true;
+    }
     if(state != ClientState::Config)
         return true;
 
@@ -668,6 +779,15 @@ bool GameClient::OnGameMessage(const GameMessage_Server_TypeOK& msg)
         break;
     }
 
+    if(isSpectating_)
+    {
+        // Spectators go straight to the map
+        mainPlayer.sendMsgAsync(new GameMessage_MapRequest(true));
+        if(ci)
+            ci->CI_NextConnectState(ConnectState::QueryMapName);
+        return true;
+    }
+
     mainPlayer.sendMsgAsync(new GameMessage_Server_Password(clientconfig.password));
 
     if(ci)
@@ -733,6 +853,57 @@ bool GameClient::OnGameMessage(const GameMessage_Server_Start& msg)
     return true;
 }
 
+bool GameClient::OnGameMessage(const GameMessage_ResyncRequest& msg)
+{
+    if(state != ClientState::Game || replayMode)
+        return true;
+    // The NWF can't be executed yet as the server did not send it
+    RTTR_Assert(GetGFNumber() <= msg.nwf);
+    resyncNWF_ = msg.nwf;
+    return true;
+}
+
+bool GameClient::OnGameMessage(const GameMessage_RejoinToken& msg)
+{
+    if(state == ClientState::Stopped || replayMode)
+        return true;
+    rejoinInfo_.server = clientconfig.server;
+    rejoinInfo_.port = clientconfig.port;
+    rejoinInfo_.token = msg.token;
+    return true;
+}
+
+/**
+ *  Rejoin a running game. The received savegame is the state at the given NWF
+ */
+bool GameClient::OnGameMessage(const GameMessage_Server_Resync& msg)
+{
+    if(state != ClientState::Config || mapinfo.type != MapType::Savegame)
+        return true;
+
+    nwfInfo = std::make_shared<NWFInfo>();
+    nwfInfo->init(msg.nwf, msg.cmdDelay, msg.numNWFs);
+    isResyncing_ = isCatchingUp_ = true;
+    try
+    {
+        StartGame(0);
+    } catch(SerializedGameData::Error& error)
+    {
+        LOG.write("Error when loading game: %s\n") % error.what();
+        Stop();
+        GAMEMANAGER.ShowMenu();
+        return true;
+    }
+    if(state != ClientState::Loading)
+        return true;
+    // Not contained in the savegame
+    RANDOM.ResetState(msg.rngState);
+    framesinfo.gf_length = framesinfo.gfLengthReq = FramesInfo::milliseconds32_t(msg.gfLength);
+    framesinfo.nwf_length = msg.nwfLength;
+    LOG.write("Rejoining the game at GF %1%\n") % msg.nwf;
+    return true;
+}
+
 /**
  *  Server-Chat-Nachricht.
  */
@@ -824,8 +995,9 @@ bool GameClient::OnGameMessage(const GameMessage_Server_Async& msg)
 
     const bfs::path filePathSave = RTTRCONFIG.ExpandPath(s25::folders::save) / makePortableFileName(fileName + ".sav");
     const bfs::path filePathLog =
-      RTTRCONFIG.ExpandPath(s25::folders::logs) / makePortableFileName(fileName + "Player.log");
-    saveRandomLog(filePathLog, RANDOM.GetAsyncLog());
+      RTTRCONFIG.ExpandPath(s25::folders::logs) / makePortableFileName(fileName + "Player.rnglog");
+    // Binary to keep it small even for deep histories. Print it with `s25client --print-random-log <file>`
+    saveRandomLogBinary(filePathLog, RANDOM.GetAsyncLog());
     SaveToFile(filePathSave);
     LOG.write(_("Async log saved at %1%,\ngame saved at %2%\n")) % filePathLog % filePathSave;
     return true;
@@ -882,58 +1054,85 @@ bool GameClient::OnGameMessage(const GameMessage_Map_Info& msg)
     else
         mapinfo.luaFilepath.clear();
 
-    if(bfs::exists(mapinfo.filepath) && (mapinfo.luaFilepath.empty() || bfs::exists(mapinfo.luaFilepath))
-       && CreateLobby())
+    mapTransfer_ = MapTransfer{msg.mapHash, msg.luaHash, 0, 0, 0};
+    if(UseExistingMapFiles(msg))
+        return true;
+    // The same map might have been received before under a different name
+    MapCache mapCache = getMapCache();
+    if(mapCache.restore(msg.mapHash, msg.mapLen, mapinfo.filepath)
+       && (mapinfo.luaFilepath.empty() || mapCache.restore(msg.luaHash, msg.luaLen, mapinfo.luaFilepath))
+       && UseExistingMapFiles(msg))
     {
-        mapinfo.mapData.CompressFromFile(mapinfo.filepath, &mapinfo.mapChecksum);
-        if(mapinfo.mapData.data.size() == msg.mapCompressedLen && mapinfo.mapData.uncompressedLength == msg.mapLen)
-        {
-            bool ok = true;
-            if(!mapinfo.luaFilepath.empty())
-            {
-                mapinfo.luaData.CompressFromFile(mapinfo.luaFilepath, &mapinfo.luaChecksum);
-                ok = (mapinfo.luaData.data.size() == msg.luaCompressedLen
-                      && mapinfo.luaData.uncompressedLength == msg.luaLen);
-            }
-
-            if(ok)
-            {
-                mainPlayer.sendMsgAsync(new GameMessage_Map_Checksum(mapinfo.mapChecksum, mapinfo.luaChecksum));
-                return true;
-            }
-        }
-        gameLobby.reset();
+        LOG.write("Using cached map for %1%\n") % mapinfo.filepath;
+        return true;
     }
     mapinfo.mapData.uncompressedLength = msg.mapLen;
     mapinfo.luaData.uncompressedLength = msg.luaLen;
     mapinfo.mapData.data.resize(msg.mapCompressedLen);
     mapinfo.luaData.data.resize(msg.luaCompressedLen);
-    mainPlayer.sendMsgAsync(new GameMessage_MapRequest(false));
+    // Continue an interrupted transfer of the same data
+    mapTransfer_->numMapBytes = mapCache.loadPartial(msg.mapHash, mapinfo.mapData.data);
+    mapTransfer_->numLuaBytes = mapCache.loadPartial(msg.luaHash, mapinfo.luaData.data);
+    mainPlayer.sendMsgAsync(new GameMessage_MapRequest(false, mapTransfer_->numMapBytes, mapTransfer_->numLuaBytes));
     return true;
 }
 
+bool GameClient::UseExistingMapFiles(const GameMessage_Map_Info& msg)
+{
+    if(!bfs::exists(mapinfo.filepath) || (!mapinfo.luaFilepath.empty() && !bfs::exists(mapinfo.luaFilepath))
+       || !CreateLobby())
+        return false;
+    mapinfo.mapData.CompressFromFile(mapinfo.filepath, &mapinfo.mapChecksum);
+    if(mapinfo.mapData.data.size() == msg.mapCompressedLen && mapinfo.mapData.uncompressedLength == msg.mapLen)
+    {
+        bool ok = true;
+        if(!mapinfo.luaFilepath.empty())
+        {
+            mapinfo.luaData.CompressFromFile(mapinfo.luaFilepath, &mapinfo.luaChecksum);
+            ok = (mapinfo.luaData.data.size() == msg.luaCompressedLen
+                  && mapinfo.luaData.uncompressedLength == msg.luaLen);
+        }
+
+        if(ok)
+        {
+            mainPlayer.sendMsgAsync(new GameMessage_Map_Checksum(mapinfo.mapChecksum, mapinfo.luaChecksum));
+            return true;
+        }
+    }
+    gameLobby.reset();
+    return false;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 /// Kartendaten
 /// @param message  Nachricht, welche ausgeführt wird
 bool GameClient::OnGameMessage(const GameMessage_Map_Data& msg)
 {
-    if(state != ClientState::Connect)
+    if(state != ClientState::Connect || !mapTransfer_)
         return true;
 
     LOG.writeToFile("<<< NMS_MAP_DATA(%u)\n") % msg.data.size();
-    if(msg.isMapData)
-        std::copy(msg.data.begin(), msg.data.end(), mapinfo.mapData.data.begin() + msg.offset);
-    else
-        std::copy(msg.data.begin(), msg.data.end(), mapinfo.luaData.data.begin() + msg.offset);
-
-    const unsigned curSize = msg.offset + msg.data.size();
-    bool isCompleted;
-    if(msg.isMapData)
-        isCompleted = mapinfo.luaFilepath.empty() && curSize == mapinfo.mapData.data.size();
-    else
-        isCompleted = curSize == mapinfo.luaData.data.size();
+    std::vector<char>& data = msg.isMapData ? mapinfo.mapData.data : mapinfo.luaData.data;
+    unsigned& numBytes = msg.isMapData ? mapTransfer_->numMapBytes : mapTransfer_->numLuaBytes;
+    // The parts of the map and the lua script are each sent in order
+    if(msg.offset != numBytes || msg.data.size() > data.size() - numBytes)
+    {
+        OnError(ClientError::MapTransmission);
+        return true;
+    }
+    std::copy(msg.data.begin(), msg.data.end(), data.begin() + msg.offset);
+    numBytes += msg.data.size();
 
-    if(isCompleted)
+    if(mapTransfer_->numMapBytes < mapinfo.mapData.data.size()
+       || mapTransfer_->numLuaBytes < mapinfo.luaData.data.size())
+    {
+        // Let the server send more
+        if(++mapTransfer_->numUnackedParts >= MAP_ACK_INTERVAL)
+        {
+            mainPlayer.sendMsgAsync(new GameMessage_Map_DataAck(mapTransfer_->numMapBytes + mapTransfer_->numLuaBytes));
+            mapTransfer_->numUnackedParts = 0;
+        }
+    } else
     {
         if(!mapinfo.mapData.DecompressToFile(mapinfo.filepath, &mapinfo.mapChecksum))
         {
@@ -947,6 +1146,14 @@ bool GameClient::OnGameMessage(const GameMessage_Map_Data& msg)
         }
         RTTR_Assert(!mapinfo.luaFilepath.empty() || mapinfo.luaChecksum == 0);
 
+        MapCache mapCache = getMapCache();
+        mapCache.removePartial(mapTransfer_->mapHash, mapinfo.mapData.data.size());
+        mapCache.removePartial(mapTransfer_->luaHash, mapinfo.luaData.data.size());
+        // Stored by the hash of the received content, so a wrongly announced hash can't poison the cache
+        mapCache.add(mapinfo.filepath);
+        if(!mapinfo.luaFilepath.empty())
+            mapCache.add(mapinfo.luaFilepath);
+
         if(!CreateLobby())
         {
             OnError(ClientError::MapTransmission);
@@ -1027,9 +1234,12 @@ bool GameClient::OnGameMessage(const GameMessage_Map_ChecksumOK& msg)
     if(!msg.correct)
     {
         gameLobby.reset();
-        if(msg.retryAllowed)
+        if(msg.retryAllowed && mapTransfer_)
+        {
+            // Transfer everything again
+            mapTransfer_->numMapBytes = mapTransfer_->numLuaBytes = mapTransfer_->numUnackedParts = 0;
             mainPlayer.sendMsgAsync(new GameMessage_MapRequest(false));
-        else
+        } else
             OnError(ClientError::MapTransmission);
     }
     return true;
@@ -1068,10 +1278,14 @@ bool GameClient::OnGameMessage(const GameMessage_GameCommand& msg)
 {
     if(nwfInfo)
     {
-        if(!nwfInfo->addPlayerCmds(msg.player, msg.cmds))
+        for(const GameMessage_GameCommand::PlayerCmds& playerCmds : msg.playerCmds)
         {
-            LOG.write("Could not add gamecommands for player %1%. He might be cheating!\n") % unsigned(msg.player);
-            RTTR_Assert(false);
+            if(!nwfInfo->addPlayerCmds(playerCmds.player, playerCmds.cmds))
+            {
+                LOG.write("Could not add gamecommands for player %1%. He might be cheating!\n")
+                  % unsigned(playerCmds.player);
+                RTTR_Assert(false);
+            }
         }
     }
     return true;
@@ -1248,11 +1462,20 @@ void GameClient::ExecuteGameFrame()
                         // Do not reset frameTime or lastTime as this will mess up interpolation for drawing
                         framesinfo.forcePauseStart = currentTime;
                         framesinfo.forcePauseLen = (rand() * 4 * framesinfo.gf_length) / RAND_MAX;
+                        ++framesinfo.numForcePauses;
+                        framesinfo.sumForcePauseLen += framesinfo.forcePauseLen;
                         return;
                     }
 
                     RTTR_Assert(nwfInfo->getServerInfo().gf == curGF);
 
+                    // Snapshot must be taken before any command of this NWF is executed
+                    if(resyncNWF_ == curGF)
+                    {
+                        SendResyncSnapshot();
+                        resyncNWF_ = 0;
+                    }
+
                     ExecuteNWF();
 
                     FramesInfo::milliseconds32_t oldGFLen = framesinfo.gf_length;
@@ -1267,7 +1490,8 @@ void GameClient::ExecuteGameFrame()
 
                 NextGF(isNWF);
                 RTTR_Assert(curGF <= nwfInfo->getNextNWF());
-                HandleAutosave();
+                if(!isCatchingUp_)
+                    HandleAutosave();
 
                 // GF-Ende im Replay aktualisieren
                 if(replayinfo && replayinfo->replay.IsRecording())
@@ -1311,6 +1535,29 @@ void GameClient::ExecuteGameFrame()
     RTTR_Assert(framesinfo.frameTime < framesinfo.gf_length);
 }
 
+void GameClient::CatchUp()
+{
+    // Execute GFs in chunks to keep the application responsive
+    const auto endTime = FramesInfo::UsedClock::now() + std::chrono::milliseconds(100);
+    while(state == ClientState::Game && !framesinfo.isPaused && FramesInfo::UsedClock::now() < endTime)
+    {
+        const unsigned curGF = GetGFNumber();
+        if(curGF == nwfInfo->getNextNWF() && !nwfInfo->isReady())
+        {
+            // Reached the others. Continue in realtime and send own commands from now on
+            isCatchingUp_ = false;
+            skiptogf = 0;
+            framesinfo.lastTime = FramesInfo::UsedClock::now();
+            if(!isSpectating_)
+                mainPlayer.sendMsgAsync(new GameMessage_ResyncDone(nwfInfo->getNumExecutedNWFs()));
+            LOG.write("Caught up with the game at GF %1%\n") % curGF;
+            return;
+        }
+        skiptogf = curGF + 1;
+        ExecuteGameFrame();
+    }
+}
+
 void GameClient::HandleAutosave()
 {
     // If inactive or during replay -> no autosave
@@ -1362,7 +1609,8 @@ void GameClient::OnGameStart()
 {
     if(state == ClientState::Loaded)
     {
-        GAMEMANAGER.ResetAverageGFPS();
+        if(GameManager* gameManager = tryGetGlobalGameManager())
+            gameManager->ResetAverageGFPS();
         framesinfo.lastTime = FramesInfo::UsedClock::now();
         state = ClientState::Game;
         if(ci)
@@ -1602,12 +1850,20 @@ bool GameClient::SaveToFile(const boost::filesystem::path& filepath)
 {
     mainPlayer.sendMsg(GameMessage_Chat(GetPlayerId(), ChatDestination::System, "Saving game..."));
 
-    // Mond malen
-    Position moonPos = VIDEODRIVER.GetMousePos();
-    moonPos.y -= 40;
-    LOADER.GetImageN("resource", 33)->DrawFull(moonPos);
-    VIDEODRIVER.SwapBuffers();
+    drawMoon();
+
+    try
+    {
+        return WriteSavegame(filepath);
+    } catch(std::exception& e)
+    {
+        SystemChat(std::string("Error during saving: ") + e.what());
+        return false;
+    }
+}
 
+bool GameClient::WriteSavegame(const boost::filesystem::path& filepath)
+{
     Savegame save;
 
     WritePlayerInfo(save);
@@ -1620,16 +1876,34 @@ bool GameClient::SaveToFile(const boost::filesystem::path& filepath)
     // Enable/Disable debugging of savegames
     save.sgd.debugMode = SETTINGS.global.debugMode;
 
+    // Spiel serialisieren
+    save.sgd.MakeSnapshot(*game);
+    // Und alles speichern
+    return save.Save(filepath, mapinfo.title);
+}
+
+void GameClient::SendResyncSnapshot()
+{
+    CompressedData snapshot;
+    unsigned checksum = 0;
     try
     {
-        // Spiel serialisieren
-        save.sgd.MakeSnapshot(*game);
-        // Und alles speichern
-        return save.Save(filepath, mapinfo.title);
+        TmpFile tmpFile(".sav");
+        tmpFile.close();
+        if(!WriteSavegame(tmpFile.filePath) || !snapshot.CompressFromFile(tmpFile.filePath, &checksum))
+            snapshot.Clear();
     } catch(std::exception& e)
     {
-        SystemChat(std::string("Error during saving: ") + e.what());
-        return false;
+        LOG.write("Failed to create the snapshot for a rejoining player: %1%\n") % e.what();
+        snapshot.Clear();
+    }
+    // An empty snapshot tells the server about the failure
+    mainPlayer.sendMsgAsync(new GameMessage_Resync_Info(resyncNWF_, checksum, snapshot.uncompressedLength,
+                                                        snapshot.data.size(), RANDOM.GetCurrentState()));
+    for(unsigned curPos = 0; curPos < snapshot.data.size(); curPos += MAP_PART_SIZE)
+    {
+        const unsigned chunkSize = std::min<unsigned>(MAP_PART_SIZE, snapshot.data.size() - curPos);
+        mainPlayer.sendMsgAsync(new GameMessage_Map_Data(true, curPos, &snapshot.data[curPos], chunkSize));
     }
 }
 
@@ -1680,8 +1954,9 @@ unsigned GameClient::GetLastReplayGF() const
 
 bool GameClient::AddGC(gc::GameCommandPtr gc)
 {
-    // Nicht in der Pause oder wenn er besiegt wurde
-    if(framesinfo.isPaused || GetPlayer(GetPlayerId()).IsDefeated() || IsReplayModeOn())
+    // Nicht in der Pause oder wenn er besiegt wurde. After rejoining only when controlling the player again
+    if(framesinfo.isPaused || GetPlayer(GetPlayerId()).IsDefeated() || IsReplayModeOn() || isResyncing_
+       || isSpectating_)
         return false;
 
     gameCommands_.push_back(gc);
@@ -1703,7 +1978,10 @@ GamePlayer& GameClient::GetPlayer(const unsigned id)
 
 std::unique_ptr<AIPlayer> GameClient::CreateAIPlayer(unsigned playerId, const AI::Info& aiInfo)
 {
-    return AIFactory::Create(aiInfo, playerId, game->world_);
+    auto ai = AIFactory::Create(aiInfo, playerId, game->world_);
+    if(auto* aijh = dynamic_cast<AIJH::AIPlayerJH*>(ai.get()))
+        aijh->GetScheduler().setBudget(std::chrono::microseconds(SETTINGS.global.aiTimeBudget));
+    return ai;
 }
 
 /// Wandelt eine GF-Angabe in eine Zeitangabe um (HH:MM:SS oder MM:SS wenn Stunden = 0)
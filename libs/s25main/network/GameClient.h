@@ -18,6 +18,7 @@
 #include "gameTypes/TeamTypes.h"
 #include "gameTypes/VisualSettings.h"
 #include "s25util/Singleton.h"
+#include <boost/optional.hpp>
 #include <memory>
 #include <vector>
 
@@ -33,6 +34,7 @@ class GameEvent;
 class GameLobby;
 class GameWorldView;
 class Game;
+class MemoryConnection;
 class Replay;
 struct PlayerGameCommands;
 class NWFInfo;
@@ -77,6 +79,11 @@ public:
 
     bool Connect(const std::string& server, const std::string& password, ServerType servertyp, unsigned short port,
                  bool host, bool use_ipv6);
+    /// Connect to a server in this process, e.g. to run several clients in tests
+    bool ConnectLocal(std::shared_ptr<MemoryConnection> connection, const std::string& password, ServerType servertyp,
+                      bool host);
+    /// Connect to a spectator relay to watch a running game
+    bool Spectate(const std::string& server, unsigned short port, bool use_ipv6);
     /// Start the server and connect to it
     bool HostGame(const CreateServerInfo& csi, const boost::filesystem::path& map_path, MapType map_type);
     void Run();
@@ -108,6 +115,7 @@ public:
     FramesInfo::milliseconds32_t GetGFLength() const { return framesinfo.gf_length; }
     unsigned GetNWFLength() const { return framesinfo.nwf_length; }
     FramesInfo::milliseconds32_t GetFrameTime() const { return framesinfo.frameTime; }
+    const FramesInfoClient& GetFramesInfo() const { return framesinfo; }
     unsigned GetGlobalAnimation(unsigned short max, unsigned char factor_numerator, unsigned char factor_denumerator,
                                 unsigned offset);
     unsigned Interpolate(unsigned max_val, const GameEvent* ev);
@@ -156,6 +164,10 @@ public:
 
     /// Spiel pausiert?
     bool IsPaused() const { return framesinfo.isPaused; }
+    /// Rejoined a running game and still executing the missed GFs?
+    bool IsCatchingUp() const { return isCatchingUp_; }
+    /// Only watching the game from the view of the first player without taking part
+    bool IsSpectating() const { return isSpectating_; }
     /// Schreibt Header der Save-Datei
     bool SaveToFile(const boost::filesystem::path& filepath);
     /// Visuelle Einstellungen aus den richtigen ableiten
@@ -192,6 +204,12 @@ private:
     void NextGF(bool wasNWF);
     /// Checks if its time for autosaving (if enabled) and does it
     void HandleAutosave();
+    /// Write the current game state to a savegame. Throws on error
+    bool WriteSavegame(const boost::filesystem::path& filepath);
+    /// Send the current game state to the server for a player rejoining the game
+    void SendResyncSnapshot();
+    /// Execute the GFs missed by a rejoining player as fast as possible
+    void CatchUp();
 
     //  Netzwerknachrichten
     RTTR_IGNORE_OVERLOADED_VIRTUAL
@@ -232,11 +250,20 @@ private:
     bool OnGameMessage(const GameMessage_RemoveLua& msg) override;
 
     bool OnGameMessage(const GameMessage_GetAsyncLog& msg) override;
+
+    bool OnGameMessage(const GameMessage_ResyncRequest& msg) override;
+    bool OnGameMessage(const GameMessage_Server_Resync& msg) override;
+    bool OnGameMessage(const GameMessage_RejoinToken& msg) override;
     RTTR_POP_DIAGNOSTIC
 
+    /// Set up the state after the connection to the server was established
+    void OnConnected();
     /// Report the error and stop
     void OnError(ClientError error);
     bool CreateLobby();
+    /// Use the map (and lua) files present locally if they match the map of the server.
+    /// Sends the checksum and returns true in that case
+    bool UseExistingMapFiles(const GameMessage_Map_Info& msg);
 
     /// Wird aufgerufen, wenn der Server gegangen ist (Verbindung verloren, ungültige Nachricht etc.)
     void ServerLost();
@@ -283,6 +310,18 @@ private:
 
     MapInfo mapinfo;
 
+    /// Progress of receiving the map from the server
+    struct MapTransfer
+    {
+        /// CRC32 announced by the server used to find the files and interrupted transfers in the map cache
+        uint32_t mapHash, luaHash;
+        /// Number of bytes received including the ones from an interrupted transfer
+        unsigned numMapBytes, numLuaBytes;
+        /// Number of parts received since the last acknowledgement
+        unsigned numUnackedParts;
+    };
+    boost::optional<MapTransfer> mapTransfer_;
+
     FramesInfoClient framesinfo;
 
     ClientInterface* ci;
@@ -292,6 +331,23 @@ private:
 
     std::unique_ptr<ReplayInfo> replayinfo;
     bool replayMode;
+
+    /// GF of the NWF at which the snapshot for a rejoining player is taken, 0 if none is requested
+    unsigned resyncNWF_ = 0;
+    /// Rejoined a running game and the own player is still controlled by an AI of the host
+    bool isResyncing_ = false;
+    /// Rejoined a running game and executing the GFs for which the commands are already known
+    bool isCatchingUp_ = false;
+    bool isSpectating_ = false;
+
+    /// Token of the last started game to take over the own player again after losing the connection.
+    /// Kept when the client is stopped
+    struct RejoinInfo
+    {
+        std::string server;
+        unsigned short port = 0;
+        std::string token;
+    } rejoinInfo_;
 };
 
 ///////////////////////////////////////////////////////////////////////////////
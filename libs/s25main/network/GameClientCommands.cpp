@@ -18,7 +18,7 @@
 void GameClient::Command_Chat(const std::string& text, const ChatDestination cd)
 {
     // Replaymodus oder kein Text --> nichts senden
-    if(IsReplayModeOn() || text.empty())
+    if(IsReplayModeOn() || IsSpectating() || text.empty())
         return;
 
     mainPlayer.sendMsgAsync(new GameMessage_Chat(0xff, cd, text));
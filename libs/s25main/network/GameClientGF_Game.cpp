@@ -34,19 +34,32 @@ void GameClient::ExecuteNWF()
         ExecuteAllGCs(player.id, currentGCs);
     }
 
-    // Send GC message for this NWF
+    // While catching up after rejoining our commands are still sent by the AI of the host.
+    // Spectators never send any
+    if(isCatchingUp_ || isSpectating_)
+    {
+        gameCommands_.clear();
+        return;
+    }
+
+    // Send the GCs of this NWF for us and all AIs in 1 message
     // First for all potential AIs as we need to combine the AI cmds of the local player with our own ones
+    std::vector<GameMessage_GameCommand::PlayerCmds> playerCmds;
     for(AIPlayer& ai : game->aiPlayers_)
     {
-        const std::vector<gc::GameCommandPtr> aiGCs = ai.FetchGameCommands();
+        std::vector<gc::GameCommandPtr> aiGCs = ai.FetchGameCommands();
         /// Cmds from own AI get added to our gcs
         if(ai.GetPlayerId() == GetPlayerId())
             gameCommands_.insert(gameCommands_.end(), aiGCs.begin(), aiGCs.end());
         else
-            mainPlayer.sendMsgAsync(new GameMessage_GameCommand(ai.GetPlayerId(), checksum, aiGCs));
+        {
+            playerCmds.push_back(GameMessage_GameCommand::PlayerCmds{static_cast<uint8_t>(ai.GetPlayerId()),
+                                                                      PlayerGameCommands(checksum, std::move(aiGCs))});
+        }
         for(auto& msg : ai.getAIInterface().FetchChatMessages())
             mainPlayer.sendMsgAsync(msg.release());
     }
-    mainPlayer.sendMsgAsync(new GameMessage_GameCommand(0xFF, checksum, gameCommands_));
+    playerCmds.push_back(GameMessage_GameCommand::PlayerCmds{0xFF, PlayerGameCommands(checksum, gameCommands_)});
+    mainPlayer.sendMsgAsync(new GameMessage_GameCommand(std::move(playerCmds)));
     gameCommands_.clear();
 }
@@ -50,6 +50,7 @@ Message* GameMessage::create_game(unsigned short id)
         case NMS_MAP_DATA: msg = new GameMessage_Map_Data(); break;
         case NMS_MAP_CHECKSUM: msg = new GameMessage_Map_Checksum(); break;
         case NMS_MAP_CHECKSUMOK: msg = new GameMessage_Map_ChecksumOK(); break;
+        case NMS_MAP_DATA_ACK: msg = new GameMessage_Map_DataAck(); break;
         case NMS_SERVER_NWF_DONE: msg = new GameMessage_Server_NWFDone(); break;
         case NMS_GAMECOMMANDS: msg = new GameMessage_GameCommand(); break;
         case NMS_PAUSE: msg = new GameMessage_Pause(); break;
@@ -59,11 +60,27 @@ Message* GameMessage::create_game(unsigned short id)
         case NMS_REMOVE_LUA: msg = new GameMessage_RemoveLua(); break;
         case NMS_GET_ASYNC_LOG: msg = new GameMessage_GetAsyncLog(); break;
         case NMS_ASYNC_LOG: msg = new GameMessage_AsyncLog(); break;
+        case NMS_RESYNC_REQUEST: msg = new GameMessage_ResyncRequest(); break;
+        case NMS_RESYNC_INFO: msg = new GameMessage_Resync_Info(); break;
+        case NMS_SERVER_RESYNC: msg = new GameMessage_Server_Resync(); break;
+        case NMS_RESYNC_DONE: msg = new GameMessage_ResyncDone(); break;
+        case NMS_REJOIN_TOKEN: msg = new GameMessage_RejoinToken(); break;
     }
 
     return msg;
 }
 
+Message* GameMessage::create_forwarding(unsigned short id)
+{
+    if(id == NMS_GAMECOMMANDS)
+    {
+        auto* msg = new GameMessage_GameCommand();
+        msg->keepGCsSerialized = true;
+        return msg;
+    }
+    return create_game(id);
+}
+
 void GameMessageWithPlayer::Serialize(Serializer& ser) const
 {
     Message::Serialize(ser);
@@ -24,6 +24,8 @@ public:
     bool run(MessageInterface* callback, unsigned senderPlayerID) override;
 
     static Message* create_game(unsigned short id);
+    /// Like create_game but game commands are not deserialized as they are only forwarded (server, relay)
+    static Message* create_forwarding(unsigned short id);
     Message* create(unsigned short id) const override { return create_game(id); }
 };
 
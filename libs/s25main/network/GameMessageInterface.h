@@ -52,9 +52,13 @@ GENERATE_GAME_MESSAGE_INTERFACE(GameMessage_Ping, GameMessage_Pong,
                                 GameMessage_Player_SwapConfirm,
 
                                 GameMessage_Map_Info, GameMessage_MapRequest, GameMessage_Map_Data,
-                                GameMessage_Map_Checksum, GameMessage_Map_ChecksumOK, GameMessage_GGSChange,
-                                GameMessage_RemoveLua, GameMessage_Pause, GameMessage_SkipToGF,
-                                GameMessage_Server_NWFDone, GameMessage_GameCommand, GameMessage_Speed,
+                                GameMessage_Map_Checksum, GameMessage_Map_ChecksumOK, GameMessage_Map_DataAck,
+                                GameMessage_GGSChange, GameMessage_RemoveLua, GameMessage_Pause,
+                                GameMessage_SkipToGF, GameMessage_Server_NWFDone, GameMessage_GameCommand,
+                                GameMessage_Speed,
 
-                                GameMessage_GetAsyncLog, GameMessage_AsyncLog)
+                                GameMessage_GetAsyncLog, GameMessage_AsyncLog,
+
+                                GameMessage_ResyncRequest, GameMessage_Resync_Info, GameMessage_Server_Resync,
+                                GameMessage_ResyncDone, GameMessage_RejoinToken)
 RTTR_POP_DIAGNOSTIC
@@ -5,26 +5,119 @@
 #include "GameMessage_GameCommand.h"
 #include "GameMessageInterface.h"
 #include "GameProtocol.h"
+#include "helpers/serializeVarInt.h"
+#include "gameData/MaxPlayers.h"
+#include "s25util/Serializer.h"
+#include <memory>
+#include <stdexcept>
+
+namespace {
+void pushSerializedGCs(Serializer& ser, const void* data, unsigned size)
+{
+    helpers::pushVarUInt(ser, size);
+    if(size > 0)
+        ser.PushRawData(data, size);
+}
+
+/// Check that the data consists of exactly numGCs valid commands before forwarding it to others.
+/// The commands don't store their size, so they are parsed to check their types and bounds and then discarded.
+/// This happens once per received message, not per receiver
+void checkSerializedGCs(const std::vector<char>& data, unsigned numGCs)
+{
+    Serializer ser(data.data(), static_cast<unsigned>(data.size()));
+    for(unsigned i = 0; i < numGCs; i++)
+        gc::GameCommand::Deserialize(ser);
+    if(ser.GetBytesLeft() != 0u)
+        throw std::range_error("Size of game commands does not match");
+}
+} // namespace
 
 //////////////////////////////////////////////////////////////////////////
 
-GameMessage_GameCommand::GameMessage_GameCommand() : GameMessageWithPlayer(NMS_GAMECOMMANDS) {}
+GameMessage_GameCommand::GameMessage_GameCommand() : GameMessage(NMS_GAMECOMMANDS) {}
+
+GameMessage_GameCommand::GameMessage_GameCommand(std::vector<PlayerCmds> playerCmds)
+    : GameMessage(NMS_GAMECOMMANDS), playerCmds(std::move(playerCmds))
+{}
 
 GameMessage_GameCommand::GameMessage_GameCommand(uint8_t player, const AsyncChecksum& checksum,
                                                  const std::vector<gc::GameCommandPtr>& gcs)
-    : GameMessageWithPlayer(NMS_GAMECOMMANDS, player), cmds(checksum, gcs)
+    : GameMessage(NMS_GAMECOMMANDS), playerCmds{PlayerCmds{player, PlayerGameCommands(checksum, gcs)}}
 {}
 
 void GameMessage_GameCommand::Serialize(Serializer& ser) const
 {
-    GameMessageWithPlayer::Serialize(ser);
-    cmds.Serialize(ser);
+    GameMessage::Serialize(ser);
+    helpers::pushVarUInt(ser, playerCmds.size());
+    if(playerCmds.empty())
+        return;
+    // All players should have the same checksum, so store it once and only the differing ones
+    const AsyncChecksum& refChecksum = playerCmds.front().cmds.checksum;
+    refChecksum.Serialize(ser);
+    for(const PlayerCmds& curCmds : playerCmds)
+    {
+        ser.PushUnsignedChar(curCmds.player);
+        const bool sameChecksum = curCmds.cmds.checksum == refChecksum;
+        ser.PushBool(sameChecksum);
+        if(!sameChecksum)
+            curCmds.cmds.checksum.Serialize(ser);
+        helpers::pushVarUInt(ser, curCmds.cmds.getNumGCs());
+        if(curCmds.cmds.serializedGCs)
+        {
+            const std::vector<char>& data = *curCmds.cmds.serializedGCs;
+            pushSerializedGCs(ser, data.data(), data.size());
+        } else
+        {
+            Serializer gcSer;
+            curCmds.cmds.SerializeGCs(gcSer);
+            pushSerializedGCs(ser, gcSer.GetData(), gcSer.GetLength());
+        }
+    }
 }
 
 void GameMessage_GameCommand::Deserialize(Serializer& ser)
 {
-    GameMessageWithPlayer::Deserialize(ser);
-    cmds.Deserialize(ser);
+    GameMessage::Deserialize(ser);
+    const unsigned numPlayerCmds = helpers::popVarUInt(ser);
+    if(numPlayerCmds > MAX_PLAYERS)
+        throw std::range_error("Invalid number of players in game commands");
+    playerCmds.resize(numPlayerCmds);
+    if(playerCmds.empty())
+        return;
+    AsyncChecksum refChecksum;
+    refChecksum.Deserialize(ser);
+    for(PlayerCmds& curCmds : playerCmds)
+    {
+        curCmds.player = ser.PopUnsignedChar();
+        if(ser.PopBool())
+            curCmds.cmds.checksum = refChecksum;
+        else
+            curCmds.cmds.checksum.Deserialize(ser);
+        const unsigned numGCs = helpers::popVarUInt(ser);
+        const unsigned size = helpers::popVarUInt(ser);
+        if(size > ser.GetBytesLeft())
+            throw std::range_error("Invalid size of game commands");
+        // Each command takes at least 1 byte for its type
+        if(numGCs > size)
+            throw std::range_error("Invalid number of game commands");
+        if(keepGCsSerialized)
+        {
+            auto data = std::make_shared<std::vector<char>>(size);
+            if(size > 0)
+                ser.PopRawData(data->data(), size);
+            checkSerializedGCs(*data, numGCs);
+            curCmds.cmds.serializedGCs = std::move(data);
+            curCmds.cmds.numSerializedGCs = numGCs;
+        } else
+        {
+            const unsigned endBytesLeft = ser.GetBytesLeft() - size;
+            curCmds.cmds.gcs.resize(numGCs);
+            for(gc::GameCommandPtr& gc : curCmds.cmds.gcs)
+                gc = gc::GameCommand::Deserialize(ser);
+            if(ser.GetBytesLeft() != endBytesLeft)
+                throw std::range_error("Size of game commands does not match");
+        }
+    }
 }
 
 bool GameMessage_GameCommand::Run(GameMessageInterface* callback) const
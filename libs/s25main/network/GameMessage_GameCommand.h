@@ -11,14 +11,29 @@
 
 class Serializer;
 
-class GameMessage_GameCommand : public GameMessageWithPlayer
+/// Game commands of one or more players.
+/// A client sends the commands of itself and its AIs for an NWF at once.
+/// The server sends the commands of all players for an NWF at once
+class GameMessage_GameCommand : public GameMessage
 {
 public:
-    PlayerGameCommands cmds;
+    struct PlayerCmds
+    {
+        /// Player the commands are for. 0xFF for the sending player
+        uint8_t player;
+        PlayerGameCommands cmds;
+    };
+    std::vector<PlayerCmds> playerCmds;
+    /// Keep the received commands serialized (PlayerGameCommands::serializedGCs) as they are only forwarded
+    bool keepGCsSerialized = false;
 
-    GameMessage_GameCommand(); //-V730
+    GameMessage_GameCommand();
+    explicit GameMessage_GameCommand(std::vector<PlayerCmds> playerCmds);
     GameMessage_GameCommand(uint8_t player, const AsyncChecksum& checksum, const std::vector<gc::GameCommandPtr>& gcs);
 
+    /// Serializes the checksum only once if it is the same for all players (the usual case)
+    /// and uses variable length integers for the counts.
+    /// The commands of each player are prefixed by their size so they can be forwarded without deserializing them
     void Serialize(Serializer& ser) const override;
     void Deserialize(Serializer& ser) override;
     bool Run(GameMessageInterface* callback) const override;
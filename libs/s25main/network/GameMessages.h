@@ -672,12 +672,15 @@ public:
     MapType mt;
     uint32_t mapLen, mapCompressedLen;
     uint32_t luaLen, luaCompressedLen;
+    /// CRC32 of the uncompressed files to find them in the map cache. 0 if unknown
+    uint32_t mapHash, luaHash;
 
     GameMessage_Map_Info() : GameMessage(NMS_MAP_INFO) {} //-V730
     GameMessage_Map_Info(std::string filename, const MapType mt, unsigned mapLen, unsigned mapCompressedLen,
-                         const unsigned luaLen, unsigned luaCompressedLen)
+                         const unsigned luaLen, unsigned luaCompressedLen, uint32_t mapHash, uint32_t luaHash)
         : GameMessage(NMS_MAP_INFO), filename(std::move(filename)), mt(mt), mapLen(mapLen),
-          mapCompressedLen(mapCompressedLen), luaLen(luaLen), luaCompressedLen(luaCompressedLen)
+          mapCompressedLen(mapCompressedLen), luaLen(luaLen), luaCompressedLen(luaCompressedLen),
+          mapHash(mapHash), luaHash(luaHash)
     {
         LOG.writeToFile(">>> NMS_MAP_INFO\n");
     }
@@ -691,6 +694,8 @@ public:
         ser.PushUnsignedInt(mapCompressedLen);
         ser.PushUnsignedInt(luaLen);
         ser.PushUnsignedInt(luaCompressedLen);
+        ser.PushUnsignedInt(mapHash);
+        ser.PushUnsignedInt(luaHash);
     }
 
     void Deserialize(Serializer& ser) override
@@ -702,6 +707,8 @@ public:
         mapCompressedLen = ser.PopUnsignedInt();
         luaLen = ser.PopUnsignedInt();
         luaCompressedLen = ser.PopUnsignedInt();
+        mapHash = ser.PopUnsignedInt();
+        luaHash = ser.PopUnsignedInt();
     }
 
     bool Run(GameMessageInterface* callback) const override
@@ -715,20 +722,28 @@ class GameMessage_MapRequest : public GameMessage
 {
 public:
     bool requestInfo;
+    /// Number of bytes of the compressed map and lua data the client already has (from an interrupted transfer)
+    uint32_t mapOffset, luaOffset;
 
     GameMessage_MapRequest() : GameMessage(NMS_MAP_REQUEST) {} //-V730
-    GameMessage_MapRequest(bool requestInfo) : GameMessage(NMS_MAP_REQUEST), requestInfo(requestInfo) {}
+    GameMessage_MapRequest(bool requestInfo, unsigned mapOffset = 0, unsigned luaOffset = 0)
+        : GameMessage(NMS_MAP_REQUEST), requestInfo(requestInfo), mapOffset(mapOffset), luaOffset(luaOffset)
+    {}
 
     void Serialize(Serializer& ser) const override
     {
         GameMessage::Serialize(ser);
         ser.PushBool(requestInfo);
+        ser.PushUnsignedInt(mapOffset);
+        ser.PushUnsignedInt(luaOffset);
     }
 
     void Deserialize(Serializer& ser) override
     {
         GameMessage::Deserialize(ser);
         requestInfo = ser.PopBool();
+        mapOffset = ser.PopUnsignedInt();
+        luaOffset = ser.PopUnsignedInt();
     }
 
     bool Run(GameMessageInterface* callback) const override { return callback->OnGameMessage(*this); }
@@ -776,6 +791,31 @@ public:
     }
 };
 
+/// Confirms received map data so the server can send more
+class GameMessage_Map_DataAck : public GameMessage
+{
+public:
+    /// Number of bytes of map and lua data received in total
+    uint32_t numBytes;
+
+    GameMessage_Map_DataAck() : GameMessage(NMS_MAP_DATA_ACK) {} //-V730
+    GameMessage_Map_DataAck(uint32_t numBytes) : GameMessage(NMS_MAP_DATA_ACK), numBytes(numBytes) {}
+
+    void Serialize(Serializer& ser) const override
+    {
+        GameMessage::Serialize(ser);
+        ser.PushUnsignedInt(numBytes);
+    }
+
+    void Deserialize(Serializer& ser) override
+    {
+        GameMessage::Deserialize(ser);
+        numBytes = ser.PopUnsignedInt();
+    }
+
+    bool Run(GameMessageInterface* callback) const override { return callback->OnGameMessage(*this); }
+};
+
 class GameMessage_Map_Checksum : public GameMessage
 {
 public:
@@ -1058,3 +1098,181 @@ public:
         return callback->OnGameMessage(*this);
     }
 };
+
+/// S->C: Request a snapshot of the game at the given NWF for a player rejoining the game
+class GameMessage_ResyncRequest : public GameMessage
+{
+public:
+    uint32_t nwf;
+
+    GameMessage_ResyncRequest() : GameMessage(NMS_RESYNC_REQUEST) {} //-V730
+    GameMessage_ResyncRequest(unsigned nwf) : GameMessage(NMS_RESYNC_REQUEST), nwf(nwf) {}
+
+    void Serialize(Serializer& ser) const override
+    {
+        GameMessage::Serialize(ser);
+        ser.PushUnsignedInt(nwf);
+    }
+
+    void Deserialize(Serializer& ser) override
+    {
+        GameMessage::Deserialize(ser);
+        nwf = ser.PopUnsignedInt();
+    }
+
+    bool Run(GameMessageInterface* callback) const override
+    {
+        LOG.writeToFile("<<< NMS_RESYNC_REQUEST(%d)\n") % nwf;
+        return callback->OnGameMessage(*this);
+    }
+};
+
+/// C->S: Info about the snapshot taken at the requested NWF. The savegame data follows as NMS_MAP_DATA
+class GameMessage_Resync_Info : public GameMessage
+{
+public:
+    uint32_t nwf;
+    /// Checksum of the uncompressed savegame
+    uint32_t checksum;
+    uint32_t length, compressedLength;
+    /// State of the RNG which is not contained in the savegame
+    UsedPRNG rngState;
+
+    GameMessage_Resync_Info() : GameMessage(NMS_RESYNC_INFO) {} //-V730
+    GameMessage_Resync_Info(unsigned nwf, unsigned checksum, unsigned length, unsigned compressedLength,
+                            const UsedPRNG& rngState)
+        : GameMessage(NMS_RESYNC_INFO), nwf(nwf), checksum(checksum), length(length),
+          compressedLength(compressedLength), rngState(rngState)
+    {}
+
+    void Serialize(Serializer& ser) const override
+    {
+        GameMessage::Serialize(ser);
+        ser.PushUnsignedInt(nwf);
+        ser.PushUnsignedInt(checksum);
+        ser.PushUnsignedInt(length);
+        ser.PushUnsignedInt(compressedLength);
+        rngState.serialize(ser);
+    }
+
+    void Deserialize(Serializer& ser) override
+    {
+        GameMessage::Deserialize(ser);
+        nwf = ser.PopUnsignedInt();
+        checksum = ser.PopUnsignedInt();
+        length = ser.PopUnsignedInt();
+        compressedLength = ser.PopUnsignedInt();
+        rngState.deserialize(ser);
+    }
+
+    bool Run(GameMessageInterface* callback) const override
+    {
+        LOG.writeToFile("<<< NMS_RESYNC_INFO(%d, %d)\n") % nwf % compressedLength;
+        return callback->OnGameMessage(*this);
+    }
+};
+
+/// S->C: Start the game from the transmitted savegame at the given NWF
+class GameMessage_Server_Resync : public GameMessage
+{
+public:
+    /// GF of the NWF and number of NWFs executed before it
+    uint32_t nwf, numNWFs;
+    uint32_t cmdDelay;
+    /// GF and NWF length in effect at the NWF
+    uint32_t gfLength, nwfLength;
+    UsedPRNG rngState;
+
+    GameMessage_Server_Resync() : GameMessage(NMS_SERVER_RESYNC) {} //-V730
+    GameMessage_Server_Resync(unsigned nwf, unsigned numNWFs, unsigned cmdDelay, unsigned gfLength,
+                              unsigned nwfLength, const UsedPRNG& rngState)
+        : GameMessage(NMS_SERVER_RESYNC), nwf(nwf), numNWFs(numNWFs), cmdDelay(cmdDelay), gfLength(gfLength),
+          nwfLength(nwfLength), rngState(rngState)
+    {}
+
+    void Serialize(Serializer& ser) const override
+    {
+        GameMessage::Serialize(ser);
+        ser.PushUnsignedInt(nwf);
+        ser.PushUnsignedInt(numNWFs);
+        ser.PushUnsignedInt(cmdDelay);
+        ser.PushUnsignedInt(gfLength);
+        ser.PushUnsignedInt(nwfLength);
+        rngState.serialize(ser);
+    }
+
+    void Deserialize(Serializer& ser) override
+    {
+        GameMessage::Deserialize(ser);
+        nwf = ser.PopUnsignedInt();
+        numNWFs = ser.PopUnsignedInt();
+        cmdDelay = ser.PopUnsignedInt();
+        gfLength = ser.PopUnsignedInt();
+        nwfLength = ser.PopUnsignedInt();
+        rngState.deserialize(ser);
+    }
+
+    bool Run(GameMessageInterface* callback) const override
+    {
+        LOG.writeToFile("<<< NMS_SERVER_RESYNC(%d, %d, %d)\n") % nwf % numNWFs % cmdDelay;
+        return callback->OnGameMessage(*this);
+    }
+};
+
+/// C->S: The rejoined player has caught up with the game after executing numNWFs NWFs.
+/// Its own commands follow for the NWFs from numNWFs + cmdDelay on
+class GameMessage_ResyncDone : public GameMessage
+{
+public:
+    uint32_t numNWFs;
+
+    GameMessage_ResyncDone() : GameMessage(NMS_RESYNC_DONE) {} //-V730
+    GameMessage_ResyncDone(unsigned numNWFs) : GameMessage(NMS_RESYNC_DONE), numNWFs(numNWFs) {}
+
+    void Serialize(Serializer& ser) const override
+    {
+        GameMessage::Serialize(ser);
+        ser.PushUnsignedInt(numNWFs);
+    }
+
+    void Deserialize(Serializer& ser) override
+    {
+        GameMessage::Deserialize(ser);
+        numNWFs = ser.PopUnsignedInt();
+    }
+
+    bool Run(GameMessageInterface* callback) const override
+    {
+        LOG.writeToFile("<<< NMS_RESYNC_DONE(%d)\n") % numNWFs;
+        return callback->OnGameMessage(*this);
+    }
+};
+
+/// S->C: Secret token identifying the player when rejoining after losing the connection.
+/// C->S: First message sent when connecting to a running game to take over the slot of that player again
+class GameMessage_RejoinToken : public GameMessage
+{
+public:
+    std::string token;
+
+    GameMessage_RejoinToken() : GameMessage(NMS_REJOIN_TOKEN) {}
+    GameMessage_RejoinToken(std::string token) : GameMessage(NMS_REJOIN_TOKEN), token(std::move(token)) {}
+
+    void Serialize(Serializer& ser) const override
+    {
+        GameMessage::Serialize(ser);
+        ser.PushString(token);
+    }
+
+    void Deserialize(Serializer& ser) override
+    {
+        GameMessage::Deserialize(ser);
+        token = ser.PopString();
+    }
+
+    bool Run(GameMessageInterface* callback) const override
+    {
+        LOG.writeToFile("<<< NMS_REJOIN_TOKEN(%s)\n") % "********";
+        return callback->OnGameMessage(*this);
+    }
+};
@@ -39,11 +39,12 @@ enum
     NMS_PLAYER_SWAP_CONFIRM,
 
     NMS_MAP_NAME = 0x0301, // x mapname
-    NMS_MAP_INFO,          // 0 | 4 parts, 4 ziplength, 4 length
-    NMS_MAP_REQUEST,
-    NMS_MAP_DATA,       // 0 | x mappartdata
-    NMS_MAP_CHECKSUM,   // 4 checksum
-    NMS_MAP_CHECKSUMOK, // 1 checksumok
+    NMS_MAP_INFO,          // 0 | 4 parts, 4 ziplength, 4 length, 8 checksums
+    NMS_MAP_REQUEST,       // 1 request info, 4 map offset, 4 lua offset
+    NMS_MAP_DATA,          // 0 | x mappartdata
+    NMS_MAP_CHECKSUM,      // 4 checksum
+    NMS_MAP_CHECKSUMOK,    // 1 checksumok
+    NMS_MAP_DATA_ACK,      // 4 received bytes
 
     NMS_SERVER_NWF_DONE = 0x0401, // 0
     NMS_GAMECOMMANDS,
@@ -55,7 +56,13 @@ enum
     NMS_REMOVE_LUA,
 
     NMS_GET_ASYNC_LOG = 0x0600,
-    NMS_ASYNC_LOG
+    NMS_ASYNC_LOG,
+
+    NMS_RESYNC_REQUEST = 0x0701, // 4 nwf
+    NMS_RESYNC_INFO,             // 4 nwf, 4 checksum, 4 length, 4 compressed length, x rng state
+    NMS_SERVER_RESYNC,           // 4 nwf, 4 num nwfs, 4 cmd delay, 4 gf length, 4 nwf length, x rng state
+    NMS_RESYNC_DONE,             // 4 num nwfs
+    NMS_REJOIN_TOKEN             // x token | x token
 };
 
 /* Hinweise:
@@ -82,12 +89,16 @@ NMS_SERVER_TYP          --> ok ? NMS_SERVER_PASSWORD : disconnect
 NMS_SERVER_PASSWORD     --> ok ? NMS_PLAYER_NAME : disconnect
 
 NMS_MAP_NAME            --> NMS_MAP_INFO
-NMS_MAP_INFO            --> parts*NMS_MAP_DATA
-NMS_MAP_DATA            --> part >= parts ? NMS_MAP_CHECKSUM
+NMS_MAP_INFO            --> in cache ? NMS_MAP_CHECKSUM : NMS_MAP_REQUEST (with offsets of a previous partial transfer)
+NMS_MAP_DATA            --> part >= parts ? NMS_MAP_CHECKSUM : every few parts NMS_MAP_DATA_ACK
 NMS_MAP_CHECKSUM        --> ( !ok ) ? disconnect
 
 NMS_GGS_CHANGE          -->
 
+NMS_REJOIN_TOKEN        --> store to be sent first when connecting to the server again
+NMS_RESYNC_REQUEST      --> at nwf: NMS_RESYNC_INFO, parts*NMS_MAP_DATA (savegame of the current state)
+NMS_SERVER_RESYNC       --> load savegame, catch up with buffered NWFs, NMS_RESYNC_DONE
+
 NMS_NFC_ANSWER          -->
 
 NMS_DEAD_MSG            --> disconnect
@@ -112,12 +123,20 @@ NMS_PLAYER_TEAM   --> bc(NMS_PLAYER_TEAM)
 NMS_PLAYER_COLOR  --> bc(NMS_PLAYER_COLOR)
 
 NMS_MAP_INFO            --> NMS_MAP_INFO
-NMS_MAP_DATA            --> NMS_MAP_DATA
+NMS_MAP_REQUEST         --> NMS_MAP_DATA (map and lua parts interleaved, at most a window of unacknowledged bytes)
+NMS_MAP_DATA_ACK        --> more NMS_MAP_DATA
 NMS_MAP_CHECKSUM        --> NMS_MAP_CHECKSUM, ( !ok ) ? kick : ( bc(NMS_PLAYER_NEW), NMS_SERVER_NAME, NMS_PLAYER_LIST,
 NMS_GGS_CHANGE )
 
 NMS_NFC_COMMAND         --> NMS_NFC_ANSWER
 
+start                   --> NMS_REJOIN_TOKEN (to each player)
+connect ingame          --> on NMS_REJOIN_TOKEN: NMS_PLAYER_ID (of the dropped player with this token or none),
+on NMS_SERVER_PASSWORD: NMS_RESYNC_REQUEST to another player
+NMS_RESYNC_INFO         --> NMS_MAP_INFO (if requested), NMS_MAP_DATA from the other player is served on NMS_MAP_REQUEST
+NMS_MAP_CHECKSUM        --> NMS_SERVER_NAME, NMS_PLAYER_LIST, NMS_GGS_CHANGE, NMS_SERVER_RESYNC, buffered messages
+NMS_RESYNC_DONE         --> bc(NMS_PLAYER_NEW), player takes over from the AI
+
 NMS_DEAD_MSG            --> kick
 
 kick                    --> bc(NMS_PLAYER_KICK), NMS_DEAD_MSG
@@ -160,3 +179,10 @@ constexpr unsigned LOAD_TIMEOUT = 10 * 60;
 /// Größe eines Map-Paketes
 /// ACHTUNG: IPV4 garantiert nur maximal 576!!
 constexpr unsigned MAP_PART_SIZE = 512;
+/// Maximum number of messages sent at once to a player receiving the map so other players are not delayed
+constexpr int MAX_MSGS_PER_SEND_MAP_TRANSFER = 64;
+/// Maximum number of map bytes sent but not yet acknowledged by the client.
+/// Limits the number of queued map parts so other messages to the client are not delayed for long
+constexpr unsigned MAP_SEND_WINDOW = 32 * MAP_PART_SIZE;
+/// Number of received map parts after which the client sends an acknowledgement
+constexpr unsigned MAP_ACK_INTERVAL = 8;
@@ -4,15 +4,19 @@
 
 #include "GameServer.h"
 #include "Debug.h"
+#include "FileChecksum.h"
 #include "GameMessage.h"
 #include "GameMessage_GameCommand.h"
 #include "GameServerPlayer.h"
 #include "GlobalGameSettings.h"
 #include "JoinPlayerInfo.h"
+#include "MemoryConnection.h"
 #include "RTTR_Version.h"
 #include "RttrConfig.h"
 #include "Savegame.h"
+#include "SerializedGameMessage.h"
 #include "Settings.h"
+#include "SocketUtils.h"
 #include "commonDefines.h"
 #include "files.h"
 #include "helpers/containerUtils.h"
@@ -29,6 +33,7 @@
 #include "libsiedler2/ArchivItem_Map.h"
 #include "libsiedler2/ArchivItem_Map_Header.h"
 #include "libsiedler2/prototypen.h"
+#include "s25util/Serializer.h"
 #include "s25util/SocketSet.h"
 #include "s25util/colors.h"
 #include "s25util/utf8.h"
@@ -36,11 +41,14 @@
 #include <boost/filesystem.hpp>
 #include <boost/nowide/convert.hpp>
 #include <boost/nowide/fstream.hpp>
-#include <cmath>
+#include <boost/optional.hpp>
 #include <helpers/chronoIO.h>
 #include <iomanip>
 #include <iterator>
+#include <limits>
+#include <random>
 #include <mygettext/mygettext.h>
+#include <thread>
 
 struct GameServer::AsyncLog
 {
@@ -52,6 +60,77 @@ struct GameServer::AsyncLog
     AsyncLog(uint8_t playerId, AsyncChecksum checksum) : playerId(playerId), done(false), checksum(checksum) {}
 };
 
+struct GameServer::SnapshotRequest
+{
+    /// Player providing the snapshot
+    unsigned providerId;
+    /// GF of the NWF at which the snapshot is taken and number of NWFs executed before it
+    unsigned nwf = 0, numNWFs = 0;
+    /// GF and NWF length in effect at that NWF
+    unsigned gfLength = 0, nwfLength = 0;
+    /// Compressed savegame and its (uncompressed) checksum
+    CompressedData snapshot;
+    unsigned checksum = 0;
+    UsedPRNG rngState;
+    unsigned numReceivedBytes = 0;
+    bool isSnapshotComplete = false;
+    /// Messages required to continue from the snapshot
+    std::vector<std::unique_ptr<Message>> pendingMsgs;
+
+    explicit SnapshotRequest(unsigned providerId) : providerId(providerId) {}
+};
+
+struct GameServer::ResyncInfo : SnapshotRequest
+{
+    /// Player rejoining the game
+    unsigned playerId;
+    bool isMapInfoRequested = false;
+    /// Snapshot was sent and the player is catching up
+    bool isStarted = false;
+    /// Index of the first command sent by the player itself after catching up
+    boost::optional<unsigned> firstOwnCmd;
+    unsigned numOwnCmds = 0;
+    /// Own commands of the player received before the AI commands preceding them
+    std::queue<PlayerGameCommands> bufferedCmds;
+    /// AI commands not required anymore due to the own commands. Used again if rejoining fails
+    std::queue<PlayerGameCommands> unusedAICmds;
+
+    ResyncInfo(unsigned playerId, unsigned providerId) : SnapshotRequest(providerId), playerId(playerId) {}
+};
+
+struct GameServer::SpectatorSnapshotRequest : SnapshotRequest
+{
+    /// Size of the spectator stream when the snapshot was requested
+    uint64_t streamPos;
+
+    SpectatorSnapshotRequest(unsigned providerId, uint64_t streamPos)
+        : SnapshotRequest(providerId), streamPos(streamPos)
+    {}
+};
+
+namespace {
+/// Maximum size of a snapshot sent by a player, compressed and uncompressed.
+/// Savegames of the largest maps are much smaller, this only keeps bogus sizes from exhausting the memory
+constexpr uint32_t MAX_SNAPSHOT_SIZE = 256u * 1024u * 1024u;
+
+/// Snapshots are only used once, so they are not cached (hash 0)
+GameMessage_Map_Info* createResyncMapInfo(const CompressedData& snapshot)
+{
+    return new GameMessage_Map_Info("resync.sav", MapType::Savegame, snapshot.uncompressedLength,
+                                    snapshot.data.size(), 0, 0, 0, 0);
+}
+
+std::string createRejoinToken()
+{
+    constexpr char chars[] = "0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ";
+    std::random_device rng;
+    std::string token(32, ' ');
+    for(char& c : token)
+        c = chars[helpers::randomValue<unsigned>(rng, 0, sizeof(chars) - 2)];
+    return token;
+}
+} // namespace
+
 GameServer::ServerConfig::ServerConfig()
 {
     Clear();
@@ -99,6 +178,12 @@ bool GameServer::CountDown::Update()
     return true;
 }
 
+GameServer::SteadyClock::duration GameServer::CountDown::GetTimeToNextUpdate() const
+{
+    return std::max<SteadyClock::duration>(SteadyClock::duration::zero(),
+                                           lasttime + std::chrono::seconds(1) - SteadyClock::now());
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 //
 GameServer::GameServer() : skiptogf(0), state(ServerState::Stopped), currentGF(0), lanAnnouncer(LAN_DISCOVERY_CFG) {}
@@ -184,18 +269,22 @@ bool GameServer::Start(const CreateServerInfo& csi, const boost::filesystem::pat
 
     if(!mapinfo.mapData.CompressFromFile(mapinfo.filepath, &mapinfo.mapChecksum))
         return false;
+    mapinfo.mapHash = CalcCRC32OfFile(mapinfo.filepath);
 
     bfs::path luaFilePath = bfs::path(mapinfo.filepath).replace_extension("lua");
     if(bfs::is_regular_file(luaFilePath))
     {
         if(!mapinfo.luaData.CompressFromFile(luaFilePath, &mapinfo.luaChecksum))
             return false;
+        mapinfo.luaHash = CalcCRC32OfFile(luaFilePath);
         mapinfo.luaFilepath = luaFilePath;
     } else
         RTTR_Assert(mapinfo.luaFilepath.empty() && mapinfo.luaChecksum == 0);
 
     // ab in die Konfiguration
     state = ServerState::Config;
+    metrics_ = Metrics();
+    isWaitingForNWF_ = false;
 
     // und das socket in listen-modus schicken
     if(!serversocket.Listen(config.port, config.ipv6, csi.use_upnp))
@@ -217,6 +306,19 @@ bool GameServer::Start(const CreateServerInfo& csi, const boost::filesystem::pat
     return true;
 }
 
+bool GameServer::StartSpectatorRelay(const SpectatorRelay::Config& relayConfig, SteadyClock::duration snapshotInterval)
+{
+    RTTR_Assert(state == ServerState::Config);
+    spectatorRelay_ = std::make_unique<SpectatorRelay>(relayConfig);
+    spectatorSnapshotInterval_ = snapshotInterval;
+    if(!spectatorRelay_->Start())
+    {
+        spectatorRelay_.reset();
+        return false;
+    }
+    return true;
+}
+
 unsigned GameServer::GetNumFilledSlots() const
 {
     unsigned numFilled = 0;
@@ -228,6 +330,14 @@ unsigned GameServer::GetNumFilledSlots() const
     return numFilled;
 }
 
+void GameServer::SetGGS(const GlobalGameSettings& ggs)
+{
+    RTTR_Assert(state == ServerState::Config);
+    ggs_ = ggs;
+    SendToAll(GameMessage_GGSChange(ggs_));
+    CancelCountdown();
+}
+
 void GameServer::AnnounceStatusChange()
 {
     if(config.servertype == ServerType::LAN)
@@ -290,7 +400,7 @@ void GameServer::Run()
     for(GameServerPlayer& player : networkPlayers)
     {
         // Ignore kicked players
-        if(!player.socket.isValid())
+        if(!player.isConnected())
             continue;
         player.executeMsgs(*this);
     }
@@ -298,15 +408,123 @@ void GameServer::Run()
     for(GameServerPlayer& player : networkPlayers)
     {
         // Ignore kicked players
-        if(!player.socket.isValid())
+        if(!player.isConnected())
             continue;
-        player.sendMsgs(10);
+        // Send everything at once unless we are sending the map which might be a lot of data
+        if(player.isMapSending())
+        {
+            SendMapParts(player);
+            player.sendMsgs(MAX_MSGS_PER_SEND_MAP_TRANSFER);
+        } else
+            player.sendMsgs(-1);
     }
-    helpers::erase_if(networkPlayers, [](const auto& player) { return !player.socket.isValid(); });
+    helpers::erase_if(networkPlayers, [](const auto& player) { return !player.isConnected(); });
+
+    // Spectators are served last, so they never delay the players
+    if(spectatorRelay_)
+        spectatorRelay_->Run();
 
     lanAnnouncer.Run();
 }
 
+unsigned GameServer::AddSocketsToWaitFor(SocketPollSet& set) const
+{
+    if(state == ServerState::Stopped)
+        return 0;
+    unsigned numSockets = 0;
+    // New connections are only accepted during configuration or from players which lost the connection
+    if(state == ServerState::Config || (state == ServerState::Game && !droppedPlayers_.empty() && !resync_))
+    {
+        set.Add(serversocket);
+        ++numSockets;
+    }
+    for(const GameServerPlayer& connection : rejoinConnections_)
+    {
+        if(connection.socket.isValid())
+        {
+            set.Add(connection.socket);
+            ++numSockets;
+        }
+    }
+    for(const GameServerPlayer& player : networkPlayers)
+    {
+        if(player.socket.isValid())
+        {
+            set.Add(player.socket);
+            ++numSockets;
+        }
+    }
+    if(spectatorRelay_)
+        numSockets += spectatorRelay_->AddSocketsToWaitFor(set);
+    return numSockets;
+}
+
+GameServer::SteadyClock::duration GameServer::GetTimeToNextEvent() const
+{
+    using namespace std::chrono;
+    if(state == ServerState::Stopped)
+        return SteadyClock::duration::max();
+    // Pings, timeouts and LAN announcements are checked at least every second
+    SteadyClock::duration result = seconds(1);
+    for(const GameServerPlayer& player : networkPlayers)
+    {
+        // In-process connections can't be waited for
+        if(player.hasReceivedData())
+            return SteadyClock::duration::zero();
+        // Map transfer is done in parts, so continue it soon
+        if(player.isMapSending() && !player.sendQueue.empty())
+            result = std::min<SteadyClock::duration>(result, milliseconds(10));
+    }
+    if(spectatorRelay_)
+        result = std::min(result, spectatorRelay_->GetTimeToNextEvent());
+    if(state == ServerState::Config && countdown.IsActive())
+        result = std::min(result, countdown.GetTimeToNextUpdate());
+    else if(state == ServerState::Game && !framesinfo.isPaused && !isWaitingForNWF_)
+    {
+        // When waiting for lagging players we wake up as soon as their commands arrive, otherwise at the next GF
+        if(skiptogf > currentGF)
+            return SteadyClock::duration::zero();
+        const auto nextGFTime = framesinfo.lastTime + framesinfo.gf_length;
+        result = std::min(result, std::max<SteadyClock::duration>(SteadyClock::duration::zero(),
+                                                                  nextGFTime - SteadyClock::now()));
+    }
+    return result;
+}
+
+uint16_t GameServer::GetPort() const
+{
+    return getLocalPort(serversocket);
+}
+
+void GameServer::WaitForEvents(SteadyClock::duration maxWaitTime) const
+{
+    WaitForEvents(std::vector<const GameServer*>{this}, maxWaitTime);
+}
+
+void GameServer::WaitForEvents(const std::vector<const GameServer*>& servers, SteadyClock::duration maxWaitTime)
+{
+    using namespace std::chrono;
+    // A multi-game server waits for more sockets than select() can handle
+    SocketPollSet set;
+    unsigned numSockets = 0;
+    SteadyClock::duration waitTime = maxWaitTime;
+    for(const GameServer* server : servers)
+    {
+        numSockets += server->AddSocketsToWaitFor(set);
+        waitTime = std::min(waitTime, server->GetTimeToNextEvent());
+    }
+    if(waitTime <= SteadyClock::duration::zero())
+        return;
+    if(numSockets == 0)
+        std::this_thread::sleep_for(waitTime);
+    else
+    {
+        // Round up, waking up too early would only lead to another wait
+        const auto waitTimeMs = duration_cast<milliseconds>(waitTime + milliseconds(1) - SteadyClock::duration(1));
+        set.Poll(static_cast<int>(std::min<milliseconds::rep>(waitTimeMs.count(), std::numeric_limits<int>::max())));
+    }
+}
+
 void GameServer::RunStateConfig()
 {
     WaitForClients();
@@ -349,12 +567,12 @@ void GameServer::RunStateLoading()
     {
         for(const NWFPlayerInfo& player : nwfInfo.getPlayerInfos())
         {
-            GameMessage_GameCommand msg(player.id, nwfInfo.getPlayerCmds(player.id).checksum,
-                                        std::vector<gc::GameCommandPtr>());
-            SendToAll(msg);
-            nwfInfo.addPlayerCmds(player.id, msg.cmds);
+            const PlayerGameCommands cmds(nwfInfo.getPlayerCmds(player.id).checksum, {});
+            nwfInfo.addPlayerCmds(player.id, cmds);
+            AddUnsentCmds(player.id, cmds);
         }
     }
+    SendUnsentCmds(true);
 
     NWFServerInfo serverInfo = nwfInfo.getServerInfo();
     // Send cmdDelay NWFDone messages
@@ -377,8 +595,13 @@ void GameServer::RunStateLoading()
 
 void GameServer::RunStateGame()
 {
+    // Players may reconnect one at a time
+    if(!droppedPlayers_.empty() && !resync_)
+        WaitForClients();
+    HandleRejoinConnections();
     if(!framesinfo.isPaused)
         ExecuteGameFrame();
+    CheckSpectatorSnapshot();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -405,6 +628,13 @@ void GameServer::Stop()
 
     // clear async logs
     asyncLogs.clear();
+    unsentCmds_.clear();
+    droppedPlayers_.clear();
+    rejoinTokens_.clear();
+    rejoinConnections_.clear();
+    resync_.reset();
+    spectatorSnapshot_.reset();
+    spectatorRelay_.reset();
 
     lanAnnouncer.Stop();
 
@@ -541,6 +771,15 @@ bool GameServer::StartGame()
     // Send start first, then load the rest
     SendToAll(GameMessage_Server_Start(random_init, nwfInfo.getNextNWF(), nwfInfo.getCmdDelay()));
     LOG.writeToFile("SERVER >>> BROADCAST: NMS_SERVER_START(%d)\n") % random_init;
+    // Only the player itself knows its token, so nobody else can take over its slot
+    rejoinTokens_.assign(playerInfos.size(), std::string());
+    for(GameServerPlayer& player : networkPlayers)
+    {
+        rejoinTokens_[player.playerId] = createRejoinToken();
+        player.sendMsgAsync(new GameMessage_RejoinToken(rejoinTokens_[player.playerId]));
+    }
+    if(spectatorRelay_)
+        AddInitialSpectatorSnapshot(random_init);
 
     // Höchsten Ping ermitteln
     unsigned highest_ping = 0;
@@ -556,7 +795,9 @@ bool GameServer::StartGame()
     framesinfo.gfLengthReq = framesinfo.gf_length = SPEED_GF_LENGTHS[ggs_.speed];
 
     // NetworkFrame-Länge bestimmen, je schlechter (also höher) die Pings, desto länger auch die Framelänge
+    // It is adapted to the measured latency during the game
     framesinfo.nwf_length = CalcNWFLenght(FramesInfo::milliseconds32_t(highest_ping));
+    nwfLengthController_.reset();
 
     LOG.write("SERVER: Using gameframe length of %1%\n") % helpers::withUnit(framesinfo.gf_length);
     LOG.write("SERVER: Using networkframe length of %1% GFs (%2%)\n") % framesinfo.nwf_length
@@ -567,6 +808,7 @@ bool GameServer::StartGame()
         if(playerInfos[id].isUsed())
             nwfInfo.addPlayer(id);
     }
+    unsentCmds_.assign(playerInfos.size(), std::queue<PlayerGameCommands>());
 
     // Add server info so nwfInfo can be ready but do NOT send it yet, as we wait for the player commands before sending
     // the done msg
@@ -581,13 +823,12 @@ bool GameServer::StartGame()
 
 unsigned GameServer::CalcNWFLenght(FramesInfo::milliseconds32_t minDuration) const
 {
-    constexpr unsigned maxNumGF = 20;
-    for(unsigned i = 1; i < maxNumGF; ++i)
+    for(unsigned i = 1; i < NWFLengthController::maxNWFLength; ++i)
     {
         if(i * framesinfo.gf_length >= minDuration)
             return i;
     }
-    return maxNumGF;
+    return NWFLengthController::maxNWFLength;
 }
 
 void GameServer::SendNWFDone(const NWFServerInfo& info)
@@ -601,12 +842,25 @@ void GameServer::SendNWFDone(const NWFServerInfo& info)
  */
 void GameServer::SendToAll(const GameMessage& msg)
 {
+    // Serialize only once for all recipients
+    const SerializedGameMessage serializedMsg(msg);
+    unsigned numRecipients = 0;
     for(GameServerPlayer& player : networkPlayers)
     {
         // ist der Slot Belegt, dann Nachricht senden
         if(player.isActive())
-            player.sendMsgAsync(msg.clone());
+        {
+            player.sendMsgAsync(new SerializedGameMessage(serializedMsg));
+            ++numRecipients;
+        }
     }
+    // Everything relayed after the snapshot is required by the rejoining player to catch up
+    if(resync_ && !resync_->isStarted)
+        resync_->pendingMsgs.emplace_back(new SerializedGameMessage(serializedMsg));
+    if(spectatorRelay_ && (state == ServerState::Loading || state == ServerState::Game))
+        spectatorRelay_->AddMessage(serializedMsg);
+    metrics_.numMsgsSent += numRecipients;
+    metrics_.numBytesSent += static_cast<uint64_t>(serializedMsg.getSize()) * numRecipients;
 }
 
 void GameServer::KickPlayer(uint8_t playerId, KickReason cause, uint32_t param)
@@ -615,11 +869,20 @@ void GameServer::KickPlayer(uint8_t playerId, KickReason cause, uint32_t param)
         return;
     JoinPlayerInfo& playerInfo = playerInfos[playerId];
     GameServerPlayer* player = GetNetworkPlayer(playerId);
+    const bool isRejoining = player && IsRejoining(playerId);
+    if(resync_ && (playerId == resync_->playerId || (playerId == resync_->providerId && !resync_->isStarted)))
+        AbortResync();
+    if(spectatorSnapshot_ && playerId == spectatorSnapshot_->providerId)
+        spectatorSnapshot_.reset();
     if(player)
         player->closeConnection();
-    // Non-existing or connecting player
-    if(!playerInfo.isUsed())
+    // Non-existing or connecting player. A player failing to rejoin keeps being replaced by the AI
+    if(!playerInfo.isUsed() || isRejoining)
         return;
+    // Lua state is not contained in the snapshot, so rejoining is impossible then
+    if(state == ServerState::Game && playerInfo.ps == PlayerState::Occupied && !playerInfo.isHost
+       && mapinfo.luaData.data.empty())
+        droppedPlayers_.push_back(playerId);
     playerInfo.ps = PlayerState::Free;
 
     SendToAll(GameMessage_Player_Kicked(playerId, cause, param));
@@ -646,7 +909,10 @@ void GameServer::ClientWatchDog()
 
     // sockets zum set hinzufügen
     for(GameServerPlayer& player : networkPlayers)
-        set.Add(player.socket);
+    {
+        if(player.socket.isValid())
+            set.Add(player.socket);
+    }
 
     // auf fehler prüfen
     if(set.Select(0, 2) > 0)
@@ -688,17 +954,40 @@ void GameServer::ExecuteGameFrame()
         {
             if(CheckForLaggingPlayers())
             {
+                if(!isWaitingForNWF_)
+                {
+                    // Let the clients know who we are waiting for
+                    SendUnsentCmds(false);
+                    isWaitingForNWF_ = true;
+                    nwfWaitStartTime_ = currentTime;
+                    ++metrics_.numDelayedNWFs;
+                    for(const NWFPlayerInfo& player : nwfInfo.getPlayerInfos())
+                    {
+                        if(player.isLagging && player.id < metrics_.numLaggedNWFs.size())
+                            ++metrics_.numLaggedNWFs[player.id];
+                    }
+                }
                 // Check for kicking every second
-                static FramesInfo::UsedClock::time_point lastLagKickTime;
-                if(currentTime - lastLagKickTime >= std::chrono::seconds(1))
+                if(currentTime - lastLagKickTime_ >= std::chrono::seconds(1))
                 {
-                    lastLagKickTime = currentTime;
+                    lastLagKickTime_ = currentTime;
                     CheckAndKickLaggingPlayers();
                 }
                 // Skip the rest
                 return;
             } else
+            {
+                nwfLengthController_.onNWFExecuted(isWaitingForNWF_);
+                if(isWaitingForNWF_)
+                {
+                    isWaitingForNWF_ = false;
+                    const auto waitTime = currentTime - nwfWaitStartTime_;
+                    metrics_.nwfWaitTime += waitTime;
+                    metrics_.maxNWFWaitTime = std::max(metrics_.maxNWFWaitTime, waitTime);
+                }
+                ++metrics_.numNWFs;
                 ExecuteNWF();
+            }
         }
         // Advance GF
         ++currentGF;
@@ -748,18 +1037,24 @@ void GameServer::ExecuteNWF()
         LOG.write(_("SERVER: At GF %1%: Speed changed from %2% to %3%. NWF %4%\n")) % currentGF
           % helpers::withUnit(oldGFLen) % helpers::withUnit(framesinfo.gf_length) % framesinfo.nwf_length;
     }
-    NWFServerInfo newInfo(lastNWF, framesinfo.gfLengthReq / FramesInfo::milliseconds32_t(1),
-                          lastNWF + framesinfo.nwf_length);
-    if(framesinfo.gfLengthReq != framesinfo.gf_length)
+    // Choose the length of the next NWF from the latency of the slowest player.
+    // This also keeps the time constant when the speed changes
+    unsigned maxPing = 0, maxPingJitter = 0;
+    for(const GameServerPlayer& player : networkPlayers)
+    {
+        maxPing = std::max(maxPing, player.getPing());
+        maxPingJitter = std::max(maxPingJitter, player.getPingJitter());
+    }
+    nwfLengthController_.setLatency(FramesInfo::milliseconds32_t(maxPing), FramesInfo::milliseconds32_t(maxPingJitter));
+    const unsigned newNWFLength = nwfLengthController_.getNWFLength(framesinfo.gfLengthReq, nwfInfo.getCmdDelay(),
+                                                                    framesinfo.nwf_length * framesinfo.gf_length);
+    if(newNWFLength != framesinfo.nwf_length)
     {
-        // Speed will change, adjust nwf length so the time will stay constant
-        using namespace std::chrono;
-        using MsDouble = duration<double, std::milli>;
-        double newNWFLen =
-          framesinfo.nwf_length * framesinfo.gf_length / duration_cast<MsDouble>(framesinfo.gfLengthReq);
-        newInfo.nextNWF = lastNWF + std::max(1l, std::lround(newNWFLen));
+        LOG.writeToFile("SERVER: At GF %1%: NWF length changed from %2% to %3% GFs (ping: %4%ms +- %5%ms)\n")
+          % currentGF % framesinfo.nwf_length % newNWFLength % maxPing % maxPingJitter;
     }
-    SendNWFDone(newInfo);
+    SendNWFDone(NWFServerInfo(lastNWF, framesinfo.gfLengthReq / FramesInfo::milliseconds32_t(1),
+                              lastNWF + newNWFLength));
 }
 
 bool GameServer::CheckForAsync()
@@ -824,25 +1119,101 @@ void GameServer::WaitForClients()
         // Verbindung annehmen
         if(!socket.isValid())
             return;
+        AddConnection(GameServerPlayer(GameMessageWithPlayer::NO_PLAYER_ID, socket));
+    }
+}
+
+bool GameServer::ConnectLocal(std::shared_ptr<MemoryConnection> connection)
+{
+    // Same as for the server socket
+    if(state != ServerState::Config && (state != ServerState::Game || droppedPlayers_.empty() || resync_))
+        return false;
+    GameServerPlayer player(GameMessageWithPlayer::NO_PLAYER_ID, Socket());
+    player.setMemoryConnection(std::move(connection));
+    AddConnection(std::move(player));
+    return true;
+}
+
+void GameServer::AddConnection(GameServerPlayer connection)
+{
+    // Ingame only a dropped player can take over its slot again. Which one is known from its rejoin token
+    if(state == ServerState::Game)
+    {
+        rejoinConnections_.push_back(std::move(connection));
+        return;
+    }
 
-        unsigned newPlayerId = 0xFFFFFFFF;
-        // Geeigneten Platz suchen
-        for(unsigned playerId = 0; playerId < playerInfos.size(); ++playerId)
+    unsigned newPlayerId = 0xFFFFFFFF;
+    // Geeigneten Platz suchen
+    for(unsigned playerId = 0; playerId < playerInfos.size(); ++playerId)
+    {
+        if(playerInfos[playerId].ps == PlayerState::Free && !GetNetworkPlayer(playerId))
         {
-            if(playerInfos[playerId].ps == PlayerState::Free && !GetNetworkPlayer(playerId))
-            {
-                networkPlayers.push_back(GameServerPlayer(playerId, socket));
-                newPlayerId = playerId;
-                break;
-            }
+            newPlayerId = playerId;
+            break;
         }
+    }
 
-        GameMessage_Player_Id msg(newPlayerId);
-        MessageHandler::send(socket, msg);
+    connection.sendMsg(GameMessage_Player_Id(newPlayerId));
 
-        // war kein platz mehr frei, wenn ja dann verbindung trennen?
-        if(newPlayerId == 0xFFFFFFFF)
-            socket.Close();
+    // war kein platz mehr frei, wenn ja dann verbindung trennen?
+    if(newPlayerId == 0xFFFFFFFF)
+        connection.closeConnection();
+    else
+    {
+        connection.playerId = newPlayerId;
+        networkPlayers.push_back(std::move(connection));
+    }
+}
+
+void GameServer::HandleRejoinConnections()
+{
+    if(rejoinConnections_.empty())
+        return;
+    SocketSet set;
+    for(const GameServerPlayer& connection : rejoinConnections_)
+    {
+        if(connection.socket.isValid())
+            set.Add(connection.socket);
+    }
+    const bool socketsReadable = set.Select(0, 0) > 0;
+    for(GameServerPlayer& connection : rejoinConnections_)
+    {
+        if((connection.hasReceivedData() || (socketsReadable && set.InSet(connection.socket)))
+           && !connection.receiveMsgs())
+            connection.closeConnection();
+    }
+
+    for(auto it = rejoinConnections_.begin(); it != rejoinConnections_.end();)
+    {
+        GameServerPlayer& connection = *it;
+        if(connection.isConnected() && !connection.hasTimedOut()
+           && (connection.recvQueue.empty() || resync_)) // Wait for the token or till the other player rejoined
+        {
+            ++it;
+            continue;
+        }
+        boost::optional<unsigned> playerId;
+        if(connection.isConnected() && !connection.recvQueue.empty())
+        {
+            const std::unique_ptr<Message> msg(connection.recvQueue.popFront());
+            if(const auto* tokenMsg = dynamic_cast<const GameMessage_RejoinToken*>(msg.get()))
+                playerId = FindDroppedPlayer(tokenMsg->token);
+        }
+        if(playerId)
+        {
+            // Messages sent after the token are handled as usual
+            connection.sendMsg(GameMessage_Player_Id(*playerId));
+            connection.playerId = *playerId;
+            networkPlayers.push_back(std::move(connection));
+        } else
+        {
+            LOG.write(_("SERVER: Rejected connection to the running game without a valid rejoin token\n"));
+            if(connection.isConnected())
+                connection.sendMsg(GameMessage_Player_Id(GameMessageWithPlayer::NO_PLAYER_ID));
+            connection.closeConnection();
+        }
+        it = rejoinConnections_.erase(it);
     }
 }
 
@@ -858,25 +1229,29 @@ void GameServer::FillPlayerQueues()
     {
         // sockets zum set hinzufügen
         for(const GameServerPlayer& player : networkPlayers)
-            set.Add(player.socket);
+        {
+            if(player.socket.isValid())
+                set.Add(player.socket);
+        }
 
         msgReceived = false;
 
         // ist eines der Sockets im Set lesbar?
-        if(set.Select(0, 0) > 0)
+        const bool socketsReadable = set.Select(0, 0) > 0;
+        for(GameServerPlayer& player : networkPlayers)
         {
-            for(GameServerPlayer& player : networkPlayers)
+            // Kicked players are still in the list
+            if(!player.isConnected())
+                continue;
+            if(player.hasReceivedData() || (socketsReadable && set.InSet(player.socket)))
             {
-                if(set.InSet(player.socket))
+                // nachricht empfangen
+                if(!player.receiveMsgs())
                 {
-                    // nachricht empfangen
-                    if(!player.receiveMsgs())
-                    {
-                        LOG.write(_("SERVER: Receiving Message for player %1% failed, kicking...\n")) % player.playerId;
-                        KickPlayer(player.playerId, KickReason::ConnectionLost, __LINE__);
-                    } else
-                        msgReceived = true;
-                }
+                    LOG.write(_("SERVER: Receiving Message for player %1% failed, kicking...\n")) % player.playerId;
+                    KickPlayer(player.playerId, KickReason::ConnectionLost, __LINE__);
+                } else
+                    msgReceived = true;
             }
         }
     } while(msgReceived);
@@ -902,7 +1277,7 @@ bool GameServer::OnGameMessage(const GameMessage_Pong& msg)
 // servertype
 bool GameServer::OnGameMessage(const GameMessage_Server_Type& msg)
 {
-    if(state != ServerState::Config)
+    if(state != ServerState::Config && !IsRejoining(msg.senderPlayerID))
     {
         KickPlayer(msg.senderPlayerID, KickReason::InvalidMsg, __LINE__);
         return true;
@@ -930,7 +1305,8 @@ bool GameServer::OnGameMessage(const GameMessage_Server_Type& msg)
  */
 bool GameServer::OnGameMessage(const GameMessage_Server_Password& msg)
 {
-    if(state != ServerState::Config)
+    const bool isRejoining = IsRejoining(msg.senderPlayerID);
+    if(state != ServerState::Config && !isRejoining)
     {
         KickPlayer(msg.senderPlayerID, KickReason::InvalidMsg, __LINE__);
         return true;
@@ -940,6 +1316,18 @@ bool GameServer::OnGameMessage(const GameMessage_Server_Password& msg)
     if(!player)
         return true;
 
+    if(isRejoining)
+    {
+        // The host status is kept from before the connection was lost
+        const bool passwordOk = config.password == msg.password || config.hostPassword == msg.password;
+        player->sendMsgAsync(new GameMessage_Server_Password(passwordOk ? "true" : "false"));
+        if(passwordOk)
+            StartResync(msg.senderPlayerID);
+        else
+            KickPlayer(msg.senderPlayerID, KickReason::WrongPassword, __LINE__);
+        return true;
+    }
+
     std::string passwordok = (config.password == msg.password ? "true" : "false");
     if(msg.password == config.hostPassword)
     {
@@ -1033,6 +1421,9 @@ bool GameServer::OnGameMessage(const GameMessage_Player_State& msg)
 // Spielername
 bool GameServer::OnGameMessage(const GameMessage_Player_Name& msg)
 {
+    // A rejoining player keeps its name
+    if(IsRejoining(msg.senderPlayerID))
+        return true;
     if(state != ServerState::Config)
     {
         KickPlayer(msg.senderPlayerID, KickReason::InvalidMsg, __LINE__);
@@ -1137,7 +1528,8 @@ bool GameServer::OnGameMessage(const GameMessage_Player_Ready& msg)
 
 bool GameServer::OnGameMessage(const GameMessage_MapRequest& msg)
 {
-    if(state != ServerState::Config)
+    const bool isRejoining = IsRejoining(msg.senderPlayerID);
+    if(state != ServerState::Config && !isRejoining)
     {
         KickPlayer(msg.senderPlayerID, KickReason::InvalidMsg, __LINE__);
         return true;
@@ -1146,52 +1538,89 @@ bool GameServer::OnGameMessage(const GameMessage_MapRequest& msg)
     if(!player)
         return true;
 
+    if(isRejoining)
+    {
+        // Rejoining players get the snapshot of the running game as a savegame instead of the map
+        if(!resync_ || resync_->playerId != msg.senderPlayerID)
+            KickPlayer(msg.senderPlayerID, KickReason::InvalidMsg, __LINE__);
+        else if(msg.requestInfo)
+        {
+            if(resync_->isSnapshotComplete)
+                player->sendMsgAsync(createResyncMapInfo(resync_->snapshot));
+            else
+                resync_->isMapInfoRequested = true;
+        } else if(player->isMapSending() || !resync_->isSnapshotComplete)
+            KickPlayer(msg.senderPlayerID, KickReason::InvalidMsg, __LINE__);
+        else
+            StartMapSending(*player, msg, resync_->snapshot.data, {});
+        return true;
+    }
+
     if(msg.requestInfo)
     {
         player->sendMsgAsync(new GameMessage_Map_Info(mapinfo.filepath.filename().string(), mapinfo.type,
                                                       mapinfo.mapData.uncompressedLength, mapinfo.mapData.data.size(),
-                                                      mapinfo.luaData.uncompressedLength, mapinfo.luaData.data.size()));
+                                                      mapinfo.luaData.uncompressedLength, mapinfo.luaData.data.size(),
+                                                      mapinfo.mapHash, mapinfo.luaHash));
     } else if(player->isMapSending())
     {
         // Don't send again
         KickPlayer(msg.senderPlayerID, KickReason::InvalidMsg, __LINE__);
     } else
     {
-        // Send map data
-        unsigned curPos = 0;
-        unsigned remainingSize = mapinfo.mapData.data.size();
-        while(remainingSize)
-        {
-            unsigned chunkSize = std::min(MAP_PART_SIZE, remainingSize);
-
-            player->sendMsgAsync(new GameMessage_Map_Data(true, curPos, &mapinfo.mapData.data[curPos], chunkSize));
-            curPos += chunkSize;
-            remainingSize -= chunkSize;
-        }
-
-        // And lua data (if there is any)
         RTTR_Assert(mapinfo.luaFilepath.empty() == mapinfo.luaData.data.empty());
         RTTR_Assert(mapinfo.luaData.data.empty() == (mapinfo.luaData.uncompressedLength == 0));
-        curPos = 0;
-        remainingSize = mapinfo.luaData.data.size();
-        while(remainingSize)
-        {
-            unsigned chunkSize = std::min(MAP_PART_SIZE, remainingSize);
+        StartMapSending(*player, msg, mapinfo.mapData.data, mapinfo.luaData.data);
+    }
+    return true;
+}
 
-            player->sendMsgAsync(new GameMessage_Map_Data(false, curPos, &mapinfo.luaData.data[curPos], chunkSize));
-            curPos += chunkSize;
-            remainingSize -= chunkSize;
-        }
-        // estimate time. max 60 chunks/s (currently limited by framerate), assume 50 (~25kb/s)
-        auto numChunks = (mapinfo.mapData.data.size() + mapinfo.luaData.data.size()) / MAP_PART_SIZE;
-        player->setMapSending(std::chrono::seconds(numChunks / 50 + 1));
+void GameServer::StartMapSending(GameServerPlayer& player, const GameMessage_MapRequest& msg,
+                                 const std::vector<char>& mapData, const std::vector<char>& luaData)
+{
+    // Client may have parts of the data from an interrupted transfer
+    if(msg.mapOffset > mapData.size() || msg.luaOffset > luaData.size())
+    {
+        KickPlayer(msg.senderPlayerID, KickReason::InvalidMsg, __LINE__);
+        return;
+    }
+    if(msg.mapOffset + msg.luaOffset > 0u)
+    {
+        LOG.write(_("SERVER: Resuming map transfer to player %1% at %2%/%3% bytes\n")) % msg.senderPlayerID
+          % (msg.mapOffset + msg.luaOffset) % (mapData.size() + luaData.size());
     }
+    metrics_.numBytesSent += mapData.size() + luaData.size() - msg.mapOffset - msg.luaOffset;
+    player.setMapSending(msg.mapOffset, msg.luaOffset);
+    // The parts are queued as the client acknowledges them
+    player.sendMapParts(mapData, luaData);
+}
+
+void GameServer::SendMapParts(GameServerPlayer& player)
+{
+    if(IsRejoining(player.playerId))
+    {
+        if(resync_ && resync_->playerId == player.playerId)
+            player.sendMapParts(resync_->snapshot.data, {});
+    } else if(state == ServerState::Config)
+        player.sendMapParts(mapinfo.mapData.data, mapinfo.luaData.data);
+}
+
+bool GameServer::OnGameMessage(const GameMessage_Map_DataAck& msg)
+{
+    GameServerPlayer* player = GetNetworkPlayer(msg.senderPlayerID);
+    if(!player)
+        return true;
+    if(!player->ackMapData(msg.numBytes))
+        KickPlayer(msg.senderPlayerID, KickReason::InvalidMsg, __LINE__);
+    else
+        SendMapParts(*player);
     return true;
 }
 
 bool GameServer::OnGameMessage(const GameMessage_Map_Checksum& msg)
 {
-    if(state != ServerState::Config)
+    const bool isRejoining = IsRejoining(msg.senderPlayerID);
+    if(state != ServerState::Config && !isRejoining)
     {
         KickPlayer(msg.senderPlayerID, KickReason::InvalidMsg, __LINE__);
         return true;
@@ -1200,6 +1629,23 @@ bool GameServer::OnGameMessage(const GameMessage_Map_Checksum& msg)
     if(!player)
         return true;
 
+    if(isRejoining)
+    {
+        if(!resync_ || resync_->playerId != msg.senderPlayerID)
+        {
+            KickPlayer(msg.senderPlayerID, KickReason::InvalidMsg, __LINE__);
+            return true;
+        }
+        const bool checksumOk = resync_->isSnapshotComplete && !resync_->isStarted
+                                && msg.mapChecksum == resync_->checksum && msg.luaChecksum == 0;
+        player->sendMsgAsync(new GameMessage_Map_ChecksumOK(checksumOk, !player->isMapSending()));
+        if(checksumOk)
+            SendResync(*player);
+        else if(player->isMapSending())
+            KickPlayer(msg.senderPlayerID, KickReason::WrongChecksum, __LINE__);
+        return true;
+    }
+
     bool checksumok = (msg.mapChecksum == mapinfo.mapChecksum && msg.luaChecksum == mapinfo.luaChecksum);
 
     LOG.writeToFile("CLIENT%d >>> SERVER: NMS_MAP_CHECKSUM(%u) expected: %u, ok: %s\n") % unsigned(msg.senderPlayerID)
@@ -1263,24 +1709,359 @@ bool GameServer::OnGameMessage(const GameMessage_Speed& msg)
 
 bool GameServer::OnGameMessage(const GameMessage_GameCommand& msg)
 {
-    int targetPlayerId = GetTargetPlayer(msg);
-    if((state != ServerState::Game && state != ServerState::Loading) || targetPlayerId < 0
-       || (state == ServerState::Loading && !msg.cmds.gcs.empty()))
+    if(state != ServerState::Game && state != ServerState::Loading)
     {
         KickPlayer(msg.senderPlayerID, KickReason::InvalidMsg, __LINE__);
         return true;
     }
+    for(const GameMessage_GameCommand::PlayerCmds& playerCmds : msg.playerCmds)
+    {
+        int targetPlayerId = GetTargetPlayer(playerCmds.player, msg.senderPlayerID);
+        if(targetPlayerId < 0 || (state == ServerState::Loading && playerCmds.cmds.getNumGCs() != 0))
+        {
+            KickPlayer(msg.senderPlayerID, KickReason::InvalidMsg, __LINE__);
+            return true;
+        }
+
+        if(resync_ && static_cast<unsigned>(targetPlayerId) == resync_->playerId)
+            AddResyncCmds(msg.senderPlayerID, playerCmds.cmds);
+        else if(targetPlayerId != msg.senderPlayerID && playerInfos[targetPlayerId].ps == PlayerState::Occupied)
+            continue; // Commands of the AI for a player which rejoined in the meantime
+        else
+            AddPlayerCmds(targetPlayerId, playerCmds.cmds);
+    }
+    // While waiting for lagging players relay everything we have right away, otherwise only complete NWFs
+    SendUnsentCmds(!isWaitingForNWF_);
 
-    if(!nwfInfo.addPlayerCmds(targetPlayerId, msg.cmds))
-        return true; // Ignore
-    GameServerPlayer* player = GetNetworkPlayer(targetPlayerId);
+    return true;
+}
+
+void GameServer::AddPlayerCmds(unsigned playerId, const PlayerGameCommands& cmds)
+{
+    if(!nwfInfo.addPlayerCmds(playerId, cmds))
+        return; // Ignore
+    GameServerPlayer* player = GetNetworkPlayer(playerId);
     if(player)
         player->setNotLagging();
-    SendToAll(GameMessage_GameCommand(targetPlayerId, msg.cmds.checksum, msg.cmds.gcs));
+    AddUnsentCmds(playerId, cmds);
+}
+
+unsigned GameServer::GetNumReceivedCmds(unsigned playerId) const
+{
+    return nwfInfo.getNumExecutedNWFs() + nwfInfo.getPlayerInfo(playerId).commands.size();
+}
+
+void GameServer::AddUnsentCmds(unsigned playerId, const PlayerGameCommands& cmds)
+{
+    RTTR_Assert(playerId < unsentCmds_.size());
+    unsentCmds_[playerId].push(cmds);
+}
+
+void GameServer::SendUnsentCmds(bool onlyComplete)
+{
+    while(true)
+    {
+        std::vector<GameMessage_GameCommand::PlayerCmds> playerCmds;
+        for(const NWFPlayerInfo& player : nwfInfo.getPlayerInfos())
+        {
+            const std::queue<PlayerGameCommands>& cmds = unsentCmds_[player.id];
+            if(!cmds.empty())
+                playerCmds.push_back({static_cast<uint8_t>(player.id), cmds.front()});
+            else if(onlyComplete)
+                return;
+        }
+        if(playerCmds.empty())
+            return;
+        for(const GameMessage_GameCommand::PlayerCmds& curCmds : playerCmds)
+            unsentCmds_[curCmds.player].pop();
+        SendToAll(GameMessage_GameCommand(std::move(playerCmds)));
+    }
+}
+
+bool GameServer::IsRejoining(unsigned playerId) const
+{
+    // Dropped players are replaced by an AI till they rejoined completely
+    return state == ServerState::Game && playerId < playerInfos.size() && playerInfos[playerId].ps == PlayerState::AI
+           && helpers::contains(droppedPlayers_, playerId);
+}
+
+boost::optional<unsigned> GameServer::FindDroppedPlayer(const std::string& rejoinToken)
+{
+    for(unsigned playerId : droppedPlayers_)
+    {
+        if(!GetNetworkPlayer(playerId) && playerId < rejoinTokens_.size() && rejoinTokens_[playerId] == rejoinToken)
+            return playerId;
+    }
+    return boost::none;
+}
+
+void GameServer::StartResync(unsigned playerId)
+{
+    // Only 1 player at a time and another player is required to provide the snapshot
+    const auto itProvider = std::find_if(networkPlayers.begin(), networkPlayers.end(),
+                                         [](const GameServerPlayer& player) { return player.isActive(); });
+    if(resync_ || itProvider == networkPlayers.end())
+    {
+        KickPlayer(playerId, KickReason::InvalidMsg, __LINE__);
+        return;
+    }
+    // The snapshot for spectators is requested again later
+    spectatorSnapshot_.reset();
+    resync_ = std::make_unique<ResyncInfo>(playerId, itProvider->playerId);
+    InitSnapshotRequest(*resync_);
+    LOG.write(_("SERVER: Player %1% rejoins the game at GF %2% with the snapshot of player %3%\n")) % playerId
+      % resync_->nwf % itProvider->playerId;
+}
+
+void GameServer::InitSnapshotRequest(SnapshotRequest& request)
+{
+    // No player can be past the last announced NWF, so the snapshot is taken there.
+    // The commands for it and following NWFs which are already relayed are required to continue from it.
+    // Everything later is relayed after the snapshot was requested
+    request.nwf = nwfInfo.getLastNWF();
+    request.numNWFs = nwfInfo.getNumExecutedNWFs() + nwfInfo.getNumServerInfos();
+    request.gfLength = framesinfo.gf_length / FramesInfo::milliseconds32_t(1);
+    request.nwfLength = framesinfo.nwf_length;
+    for(unsigned idx = nwfInfo.getNumServerInfos();; idx++)
+    {
+        std::vector<GameMessage_GameCommand::PlayerCmds> playerCmds;
+        for(const NWFPlayerInfo& player : nwfInfo.getPlayerInfos())
+        {
+            // Unsent commands are always the last ones
+            if(idx + unsentCmds_[player.id].size() < player.commands.size())
+                playerCmds.push_back({static_cast<uint8_t>(player.id), player.commands[idx]});
+        }
+        if(playerCmds.empty())
+            break;
+        request.pendingMsgs.emplace_back(new GameMessage_GameCommand(std::move(playerCmds)));
+    }
+    GetNetworkPlayer(request.providerId)->sendMsgAsync(new GameMessage_ResyncRequest(request.nwf));
+}
+
+GameServer::SnapshotRequest* GameServer::GetSnapshotRequest(unsigned providerId)
+{
+    if(resync_ && !resync_->isStarted && resync_->providerId == providerId)
+        return resync_.get();
+    if(spectatorSnapshot_ && spectatorSnapshot_->providerId == providerId)
+        return spectatorSnapshot_.get();
+    return nullptr;
+}
+
+bool GameServer::OnGameMessage(const GameMessage_Resync_Info& msg)
+{
+    // Only accepted from the player chosen to provide it. Might be outdated if the rejoining failed
+    SnapshotRequest* request = GetSnapshotRequest(msg.senderPlayerID);
+    if(!request || request->providerId != msg.senderPlayerID || msg.nwf != request->nwf
+       || request->snapshot.uncompressedLength != 0)
+        return true;
+    if(msg.length > MAX_SNAPSHOT_SIZE || msg.compressedLength > MAX_SNAPSHOT_SIZE)
+    {
+        LOG.write(_("SERVER: Player %1% announced a snapshot of invalid size\n")) % msg.senderPlayerID;
+        // Also aborts the request
+        KickPlayer(msg.senderPlayerID, KickReason::InvalidMsg, __LINE__);
+        return true;
+    }
+    if(msg.length == 0 || msg.compressedLength == 0)
+    {
+        LOG.write(_("SERVER: Player %1% failed to create a snapshot of the game\n")) % msg.senderPlayerID;
+        if(request == spectatorSnapshot_.get())
+            spectatorSnapshot_.reset();
+        else
+            KickPlayer(resync_->playerId, KickReason::InvalidMsg, __LINE__);
+        return true;
+    }
+    request->checksum = msg.checksum;
+    request->rngState = msg.rngState;
+    request->snapshot.uncompressedLength = msg.length;
+    request->snapshot.data.resize(msg.compressedLength);
+    return true;
+}
 
+bool GameServer::OnGameMessage(const GameMessage_Map_Data& msg)
+{
+    // Only snapshots are sent to the server. Data received before the info belongs to an outdated request
+    SnapshotRequest* request = GetSnapshotRequest(msg.senderPlayerID);
+    if(!request || request->snapshot.uncompressedLength == 0 || request->isSnapshotComplete)
+        return true;
+    std::vector<char>& data = request->snapshot.data;
+    if(!msg.isMapData || msg.offset + msg.data.size() > data.size())
+    {
+        KickPlayer(msg.senderPlayerID, KickReason::InvalidMsg, __LINE__);
+        return true;
+    }
+    std::copy(msg.data.begin(), msg.data.end(), data.begin() + msg.offset);
+    request->numReceivedBytes += msg.data.size();
+    if(request->numReceivedBytes < data.size())
+        return true;
+    request->isSnapshotComplete = true;
+    if(request == spectatorSnapshot_.get())
+    {
+        AddSpectatorSnapshot(*spectatorSnapshot_);
+        spectatorSnapshot_.reset();
+        return true;
+    }
+    GameServerPlayer* player = GetNetworkPlayer(resync_->playerId);
+    if(player && resync_->isMapInfoRequested)
+        player->sendMsgAsync(createResyncMapInfo(resync_->snapshot));
     return true;
 }
 
+void GameServer::SendResync(GameServerPlayer& player)
+{
+    RTTR_Assert(resync_ && !resync_->isStarted);
+    player.sendMsgAsync(new GameMessage_Server_Name(config.gamename));
+    player.sendMsgAsync(new GameMessage_Player_List(playerInfos));
+    player.sendMsgAsync(new GameMessage_GGSChange(ggs_));
+    player.sendMsgAsync(new GameMessage_Server_Resync(resync_->nwf, resync_->numNWFs, nwfInfo.getCmdDelay(),
+                                                      resync_->gfLength, resync_->nwfLength, resync_->rngState));
+    for(std::unique_ptr<Message>& msg : resync_->pendingMsgs)
+        player.sendMsgAsync(msg.release());
+    resync_->pendingMsgs.clear();
+    resync_->snapshot.Clear();
+    resync_->isStarted = true;
+    // From now on the player gets everything directly
+    player.setActive();
+}
+
+bool GameServer::OnGameMessage(const GameMessage_ResyncDone& msg)
+{
+    if(!resync_ || msg.senderPlayerID != resync_->playerId || !resync_->isStarted || resync_->firstOwnCmd)
+    {
+        KickPlayer(msg.senderPlayerID, KickReason::InvalidMsg, __LINE__);
+        return true;
+    }
+    // The player sends its commands from the current NWF on which are for the NWF cmdDelay NWFs later
+    resync_->firstOwnCmd = msg.numNWFs + nwfInfo.getCmdDelay();
+    LOG.write(_("SERVER: Player %1% caught up and takes over at NWF %2%\n")) % msg.senderPlayerID
+      % *resync_->firstOwnCmd;
+    CheckResyncFinished();
+    return true;
+}
+
+bool GameServer::OnGameMessage(const GameMessage_RejoinToken& /*msg*/)
+{
+    // Only used to assign the slot when connecting to a running game
+    return true;
+}
+
+void GameServer::AddResyncCmds(unsigned senderPlayerId, const PlayerGameCommands& cmds)
+{
+    ResyncInfo& resync = *resync_;
+    const unsigned playerId = resync.playerId;
+    if(senderPlayerId != playerId)
+    {
+        // The AI commands are used until the own commands start
+        if(!resync.firstOwnCmd || GetNumReceivedCmds(playerId) < *resync.firstOwnCmd)
+            AddPlayerCmds(playerId, cmds);
+        else
+            resync.unusedAICmds.push(cmds);
+    } else if(resync.firstOwnCmd)
+    {
+        // Own commands for NWFs the AI already sent commands for are dropped
+        if(*resync.firstOwnCmd + resync.numOwnCmds >= GetNumReceivedCmds(playerId))
+            resync.bufferedCmds.push(cmds);
+        resync.numOwnCmds++;
+    }
+    // Add own commands as soon as all preceding AI commands are there
+    while(!resync.bufferedCmds.empty()
+          && *resync.firstOwnCmd + resync.numOwnCmds - resync.bufferedCmds.size() == GetNumReceivedCmds(playerId))
+    {
+        AddPlayerCmds(playerId, resync.bufferedCmds.front());
+        resync.bufferedCmds.pop();
+    }
+    CheckResyncFinished();
+}
+
+void GameServer::CheckResyncFinished()
+{
+    if(!resync_ || !resync_->firstOwnCmd)
+        return;
+    const unsigned playerId = resync_->playerId;
+    // Finished when the next own command is for the next NWF without commands of the player
+    if(!resync_->bufferedCmds.empty()
+       || *resync_->firstOwnCmd + resync_->numOwnCmds != GetNumReceivedCmds(playerId))
+        return;
+    resync_.reset();
+    helpers::erase(droppedPlayers_, playerId);
+    JoinPlayerInfo& playerInfo = playerInfos[playerId];
+    playerInfo.ps = PlayerState::Occupied;
+    // Lets the host remove the AI and all others show the player again
+    SendToAll(GameMessage_Player_New(playerId, playerInfo.name));
+    LOG.write(_("SERVER: Player %1% rejoined the game\n")) % playerId;
+    AnnounceStatusChange();
+}
+
+void GameServer::AbortResync()
+{
+    if(!resync_)
+        return;
+    LOG.write(_("SERVER: Rejoining of player %1% failed\n")) % resync_->playerId;
+    const std::unique_ptr<ResyncInfo> resync = std::move(resync_);
+    GameServerPlayer* player = GetNetworkPlayer(resync->playerId);
+    if(player)
+        player->closeConnection();
+    // The AI continues controlling the player
+    for(; !resync->unusedAICmds.empty(); resync->unusedAICmds.pop())
+        AddPlayerCmds(resync->playerId, resync->unusedAICmds.front());
+}
+
+void GameServer::CheckSpectatorSnapshot()
+{
+    // Lua state is not contained in the snapshot, so spectators can only join at the start then
+    if(!spectatorRelay_ || spectatorSnapshot_ || resync_ || !mapinfo.luaData.data.empty()
+       || spectatorSnapshotInterval_ == SteadyClock::duration::zero()
+       || SteadyClock::now() - lastSpectatorSnapshotTime_ < spectatorSnapshotInterval_)
+        return;
+    const auto itProvider = std::find_if(networkPlayers.begin(), networkPlayers.end(),
+                                         [](const GameServerPlayer& player) { return player.isActive(); });
+    if(itProvider == networkPlayers.end())
+        return;
+    lastSpectatorSnapshotTime_ = SteadyClock::now();
+    spectatorSnapshot_ =
+      std::make_unique<SpectatorSnapshotRequest>(itProvider->playerId, spectatorRelay_->GetStreamSize());
+    InitSnapshotRequest(*spectatorSnapshot_);
+}
+
+void GameServer::AddInitialSpectatorSnapshot(unsigned randomInit)
+{
+    auto snapshot = std::make_unique<SpectatorRelay::Snapshot>();
+    snapshot->mapName = mapinfo.filepath.filename().string();
+    snapshot->mapType = mapinfo.type;
+    snapshot->mapData = mapinfo.mapData;
+    snapshot->luaData = mapinfo.luaData;
+    snapshot->mapChecksum = mapinfo.mapChecksum;
+    snapshot->luaChecksum = mapinfo.luaChecksum;
+    snapshot->mapHash = mapinfo.mapHash;
+    snapshot->luaHash = mapinfo.luaHash;
+    snapshot->startMsgs.emplace_back(new GameMessage_Server_Name(config.gamename));
+    snapshot->startMsgs.emplace_back(new GameMessage_Player_List(playerInfos));
+    snapshot->startMsgs.emplace_back(new GameMessage_GGSChange(ggs_));
+    snapshot->startMsgs.emplace_back(
+      new GameMessage_Server_Start(randomInit, nwfInfo.getNextNWF(), nwfInfo.getCmdDelay()));
+    snapshot->streamPos = spectatorRelay_->GetStreamSize();
+    spectatorRelay_->AddSnapshot(std::move(snapshot));
+    lastSpectatorSnapshotTime_ = SteadyClock::now();
+}
+
+void GameServer::AddSpectatorSnapshot(SpectatorSnapshotRequest& request)
+{
+    auto snapshot = std::make_unique<SpectatorRelay::Snapshot>();
+    snapshot->mapName = "spectate.sav";
+    snapshot->mapType = MapType::Savegame;
+    snapshot->mapData = std::move(request.snapshot);
+    snapshot->mapChecksum = request.checksum;
+    snapshot->startMsgs.emplace_back(new GameMessage_Server_Name(config.gamename));
+    snapshot->startMsgs.emplace_back(new GameMessage_Player_List(playerInfos));
+    snapshot->startMsgs.emplace_back(new GameMessage_GGSChange(ggs_));
+    snapshot->startMsgs.emplace_back(new GameMessage_Server_Resync(
+      request.nwf, request.numNWFs, nwfInfo.getCmdDelay(), request.gfLength, request.nwfLength, request.rngState));
+    for(std::unique_ptr<Message>& msg : request.pendingMsgs)
+        snapshot->startMsgs.push_back(std::move(msg));
+    snapshot->streamPos = request.streamPos;
+    spectatorRelay_->AddSnapshot(std::move(snapshot));
+    LOG.write(_("SERVER: Took a snapshot for spectators at GF %1%\n")) % request.nwf;
+}
+
 bool GameServer::OnGameMessage(const GameMessage_AsyncLog& msg)
 {
     if(state != ServerState::Game)
@@ -1353,6 +2134,7 @@ bool GameServer::OnGameMessage(const GameMessage_RemoveLua& msg)
     mapinfo.luaFilepath.clear();
     mapinfo.luaData.Clear();
     mapinfo.luaChecksum = 0;
+    mapinfo.luaHash = 0;
     SendToAll(msg);
     CancelCountdown();
     return true;
@@ -1684,6 +2466,13 @@ void GameServer::SwapPlayer(const uint8_t player1, const uint8_t player2)
         // Ingame we can only switch to a KI
         if(playerInfos[player1].ps != PlayerState::Occupied || playerInfos[player2].ps != PlayerState::AI)
             return;
+        // The slot of a rejoining player is reserved
+        if(resync_ && (resync_->playerId == player2 || resync_->providerId == player1))
+            return;
+        if(spectatorSnapshot_ && spectatorSnapshot_->providerId == player1)
+            spectatorSnapshot_.reset();
+        // The player now controlling the slot of a dropped player can't be replaced by it anymore
+        helpers::erase(droppedPlayers_, player2);
 
         LOG.write("GameServer::ChangePlayer %i - %i \n") % unsigned(player1) % unsigned(player2);
         using std::swap;
@@ -1740,14 +2529,19 @@ bool GameServer::IsHost(unsigned playerIdx) const
 
 int GameServer::GetTargetPlayer(const GameMessageWithPlayer& msg)
 {
-    if(msg.player != 0xFF)
+    return GetTargetPlayer(msg.player, msg.senderPlayerID);
+}
+
+int GameServer::GetTargetPlayer(uint8_t player, uint8_t senderPlayerId)
+{
+    if(player != 0xFF)
     {
-        if(msg.player < playerInfos.size() && (msg.player == msg.senderPlayerID || IsHost(msg.senderPlayerID)))
+        if(player < playerInfos.size() && (player == senderPlayerId || IsHost(senderPlayerId)))
         {
-            GameServerPlayer* networkPlayer = GetNetworkPlayer(msg.senderPlayerID);
+            GameServerPlayer* networkPlayer = GetNetworkPlayer(senderPlayerId);
             if(networkPlayer->isActive())
-                return msg.player;
-            unsigned result = msg.player;
+                return player;
+            unsigned result = player;
             // Apply pending swaps
             for(auto& pSwap : networkPlayer->getPendingSwaps()) //-V522
             {
@@ -1758,7 +2552,7 @@ int GameServer::GetTargetPlayer(const GameMessageWithPlayer& msg)
             }
             return result;
         }
-    } else if(msg.senderPlayerID < playerInfos.size())
-        return msg.senderPlayerID;
+    } else if(senderPlayerId < playerInfos.size())
+        return senderPlayerId;
     return -1;
 }
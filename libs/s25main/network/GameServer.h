@@ -4,35 +4,61 @@
 
 #pragma once
 
+#include "Clock.h"
 #include "FramesInfo.h"
 #include "GameMessageInterface.h"
 #include "GameProtocol.h"
 #include "GlobalGameSettings.h"
 #include "JoinPlayerInfo.h"
 #include "NWFInfo.h"
+#include "NWFLengthController.h"
+#include "SpectatorRelay.h"
 #include "gameTypes/MapInfo.h"
 #include "gameTypes/ServerType.h"
+#include "gameData/MaxPlayers.h"
 #include "liblobby/LobbyInterface.h"
 #include "s25util/LANDiscoveryService.h"
 #include "s25util/Singleton.h"
+#include <boost/optional.hpp>
+#include <array>
 #include <chrono>
+#include <cstdint>
+#include <memory>
+#include <queue>
+#include <string>
 #include <vector>
 
 struct CreateServerInfo;
+class SocketPollSet;
 class GameMessage;
 class GameMessageWithPlayer;
 class GameMessage_GameCommand;
 class GameServerPlayer;
+class MemoryConnection;
 struct AIServerPlayer;
 
-class GameServer :
-    public Singleton<GameServer, SingletonPolicies::WithLongevity>,
-    public GameMessageInterface,
-    public LobbyInterface
+/// Server for a single game. Multiple instances can be run side by side, e.g. by a dedicated server.
+/// The server used by the game client for hosting is GAMESERVER
+class GameServer : public GameMessageInterface, public LobbyInterface
 {
 public:
-    static constexpr unsigned Longevity = 6;
-    using SteadyClock = std::chrono::steady_clock;
+    /// The global clock, which can be replaced, e.g. to simulate a network game with a deterministic time
+    using SteadyClock = Clock;
+
+    /// Statistics about the network performance of a running game
+    struct Metrics
+    {
+        /// Number of executed network frames
+        unsigned numNWFs = 0;
+        /// Number of NWFs at which the server had to wait for commands of lagging players
+        unsigned numDelayedNWFs = 0;
+        /// Time spent waiting for lagging players in total and at most for a single NWF
+        SteadyClock::duration nwfWaitTime{}, maxNWFWaitTime{};
+        /// Number of NWFs each player was lagging at
+        std::array<unsigned, MAX_PLAYERS> numLaggedNWFs{};
+        /// Number of messages and payload bytes sent to all players
+        uint64_t numMsgsSent = 0, numBytesSent = 0;
+    };
 
     GameServer();
     ~GameServer();
@@ -41,7 +67,21 @@ public:
     bool Start(const CreateServerInfo& csi, const boost::filesystem::path& map_path, MapType map_type,
                const std::string& hostPw);
 
+    /// Serve the game to spectators with the given config. Snapshots for spectators joining later are taken in the
+    /// given interval (0 = never). Must be called after Start
+    bool StartSpectatorRelay(const SpectatorRelay::Config& relayConfig, SteadyClock::duration snapshotInterval);
+    const SpectatorRelay* GetSpectatorRelay() const { return spectatorRelay_.get(); }
+
+    /// Accept a client in this process connected via the given connection the same way as one connecting to the
+    /// socket. Return false if no new connections are accepted at the moment
+    bool ConnectLocal(std::shared_ptr<MemoryConnection> connection);
+
     void Run();
+    /// Block until a message can be received or the next timed event (GF, ping, countdown) is due.
+    /// Waits at most maxWaitTime
+    void WaitForEvents(SteadyClock::duration maxWaitTime) const;
+    /// Same as the member function but waits for the events of all given servers
+    static void WaitForEvents(const std::vector<const GameServer*>& servers, SteadyClock::duration maxWaitTime);
 
     void RunStateGame();
 
@@ -49,6 +89,16 @@ public:
 
     void Stop();
 
+    bool IsRunning() const { return state != ServerState::Stopped; }
+    /// Return the port the server listens on, e.g. the one chosen by the OS when started with port 0
+    uint16_t GetPort() const;
+    bool IsInGame() const { return state == ServerState::Game; }
+    unsigned GetCurrentGF() const { return currentGF; }
+    unsigned GetNumFilledSlots() const;
+    const Metrics& GetMetrics() const { return metrics_; }
+    /// Replace the game settings loaded on start. Only possible before the game was started
+    void SetGGS(const GlobalGameSettings& ggs);
+
     /// Assign players that do not have a fixed team, return true if any player was assigned.
     static bool assignPlayersOfRandomTeams(std::vector<JoinPlayerInfo>& playerInfos);
 
@@ -68,11 +118,18 @@ private:
     void KickPlayer(uint8_t playerId, KickReason cause, uint32_t param);
 
     void ClientWatchDog();
+    /// Add all sockets to the set from which messages or connections are expected. Return number of sockets added
+    unsigned AddSocketsToWaitFor(SocketPollSet& set) const;
+    /// Get the time till the next timed event which needs to be handled by Run
+    SteadyClock::duration GetTimeToNextEvent() const;
 
     void WaitForClients();
+    /// Assign a free slot to a new connection or, ingame, wait for its rejoin token
+    void AddConnection(GameServerPlayer connection);
+    /// Give connections to the running game the slot of the dropped player identified by their rejoin token
+    void HandleRejoinConnections();
     void FillPlayerQueues();
 
-    unsigned GetNumFilledSlots() const;
     /// Notifies listeners (e.g. Lobby) that the game status has changed (e.g player count)
     void AnnounceStatusChange();
     void SetPaused(bool paused);
@@ -96,6 +153,7 @@ private:
     bool OnGameMessage(const GameMessage_Player_SwapConfirm& msg) override;
     bool OnGameMessage(const GameMessage_MapRequest& msg) override;
     bool OnGameMessage(const GameMessage_Map_Checksum& msg) override;
+    bool OnGameMessage(const GameMessage_Map_DataAck& msg) override;
     bool OnGameMessage(const GameMessage_GameCommand& msg) override;
     bool OnGameMessage(const GameMessage_Speed& msg) override;
     bool OnGameMessage(const GameMessage_AsyncLog& msg) override;
@@ -104,8 +162,18 @@ private:
     bool OnGameMessage(const GameMessage_CancelCountdown& msg) override;
     bool OnGameMessage(const GameMessage_Pause& msg) override;
     bool OnGameMessage(const GameMessage_SkipToGF& msg) override;
+    bool OnGameMessage(const GameMessage_Map_Data& msg) override;
+    bool OnGameMessage(const GameMessage_Resync_Info& msg) override;
+    bool OnGameMessage(const GameMessage_ResyncDone& msg) override;
+    bool OnGameMessage(const GameMessage_RejoinToken& msg) override;
     RTTR_POP_DIAGNOSTIC
 
+    /// Start sending the requested map data to the player
+    void StartMapSending(GameServerPlayer& player, const GameMessage_MapRequest& msg, const std::vector<char>& mapData,
+                         const std::vector<char>& luaData);
+    /// Queue the next map parts for a player receiving the map
+    void SendMapParts(GameServerPlayer& player);
+
     void CancelCountdown();
     bool ArePlayersReady() const;
     /// Some player data has changed. Set non-ready and cancel countdown
@@ -131,6 +199,39 @@ private:
     bool IsHost(unsigned playerIdx) const;
     /// Get the player this message concerns. which is msg.player, msg.senderPlayer or -1 on error/wrong values
     int GetTargetPlayer(const GameMessageWithPlayer& msg);
+    int GetTargetPlayer(uint8_t player, uint8_t senderPlayerId);
+    /// Queue the received commands of a player for relaying them to all players
+    void AddUnsentCmds(unsigned playerId, const PlayerGameCommands& cmds);
+    /// Send the queued commands of all players batched per NWF.
+    /// If onlyComplete is true only NWFs for which the commands of all players are known are sent
+    void SendUnsentCmds(bool onlyComplete);
+    /// Add the commands of a player for its next NWF and queue them for relaying
+    void AddPlayerCmds(unsigned playerId, const PlayerGameCommands& cmds);
+    /// Number of commands received from the player since the game start
+    unsigned GetNumReceivedCmds(unsigned playerId) const;
+
+    /// Is the player connected to take over its slot in the running game again?
+    bool IsRejoining(unsigned playerId) const;
+    /// Return the dropped player not yet reconnected with the given rejoin token
+    boost::optional<unsigned> FindDroppedPlayer(const std::string& rejoinToken);
+    /// Request a snapshot of the game at the last announced NWF from its provider
+    void InitSnapshotRequest(SnapshotRequest& request);
+    /// Get the pending snapshot request with the given provider, if any
+    SnapshotRequest* GetSnapshotRequest(unsigned providerId);
+    /// Request a snapshot of the game for the rejoining player from another player
+    void StartResync(unsigned playerId);
+    /// Send the snapshot and everything relayed since it was taken to the rejoining player
+    void SendResync(GameServerPlayer& player);
+    /// Handle commands for the rejoining player which are either from the AI replacing it or its own ones
+    void AddResyncCmds(unsigned senderPlayerId, const PlayerGameCommands& cmds);
+    /// Hand the slot over to the rejoined player once the AI commands are replaced by its own ones
+    void CheckResyncFinished();
+    void AbortResync();
+    /// Request a snapshot for spectators if it is time for it
+    void CheckSpectatorSnapshot();
+    /// Pass the snapshot taken at the start of the game to the spectator relay
+    void AddInitialSpectatorSnapshot(unsigned randomInit);
+    void AddSpectatorSnapshot(SpectatorSnapshotRequest& request);
 
     unsigned skiptogf;
 
@@ -163,6 +264,25 @@ private:
     std::vector<JoinPlayerInfo> playerInfos;
     std::vector<GameServerPlayer> networkPlayers;
     NWFInfo nwfInfo;
+    NWFLengthController nwfLengthController_;
+    /// Received but not yet relayed commands per player
+    std::vector<std::queue<PlayerGameCommands>> unsentCmds_;
+    /// Players which lost the connection during the game and can rejoin
+    std::vector<unsigned> droppedPlayers_;
+    /// Secret per player sent at the start. Required to take over the slot again after losing the connection
+    std::vector<std::string> rejoinTokens_;
+    /// Connections to the running game which did not yet send their rejoin token
+    std::vector<GameServerPlayer> rejoinConnections_;
+    struct SnapshotRequest;
+    struct ResyncInfo;
+    struct SpectatorSnapshotRequest;
+    /// State of the player currently rejoining the game (if any)
+    std::unique_ptr<ResyncInfo> resync_;
+    std::unique_ptr<SpectatorRelay> spectatorRelay_;
+    SteadyClock::duration spectatorSnapshotInterval_{};
+    SteadyClock::time_point lastSpectatorSnapshotTime_;
+    /// Snapshot currently taken for spectators (if any)
+    std::unique_ptr<SpectatorSnapshotRequest> spectatorSnapshot_;
     GlobalGameSettings ggs_;
 
     /// der Spielstartcountdown
@@ -170,7 +290,7 @@ private:
     {
         bool isActive;
         unsigned remainingSecs;
-        std::chrono::steady_clock::time_point lasttime;
+        SteadyClock::time_point lasttime;
 
     public:
         CountDown();
@@ -180,6 +300,8 @@ private:
         /// Updates the state and returns true on change. Stops 1s after remainingSecs reached zero
         bool Update();
         bool IsActive() const { return isActive; }
+        /// Time till Update needs to be called again
+        SteadyClock::duration GetTimeToNextUpdate() const;
         unsigned GetRemainingSecs() const { return remainingSecs; }
     } countdown;
 
@@ -187,12 +309,26 @@ private:
     /// AsyncLogs of all players
     std::vector<AsyncLog> asyncLogs;
     /// Time at which the loading started
-    std::chrono::steady_clock::time_point loadStartTime;
+    SteadyClock::time_point loadStartTime;
 
     LANDiscoveryService lanAnnouncer;
     void RunStateLoading();
+
+    Metrics metrics_;
+    /// Time at which the server started waiting for lagging players at the current NWF
+    FramesInfo::UsedClock::time_point nwfWaitStartTime_;
+    bool isWaitingForNWF_ = false;
+    /// Time of the last check for kicking lagging players
+    FramesInfo::UsedClock::time_point lastLagKickTime_;
+};
+
+/// The server of the locally hosted game
+class GlobalGameServer : public Singleton<GlobalGameServer, SingletonPolicies::WithLongevity>, public GameServer
+{
+public:
+    static constexpr unsigned Longevity = 6;
 };
 
 ///////////////////////////////////////////////////////////////////////////////
 // Makros / Defines
-#define GAMESERVER GameServer::inst()
+#define GAMESERVER GlobalGameServer::inst()
@@ -19,7 +19,7 @@ int durationToInt(const T_Duration& duration)
 } // namespace
 
 GameServerPlayer::GameServerPlayer(unsigned id, const Socket& socket) //-V818
-    : NetworkPlayer(id), state_(JustConnectedState())
+    : NetworkPlayer(id, GameMessage::create_forwarding), state_(JustConnectedState())
 {
     boost::get<JustConnectedState>(state_).timer.start();
     this->socket = socket;
@@ -27,17 +27,61 @@ GameServerPlayer::GameServerPlayer(unsigned id, const Socket& socket) //-V818
 
 GameServerPlayer::~GameServerPlayer() = default;
 
-void GameServerPlayer::setMapSending(std::chrono::seconds estimatedSendTime)
+void GameServerPlayer::setMapSending(unsigned mapOffset, unsigned luaOffset)
 {
     MapSendingState state;
     state.timer.start();
-    state.estimatedSendTime = estimatedSendTime;
+    state.mapOffset = mapOffset;
+    state.luaOffset = luaOffset;
+    state.numSentBytes = state.numAckedBytes = mapOffset + luaOffset;
     state_ = std::move(state);
 }
 
+void GameServerPlayer::sendMapParts(const std::vector<char>& mapData, const std::vector<char>& luaData)
+{
+    MapSendingState* state = boost::get<MapSendingState>(&state_);
+    if(!state)
+        return;
+    bool sendMap = state->mapOffset <= state->luaOffset;
+    while(state->numSentBytes - state->numAckedBytes < MAP_SEND_WINDOW)
+    {
+        const bool hasMapData = state->mapOffset < mapData.size();
+        const bool hasLuaData = state->luaOffset < luaData.size();
+        if(!hasMapData && !hasLuaData)
+            break;
+        if(!hasLuaData)
+            sendMap = true;
+        else if(!hasMapData)
+            sendMap = false;
+        const std::vector<char>& data = sendMap ? mapData : luaData;
+        unsigned& offset = sendMap ? state->mapOffset : state->luaOffset;
+        const unsigned chunkSize = std::min<unsigned>(MAP_PART_SIZE, data.size() - offset);
+        sendQueue.push(new GameMessage_Map_Data(sendMap, offset, &data[offset], chunkSize));
+        offset += chunkSize;
+        state->numSentBytes += chunkSize;
+        sendMap = !sendMap;
+    }
+}
+
+bool GameServerPlayer::ackMapData(unsigned numBytes)
+{
+    MapSendingState* state = boost::get<MapSendingState>(&state_);
+    // Late acknowledgement after the transfer finished
+    if(!state)
+        return true;
+    if(numBytes > state->numSentBytes)
+        return false;
+    if(numBytes > state->numAckedBytes)
+    {
+        state->numAckedBytes = numBytes;
+        state->timer.restart();
+    }
+    return true;
+}
+
 void GameServerPlayer::setActive()
 {
-    state_ = ActiveState(3);
+    state_ = ActiveState(3, 10);
 }
 
 void GameServerPlayer::doPing()
@@ -61,16 +105,31 @@ unsigned GameServerPlayer::calcPingTime()
     state.isPinging = false;
     state.pingTimer.restart();
     unsigned curPing = static_cast<unsigned>(std::max(1, result));
+    if(state.lastPing != 0u)
+        state.pingJitter.add(curPing > state.lastPing ? curPing - state.lastPing : state.lastPing - curPing);
+    state.lastPing = curPing;
     state.ping.add(curPing);
     return state.ping.get();
 }
 
+unsigned GameServerPlayer::getPing() const
+{
+    const ActiveState* state = boost::get<ActiveState>(&state_);
+    return state ? state->ping.get() : 0u;
+}
+
+unsigned GameServerPlayer::getPingJitter() const
+{
+    const ActiveState* state = boost::get<ActiveState>(&state_);
+    return state ? state->pingJitter.get() : 0u;
+}
+
 bool GameServerPlayer::hasTimedOut() const
 {
     return boost::apply_visitor(
       composeVisitor(
         [](const JustConnectedState& s) { return s.timer.getElapsed() > seconds(CONNECT_TIMEOUT); },
-        [](const MapSendingState& s) { return s.timer.getElapsed() > seconds(CONNECT_TIMEOUT) + s.estimatedSendTime; },
+        [](const MapSendingState& s) { return s.timer.getElapsed() > seconds(CONNECT_TIMEOUT); },
         [](const ActiveState& s) { return s.isPinging && s.pingTimer.getElapsed() > seconds(PING_TIMEOUT); }),
       state_);
 }
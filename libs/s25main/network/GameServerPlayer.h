@@ -18,8 +18,12 @@ class GameServerPlayer : public NetworkPlayer
     };
     struct MapSendingState
     {
+        /// Restarted whenever the client makes progress
         Timer timer;
-        std::chrono::seconds estimatedSendTime;
+        /// Next byte of the map and lua data to send
+        unsigned mapOffset, luaOffset;
+        /// Number of bytes sent and acknowledged including the ones the client already had
+        unsigned numSentBytes, numAckedBytes;
     };
     struct ActiveState
     {
@@ -28,18 +32,25 @@ class GameServerPlayer : public NetworkPlayer
         /// Timer started when the player started lagging
         Timer lagTimer;
         helpers::SmoothedValue<unsigned> ping;
+        /// Difference between consecutive pings
+        helpers::SmoothedValue<unsigned> pingJitter;
+        /// Last measured ping, 0 if none
+        unsigned lastPing;
         /// These swaps are yet to be confirmed by the client
         std::vector<std::pair<unsigned, unsigned>> pendingSwaps;
         /// Are we waiting for a ping reply
         bool isPinging;
-        ActiveState(unsigned maxSmoothValues) : ping(maxSmoothValues), isPinging(false) {}
+        ActiveState(unsigned maxSmoothValues, unsigned maxJitterValues)
+            : ping(maxSmoothValues), pingJitter(maxJitterValues), lastPing(0), isPinging(false)
+        {}
     };
 
 public:
     GameServerPlayer(unsigned id, const Socket& socket);
     ~GameServerPlayer();
 
-    void setMapSending(std::chrono::seconds estimatedSendTime);
+    /// Start sending the map (and lua) data starting at the given offsets
+    void setMapSending(unsigned mapOffset, unsigned luaOffset);
     void setActive();
     bool isMapSending() const { return holds_alternative<MapSendingState>(state_); }
     bool isActive() const { return holds_alternative<ActiveState>(state_); }
@@ -50,6 +61,10 @@ public:
     void doPing();
     /// Called when a ping response was received. Return the ping in ms
     unsigned calcPingTime();
+    /// Smoothed ping (round trip time) in ms or 0 if unknown
+    unsigned getPing() const;
+    /// Average variation of the ping in ms
+    unsigned getPingJitter() const;
     /// Check if the player timed out.
     bool hasTimedOut() const;
 
@@ -60,6 +75,12 @@ public:
 
     auto& getPendingSwaps() { return boost::get<ActiveState>(state_).pendingSwaps; }
 
+    /// Queue the next parts of the map and lua data as far as the send window allows.
+    /// The parts of both are interleaved so the lua script does not wait for the whole map
+    void sendMapParts(const std::vector<char>& mapData, const std::vector<char>& luaData);
+    /// Client acknowledged the receipt of numBytes bytes. Return false if that is more than sent
+    bool ackMapData(unsigned numBytes);
+
 private:
     boost::variant<JustConnectedState, MapSendingState, ActiveState> state_;
 };
@@ -0,0 +1,117 @@
+// Copyright (C) 2005 - 2021 Settlers Freaks (sf-team at siedler25.org)
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "MapCache.h"
+#include "FileChecksum.h"
+#include "helpers/format.hpp"
+#include <boost/filesystem.hpp>
+#include <boost/nowide/fstream.hpp>
+#include <algorithm>
+#include <ctime>
+#include <utility>
+
+namespace bfs = boost::filesystem;
+namespace bnw = boost::nowide;
+
+namespace {
+bool copyFile(const bfs::path& from, const bfs::path& to)
+{
+    boost::system::error_code ec;
+    bfs::remove(to, ec);
+    bfs::copy_file(from, to, ec);
+    return !ec;
+}
+} // namespace
+
+MapCache::MapCache(bfs::path directory, unsigned maxNumFiles)
+    : directory_(std::move(directory)), maxNumFiles_(maxNumFiles)
+{}
+
+bool MapCache::restore(uint32_t hash, unsigned length, const bfs::path& targetPath)
+{
+    if(hash == 0u)
+        return false;
+    const bfs::path filePath = getFilePath(hash, length);
+    boost::system::error_code ec;
+    if(!bfs::is_regular_file(filePath, ec) || bfs::file_size(filePath, ec) != length || ec)
+        return false;
+    // Don't hand out files which were modified or damaged after they were cached
+    if(CalcCRC32OfFile(filePath) != hash)
+    {
+        bfs::remove(filePath, ec);
+        return false;
+    }
+    // Used files are kept longest
+    bfs::last_write_time(filePath, std::time(nullptr), ec);
+    return copyFile(filePath, targetPath);
+}
+
+void MapCache::add(const bfs::path& filePath)
+{
+    boost::system::error_code ec;
+    const auto length = bfs::file_size(filePath, ec);
+    if(ec || (!bfs::create_directories(directory_, ec) && ec))
+        return;
+    const uint32_t hash = CalcCRC32OfFile(filePath);
+    if(hash != 0u && copyFile(filePath, getFilePath(hash, static_cast<unsigned>(length))))
+        prune();
+}
+
+void MapCache::storePartial(uint32_t hash, const std::vector<char>& data, unsigned numBytes)
+{
+    boost::system::error_code ec;
+    if(hash == 0u || numBytes == 0u || numBytes >= data.size() || (!bfs::create_directories(directory_, ec) && ec))
+        return;
+    bnw::ofstream file(getPartialFilePath(hash, data.size()), std::ios::binary);
+    if(file.write(data.data(), numBytes))
+        prune();
+}
+
+unsigned MapCache::loadPartial(uint32_t hash, std::vector<char>& data) const
+{
+    if(hash == 0u)
+        return 0;
+    const bfs::path filePath = getPartialFilePath(hash, data.size());
+    boost::system::error_code ec;
+    const auto numBytes = bfs::file_size(filePath, ec);
+    if(ec || numBytes >= data.size())
+        return 0;
+    bnw::ifstream file(filePath, std::ios::binary);
+    if(!file.read(data.data(), numBytes))
+        return 0;
+    return static_cast<unsigned>(numBytes);
+}
+
+void MapCache::removePartial(uint32_t hash, unsigned compressedLength)
+{
+    boost::system::error_code ec;
+    bfs::remove(getPartialFilePath(hash, compressedLength), ec);
+}
+
+bfs::path MapCache::getFilePath(uint32_t hash, unsigned length) const
+{
+    return directory_ / helpers::format("crc%08X_%u", hash, length);
+}
+
+bfs::path MapCache::getPartialFilePath(uint32_t hash, unsigned compressedLength) const
+{
+    return directory_ / helpers::format("crc%08X_%u.part", hash, compressedLength);
+}
+
+void MapCache::prune()
+{
+    std::vector<std::pair<std::time_t, bfs::path>> files;
+    boost::system::error_code ec;
+    for(const auto& entry : bfs::directory_iterator(directory_, ec))
+    {
+        if(bfs::is_regular_file(entry.status()))
+            files.emplace_back(bfs::last_write_time(entry.path(), ec), entry.path());
+    }
+    if(files.size() <= maxNumFiles_)
+        return;
+    // Remove the least recently used files
+    std::sort(files.begin(), files.end());
+    for(unsigned i = 0; i < files.size() - maxNumFiles_; i++)
+        bfs::remove(files[i].second, ec);
+}
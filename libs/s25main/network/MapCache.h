@@ -0,0 +1,42 @@
+// Copyright (C) 2005 - 2021 Settlers Freaks (sf-team at siedler25.org)
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <boost/filesystem/path.hpp>
+#include <cstdint>
+#include <vector>
+
+/// Stores maps and lua scripts received from a server by the CRC32 and size of their content,
+/// so they don't need to be transferred again when the same map is played another time.
+/// Also keeps the data of interrupted transfers so they can be resumed.
+/// A hash of 0 means the content is unknown and nothing is cached for it
+class MapCache
+{
+public:
+    explicit MapCache(boost::filesystem::path directory, unsigned maxNumFiles = 100);
+
+    /// Copy the cached file with the given CRC32 and (uncompressed) length to targetPath.
+    /// Return false if there is no such file or its content doesn't match the hash
+    bool restore(uint32_t hash, unsigned length, const boost::filesystem::path& targetPath);
+    /// Add a copy of the given file keyed by the CRC32 of its content.
+    /// Removes the least recently used files if the cache is full
+    void add(const boost::filesystem::path& filePath);
+
+    /// Store the first numBytes of the compressed data of an interrupted transfer of the file with the given CRC32.
+    /// data must already have the size of the complete compressed data
+    void storePartial(uint32_t hash, const std::vector<char>& data, unsigned numBytes);
+    /// Load the start of the compressed data of an interrupted transfer into data which has the size of the complete
+    /// compressed data. Return the number of bytes loaded
+    unsigned loadPartial(uint32_t hash, std::vector<char>& data) const;
+    void removePartial(uint32_t hash, unsigned compressedLength);
+
+private:
+    boost::filesystem::path getFilePath(uint32_t hash, unsigned length) const;
+    boost::filesystem::path getPartialFilePath(uint32_t hash, unsigned compressedLength) const;
+    void prune();
+
+    boost::filesystem::path directory_;
+    unsigned maxNumFiles_;
+};
@@ -0,0 +1,70 @@
+// Copyright (C) 2005 - 2021 Settlers Freaks (sf-team at siedler25.org)
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "MemoryConnection.h"
+#include "RTTR_Assert.h"
+#include "s25util/Message.h"
+#include "s25util/Serializer.h"
+
+MemoryConnection::Pair MemoryConnection::createPair()
+{
+    auto first = std::make_shared<MemoryConnection>();
+    auto second = std::make_shared<MemoryConnection>();
+    first->peer_ = second;
+    second->peer_ = first;
+    return Pair(std::move(first), std::move(second));
+}
+
+void MemoryConnection::close()
+{
+    isClosed_ = true;
+    if(auto peer = peer_.lock())
+        peer->isClosed_ = true;
+    peer_.reset();
+}
+
+bool MemoryConnection::isConnected() const
+{
+    return !isClosed_ && !peer_.expired();
+}
+
+bool MemoryConnection::send(const Message& msg)
+{
+    Serializer ser;
+    msg.Serialize(ser);
+    return sendPacket(Packet{msg.getId(), std::vector<char>(ser.GetData(), ser.GetData() + ser.GetLength())});
+}
+
+bool MemoryConnection::sendPacket(Packet packet)
+{
+    const auto peer = peer_.lock();
+    if(isClosed_ || !peer)
+        return false;
+    peer->inbox_.push_back(std::move(packet));
+    return true;
+}
+
+MemoryConnection::Packet MemoryConnection::popPacket()
+{
+    RTTR_Assert(!inbox_.empty());
+    Packet packet = std::move(inbox_.front());
+    inbox_.pop_front();
+    return packet;
+}
+
+bool MemoryConnection::receive(MessageQueue& queue, CreateMsgFunction createMsg)
+{
+    // Like a socket deliver what was received before the connection was closed
+    while(!inbox_.empty())
+    {
+        const Packet packet = popPacket();
+        std::unique_ptr<Message> msg(createMsg(packet.msgId));
+        if(!msg)
+            return false;
+        Serializer ser(packet.data.data(), static_cast<unsigned>(packet.data.size()));
+        msg->Deserialize(ser);
+        queue.push(msg.release());
+    }
+    return isConnected();
+}
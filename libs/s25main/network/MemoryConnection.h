@@ -0,0 +1,51 @@
+// Copyright (C) 2005 - 2021 Settlers Freaks (sf-team at siedler25.org)
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "s25util/MessageQueue.h"
+#include <deque>
+#include <memory>
+#include <utility>
+#include <vector>
+
+class Message;
+
+/// End of a connection within the process which can be used instead of a socket, e.g. to run a server and its
+/// clients in a single process for tests. Messages are passed serialized, so the receiver gets its own copy as
+/// if it came over the network
+class MemoryConnection
+{
+public:
+    /// A serialized message
+    struct Packet
+    {
+        unsigned short msgId;
+        std::vector<char> data;
+    };
+    using Pair = std::pair<std::shared_ptr<MemoryConnection>, std::shared_ptr<MemoryConnection>>;
+
+    /// Create the 2 ends of a new connection
+    static Pair createPair();
+
+    /// Closing one end closes the connection for both. It is also closed when the other end is destroyed
+    void close();
+    bool isConnected() const;
+    bool hasPackets() const { return !inbox_.empty(); }
+    /// True if packets were received or the connection was closed, i.e. when receiving would not block a socket
+    bool isReadable() const { return hasPackets() || !isConnected(); }
+
+    /// Send the message to the other end. Return false if the connection is closed
+    bool send(const Message& msg);
+    bool sendPacket(Packet packet);
+    /// Take the next received packet. There must be one
+    Packet popPacket();
+    /// Move all received messages to the queue. Return false if the connection is closed
+    bool receive(MessageQueue& queue, CreateMsgFunction createMsg);
+
+private:
+    std::weak_ptr<MemoryConnection> peer_;
+    std::deque<Packet> inbox_;
+    bool isClosed_ = false;
+};
@@ -0,0 +1,67 @@
+// Copyright (C) 2005 - 2021 Settlers Freaks (sf-team at siedler25.org)
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "NWFLengthController.h"
+#include "RTTR_Assert.h"
+#include "helpers/mathFuncs.h"
+#include <algorithm>
+#include <cmath>
+
+constexpr unsigned NWFLengthController::maxNWFLength;
+constexpr unsigned NWFLengthController::stallWindowSize;
+constexpr double NWFLengthController::minJitterFactor;
+constexpr double NWFLengthController::maxJitterFactor;
+
+NWFLengthController::NWFLengthController(double targetStallRate) : targetStallRate_(targetStallRate)
+{
+    reset();
+}
+
+void NWFLengthController::reset()
+{
+    rtt_ = jitter_ = milliseconds32_t::zero();
+    jitterFactor_ = 2;
+    numNWFs_ = numStalledNWFs_ = 0;
+}
+
+void NWFLengthController::setLatency(milliseconds32_t rtt, milliseconds32_t jitter)
+{
+    rtt_ = rtt;
+    jitter_ = jitter;
+}
+
+void NWFLengthController::onNWFExecuted(bool wasStalled)
+{
+    ++numNWFs_;
+    if(wasStalled)
+        ++numStalledNWFs_;
+    if(numNWFs_ < stallWindowSize)
+        return;
+    const double stallRate = static_cast<double>(numStalledNWFs_) / numNWFs_;
+    if(stallRate > targetStallRate_)
+        jitterFactor_ = std::min(maxJitterFactor, jitterFactor_ + 1);
+    else if(stallRate <= targetStallRate_ / 2)
+        jitterFactor_ = std::max(minJitterFactor, jitterFactor_ - 0.5);
+    numNWFs_ = numStalledNWFs_ = 0;
+}
+
+FramesInfo::milliseconds32_t NWFLengthController::getRequiredCmdTime() const
+{
+    return rtt_ + milliseconds32_t(static_cast<uint32_t>(std::lround(jitter_.count() * jitterFactor_)));
+}
+
+unsigned NWFLengthController::getNWFLength(milliseconds32_t gfLength, unsigned cmdDelay,
+                                           milliseconds32_t curNWFDuration) const
+{
+    RTTR_Assert(gfLength.count() > 0u);
+    // Commands of NWF n are sent when executing NWF n and are required at NWF n + cmdDelay.
+    // As the clients progress at different times only use cmdDelay - 1 NWFs for sending them
+    const unsigned numNWFsForCmds = std::max(1u, cmdDelay - 1u);
+    const uint32_t requiredNWFDuration = helpers::divCeil(getRequiredCmdTime().count(), numNWFsForCmds);
+    unsigned result = helpers::divCeil(requiredNWFDuration, gfLength.count());
+    // Reduce gradually to avoid oscillating between short and long NWFs
+    if(curNWFDuration > gfLength)
+        result = std::max(result, (curNWFDuration - gfLength) / gfLength);
+    return helpers::clamp(result, 1u, maxNWFLength);
+}
@@ -0,0 +1,43 @@
+// Copyright (C) 2005 - 2021 Settlers Freaks (sf-team at siedler25.org)
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "FramesInfo.h"
+
+/// Chooses the length of the network frames (NWFs) from the measured latency of the players.
+/// Short NWFs mean less delay between issuing and executing a command, long NWFs avoid stalls waiting for commands.
+/// A safety margin (multiple of the jitter) is added to the round trip time
+/// and adapted so the rate of stalled NWFs stays around the target rate
+class NWFLengthController
+{
+public:
+    using milliseconds32_t = FramesInfo::milliseconds32_t;
+
+    static constexpr unsigned maxNWFLength = 20;
+    /// Number of NWFs over which the stall rate is measured
+    static constexpr unsigned stallWindowSize = 50;
+    static constexpr double minJitterFactor = 1;
+    static constexpr double maxJitterFactor = 10;
+
+    explicit NWFLengthController(double targetStallRate = 0.02);
+
+    void reset();
+    /// Set the current latency estimate, i.e. the round trip time and its jitter of the slowest player
+    void setLatency(milliseconds32_t rtt, milliseconds32_t jitter);
+    /// Called for every executed NWF. wasStalled is true if the NWF was delayed waiting for commands
+    void onNWFExecuted(bool wasStalled);
+    /// Get the length in GFs of the next NWF given the GF length to use and the current NWF duration.
+    /// Longer NWFs are used immediately, the duration decreases at most by 1 GF per NWF
+    unsigned getNWFLength(milliseconds32_t gfLength, unsigned cmdDelay, milliseconds32_t curNWFDuration) const;
+    /// Minimum duration a command needs to be sent and relayed to all players
+    milliseconds32_t getRequiredCmdTime() const;
+    double getJitterFactor() const { return jitterFactor_; }
+
+private:
+    double targetStallRate_;
+    milliseconds32_t rtt_, jitter_;
+    double jitterFactor_;
+    unsigned numNWFs_, numStalledNWFs_;
+};
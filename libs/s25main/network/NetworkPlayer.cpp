@@ -4,27 +4,62 @@
 
 #include "NetworkPlayer.h"
 #include "GameMessage.h"
+#include "MemoryConnection.h"
+#include "RTTR_Assert.h"
 
-NetworkPlayer::NetworkPlayer(unsigned playerId)
-    : playerId(playerId), recvQueue(GameMessage::create_game), sendQueue(GameMessage::create_game)
+NetworkPlayer::NetworkPlayer(unsigned playerId) : NetworkPlayer(playerId, GameMessage::create_game) {}
+
+NetworkPlayer::NetworkPlayer(unsigned playerId, CreateMsgFunction createMsg)
+    : playerId(playerId), recvQueue(createMsg), sendQueue(createMsg), createMsg_(createMsg)
 {}
 
 void NetworkPlayer::closeConnection()
 {
     // Close socket and clear queues
     socket.Close();
+    if(memoryConnection_)
+    {
+        memoryConnection_->close();
+        memoryConnection_.reset();
+    }
     sendQueue.clear();
     recvQueue.clear();
 }
 
+void NetworkPlayer::setMemoryConnection(std::shared_ptr<MemoryConnection> connection)
+{
+    RTTR_Assert(!socket.isValid());
+    memoryConnection_ = std::move(connection);
+}
+
+bool NetworkPlayer::isConnected() const
+{
+    return memoryConnection_ ? memoryConnection_->isConnected() : socket.isValid();
+}
+
+bool NetworkPlayer::hasReceivedData() const
+{
+    return memoryConnection_ && memoryConnection_->isReadable();
+}
+
 bool NetworkPlayer::receiveMsgs()
 {
+    if(memoryConnection_)
+        return memoryConnection_->receive(recvQueue, createMsg_);
     return recvQueue.recvAll(socket) >= 0;
 }
 
 bool NetworkPlayer::sendMsgs(int maxNumMsgs)
 {
-    return sendQueue.send(socket, maxNumMsgs);
+    if(!memoryConnection_)
+        return sendQueue.send(socket, maxNumMsgs);
+    for(int i = 0; (maxNumMsgs < 0 || i < maxNumMsgs) && !sendQueue.empty(); i++)
+    {
+        if(!memoryConnection_->send(*sendQueue.front()))
+            return false;
+        sendQueue.pop();
+    }
+    return true;
 }
 
 void NetworkPlayer::sendMsgAsync(Message* msg)
@@ -34,7 +69,10 @@ void NetworkPlayer::sendMsgAsync(Message* msg)
 
 void NetworkPlayer::sendMsg(const Message& msg)
 {
-    MessageQueue::sendMessage(socket, msg);
+    if(memoryConnection_)
+        memoryConnection_->send(msg);
+    else
+        MessageQueue::sendMessage(socket, msg);
 }
 
 void NetworkPlayer::executeMsgs(MessageInterface& msgHandler)
@@ -53,4 +91,6 @@ void swap(NetworkPlayer& lhs, NetworkPlayer& rhs)
     swap(lhs.recvQueue, rhs.recvQueue);
     swap(lhs.sendQueue, rhs.sendQueue);
     swap(lhs.socket, rhs.socket);
+    swap(lhs.createMsg_, rhs.createMsg_);
+    swap(lhs.memoryConnection_, rhs.memoryConnection_);
 }
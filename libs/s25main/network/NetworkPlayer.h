@@ -6,19 +6,30 @@
 
 #include "s25util/MessageQueue.h"
 #include "s25util/Socket.h"
+#include <memory>
 
 class Message;
 class MessageInterface;
+class MemoryConnection;
 
-/// A player with a network connection and send/recv queues
+/// A player with a network connection and send/recv queues.
+/// The connection is either the socket or, if set, a MemoryConnection within the process
 class NetworkPlayer
 {
 public:
     NetworkPlayer(unsigned playerId);
+    /// Create received messages with the given function instead of GameMessage::create_game
+    NetworkPlayer(unsigned playerId, CreateMsgFunction createMsg);
     virtual ~NetworkPlayer() = default;
-    /// Close the socket and clear queues
+    /// Close the socket or memory connection and clear queues
     virtual void closeConnection();
-    /// Receive all waiting messages from the socket. Return false on error
+    /// Use the given connection instead of the socket till the connection is closed
+    void setMemoryConnection(std::shared_ptr<MemoryConnection> connection);
+    bool hasMemoryConnection() const { return memoryConnection_ != nullptr; }
+    bool isConnected() const;
+    /// True if the memory connection has data to receive or got closed. Sockets need to be checked via a SocketSet
+    bool hasReceivedData() const;
+    /// Receive all waiting messages from the connection. Return false on error
     bool receiveMsgs();
     /// Send at most maxNumMsgs (if non-negative). Return false on error
     bool sendMsgs(int maxNumMsgs);
@@ -33,6 +44,12 @@ public:
     unsigned playerId;
     MessageQueue recvQueue, sendQueue;
     Socket socket;
+
+private:
+    CreateMsgFunction createMsg_;
+    std::shared_ptr<MemoryConnection> memoryConnection_;
+
+    friend void swap(NetworkPlayer& lhs, NetworkPlayer& rhs);
 };
 
 void swap(NetworkPlayer& lhs, NetworkPlayer& rhs);
@@ -5,13 +5,25 @@
 #include "PlayerGameCommands.h"
 #include "s25util/Serializer.h"
 
+void PlayerGameCommands::SerializeGCs(Serializer& ser) const
+{
+    if(serializedGCs)
+    {
+        if(!serializedGCs->empty())
+            ser.PushRawData(serializedGCs->data(), serializedGCs->size());
+    } else
+    {
+        for(const gc::GameCommandPtr& gc : gcs)
+            gc->Serialize(ser);
+    }
+}
+
 void PlayerGameCommands::Serialize(Serializer& ser) const
 {
     checksum.Serialize(ser);
 
-    ser.PushUnsignedInt(gcs.size());
-    for(const gc::GameCommandPtr& gc : gcs)
-        gc->Serialize(ser);
+    ser.PushUnsignedInt(getNumGCs());
+    SerializeGCs(ser);
 }
 
 void PlayerGameCommands::Deserialize(Serializer& ser)
@@ -6,6 +6,7 @@
 
 #include "AsyncChecksum.h"
 #include "GameCommand.h"
+#include <memory>
 #include <utility>
 #include <vector>
 
@@ -16,11 +17,19 @@ struct PlayerGameCommands
     AsyncChecksum checksum;
     /// The game gammands for this NWF
     std::vector<gc::GameCommandPtr> gcs;
+    /// Serialized game commands used instead of gcs when they are only forwarded (e.g. by the server).
+    /// Shared as they are never modified
+    std::shared_ptr<const std::vector<char>> serializedGCs;
+    unsigned numSerializedGCs = 0;
 
     PlayerGameCommands() = default;
     PlayerGameCommands(const AsyncChecksum& checksum, std::vector<gc::GameCommandPtr> gcs)
         : checksum(checksum), gcs(std::move(gcs))
     {}
+    /// Number of game commands in either representation
+    unsigned getNumGCs() const { return serializedGCs ? numSerializedGCs : gcs.size(); }
+    /// Serialize only the game commands without their number
+    void SerializeGCs(Serializer& ser) const;
     void Serialize(Serializer& ser) const;
     void Deserialize(Serializer& ser);
 };
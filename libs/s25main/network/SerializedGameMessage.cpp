@@ -0,0 +1,30 @@
+// Copyright (C) 2005 - 2021 Settlers Freaks (sf-team at siedler25.org)
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "SerializedGameMessage.h"
+#include "s25util/Serializer.h"
+#include <stdexcept>
+
+SerializedGameMessage::SerializedGameMessage(const Message& msg) : GameMessage(msg.getId())
+{
+    Serializer ser;
+    msg.Serialize(ser);
+    data_ = std::make_shared<const std::vector<char>>(ser.GetData(), ser.GetData() + ser.GetLength());
+}
+
+void SerializedGameMessage::Serialize(Serializer& ser) const
+{
+    if(!data_->empty())
+        ser.PushRawData(data_->data(), data_->size());
+}
+
+void SerializedGameMessage::Deserialize(Serializer& /*ser*/)
+{
+    throw std::logic_error("Serialized messages are only sent");
+}
+
+bool SerializedGameMessage::Run(GameMessageInterface* /*callback*/) const
+{
+    throw std::logic_error("Serialized messages are only sent");
+}
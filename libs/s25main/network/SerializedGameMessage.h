@@ -0,0 +1,30 @@
+// Copyright (C) 2005 - 2021 Settlers Freaks (sf-team at siedler25.org)
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "GameMessage.h"
+#include <memory>
+#include <vector>
+
+/// Message serialized once to be sent to many receivers.
+/// Copies share the serialized data, so they are cheap to create and need no further serialization when sent.
+/// It can only be sent, the receiver gets the original message.
+/// Run and Deserialize throw as received messages are always created from their id (GameMessage::create_game).
+/// For the same reason clone() returns the original message: It is created from the id and deserialized from the data
+class SerializedGameMessage : public GameMessage
+{
+public:
+    explicit SerializedGameMessage(const Message& msg);
+
+    void Serialize(Serializer& ser) const override;
+    void Deserialize(Serializer& ser) override;
+    bool Run(GameMessageInterface* callback) const override;
+
+    /// Size of the serialized message
+    unsigned getSize() const { return data_->size(); }
+
+private:
+    std::shared_ptr<const std::vector<char>> data_;
+};
@@ -0,0 +1,72 @@
+// Copyright (C) 2005 - 2021 Settlers Freaks (sf-team at siedler25.org)
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "SocketUtils.h"
+#include "s25util/Socket.h"
+#ifdef _WIN32
+#    include <winsock2.h>
+#    include <ws2tcpip.h>
+using socklen_t = int;
+using pollfd = WSAPOLLFD;
+#else
+#    include <netinet/in.h>
+#    include <poll.h>
+#    include <sys/socket.h>
+#endif
+
+uint16_t getLocalPort(const Socket& socket)
+{
+    if(!socket.isValid())
+        return 0;
+    sockaddr_storage addr{};
+    socklen_t addrLen = sizeof(addr);
+    if(getsockname(socket.GetSocket(), reinterpret_cast<sockaddr*>(&addr), &addrLen) != 0)
+        return 0;
+    if(addr.ss_family == AF_INET)
+        return ntohs(reinterpret_cast<const sockaddr_in&>(addr).sin_port);
+    if(addr.ss_family == AF_INET6)
+        return ntohs(reinterpret_cast<const sockaddr_in6&>(addr).sin6_port);
+    return 0;
+}
+
+unsigned SocketPollSet::Add(const Socket& socket, bool checkWrite)
+{
+    entries_.push_back(Entry{&socket, checkWrite, 0});
+    return size() - 1u;
+}
+
+int SocketPollSet::Poll(int timeoutMs)
+{
+    std::vector<pollfd> fds(entries_.size());
+    for(unsigned i = 0; i < entries_.size(); i++)
+    {
+        fds[i].fd = entries_[i].socket->GetSocket();
+        fds[i].events = static_cast<short>(entries_[i].checkWrite ? (POLLIN | POLLOUT) : POLLIN);
+        fds[i].revents = 0;
+    }
+#ifdef _WIN32
+    const int result = WSAPoll(fds.data(), static_cast<ULONG>(fds.size()), timeoutMs);
+#else
+    const int result = poll(fds.data(), static_cast<nfds_t>(fds.size()), timeoutMs);
+#endif
+    for(unsigned i = 0; i < entries_.size(); i++)
+        entries_[i].events = (result > 0) ? fds[i].revents : 0;
+    return result;
+}
+
+bool SocketPollSet::IsReadable(unsigned idx) const
+{
+    // A closed connection is reported as readable by select, do the same so the receive detects it
+    return (entries_[idx].events & (POLLIN | POLLHUP)) != 0;
+}
+
+bool SocketPollSet::IsWritable(unsigned idx) const
+{
+    return (entries_[idx].events & POLLOUT) != 0;
+}
+
+bool SocketPollSet::HasError(unsigned idx) const
+{
+    return (entries_[idx].events & (POLLERR | POLLNVAL)) != 0;
+}
@@ -0,0 +1,48 @@
+// Copyright (C) 2005 - 2021 Settlers Freaks (sf-team at siedler25.org)
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+class Socket;
+
+/// Return the local port the socket is bound to or 0 on error.
+/// Used to get the port assigned by the OS when listening on port 0
+uint16_t getLocalPort(const Socket& socket);
+
+/// Set of sockets to check or wait for via poll().
+/// Unlike the SocketSet (select) it works with any number of sockets and not only up to FD_SETSIZE
+class SocketPollSet
+{
+public:
+    /// Add a socket to check it for readability (including closed connections) and errors.
+    /// If checkWrite is set, check it also for being able to take more data.
+    /// Return the index of the socket in the set. The socket must stay alive until the set is cleared
+    unsigned Add(const Socket& socket, bool checkWrite = false);
+    void Clear() { entries_.clear(); }
+    bool empty() const { return entries_.empty(); }
+    unsigned size() const { return static_cast<unsigned>(entries_.size()); }
+
+    /// Wait at most timeoutMs until any socket is ready, 0 only checks the current state.
+    /// Return the number of ready sockets or -1 on error
+    int Poll(int timeoutMs);
+    /// Whether the socket with the given index has data to read or got closed
+    bool IsReadable(unsigned idx) const;
+    /// Whether the socket with the given index can take more data. Only valid if it was added with checkWrite
+    bool IsWritable(unsigned idx) const;
+    /// Whether the socket with the given index has an error
+    bool HasError(unsigned idx) const;
+
+private:
+    struct Entry
+    {
+        const Socket* socket;
+        bool checkWrite;
+        /// Result of the last poll (revents)
+        short events;
+    };
+    std::vector<Entry> entries_;
+};
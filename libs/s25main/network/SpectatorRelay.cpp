@@ -0,0 +1,652 @@
+// Copyright (C) 2005 - 2021 Settlers Freaks (sf-team at siedler25.org)
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "SpectatorRelay.h"
+#include "FileChecksum.h"
+#include "GameMessage.h"
+#include "GameServerPlayer.h"
+#include "RTTR_Version.h"
+#include "SocketUtils.h"
+#include "helpers/containerUtils.h"
+#include "network/GameMessages.h"
+#include "s25util/Log.h"
+#include "s25util/SocketSet.h"
+#include <mygettext/mygettext.h>
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+/// Maximum number of stream messages queued for a spectator. More are only queued when its socket is writable again
+constexpr unsigned MAX_QUEUED_MSGS = 64;
+
+/// Check if the socket can take more data without blocking
+bool isWritable(const Socket& socket)
+{
+    SocketPollSet set;
+    set.Add(socket, true);
+    return set.Poll(0) > 0 && set.IsWritable(0);
+}
+
+/// Additive checksum of the uncompressed data as sent by the clients. Throws if the data can't be decompressed
+unsigned calcChecksum(const CompressedData& data)
+{
+    if(data.data.empty())
+        return 0;
+    return CalcChecksumOfBuffer(CompressedData::decompress(data.data, data.uncompressedLength));
+}
+} // namespace
+
+struct SpectatorRelay::Spectator : GameServerPlayer
+{
+    /// Snapshot the spectator starts watching from
+    std::shared_ptr<const Snapshot> snapshot;
+    /// Index of the next message of the stream to send
+    uint64_t nextMsg = 0;
+    bool isMapInfoRequested = false;
+    /// Received the snapshot and gets the stream
+    bool isWatching = false;
+
+    Spectator(unsigned id, const Socket& socket) : GameServerPlayer(id, socket) {}
+};
+
+SpectatorRelay::SpectatorRelay(Config config) : config_(std::move(config)) {}
+
+SpectatorRelay::~SpectatorRelay()
+{
+    Stop();
+}
+
+bool SpectatorRelay::Start()
+{
+    Stop();
+    if(!serverSocket_.Listen(config_.port, config_.ipv6))
+    {
+        LOG.write(_("SpectatorRelay: Listening on port %1% failed!\n")) % config_.port;
+        return false;
+    }
+    LOG.write(_("SpectatorRelay: Spectators can connect on port %1% (delay: %2%s)\n")) % GetPort()
+      % std::chrono::duration_cast<std::chrono::seconds>(config_.delay).count();
+    return true;
+}
+
+uint16_t SpectatorRelay::GetPort() const
+{
+    return getLocalPort(serverSocket_);
+}
+
+bool SpectatorRelay::ConnectUpstream(const std::string& host, uint16_t port)
+{
+    upstream_ = std::make_unique<NetworkPlayer>(0, GameMessage::create_forwarding);
+    if(!upstream_->socket.Connect(host, port, config_.ipv6))
+    {
+        LOG.write(_("SpectatorRelay: Connecting to %1%:%2% failed!\n")) % host % port;
+        upstream_.reset();
+        return false;
+    }
+    upstreamState_ = UpstreamState::Connecting;
+    return true;
+}
+
+void SpectatorRelay::Stop()
+{
+    spectators_.clear();
+    serverSocket_.Close();
+    if(upstream_)
+        upstream_->closeConnection();
+    upstream_.reset();
+    upstreamSnapshot_.reset();
+    stream_.clear();
+    snapshots_.clear();
+    streamStart_ = releasedEnd_ = 0;
+}
+
+bool SpectatorRelay::IsUpstreamConnected() const
+{
+    return upstream_ && upstream_->socket.isValid();
+}
+
+bool SpectatorRelay::HasPendingMessages() const
+{
+    if(releasedEnd_ < GetStreamSize())
+        return true;
+    return helpers::contains_if(spectators_, [this](const Spectator& spectator) {
+        return spectator.socket.isValid() && spectator.isWatching && HasDataToSend(spectator);
+    });
+}
+
+unsigned SpectatorRelay::GetNumSpectators() const
+{
+    return static_cast<unsigned>(spectators_.size());
+}
+
+bool SpectatorRelay::isRelayed(uint16_t msgId)
+{
+    // Everything changing the game state. Chats and lobby messages are not for spectators
+    switch(msgId)
+    {
+        case NMS_GAMECOMMANDS:
+        case NMS_SERVER_NWF_DONE:
+        case NMS_PAUSE:
+        case NMS_SKIP_TO_GF:
+        case NMS_PLAYER_KICKED:
+        case NMS_PLAYER_NEW: return true;
+        default: return false;
+    }
+}
+
+void SpectatorRelay::AddSnapshot(std::unique_ptr<Snapshot> snapshot)
+{
+    RTTR_Assert(snapshot->streamPos >= streamStart_ && snapshot->streamPos <= GetStreamSize());
+    RTTR_Assert(snapshots_.empty() || snapshots_.back()->streamPos <= snapshot->streamPos);
+    snapshots_.push_back(std::move(snapshot));
+}
+
+void SpectatorRelay::AddMessage(const Message& msg)
+{
+    if(isRelayed(msg.getId()))
+        stream_.push_back(StreamEntry{SerializedGameMessage(msg), SteadyClock::now()});
+}
+
+void SpectatorRelay::Run()
+{
+    if(!IsRunning())
+        return;
+    AcceptSpectators();
+    RunUpstream();
+    CheckSpectators();
+    ReceiveFromSpectators();
+    ReleaseMessages();
+    SendToSpectators();
+    helpers::erase_if(spectators_, [](const Spectator& spectator) { return !spectator.socket.isValid(); });
+    TrimStream();
+}
+
+void SpectatorRelay::AcceptSpectators()
+{
+    SocketSet set;
+    set.Add(serverSocket_);
+    if(set.Select(0, 0) <= 0)
+        return;
+    Socket socket = serverSocket_.Accept();
+    if(!socket.isValid())
+        return;
+    if(spectators_.size() >= config_.maxNumSpectators)
+    {
+        Spectator rejected(0, socket);
+        rejected.sendMsg(GameMessage_Player_Id(GameMessageWithPlayer::NO_PLAYER_ID));
+        rejected.closeConnection();
+        return;
+    }
+    spectators_.emplace_back(nextSpectatorId_++, socket);
+    // The spectator views the game as the first player, the actual one is chosen when the player list is known
+    spectators_.back().sendMsgAsync(new GameMessage_Player_Id(0));
+}
+
+void SpectatorRelay::RunUpstream()
+{
+    if(!IsUpstreamConnected())
+        return;
+    SocketSet set;
+    set.Add(upstream_->socket);
+    if(set.Select(0, 2) > 0)
+    {
+        CloseUpstream("socket error");
+        return;
+    }
+    set.Clear();
+    set.Add(upstream_->socket);
+    if(set.Select(0, 0) > 0 && !upstream_->receiveMsgs())
+    {
+        CloseUpstream("connection lost");
+        return;
+    }
+    curSpectator_ = nullptr;
+    while(!upstream_->recvQueue.empty() && upstream_->socket.isValid())
+    {
+        Message& msg = *upstream_->recvQueue.front();
+        if(upstreamState_ == UpstreamState::Connecting || upstreamState_ == UpstreamState::ReceivingMap
+           || msg.getId() == NMS_PING)
+            msg.run(this, 0);
+        else if(upstreamState_ == UpstreamState::ReceivingStart)
+        {
+            upstreamSnapshot_->startMsgs.emplace_back(msg.clone());
+            if(msg.getId() == NMS_SERVER_START || msg.getId() == NMS_SERVER_RESYNC)
+            {
+                // Everything following is the stream
+                upstreamSnapshot_->streamPos = GetStreamSize();
+                AddSnapshot(std::move(upstreamSnapshot_));
+                upstreamState_ = UpstreamState::Watching;
+                LOG.write(_("SpectatorRelay: Receiving the game stream\n"));
+            }
+        } else
+            AddMessage(msg);
+        upstream_->recvQueue.pop();
+    }
+    if(!upstream_->sendMsgs(-1))
+        CloseUpstream("sending failed");
+}
+
+void SpectatorRelay::CloseUpstream(const char* reason)
+{
+    LOG.write(_("SpectatorRelay: Lost the connection to the upstream server: %1%\n")) % reason;
+    upstream_->closeConnection();
+}
+
+void SpectatorRelay::CheckSpectators()
+{
+    // There may be more spectators than select() can handle
+    SocketPollSet set;
+    std::vector<Spectator*> polledSpectators;
+    for(Spectator& spectator : spectators_)
+    {
+        if(spectator.socket.isValid())
+        {
+            set.Add(spectator.socket);
+            polledSpectators.push_back(&spectator);
+        }
+    }
+    if(set.Poll(0) > 0)
+    {
+        for(unsigned i = 0; i < polledSpectators.size(); i++)
+        {
+            if(set.HasError(i))
+                DropSpectator(*polledSpectators[i], "socket error");
+        }
+    }
+    for(Spectator& spectator : spectators_)
+    {
+        if(!spectator.socket.isValid())
+            continue;
+        if(spectator.hasTimedOut())
+            DropSpectator(spectator, "timeout");
+        else
+            spectator.doPing();
+    }
+}
+
+void SpectatorRelay::ReceiveFromSpectators()
+{
+    SocketPollSet set;
+    std::vector<Spectator*> polledSpectators;
+    for(Spectator& spectator : spectators_)
+    {
+        if(spectator.socket.isValid())
+        {
+            set.Add(spectator.socket);
+            polledSpectators.push_back(&spectator);
+        }
+    }
+    if(set.Poll(0) <= 0)
+        return;
+    for(unsigned i = 0; i < polledSpectators.size(); i++)
+    {
+        Spectator& spectator = *polledSpectators[i];
+        if(!set.IsReadable(i))
+            continue;
+        if(!spectator.receiveMsgs())
+        {
+            DropSpectator(spectator, "connection lost");
+            continue;
+        }
+        curSpectator_ = &spectator;
+        spectator.executeMsgs(*this);
+        curSpectator_ = nullptr;
+    }
+}
+
+void SpectatorRelay::ReleaseMessages()
+{
+    const SteadyClock::time_point releaseTime = SteadyClock::now() - config_.delay;
+    while(releasedEnd_ < GetStreamSize() && stream_[releasedEnd_ - streamStart_].time <= releaseTime)
+        ++releasedEnd_;
+    // Only the latest released snapshot is used for new spectators
+    const bool hadReleasedSnapshot = !snapshots_.empty() && snapshots_.front()->streamPos <= releasedEnd_;
+    while(snapshots_.size() > 1u && snapshots_[1]->streamPos <= releasedEnd_)
+        snapshots_.pop_front();
+    if(!hadReleasedSnapshot && !snapshots_.empty() && snapshots_.front()->streamPos <= releasedEnd_)
+    {
+        for(Spectator& spectator : spectators_)
+        {
+            if(spectator.isMapInfoRequested)
+                SendMapInfo(spectator);
+        }
+    }
+
+    for(Spectator& spectator : spectators_)
+    {
+        if(spectator.socket.isValid() && spectator.isWatching && spectator.nextMsg < releasedEnd_
+           && stream_[spectator.nextMsg - streamStart_].time + config_.maxLag < releaseTime)
+            DropSpectator(spectator, "too slow");
+    }
+}
+
+bool SpectatorRelay::HasDataToSend(const Spectator& spectator) const
+{
+    return !spectator.sendQueue.empty() || (spectator.isWatching && spectator.nextMsg < releasedEnd_);
+}
+
+void SpectatorRelay::SendToSpectators()
+{
+    SocketPollSet set;
+    std::vector<Spectator*> polledSpectators;
+    for(Spectator& spectator : spectators_)
+    {
+        if(spectator.socket.isValid() && HasDataToSend(spectator))
+        {
+            set.Add(spectator.socket, true);
+            polledSpectators.push_back(&spectator);
+        }
+    }
+    if(polledSpectators.empty() || set.Poll(0) <= 0)
+        return;
+    for(unsigned i = 0; i < polledSpectators.size(); i++)
+    {
+        if(set.IsWritable(i))
+            SendToSpectator(*polledSpectators[i]);
+    }
+}
+
+void SpectatorRelay::SendToSpectator(Spectator& spectator)
+{
+    // Each message is only sent after poll reported the socket as writable, so a slow spectator can't block the
+    // others as long as a single message fits into the free send buffer. At most MAX_QUEUED_MSGS are sent per run
+    // so a fast spectator doesn't delay the rest of the loop either
+    for(unsigned numSent = 0; numSent < MAX_QUEUED_MSGS; numSent++)
+    {
+        for(; spectator.isWatching && spectator.nextMsg < releasedEnd_ && spectator.sendQueue.size() < MAX_QUEUED_MSGS;
+            ++spectator.nextMsg)
+        {
+            spectator.sendMsgAsync(new SerializedGameMessage(stream_[spectator.nextMsg - streamStart_].msg));
+        }
+        if(spectator.sendQueue.empty())
+            return;
+        if(numSent > 0u && !isWritable(spectator.socket))
+            return;
+        if(!spectator.sendMsgs(1))
+        {
+            DropSpectator(spectator, "sending failed");
+            return;
+        }
+    }
+}
+
+void SpectatorRelay::TrimStream()
+{
+    // Keep everything required by the latest released snapshot and all spectators
+    if(snapshots_.empty())
+        return;
+    uint64_t minPos = std::min(snapshots_.front()->streamPos, releasedEnd_);
+    for(const Spectator& spectator : spectators_)
+    {
+        if(spectator.isWatching)
+            minPos = std::min(minPos, spectator.nextMsg);
+        else if(spectator.snapshot)
+            minPos = std::min(minPos, spectator.snapshot->streamPos);
+    }
+    for(; streamStart_ < minPos; ++streamStart_)
+        stream_.pop_front();
+}
+
+void SpectatorRelay::DropSpectator(Spectator& spectator, const char* reason)
+{
+    if(!spectator.socket.isValid())
+        return;
+    LOG.write(_("SpectatorRelay: Dropping spectator %1%: %2%\n")) % spectator.playerId % reason;
+    spectator.closeConnection();
+    spectator.snapshot.reset();
+}
+
+unsigned SpectatorRelay::AddSocketsToWaitFor(SocketPollSet& set) const
+{
+    if(!IsRunning())
+        return 0;
+    unsigned numSockets = 1;
+    set.Add(serverSocket_);
+    if(IsUpstreamConnected())
+    {
+        set.Add(upstream_->socket);
+        ++numSockets;
+    }
+    // Spectators with pending data are woken up as soon as they can take more
+    for(const Spectator& spectator : spectators_)
+    {
+        if(spectator.socket.isValid())
+        {
+            set.Add(spectator.socket, HasDataToSend(spectator));
+            ++numSockets;
+        }
+    }
+    return numSockets;
+}
+
+SpectatorRelay::SteadyClock::duration SpectatorRelay::GetTimeToNextEvent() const
+{
+    using namespace std::chrono;
+    if(!IsRunning())
+        return SteadyClock::duration::max();
+    // Pings and timeouts are checked at least every second
+    SteadyClock::duration result = seconds(1);
+    if(releasedEnd_ < GetStreamSize())
+    {
+        const auto releaseTime = stream_[releasedEnd_ - streamStart_].time + config_.delay;
+        result = std::min(result, std::max<SteadyClock::duration>(SteadyClock::duration::zero(),
+                                                                  releaseTime - SteadyClock::now()));
+    }
+    return result;
+}
+
+void SpectatorRelay::WaitForEvents(SteadyClock::duration maxWaitTime) const
+{
+    using namespace std::chrono;
+    SocketPollSet set;
+    const unsigned numSockets = AddSocketsToWaitFor(set);
+    const SteadyClock::duration waitTime = std::min(maxWaitTime, GetTimeToNextEvent());
+    if(waitTime <= SteadyClock::duration::zero())
+        return;
+    if(numSockets == 0)
+        std::this_thread::sleep_for(waitTime);
+    else
+    {
+        const auto waitTimeMs = duration_cast<milliseconds>(waitTime + milliseconds(1) - SteadyClock::duration(1));
+        set.Poll(static_cast<int>(std::min<milliseconds::rep>(waitTimeMs.count(), std::numeric_limits<int>::max())));
+    }
+}
+
+void SpectatorRelay::SendMapInfo(Spectator& spectator)
+{
+    spectator.isMapInfoRequested = false;
+    spectator.snapshot = snapshots_.front();
+    const Snapshot& snapshot = *spectator.snapshot;
+    spectator.sendMsgAsync(new GameMessage_Map_Info(snapshot.mapName, snapshot.mapType,
+                                                    snapshot.mapData.uncompressedLength, snapshot.mapData.data.size(),
+                                                    snapshot.luaData.uncompressedLength, snapshot.luaData.data.size(),
+                                                    snapshot.mapHash, snapshot.luaHash));
+}
+
+bool SpectatorRelay::OnGameMessage(const GameMessage_Pong& /*msg*/)
+{
+    if(curSpectator_)
+        curSpectator_->calcPingTime();
+    return true;
+}
+
+bool SpectatorRelay::OnGameMessage(const GameMessage_Server_Type& msg)
+{
+    if(!curSpectator_)
+        return true;
+    // Spectators can connect regardless of the type of the game
+    const bool versionOk = msg.revision == rttr::version::GetRevision();
+    curSpectator_->sendMsgAsync(new GameMessage_Server_TypeOK(versionOk ? 0 : 2));
+    if(!versionOk)
+    {
+        curSpectator_->sendMsgs(-1);
+        DropSpectator(*curSpectator_, "wrong version");
+    }
+    return true;
+}
+
+bool SpectatorRelay::OnGameMessage(const GameMessage_MapRequest& msg)
+{
+    if(!curSpectator_)
+        return true;
+    Spectator& spectator = *curSpectator_;
+    if(msg.requestInfo)
+    {
+        // Wait for a snapshot if none is released yet
+        if(!snapshots_.empty() && snapshots_.front()->streamPos <= releasedEnd_)
+            SendMapInfo(spectator);
+        else
+            spectator.isMapInfoRequested = true;
+    } else if(!spectator.snapshot || spectator.isMapSending() || spectator.isWatching
+              || msg.mapOffset > spectator.snapshot->mapData.data.size()
+              || msg.luaOffset > spectator.snapshot->luaData.data.size())
+        DropSpectator(spectator, "invalid map request");
+    else
+    {
+        spectator.setMapSending(msg.mapOffset, msg.luaOffset);
+        spectator.sendMapParts(spectator.snapshot->mapData.data, spectator.snapshot->luaData.data);
+    }
+    return true;
+}
+
+bool SpectatorRelay::OnGameMessage(const GameMessage_Map_DataAck& msg)
+{
+    if(!curSpectator_)
+        return true;
+    Spectator& spectator = *curSpectator_;
+    if(!spectator.ackMapData(msg.numBytes))
+        DropSpectator(spectator, "invalid map acknowledgement");
+    else if(spectator.snapshot)
+        spectator.sendMapParts(spectator.snapshot->mapData.data, spectator.snapshot->luaData.data);
+    return true;
+}
+
+bool SpectatorRelay::OnGameMessage(const GameMessage_Map_Checksum& msg)
+{
+    if(!curSpectator_)
+        return true;
+    Spectator& spectator = *curSpectator_;
+    if(!spectator.snapshot || spectator.isWatching)
+    {
+        DropSpectator(spectator, "unexpected map checksum");
+        return true;
+    }
+    const Snapshot& snapshot = *spectator.snapshot;
+    const bool checksumOk = msg.mapChecksum == snapshot.mapChecksum && msg.luaChecksum == snapshot.luaChecksum;
+    spectator.sendMsgAsync(new GameMessage_Map_ChecksumOK(checksumOk, !spectator.isMapSending()));
+    if(!checksumOk)
+    {
+        if(spectator.isMapSending())
+            DropSpectator(spectator, "wrong checksum");
+        return true;
+    }
+    for(const std::unique_ptr<Message>& startMsg : snapshot.startMsgs)
+        spectator.sendMsgAsync(startMsg->clone());
+    spectator.nextMsg = snapshot.streamPos;
+    spectator.isWatching = true;
+    spectator.setActive();
+    LOG.write(_("SpectatorRelay: Spectator %1% started watching (%2% spectators)\n")) % spectator.playerId
+      % spectators_.size();
+    return true;
+}
+
+bool SpectatorRelay::OnGameMessage(const GameMessage_Ping& /*msg*/)
+{
+    if(!curSpectator_)
+        upstream_->sendMsgAsync(new GameMessage_Pong());
+    return true;
+}
+
+bool SpectatorRelay::OnGameMessage(const GameMessage_Player_Id& msg)
+{
+    if(curSpectator_ || upstreamState_ != UpstreamState::Connecting)
+        return true;
+    if(msg.player == GameMessageWithPlayer::NO_PLAYER_ID)
+        CloseUpstream("server full");
+    else
+        upstream_->sendMsgAsync(new GameMessage_Server_Type(ServerType::Direct, rttr::version::GetRevision()));
+    return true;
+}
+
+bool SpectatorRelay::OnGameMessage(const GameMessage_Server_TypeOK& msg)
+{
+    if(curSpectator_ || upstreamState_ != UpstreamState::Connecting)
+        return true;
+    if(msg.err_code != 0)
+        CloseUpstream("server type or version rejected");
+    else
+        upstream_->sendMsgAsync(new GameMessage_MapRequest(true));
+    return true;
+}
+
+bool SpectatorRelay::OnGameMessage(const GameMessage_Map_Info& msg)
+{
+    if(curSpectator_ || upstreamState_ != UpstreamState::Connecting)
+        return true;
+    upstreamSnapshot_ = std::make_unique<Snapshot>();
+    upstreamSnapshot_->mapName = msg.filename;
+    upstreamSnapshot_->mapType = msg.mt;
+    upstreamSnapshot_->mapData.uncompressedLength = msg.mapLen;
+    upstreamSnapshot_->mapData.data.resize(msg.mapCompressedLen);
+    upstreamSnapshot_->luaData.uncompressedLength = msg.luaLen;
+    upstreamSnapshot_->luaData.data.resize(msg.luaCompressedLen);
+    upstreamSnapshot_->mapHash = msg.mapHash;
+    upstreamSnapshot_->luaHash = msg.luaHash;
+    numUpstreamMapBytes_ = numUpstreamLuaBytes_ = numUnackedUpstreamParts_ = 0;
+    upstreamState_ = UpstreamState::ReceivingMap;
+    upstream_->sendMsgAsync(new GameMessage_MapRequest(false));
+    return true;
+}
+
+bool SpectatorRelay::OnGameMessage(const GameMessage_Map_Data& msg)
+{
+    if(curSpectator_ || upstreamState_ != UpstreamState::ReceivingMap)
+        return true;
+    std::vector<char>& data = msg.isMapData ? upstreamSnapshot_->mapData.data : upstreamSnapshot_->luaData.data;
+    unsigned& numBytes = msg.isMapData ? numUpstreamMapBytes_ : numUpstreamLuaBytes_;
+    if(msg.offset != numBytes || msg.data.size() > data.size() - numBytes)
+    {
+        CloseUpstream("invalid map data");
+        return true;
+    }
+    std::copy(msg.data.begin(), msg.data.end(), data.begin() + msg.offset);
+    numBytes += msg.data.size();
+    if(numUpstreamMapBytes_ < upstreamSnapshot_->mapData.data.size()
+       || numUpstreamLuaBytes_ < upstreamSnapshot_->luaData.data.size())
+    {
+        if(++numUnackedUpstreamParts_ >= MAP_ACK_INTERVAL)
+        {
+            upstream_->sendMsgAsync(new GameMessage_Map_DataAck(numUpstreamMapBytes_ + numUpstreamLuaBytes_));
+            numUnackedUpstreamParts_ = 0;
+        }
+    } else
+    {
+        // The data is only passed on, but its checksums are required to check the ones of the spectators
+        try
+        {
+            upstreamSnapshot_->mapChecksum = calcChecksum(upstreamSnapshot_->mapData);
+            upstreamSnapshot_->luaChecksum = calcChecksum(upstreamSnapshot_->luaData);
+        } catch(const std::runtime_error&)
+        {
+            CloseUpstream("invalid map data");
+            return true;
+        }
+        upstream_->sendMsgAsync(
+          new GameMessage_Map_Checksum(upstreamSnapshot_->mapChecksum, upstreamSnapshot_->luaChecksum));
+    }
+    return true;
+}
+
+bool SpectatorRelay::OnGameMessage(const GameMessage_Map_ChecksumOK& msg)
+{
+    if(curSpectator_ || upstreamState_ != UpstreamState::ReceivingMap)
+        return true;
+    if(!msg.correct)
+        CloseUpstream("map transfer failed");
+    else
+        upstreamState_ = UpstreamState::ReceivingStart;
+    return true;
+}
@@ -0,0 +1,164 @@
+// Copyright (C) 2005 - 2021 Settlers Freaks (sf-team at siedler25.org)
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "Clock.h"
+#include "GameMessageInterface.h"
+#include "SerializedGameMessage.h"
+#include "gameTypes/CompressedData.h"
+#include "gameTypes/MapType.h"
+#include "s25util/Socket.h"
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+class Message;
+class NetworkPlayer;
+class SocketPollSet;
+
+/// Serves the finalized command stream of a running game to spectators which don't take part in the lockstep.
+/// Every message is released only after a configurable delay and then sent to each spectator as fast as its
+/// connection allows, so a slow spectator only falls behind (and gets dropped) instead of holding up the players.
+/// Spectators start watching from the latest released snapshot of the game.
+/// The stream is either fed by a GameServer or received from another relay to fan it out to more spectators.
+class SpectatorRelay : public GameMessageInterface
+{
+public:
+    /// Same (replaceable) clock as used by the GameServer
+    using SteadyClock = Clock;
+
+    struct Config
+    {
+        uint16_t port = 3666;
+        bool ipv6 = false;
+        /// Time by which the stream is delayed
+        SteadyClock::duration delay = SteadyClock::duration::zero();
+        /// Spectators falling behind the released stream by more than this are dropped
+        SteadyClock::duration maxLag = std::chrono::seconds(30);
+        unsigned maxNumSpectators = 500;
+    };
+
+    /// State of the game from which spectators can start watching
+    struct Snapshot
+    {
+        /// Map or savegame the spectators load
+        std::string mapName;
+        MapType mapType = MapType::OldMap;
+        CompressedData mapData, luaData;
+        /// Checksums confirmed by the spectators after receiving the data
+        unsigned mapChecksum = 0, luaChecksum = 0;
+        /// CRC32 of the uncompressed data to find it in the map cache of the spectators. 0 if not cacheable
+        uint32_t mapHash = 0, luaHash = 0;
+        /// Messages sent after the map was received. Ends with Server_Start or Server_Resync followed by the
+        /// messages required to continue from the snapshot which were added to the stream before it
+        std::vector<std::unique_ptr<Message>> startMsgs;
+        /// Index of the first message of the stream following the snapshot
+        uint64_t streamPos = 0;
+    };
+
+    explicit SpectatorRelay(Config config);
+    ~SpectatorRelay() override;
+
+    /// Start listening for spectators
+    bool Start();
+    /// Receive the stream from another relay or game server instead of it being added
+    bool ConnectUpstream(const std::string& host, uint16_t port);
+    void Stop();
+    bool IsRunning() const { return serverSocket_.isValid(); }
+    /// Return the port spectators can connect to, e.g. the one chosen by the OS when configured with port 0
+    uint16_t GetPort() const;
+    bool IsUpstreamConnected() const;
+    /// Are there messages which were not yet released or not yet sent to all spectators?
+    bool HasPendingMessages() const;
+
+    /// Add a snapshot taken after the first snapshot->streamPos messages of the stream
+    void AddSnapshot(std::unique_ptr<Snapshot> snapshot);
+    /// Add a message sent to all players to the stream. Messages not required for watching are ignored
+    void AddMessage(const Message& msg);
+    /// Number of messages added to the stream so far
+    uint64_t GetStreamSize() const { return streamStart_ + stream_.size(); }
+    unsigned GetNumSpectators() const;
+
+    void Run();
+    /// Add all sockets from which messages or connections are expected or which have data to send.
+    /// Return number of sockets added
+    unsigned AddSocketsToWaitFor(SocketPollSet& set) const;
+    /// Get the time till the next message is released or queued messages should be sent
+    SteadyClock::duration GetTimeToNextEvent() const;
+    /// Block until a message can be received or the next event is due. Waits at most maxWaitTime
+    void WaitForEvents(SteadyClock::duration maxWaitTime) const;
+
+    /// Is the message with the given ID relayed to spectators?
+    static bool isRelayed(uint16_t msgId);
+
+private:
+    struct Spectator;
+    struct StreamEntry
+    {
+        /// Shared by all spectators
+        SerializedGameMessage msg;
+        SteadyClock::time_point time;
+    };
+    enum class UpstreamState
+    {
+        Connecting,
+        ReceivingMap,
+        ReceivingStart,
+        Watching
+    };
+
+    void AcceptSpectators();
+    void RunUpstream();
+    void CheckSpectators();
+    void ReceiveFromSpectators();
+    void ReleaseMessages();
+    void SendToSpectators();
+    /// Send the pending messages of the spectator as long as its socket can take them
+    void SendToSpectator(Spectator& spectator);
+    void TrimStream();
+    void DropSpectator(Spectator& spectator, const char* reason);
+    /// Queue the map info of the released snapshot for the spectator
+    void SendMapInfo(Spectator& spectator);
+    bool HasDataToSend(const Spectator& spectator) const;
+    void CloseUpstream(const char* reason);
+
+    RTTR_IGNORE_OVERLOADED_VIRTUAL
+    // From spectators
+    bool OnGameMessage(const GameMessage_Pong& msg) override;
+    bool OnGameMessage(const GameMessage_Server_Type& msg) override;
+    bool OnGameMessage(const GameMessage_MapRequest& msg) override;
+    bool OnGameMessage(const GameMessage_Map_DataAck& msg) override;
+    bool OnGameMessage(const GameMessage_Map_Checksum& msg) override;
+    // From upstream
+    bool OnGameMessage(const GameMessage_Ping& msg) override;
+    bool OnGameMessage(const GameMessage_Player_Id& msg) override;
+    bool OnGameMessage(const GameMessage_Server_TypeOK& msg) override;
+    bool OnGameMessage(const GameMessage_Map_Info& msg) override;
+    bool OnGameMessage(const GameMessage_Map_Data& msg) override;
+    bool OnGameMessage(const GameMessage_Map_ChecksumOK& msg) override;
+    RTTR_POP_DIAGNOSTIC
+
+    Config config_;
+    Socket serverSocket_;
+    std::vector<Spectator> spectators_;
+    /// Spectator whose messages are currently executed, nullptr for the upstream
+    Spectator* curSpectator_ = nullptr;
+    unsigned nextSpectatorId_ = 0;
+
+    /// Messages of the stream starting at index streamStart_. The first releasedEnd_ - streamStart_ are released
+    std::deque<StreamEntry> stream_;
+    uint64_t streamStart_ = 0, releasedEnd_ = 0;
+    /// Snapshots ordered by their stream position. The first one is released if its position is <= releasedEnd_
+    std::deque<std::shared_ptr<const Snapshot>> snapshots_;
+
+    std::unique_ptr<NetworkPlayer> upstream_;
+    UpstreamState upstreamState_ = UpstreamState::Connecting;
+    /// Snapshot received from upstream until all its start messages are there
+    std::unique_ptr<Snapshot> upstreamSnapshot_;
+    unsigned numUpstreamMapBytes_ = 0, numUpstreamLuaBytes_ = 0, numUnackedUpstreamParts_ = 0;
+};
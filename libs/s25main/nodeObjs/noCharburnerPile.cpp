@@ -10,6 +10,7 @@
 #include "network/GameClient.h"
 #include "noEnvObject.h"
 #include "noFire.h"
+#include "notifications/NodeNote.h"
 #include "ogl/glArchivItem_Bitmap.h"
 #include "world/GameWorld.h"
 
@@ -41,6 +42,7 @@ void noCharburnerPile::Destroy()
 
     // Bauplätze drumrum neu berechnen
     world->RecalcBQAroundPointBig(pos);
+    world->GetNotifications().publish(NodeNote(NodeNote::ObjRemoved, pos));
 
     noCoordBase::Destroy();
 }
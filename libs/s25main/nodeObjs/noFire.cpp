@@ -12,6 +12,7 @@
 #include "addons/const_addons.h"
 #include "drivers/VideoDriverWrapper.h"
 #include "network/GameClient.h"
+#include "notifications/NodeNote.h"
 #include "ogl/glArchivItem_Bitmap.h"
 #include "world/GameWorld.h"
 
@@ -33,6 +34,7 @@ void noFire::Destroy()
     world->SetNO(pos, nullptr);
     // Bauplätze drumrum neu berechnen
     world->RecalcBQAroundPoint(pos);
+    world->GetNotifications().publish(NodeNote(NodeNote::ObjRemoved, pos));
 
     // Evtl Sounds vernichten
     world->GetSoundMgr().stopSounds(*this);
@@ -13,9 +13,10 @@ struct NodeNote
 
     enum Type
     {
-        Altitude, // Nodes altitude was changed
-        BQ,       // Building quality
+        Altitude,   // Nodes altitude was changed
+        BQ,         // Building quality
         Owner,
+        ObjRemoved, // Building (site), fire or charburner pile was removed. Does not need to change the BQ
     };
 
     NodeNote(Type type, const MapPoint& pt) : type(type), pos(pt) {}
@@ -0,0 +1,53 @@
+// Copyright (C) 2005 - 2021 Settlers Freaks (sf-team at siedler25.org)
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "DrawList.h"
+#include "s25util/colors.h"
+#include <algorithm>
+
+namespace {
+DrawList::Color toColor(unsigned color)
+{
+    return {{static_cast<uint8_t>(GetRed(color)), static_cast<uint8_t>(GetGreen(color)),
+             static_cast<uint8_t>(GetBlue(color)), static_cast<uint8_t>(GetAlpha(color))}};
+}
+} // namespace
+
+void DrawList::clear()
+{
+    rectVertices_.clear();
+    rectColors_.clear();
+    for(unsigned i = 0; i < numLineBatches_; i++)
+    {
+        lineBatches_[i].vertices.clear();
+        lineBatches_[i].colors.clear();
+    }
+    numLineBatches_ = 0;
+}
+
+void DrawList::addRect(const Rect& rect, unsigned color)
+{
+    rectVertices_.push_back(Vertex(rect.left, rect.top));
+    rectVertices_.push_back(Vertex(rect.left, rect.bottom));
+    rectVertices_.push_back(Vertex(rect.right, rect.bottom));
+    rectVertices_.push_back(Vertex(rect.right, rect.top));
+    rectColors_.insert(rectColors_.end(), 4, toColor(color));
+}
+
+void DrawList::addLine(DrawPoint pt1, DrawPoint pt2, unsigned width, unsigned color)
+{
+    const auto itEnd = lineBatches_.begin() + numLineBatches_;
+    auto it =
+      std::find_if(lineBatches_.begin(), itEnd, [width](const LineBatch& batch) { return batch.width == width; });
+    if(it == itEnd)
+    {
+        if(numLineBatches_ == lineBatches_.size())
+            lineBatches_.emplace_back();
+        it = lineBatches_.begin() + numLineBatches_++;
+        it->width = width;
+    }
+    it->vertices.push_back(Vertex(pt1));
+    it->vertices.push_back(Vertex(pt2));
+    it->colors.insert(it->colors.end(), 2, toColor(color));
+}
@@ -0,0 +1,50 @@
+// Copyright (C) 2005 - 2021 Settlers Freaks (sf-team at siedler25.org)
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "DrawPoint.h"
+#include "Point.h"
+#include "Rect.h"
+#include <array>
+#include <cstdint>
+#include <vector>
+
+/// Recorded list of untextured primitives (rectangles and lines) which can be drawn in one batch.
+/// Coordinates are relative to the position passed when drawing, so the list stays valid when its owner moves.
+/// Rectangles are drawn before lines and lines are grouped by their width.
+class DrawList
+{
+public:
+    using Vertex = Point<float>;
+    using Color = std::array<uint8_t, 4>;
+    struct LineBatch
+    {
+        unsigned width;
+        std::vector<Vertex> vertices;
+        std::vector<Color> colors;
+    };
+
+    /// Remove all primitives but keep the allocated memory
+    void clear();
+    bool empty() const { return rectVertices_.empty() && numLineBatches_ == 0; }
+
+    void addRect(const Rect& rect, unsigned color);
+    void addLine(DrawPoint pt1, DrawPoint pt2, unsigned width, unsigned color);
+
+    /// Vertices of all rectangles, 4 per rectangle
+    const std::vector<Vertex>& getRectVertices() const { return rectVertices_; }
+    const std::vector<Color>& getRectColors() const { return rectColors_; }
+    /// Number of valid entries in getLineBatches()
+    unsigned getNumLineBatches() const { return numLineBatches_; }
+    /// Lines grouped by their width, 2 vertices per line
+    const std::vector<LineBatch>& getLineBatches() const { return lineBatches_; }
+
+private:
+    std::vector<Vertex> rectVertices_;
+    std::vector<Color> rectColors_;
+    std::vector<LineBatch> lineBatches_;
+    /// Line batches beyond this are unused and only kept to reuse their memory
+    unsigned numLineBatches_ = 0;
+};
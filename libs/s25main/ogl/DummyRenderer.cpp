@@ -20,6 +20,7 @@ void APIENTRY glDeleteTextures(GLsizei, const GLuint*) {}
 void APIENTRY glBindTexture(GLenum, GLuint) {}
 void APIENTRY glTexParameteri(GLenum, GLenum, GLint) {}
 void APIENTRY glTexImage2D(GLenum, GLint, GLint, GLsizei, GLsizei, GLint, GLenum, GLenum, const GLvoid*) {}
+void APIENTRY glTexSubImage2D(GLenum, GLint, GLint, GLint, GLsizei, GLsizei, GLenum, GLenum, const GLvoid*) {}
 void APIENTRY glClear(GLbitfield) {}
 void APIENTRY glVertexPointer(GLint, GLenum, GLsizei, const GLvoid*) {}
 void APIENTRY glTexCoordPointer(GLint, GLenum, GLsizei, const GLvoid*) {}
@@ -42,6 +43,7 @@ bool DummyRenderer::initOpenGL(OpenGL_Loader_Proc)
     MOCK(glBindTexture);
     MOCK(glTexParameteri);
     MOCK(glTexImage2D);
+    MOCK(glTexSubImage2D);
     MOCK(glClear);
     MOCK(glVertexPointer);
     MOCK(glTexCoordPointer);
@@ -18,4 +18,5 @@ public:
     {}
     void DrawRect(const Rect&, unsigned) override {}
     void DrawLine(DrawPoint, DrawPoint, unsigned, unsigned) override {}
+    void DrawPrimitives(const DrawList&, DrawPoint) override {}
 };
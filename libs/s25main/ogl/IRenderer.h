@@ -7,6 +7,7 @@
 #include "DrawPoint.h"
 #include "Rect.h"
 
+class DrawList;
 class glArchivItem_Bitmap;
 
 /// Render functions for basic stuff
@@ -34,4 +35,6 @@ public:
                                unsigned color) = 0;
     virtual void DrawRect(const Rect& rect, unsigned color) = 0;
     virtual void DrawLine(DrawPoint pt1, DrawPoint pt2, unsigned width, unsigned color) = 0;
+    /// Draw all primitives of the list in as few calls as possible. Positions are relative to offset
+    virtual void DrawPrimitives(const DrawList& list, DrawPoint offset) = 0;
 };
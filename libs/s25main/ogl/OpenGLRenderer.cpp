@@ -3,6 +3,7 @@
 // SPDX-License-Identifier: GPL-2.0-or-later
 
 #include "OpenGLRenderer.h"
+#include "DrawList.h"
 #include "DrawPoint.h"
 #include "glArchivItem_Bitmap.h"
 #include "openglCfg.hpp"
@@ -120,6 +121,39 @@ void OpenGLRenderer::DrawLine(DrawPoint pt1, DrawPoint pt2, unsigned width, unsi
     glEnable(GL_TEXTURE_2D);
 }
 
+void OpenGLRenderer::DrawPrimitives(const DrawList& list, DrawPoint offset)
+{
+    if(list.empty())
+        return;
+
+    glDisable(GL_TEXTURE_2D);
+    // No texture coordinates are provided so they must not be read
+    glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+    glEnableClientState(GL_COLOR_ARRAY);
+    glPushMatrix();
+    glTranslatef(static_cast<GLfloat>(offset.x), static_cast<GLfloat>(offset.y), 0.0f);
+
+    if(!list.getRectVertices().empty())
+    {
+        glVertexPointer(2, GL_FLOAT, 0, list.getRectVertices().data());
+        glColorPointer(4, GL_UNSIGNED_BYTE, 0, list.getRectColors().data());
+        glDrawArrays(GL_QUADS, 0, list.getRectVertices().size());
+    }
+    for(unsigned i = 0; i < list.getNumLineBatches(); i++)
+    {
+        const DrawList::LineBatch& lines = list.getLineBatches()[i];
+        glLineWidth(static_cast<GLfloat>(lines.width));
+        glVertexPointer(2, GL_FLOAT, 0, lines.vertices.data());
+        glColorPointer(4, GL_UNSIGNED_BYTE, 0, lines.colors.data());
+        glDrawArrays(GL_LINES, 0, lines.vertices.size());
+    }
+
+    glPopMatrix();
+    glDisableClientState(GL_COLOR_ARRAY);
+    glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+    glEnable(GL_TEXTURE_2D);
+}
+
 bool OpenGLRenderer::initOpenGL(OpenGL_Loader_Proc loader)
 {
 #if RTTR_OGL_ES
@@ -18,4 +18,5 @@ public:
                        unsigned color) override;
     void DrawRect(const Rect& rect, unsigned color) override;
     void DrawLine(DrawPoint pt1, DrawPoint pt2, unsigned width, unsigned color) override;
+    void DrawPrimitives(const DrawList& list, DrawPoint offset) override;
 };
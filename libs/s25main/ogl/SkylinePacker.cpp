@@ -0,0 +1,94 @@
+// Copyright (C) 2005 - 2021 Settlers Freaks (sf-team at siedler25.org)
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "SkylinePacker.h"
+#include <algorithm>
+#include <limits>
+
+SkylinePacker::SkylinePacker(const Extent& size) : size_(size), usedArea_(0)
+{
+    clear();
+}
+
+void SkylinePacker::clear()
+{
+    skyline_.clear();
+    skyline_.push_back(Segment{0, 0, size_.x});
+    usedArea_ = 0;
+}
+
+boost::optional<unsigned> SkylinePacker::fit(unsigned segmentIdx, const Extent& itemSize) const
+{
+    if(skyline_[segmentIdx].x + itemSize.x > size_.x)
+        return boost::none;
+    // The item rests on the highest segment it spans
+    unsigned y = 0;
+    unsigned widthLeft = itemSize.x;
+    for(unsigned i = segmentIdx; widthLeft > 0; i++)
+    {
+        y = std::max(y, skyline_[i].y);
+        if(y + itemSize.y > size_.y)
+            return boost::none;
+        if(skyline_[i].width >= widthLeft)
+            break;
+        widthLeft -= skyline_[i].width;
+    }
+    return y;
+}
+
+boost::optional<Extent> SkylinePacker::insert(const Extent& itemSize)
+{
+    if(itemSize.x == 0 || itemSize.y == 0)
+        return Extent(0, 0);
+
+    // Choose the position with the lowest top edge, leftmost on ties
+    unsigned bestIdx = 0;
+    unsigned bestTop = std::numeric_limits<unsigned>::max();
+    unsigned bestY = 0;
+    for(unsigned i = 0; i < skyline_.size(); i++)
+    {
+        const boost::optional<unsigned> y = fit(i, itemSize);
+        if(y && *y + itemSize.y < bestTop)
+        {
+            bestIdx = i;
+            bestY = *y;
+            bestTop = *y + itemSize.y;
+        }
+    }
+    if(bestTop == std::numeric_limits<unsigned>::max())
+        return boost::none;
+
+    const Extent pos(skyline_[bestIdx].x, bestY);
+    const unsigned itemEnd = pos.x + itemSize.x;
+    skyline_.insert(skyline_.begin() + bestIdx, Segment{pos.x, bestTop, itemSize.x});
+
+    // Cut away the parts of the following segments now covered by the item
+    auto it = skyline_.begin() + bestIdx + 1;
+    while(it != skyline_.end() && it->x < itemEnd)
+    {
+        if(it->x + it->width <= itemEnd)
+            it = skyline_.erase(it);
+        else
+        {
+            const unsigned overlap = itemEnd - it->x;
+            it->x += overlap;
+            it->width -= overlap;
+            break;
+        }
+    }
+
+    // Merge neighbours of the same height
+    for(unsigned i = 1; i < skyline_.size();)
+    {
+        if(skyline_[i - 1].y == skyline_[i].y)
+        {
+            skyline_[i - 1].width += skyline_[i].width;
+            skyline_.erase(skyline_.begin() + i);
+        } else
+            i++;
+    }
+
+    usedArea_ += itemSize.x * itemSize.y;
+    return pos;
+}
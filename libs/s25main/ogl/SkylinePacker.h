@@ -0,0 +1,40 @@
+// Copyright (C) 2005 - 2021 Settlers Freaks (sf-team at siedler25.org)
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "Point.h"
+#include <boost/optional.hpp>
+#include <vector>
+
+/// Packs rectangles into a fixed area using the skyline bottom-left heuristic.
+/// Only the upper contour ("skyline") of the used area is stored, so rectangles can be added at any time.
+class SkylinePacker
+{
+public:
+    explicit SkylinePacker(const Extent& size);
+
+    /// Find a free position for a rectangle of the given size and mark that area as used.
+    /// Return boost::none if there is not enough space left
+    boost::optional<Extent> insert(const Extent& itemSize);
+    /// Remove all rectangles
+    void clear();
+
+    const Extent& getSize() const { return size_; }
+    /// Area covered by inserted rectangles
+    unsigned getUsedArea() const { return usedArea_; }
+
+private:
+    struct Segment
+    {
+        unsigned x, y, width;
+    };
+    /// Return the y position at which the item can be placed with its left side at the start of the given segment
+    boost::optional<unsigned> fit(unsigned segmentIdx, const Extent& itemSize) const;
+
+    Extent size_;
+    unsigned usedArea_;
+    /// Segments of the skyline ordered by x, covering the whole width
+    std::vector<Segment> skyline_;
+};
@@ -3,23 +3,75 @@
 // SPDX-License-Identifier: GPL-2.0-or-later
 
 #include "glArchivItem_Bitmap.h"
+#include "Loader.h"
 #include "Point.h"
 #include "drivers/VideoDriverWrapper.h"
+#include "ogl/glTexturePacker.h"
 #include "libsiedler2/PixelBufferBGRA.h"
 #include <glad/glad.h>
+#include <utility>
 
-glArchivItem_Bitmap::glArchivItem_Bitmap() = default;
+namespace {
+/// Bigger bitmaps (e.g. backgrounds) would only waste space on the shared textures
+constexpr unsigned MAX_SHARED_BITMAP_SIZE = 256;
+} // namespace
+
+glArchivItem_Bitmap::glArchivItem_Bitmap() : sharedTexturePos_(0, 0), sharedTextureRefused_(false) {}
 
 glArchivItem_Bitmap::glArchivItem_Bitmap(const glArchivItem_Bitmap& item)
-    : ArchivItem_BitmapBase(item), baseArchivItem_Bitmap(item), glArchivItem_BitmapBase(item)
+    : ArchivItem_BitmapBase(item), baseArchivItem_Bitmap(item), glArchivItem_BitmapBase(item),
+      sharedTexturePos_(0, 0), sharedTextureRefused_(false)
 {}
 
+void glArchivItem_Bitmap::setInterpolateTexture(bool interpolate)
+{
+    glArchivItem_BitmapBase::setInterpolateTexture(interpolate);
+    // The shared textures don't interpolate
+    if(!UsesNearestFilter())
+        sharedTexture_.reset();
+    sharedTextureRefused_ = false;
+}
+
+bool glArchivItem_Bitmap::PlaceOnSharedTexture()
+{
+    if(sharedTexture_)
+        return true;
+    if(sharedTextureRefused_)
+        return false;
+    // Not available (yet)
+    glTexturePacker* packer = LOADER.getTexturePacker();
+    if(!packer)
+        return false;
+
+    const Extent size = GetSize();
+    // Interpolating would mix in the neighbours on the shared texture
+    if(!CanUseSharedTexture() || !UsesNearestFilter() || size.x > MAX_SHARED_BITMAP_SIZE
+       || size.y > MAX_SHARED_BITMAP_SIZE)
+    {
+        sharedTextureRefused_ = true;
+        return false;
+    }
+
+    SetDefaultPaletteIfRequired();
+    libsiedler2::PixelBufferBGRA buffer(size.x, size.y);
+    print(buffer);
+    boost::optional<glTexturePacker::Placement> placement = packer->insert(buffer);
+    if(!placement)
+    {
+        sharedTextureRefused_ = true;
+        return false;
+    }
+    sharedTexture_ = std::move(placement->texture);
+    sharedTexturePos_ = placement->pos;
+    return true;
+}
+
 /**
  *  Zeichnet die Textur.
  */
 void glArchivItem_Bitmap::Draw(Rect dstArea, Rect srcArea, unsigned color /*= COLOR_WHITE*/)
 {
-    if(GetTexture() == 0)
+    if(getWidth() == 0 || getHeight() == 0)
         return;
 
     RTTR_Assert(dstArea.getSize().x > 0 && dstArea.getSize().y > 0);
@@ -40,6 +92,24 @@ void glArchivItem_Bitmap::Draw(Rect dstArea, Rect srcArea, unsigned color /*= CO
 
     RTTR_Assert(getBobType() != libsiedler2::BobType::BitmapPlayer);
 
+    unsigned texture;
+    Point<GLfloat> texOrigin(0, 0), texSize;
+    // Parts outside of the bitmap are transparent on the own texture but other bitmaps on a shared one
+    const bool isSrcInside = srcArea.left >= 0 && srcArea.top >= 0 && srcArea.right <= static_cast<int>(getWidth())
+                             && srcArea.bottom <= static_cast<int>(getHeight());
+    if(isSrcInside && PlaceOnSharedTexture())
+    {
+        texture = sharedTexture_->get();
+        texOrigin = Point<GLfloat>(sharedTexturePos_);
+        texSize = Point<GLfloat>(sharedTexture_->getSize());
+    } else
+    {
+        texture = GetTexture();
+        if(texture == 0)
+            return;
+        texSize = Point<GLfloat>(GetTexSize());
+    }
+
     std::array<Point<GLfloat>, 4> texCoords, vertices;
 
     dstArea.move(-GetOrigin());
@@ -49,8 +119,8 @@ void glArchivItem_Bitmap::Draw(Rect dstArea, Rect srcArea, unsigned color /*= CO
     vertices[0].y = vertices[3].y = GLfloat(dstArea.top);
     vertices[1].y = vertices[2].y = GLfloat(dstArea.bottom);
 
-    Point<GLfloat> srcOrig = Point<GLfloat>(srcArea.getOrigin()) / GetTexSize();
-    Point<GLfloat> srcEndPt = Point<GLfloat>(srcArea.getEndPt()) / GetTexSize();
+    Point<GLfloat> srcOrig = (texOrigin + Point<GLfloat>(srcArea.getOrigin())) / texSize;
+    Point<GLfloat> srcEndPt = (texOrigin + Point<GLfloat>(srcArea.getEndPt())) / texSize;
     texCoords[0].x = texCoords[1].x = srcOrig.x;
     texCoords[2].x = texCoords[3].x = srcEndPt.x;
     texCoords[0].y = texCoords[3].y = srcOrig.y;
@@ -58,7 +128,7 @@ void glArchivItem_Bitmap::Draw(Rect dstArea, Rect srcArea, unsigned color /*= CO
 
     glVertexPointer(2, GL_FLOAT, 0, vertices.data());
     glTexCoordPointer(2, GL_FLOAT, 0, texCoords.data());
-    VIDEODRIVER.BindTexture(GetTexture());
+    VIDEODRIVER.BindTexture(texture);
     glColor4ub(GetRed(color), GetGreen(color), GetBlue(color), GetAlpha(color));
     glDrawArrays(GL_QUADS, 0, 4);
 }
@@ -10,6 +10,9 @@
 #include "glArchivItem_BitmapBase.h"
 #include "libsiedler2/ArchivItem_Bitmap.h"
 #include "s25util/colors.h"
+#include <memory>
+
+class glTexture;
 
 /// Basisklasse für GL-Bitmapitems.
 class glArchivItem_Bitmap :
@@ -34,6 +37,7 @@ public:
 
     Position GetOrigin() const override { return glArchivItem_BitmapBase::GetOrigin(); }
     Extent GetSize() const override { return glArchivItem_BitmapBase::GetSize(); }
+    void setInterpolateTexture(bool interpolate) override;
 
 protected:
     /// Draw the texture.
@@ -42,4 +46,17 @@ protected:
     void Draw(Rect dstArea, Rect srcArea, unsigned color = COLOR_WHITE);
     void FillTexture() override;
     Extent CalcTextureSize() const override;
+    /// Whether the bitmap may be drawn from a texture shared with other bitmaps instead of its own one
+    virtual bool CanUseSharedTexture() const { return true; }
+
+private:
+    /// Put the bitmap onto a shared texture if possible and not done yet. Return true if it is on one
+    bool PlaceOnSharedTexture();
+
+    /// Shared texture (see glTexturePacker) holding the bitmap if it is drawn from there
+    std::shared_ptr<const glTexture> sharedTexture_;
+    /// Position of the bitmap on the shared texture
+    Extent sharedTexturePos_;
+    /// Whether the texture packer refused the bitmap already
+    bool sharedTextureRefused_;
 };
@@ -79,8 +79,7 @@ void glArchivItem_BitmapBase::GenerateTexture()
     if(!texture)
         return;
 
-    if(!getPalette() && getFormat() == libsiedler2::TextureFormat::Paletted)
-        setPaletteCopy(*LOADER.GetPaletteN("pal5"));
+    SetDefaultPaletteIfRequired();
 
     VIDEODRIVER.BindTexture(texture);
 
@@ -91,6 +90,12 @@ void glArchivItem_BitmapBase::GenerateTexture()
     FillTexture();
 }
 
+void glArchivItem_BitmapBase::SetDefaultPaletteIfRequired()
+{
+    if(!getPalette() && getFormat() == libsiedler2::TextureFormat::Paletted)
+        setPaletteCopy(*LOADER.GetPaletteN("pal5"));
+}
+
 int glArchivItem_BitmapBase::GetInternalFormat() const
 {
     return GL_RGBA;
@@ -44,4 +44,8 @@ protected:
     virtual Extent CalcTextureSize() const = 0;
     /// Returns the currently set texture or 0 if none created
     unsigned GetTexNoCreate() const { return texture; }
+    /// Whether the texture is (or will be) created with GL_NEAREST filtering
+    bool UsesNearestFilter() const { return interpolateTexture_; }
+    /// Use the default palette if the bitmap requires one but has none
+    void SetDefaultPaletteIfRequired();
 };
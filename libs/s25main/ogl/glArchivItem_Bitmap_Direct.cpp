@@ -6,12 +6,14 @@
 #include "drivers/VideoDriverWrapper.h"
 #include "libsiedler2/PixelBufferBGRA.h"
 #include <glad/glad.h>
+#include <algorithm>
 #include <stdexcept>
 
-glArchivItem_Bitmap_Direct::glArchivItem_Bitmap_Direct() : isUpdating_(false) {}
+glArchivItem_Bitmap_Direct::glArchivItem_Bitmap_Direct() : isUpdating_(false), numTiles_(0, 0) {}
 
 glArchivItem_Bitmap_Direct::glArchivItem_Bitmap_Direct(const glArchivItem_Bitmap_Direct& item)
-    : ArchivItem_BitmapBase(item), baseArchivItem_Bitmap(item), glArchivItem_Bitmap(item), isUpdating_(false)
+    : ArchivItem_BitmapBase(item), baseArchivItem_Bitmap(item), glArchivItem_Bitmap(item), isUpdating_(false),
+      numTiles_(0, 0)
 {}
 
 void glArchivItem_Bitmap_Direct::beginUpdate()
@@ -19,7 +21,15 @@ void glArchivItem_Bitmap_Direct::beginUpdate()
     if(isUpdating_)
         throw std::logic_error("Already updating! Forgot an endUpdate?");
     isUpdating_ = true;
-    areaToUpdate_ = Rect(0, 0, 0, 0);
+    const Extent size = GetSize();
+    const Extent numTiles((size.x + UPDATE_TILE_SIZE - 1) / UPDATE_TILE_SIZE,
+                          (size.y + UPDATE_TILE_SIZE - 1) / UPDATE_TILE_SIZE);
+    if(numTiles != numTiles_)
+    {
+        numTiles_ = numTiles;
+        dirtyTiles_.assign(prodOfComponents(numTiles_), false);
+    }
+    dirtyTileArea_ = Rect(0, 0, 0, 0);
 }
 
 void glArchivItem_Bitmap_Direct::endUpdate()
@@ -27,12 +37,45 @@ void glArchivItem_Bitmap_Direct::endUpdate()
     if(!isUpdating_)
         throw std::logic_error("Already updating! Forgot an endUpdate?");
     isUpdating_ = false;
-    // Nothing to update or no texture created yet
-    if(prodOfComponents(areaToUpdate_.getSize()) == 0 || !GetTexNoCreate())
+    // Nothing to update
+    if(prodOfComponents(dirtyTileArea_.getSize()) == 0)
         return;
 
-    libsiedler2::PixelBufferBGRA buffer(areaToUpdate_.getSize().x, areaToUpdate_.getSize().y);
-    Position origin = areaToUpdate_.getOrigin();
+    // Upload horizontal runs of dirty tiles so spread out changes don't upload the whole bounding box
+    const bool hasTexture = GetTexNoCreate() != 0;
+    for(int y = dirtyTileArea_.top; y < dirtyTileArea_.bottom; ++y)
+    {
+        int x = dirtyTileArea_.left;
+        while(x < dirtyTileArea_.right)
+        {
+            const unsigned rowStart = y * numTiles_.x;
+            if(!dirtyTiles_[rowStart + x])
+            {
+                ++x;
+                continue;
+            }
+            const int runStart = x;
+            for(; x < dirtyTileArea_.right && dirtyTiles_[rowStart + x]; ++x)
+                dirtyTiles_[rowStart + x] = false;
+            if(hasTexture)
+            {
+                const int tileSize = static_cast<int>(UPDATE_TILE_SIZE);
+                Rect area;
+                area.left = runStart * tileSize;
+                area.top = y * tileSize;
+                // Clip to bitmap size
+                area.right = std::min(x * tileSize, static_cast<int>(GetSize().x));
+                area.bottom = std::min((y + 1) * tileSize, static_cast<int>(GetSize().y));
+                uploadArea(area);
+            }
+        }
+    }
+}
+
+void glArchivItem_Bitmap_Direct::uploadArea(const Rect& area)
+{
+    libsiedler2::PixelBufferBGRA buffer(area.getSize().x, area.getSize().y);
+    Position origin = area.getOrigin();
     int ec = print(buffer, nullptr, 0, 0, origin.x, origin.y);
     RTTR_Assert(ec == 0);
     VIDEODRIVER.BindTexture(GetTexNoCreate());
@@ -46,19 +89,21 @@ void glArchivItem_Bitmap_Direct::updatePixel(const DrawPoint& pos, const libsied
     RTTR_Assert(pos.x >= 0 && pos.y >= 0);
     RTTR_Assert(static_cast<unsigned>(pos.x) < GetSize().x && static_cast<unsigned>(pos.y) < GetSize().y);
     setPixel(pos.x, pos.y, clr);
+    const Position tile(pos.x / UPDATE_TILE_SIZE, pos.y / UPDATE_TILE_SIZE);
+    dirtyTiles_[tile.y * numTiles_.x + tile.x] = true;
     // If the area is empty, create one
-    if(areaToUpdate_.getSize().x == 0)
-        areaToUpdate_ = Rect(Position(pos), Extent(1, 1));
+    if(dirtyTileArea_.getSize().x == 0)
+        dirtyTileArea_ = Rect(tile, Extent(1, 1));
     else
     {
         // Else resize if required
-        if(pos.x < areaToUpdate_.left)
-            areaToUpdate_.left = pos.x;
-        if(pos.x >= areaToUpdate_.right)
-            areaToUpdate_.right = pos.x + 1;
-        if(pos.y < areaToUpdate_.top)
-            areaToUpdate_.top = pos.y;
-        if(pos.y >= areaToUpdate_.bottom)
-            areaToUpdate_.bottom = pos.y + 1;
+        if(tile.x < dirtyTileArea_.left)
+            dirtyTileArea_.left = tile.x;
+        if(tile.x >= dirtyTileArea_.right)
+            dirtyTileArea_.right = tile.x + 1;
+        if(tile.y < dirtyTileArea_.top)
+            dirtyTileArea_.top = tile.y;
+        if(tile.y >= dirtyTileArea_.bottom)
+            dirtyTileArea_.bottom = tile.y + 1;
     }
 }
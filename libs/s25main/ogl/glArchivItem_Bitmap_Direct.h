@@ -6,6 +6,7 @@
 
 #include "Rect.h"
 #include "glArchivItem_Bitmap.h"
+#include <vector>
 
 namespace libsiedler2 {
 struct ColorBGRA;
@@ -21,7 +22,7 @@ public:
 
     /// Call before updating texture
     void beginUpdate();
-    /// Call after updating texture
+    /// Call after updating texture. Uploads only the (coalesced) tiles that were changed
     void endUpdate();
     /// Updates a pixels color
     void updatePixel(const DrawPoint& pos, const libsiedler2::ColorBGRA& clr);
@@ -31,7 +32,22 @@ public:
     /// schreibt die Bilddaten in eine Datei.
     int write(std::ostream& /*file*/, const libsiedler2::ArchivItem_Palette* /*palette*/) const override { return 254; }
 
+    /// Size of the tiles (in pixels) used to track changed areas
+    static constexpr unsigned UPDATE_TILE_SIZE = 32;
+
+protected:
+    /// The pixels are changed in the own texture
+    bool CanUseSharedTexture() const override { return false; }
+
 private:
+    /// Upload the given area of the bitmap to the texture
+    void uploadArea(const Rect& area);
+
     bool isUpdating_;
-    Rect areaToUpdate_;
+    /// Number of tiles in x and y direction
+    Extent numTiles_;
+    /// Flag for each tile (row major) whether it contains changed pixels
+    std::vector<bool> dirtyTiles_;
+    /// Area containing all dirty tiles (in tiles)
+    Rect dirtyTileArea_;
 };
@@ -15,8 +15,11 @@
 #include "libsiedler2/libsiedler2.h"
 #include "s25util/utf8.h"
 #include <boost/algorithm/string.hpp>
+#include <boost/functional/hash.hpp>
 #include <boost/nowide/detail/utf.hpp>
+#include <algorithm>
 #include <cmath>
+#include <functional>
 #include <vector>
 
 constexpr bool RTTR_PRINT_FONTS = false;
@@ -176,10 +179,92 @@ void glFont::Draw(DrawPoint pos, const std::string& text, FontStyle format, unsi
 {
     RTTR_Assert(s25util::isValidUTF8(text));
 
+    if(text.empty())
+        return;
+
+    // Get texture first as it might need to be created
+    glArchivItem_Bitmap& usedFont = format.is(FontStyle::NO_OUTLINE) ? *fontNoOutline : *fontWithOutline;
+    unsigned texture = usedFont.GetTexture();
+    if(!texture)
+        return;
+
+    const TextLayout& layout = GetLayout(text, maxWidth, end, GlPoint(usedFont.GetTexSize()));
+    if(layout.vertices.vertices.empty())
+        return;
+
+    // Vertical alignment (assumes 1 line only!)
+    if(format.is(FontStyle::BOTTOM))
+        pos.y -= maxCharSize.y;
+    else if(format.is(FontStyle::VCENTER))
+        pos.y -= maxCharSize.y / 2;
+    // Horizontal alignment
+    if(format.is(FontStyle::RIGHT))
+        pos.x -= layout.width;
+    else if(format.is(FontStyle::CENTER))
+        pos.x -= layout.width / 2;
+
+    const GlPoint offset(pos);
+    drawVertices.resize(layout.vertices.vertices.size());
+    std::transform(layout.vertices.vertices.begin(), layout.vertices.vertices.end(), drawVertices.begin(),
+                   [offset](const GlPoint& pt) { return pt + offset; });
+
+    glVertexPointer(2, GL_FLOAT, 0, &drawVertices[0]);
+    glTexCoordPointer(2, GL_FLOAT, 0, &layout.vertices.texCoords[0]);
+    VIDEODRIVER.BindTexture(texture);
+    glColor4ub(GetRed(color), GetGreen(color), GetBlue(color), GetAlpha(color));
+    glDrawArrays(GL_QUADS, 0, drawVertices.size());
+}
+
+const glFont::TextLayout& glFont::GetLayout(const std::string& text, unsigned short maxWidth, const std::string& end,
+                                            const GlPoint& texSize) const
+{
+    size_t hash = std::hash<std::string>()(text);
+    boost::hash_combine(hash, end);
+    boost::hash_combine(hash, maxWidth);
+
+    const auto itLookup = textCacheLookup.find(hash);
+    if(itLookup != textCacheLookup.end())
+    {
+        const auto itEntry = itLookup->second;
+        // Move to front as it is the most recently used one. Iterators stay valid
+        textCache.splice(textCache.begin(), textCache, itEntry);
+        if(itEntry->maxWidth == maxWidth && itEntry->text == text && itEntry->end == end)
+            return *itEntry;
+        // Else it is a hash collision and the entry gets replaced below
+    } else
+    {
+        if(textCache.size() >= MAX_CACHED_TEXTS)
+        {
+            // Reuse the least recently used entry to avoid reallocating its buffers
+            const auto itLast = std::prev(textCache.end());
+            textCacheLookup.erase(itLast->hash);
+            textCache.splice(textCache.begin(), textCache, itLast);
+        } else
+            textCache.emplace_front();
+        textCacheLookup[hash] = textCache.begin();
+    }
+
+    TextLayout& layout = textCache.front();
+    layout.hash = hash;
+    layout.text = text;
+    layout.end = end;
+    layout.maxWidth = maxWidth;
+    CreateLayout(layout, texSize);
+    return layout;
+}
+
+void glFont::CreateLayout(TextLayout& layout, const GlPoint& texSize) const
+{
+    const std::string& text = layout.text;
+    const std::string& end = layout.end;
+    layout.vertices.texCoords.clear();
+    layout.vertices.vertices.clear();
+    layout.width = 0;
+
     unsigned maxNumChars;
     unsigned short textWidth;
     bool drawEnd;
-    if(maxWidth == 0xFFFF)
+    if(layout.maxWidth == 0xFFFF)
     {
         maxNumChars = text.size();
         textWidth = getWidth(text);
@@ -187,7 +272,7 @@ void glFont::Draw(DrawPoint pos, const std::string& text, FontStyle format, unsi
     } else
     {
         RTTR_Assert(s25util::isValidUTF8(end));
-        textWidth = getWidth(text, maxWidth, &maxNumChars);
+        textWidth = getWidth(text, layout.maxWidth, &maxNumChars);
         if(!end.empty() && maxNumChars < text.size())
         {
             unsigned short endWidth = getWidth(end);
@@ -205,26 +290,14 @@ void glFont::Draw(DrawPoint pos, const std::string& text, FontStyle format, unsi
 
     if(maxNumChars == 0)
         return;
+    layout.width = textWidth;
     const auto itEnd = text.cbegin() + maxNumChars;
 
-    // Vertical alignment (assumes 1 line only!)
-    if(format.is(FontStyle::BOTTOM))
-        pos.y -= maxCharSize.y;
-    else if(format.is(FontStyle::VCENTER))
-        pos.y -= maxCharSize.y / 2;
-    // Horizontal alignment
-    if(format.is(FontStyle::RIGHT))
-        pos.x -= textWidth;
-    else if(format.is(FontStyle::CENTER))
-        pos.x -= textWidth / 2;
-
-    texList.texCoords.clear();
-    texList.vertices.clear();
-
+    DrawPoint curPos(0, 0);
     for(auto it = text.begin(); it != itEnd;)
     {
         const utf::code_point curChar = utf8::decode(it, itEnd);
-        DrawChar(curChar, texList, pos);
+        DrawChar(curChar, layout.vertices, curPos);
     }
 
     if(drawEnd)
@@ -232,29 +305,14 @@ void glFont::Draw(DrawPoint pos, const std::string& text, FontStyle format, unsi
         for(auto it = end.begin(); it != end.end();)
         {
             const utf::code_point curChar = utf8::decode(it, end.end());
-            DrawChar(curChar, texList, pos);
+            DrawChar(curChar, layout.vertices, curPos);
         }
     }
 
-    if(texList.vertices.empty())
-        return;
-
-    // Get texture first as it might need to be created
-    glArchivItem_Bitmap& usedFont = format.is(FontStyle::NO_OUTLINE) ? *fontNoOutline : *fontWithOutline;
-    unsigned texture = usedFont.GetTexture();
-    if(!texture)
-        return;
-    const GlPoint texSize(usedFont.GetTexSize());
-    RTTR_Assert(texList.texCoords.size() == texList.vertices.size());
-    RTTR_Assert(texList.texCoords.size() % 4u == 0);
-    for(GlPoint& pt : texList.texCoords)
+    RTTR_Assert(layout.vertices.texCoords.size() == layout.vertices.vertices.size());
+    RTTR_Assert(layout.vertices.texCoords.size() % 4u == 0);
+    for(GlPoint& pt : layout.vertices.texCoords)
         pt /= texSize;
-
-    glVertexPointer(2, GL_FLOAT, 0, &texList.vertices[0]);
-    glTexCoordPointer(2, GL_FLOAT, 0, &texList.texCoords[0]);
-    VIDEODRIVER.BindTexture(texture);
-    glColor4ub(GetRed(color), GetGreen(color), GetBlue(color), GetAlpha(color));
-    glDrawArrays(GL_QUADS, 0, texList.vertices.size());
 }
 
 template<bool T_limitWidth>
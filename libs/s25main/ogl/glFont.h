@@ -9,11 +9,13 @@
 #include "ogl/FontStyle.h"
 #include "ogl/glArchivItem_Bitmap.h"
 #include "s25util/colors.h"
+#include <boost/container/flat_map.hpp>
 #include <glad/glad.h>
 #include <array>
-#include <map>
+#include <list>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace libsiedler2 {
@@ -68,6 +70,11 @@ public:
     /// liefert die Breite eines Zeichens
     unsigned CharWidth(char32_t c) const { return GetCharInfo(c).width; }
 
+    /// Maximum number of laid out texts kept for reuse by Draw
+    static constexpr unsigned MAX_CACHED_TEXTS = 256;
+    /// Return the number of currently cached text layouts
+    unsigned getNumCachedTexts() const { return static_cast<unsigned>(textCache.size()); }
+
 private:
     struct CharInfo
     {
@@ -83,10 +90,27 @@ private:
         std::vector<GlPoint> vertices;
     };
 
+    /// Laid out text which is independent of position, alignment and color
+    struct TextLayout
+    {
+        size_t hash;
+        std::string text, end;
+        unsigned short maxWidth;
+        unsigned short width;
+        /// Vertices relative to the (unaligned) draw position with normalized texture coordinates
+        VertexArrays vertices;
+    };
+    using TextCache = std::list<TextLayout>;
+
     void AddCharInfo(char32_t c, const CharInfo& info);
     /// liefert das Char-Info eines Zeichens
     const CharInfo& GetCharInfo(char32_t c) const;
     void DrawChar(char32_t curChar, VertexArrays& vertices, DrawPoint& curPos) const;
+    /// Get the layout for the text from the cache or create it (possibly evicting the least recently used one)
+    const TextLayout& GetLayout(const std::string& text, unsigned short maxWidth, const std::string& end,
+                                const GlPoint& texSize) const;
+    /// Fill the layout with the glyphs of its text
+    void CreateLayout(TextLayout& layout, const GlPoint& texSize) const;
 
     Extent maxCharSize; // How big each char is at most (aka dx,dy)
     std::unique_ptr<glArchivItem_Bitmap> fontNoOutline;
@@ -94,9 +118,15 @@ private:
 
     /// Holds ascii chars only. As most chars are ascii this is faster then accessing the map
     std::array<std::pair<bool, CharInfo>, 256> asciiMapping;
-    std::map<char32_t, CharInfo> utf8_mapping;
+    /// Sorted contiguous storage for all other chars which is faster to search than a node based map
+    boost::container::flat_map<char32_t, CharInfo> utf8_mapping;
     CharInfo placeHolder;         /// Placeholder if glyph is missing
-    mutable VertexArrays texList; /// Buffer to hold last textures. Used so memory reallocations are avoided
+    /// Buffer to hold the positioned vertices of the last text. Used so memory reallocations are avoided
+    mutable std::vector<GlPoint> drawVertices;
+    /// Most recently used text layouts, most recent first
+    mutable TextCache textCache;
+    /// Maps the hash of (text, maxWidth, end) to the entry in the cache
+    mutable std::unordered_map<size_t, TextCache::iterator> textCacheLookup;
 
     /// Get width of the sequence defined by the begin/end pair of iterators
     template<bool T_unlimitedWidth>
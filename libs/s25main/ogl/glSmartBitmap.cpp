@@ -6,12 +6,14 @@
 #include "Loader.h"
 #include "drivers/VideoDriverWrapper.h"
 #include "ogl/glBitmapItem.h"
+#include "ogl/glTexturePacker.h"
 #include "libsiedler2/ArchivItem_Bitmap.h"
 #include "libsiedler2/ArchivItem_Bitmap_Player.h"
 #include "libsiedler2/PixelBufferBGRA.h"
 #include "s25util/colors.h"
 #include <glad/glad.h>
 #include <limits>
+#include <utility>
 
 namespace {
 struct GL_RGBAColor
@@ -20,7 +22,7 @@ struct GL_RGBAColor
 };
 } // namespace
 
-glSmartBitmap::glSmartBitmap() : origin_(0, 0), size_(0, 0), sharedTexture(false), texture(0), hasPlayer(false) {}
+glSmartBitmap::glSmartBitmap() : origin_(0, 0), size_(0, 0), texture(0), hasPlayer(false) {}
 
 glSmartBitmap::~glSmartBitmap()
 {
@@ -31,6 +33,7 @@ void glSmartBitmap::reset()
 {
     if(texture && !sharedTexture)
         VIDEODRIVER.DeleteTexture(texture);
+    sharedTexture.reset();
     texture = 0;
 
     for(glBitmapItem& bmpItem : items)
@@ -41,6 +44,12 @@ void glSmartBitmap::reset()
     items.clear();
 }
 
+void glSmartBitmap::setSharedTexture(std::shared_ptr<const glTexture> tex)
+{
+    sharedTexture = std::move(tex);
+    texture = sharedTexture ? sharedTexture->get() : 0;
+}
+
 Extent glSmartBitmap::getRequiredTexSize() const
 {
     Extent texSize(size_);
@@ -249,7 +258,9 @@ void glSmartBitmap::drawPercent(DrawPoint drawPt, unsigned percent, unsigned col
 {
     if(!texture)
     {
-        generateTexture();
+        // Bitmaps not packed at startup are added to the shared textures on first use
+        if(!LOADER.addToSharedTextures(*this))
+            generateTexture();
 
         if(!texture)
             return;
@@ -17,6 +17,7 @@ class PixelBufferBGRA;
 } // namespace libsiedler2
 
 class glBitmapItem;
+class glTexture;
 
 class glSmartBitmap : public ITexture
 {
@@ -24,7 +25,8 @@ private:
     DrawPoint origin_;
     Extent size_;
 
-    bool sharedTexture;
+    /// Texture shared with other bitmaps, if used
+    std::shared_ptr<const glTexture> sharedTexture;
     unsigned texture;
 
     bool hasPlayer;
@@ -50,11 +52,8 @@ public:
     bool isPlayer() const { return hasPlayer; }
     bool empty() const { return items.empty(); }
 
-    void setSharedTexture(unsigned tex)
-    {
-        texture = tex;
-        sharedTexture = (tex != 0);
-    }
+    /// Use the given texture shared with other bitmaps (see glTexturePacker)
+    void setSharedTexture(std::shared_ptr<const glTexture> tex);
     unsigned getTexture() const { return texture; }
 
     void generateTexture();
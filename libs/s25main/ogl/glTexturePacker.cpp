@@ -5,7 +5,6 @@
 #include "glTexturePacker.h"
 #include "drivers/VideoDriverWrapper.h"
 #include "ogl/glSmartBitmap.h"
-#include "ogl/glTexturePackerNode.h"
 #include "ogl/saveBitmap.h"
 #include "libsiedler2/PixelBufferBGRA.h"
 #include <glad/glad.h>
@@ -20,115 +19,218 @@ static bool isSizeGreater(glSmartBitmap* a, glSmartBitmap* b)
     return (sizeA.x * sizeA.y) > (sizeB.x * sizeB.y);
 }
 
-bool glTexturePacker::packHelper(std::vector<glSmartBitmap*>& list)
+void glTexturePacker::assign(glSmartBitmap& bmp, const Placement& placement)
 {
-    glTexture texture;
+    const Point<float> pageSize(placement.texture->getSize());
+    const Extent& pos = placement.pos;
+    const Extent texSize = bmp.getRequiredTexSize();
+    Extent usedSize(texSize);
+    if(bmp.isPlayer())
+        usedSize.x /= 2;
 
-    if(!texture)
-        return false;
+    bmp.texCoords[0] = pos / pageSize;
+    bmp.texCoords[2] = (pos + usedSize) / pageSize;
+    bmp.texCoords[1] = {bmp.texCoords[0].x, bmp.texCoords[2].y};
+    bmp.texCoords[3] = {bmp.texCoords[2].x, bmp.texCoords[0].y};
 
-    // find space needed in total and biggest texture to store (as a start)
-    Extent maxBmpSize(0, 0);
-    unsigned total = 0;
-    for(glSmartBitmap* bmp : list)
+    if(bmp.isPlayer())
     {
-        Extent texSize = bmp->getRequiredTexSize();
-        maxBmpSize = elMax(maxBmpSize, texSize);
-
-        total += texSize.x * texSize.y;
+        bmp.texCoords[4] = bmp.texCoords[3];
+        bmp.texCoords[6] = (pos + texSize) / pageSize;
+        bmp.texCoords[5] = {bmp.texCoords[4].x, bmp.texCoords[6].y};
+        bmp.texCoords[7] = {bmp.texCoords[6].x, bmp.texCoords[4].y};
     }
+    // tell our glSmartBitmap, that it uses a shared texture (so it won't try to delete/free it)
+    bmp.setSharedTexture(placement.texture);
+}
+
+glTexturePacker::Page* glTexturePacker::createPage(const Extent& minSize, unsigned wantedArea)
+{
+    auto texture = std::make_shared<glTexture>();
+    if(!*texture)
+        return nullptr;
 
     // most cards work much better with texture sizes of powers of two.
-    maxBmpSize = VIDEODRIVER.calcPreferredTextureSize(maxBmpSize);
+    Extent size = VIDEODRIVER.calcPreferredTextureSize(minSize);
+    if(!texture->checkSize(size))
+        return nullptr;
 
-    if(!texture.checkSize(maxBmpSize))
-        return false;
+    // increase width or height until the wanted area fits or the maximum page size is reached
+    while(size.x * size.y < wantedArea)
+    {
+        const auto newSize = (size.x <= size.y) ? Extent(size.x * 2, size.y) : Extent(size.x, size.y * 2);
+        if(std::max(newSize.x, newSize.y) > MAX_PAGE_SIZE || !texture->checkSize(newSize))
+            break;
+        size = newSize;
+    }
 
-    // maximum texture size reached?
-    bool maxTex = false;
-    std::vector<glTexturePackerNode*> tmpVec;
-    tmpVec.reserve(list.size());
+    pages.push_back(Page{std::move(texture), SkylinePacker(size)});
+    return &pages.back();
+}
 
-    Extent curSize = maxBmpSize;
-    do
+void glTexturePacker::releaseUnusedPages()
+{
+    for(Page& page : pages)
     {
-        // two possibilities: enough space OR maximum texture size reached
-        if((curSize.x * curSize.y >= total) || maxTex)
+        // Only referenced by us -> All bitmaps on it are gone
+        if(page.texture.use_count() == 1)
+            page.packer.clear();
+    }
+}
+
+glTexturePacker::Page* glTexturePacker::insertIntoExistingPage(const Extent& size, Extent& pos)
+{
+    for(Page& page : pages)
+    {
+        const boost::optional<Extent> curPos = page.packer.insert(size);
+        if(curPos)
         {
-            // texture packer
-            auto root = std::make_unique<glTexturePackerNode>(curSize);
+            pos = *curPos;
+            return &page;
+        }
+    }
+    return nullptr;
+}
 
-            // list to store bitmaps we could not fit in our current texture
-            std::vector<glSmartBitmap*> left;
+bool glTexturePacker::pack()
+{
+    releaseUnusedPages();
+    std::sort(items.begin(), items.end(), isSizeGreater);
 
-            libsiedler2::PixelBufferBGRA buffer(curSize.x, curSize.y);
+    // Fill up existing pages first
+    std::vector<glSmartBitmap*> left;
+    for(glSmartBitmap* bmp : items)
+    {
+        const Extent texSize = bmp->getRequiredTexSize();
+        Extent pos;
+        Page* page = insertIntoExistingPage(texSize, pos);
+        if(!page)
+        {
+            left.push_back(bmp);
+            continue;
+        }
+        libsiedler2::PixelBufferBGRA buffer(texSize.x, texSize.y);
+        bmp->drawTo(buffer);
+        page->texture->uploadSubData(buffer, pos);
+        assign(*bmp, Placement{page->texture, pos});
+    }
+    items.clear();
 
-            // try storing bitmaps in the big texture
-            for(glSmartBitmap* bmp : list)
-            {
-                if(!root->insert(bmp, buffer, tmpVec))
-                {
-                    // inserting this bitmap failed? just remember it for next texture
-                    left.push_back(bmp);
-                } else
-                {
-                    // tell or glSmartBitmap, that it uses a shared texture (so it won't try to delete/free it)
-                    bmp->setSharedTexture(texture.get());
-                }
-            }
-            if((false))
-            {
-                bfs::path outFilepath = std::to_string(texture.get()) + "-" + std::to_string(curSize.x) + "x"
-                                        + std::to_string(curSize.y) + ".bmp";
-                saveBitmap(buffer, outFilepath);
-            }
-            // free texture packer, as it is not needed any more
-            root->destroy(list.size());
-            root.reset();
-
-            if(!texture.uploadData(buffer))
-                return false;
-
-            if(left.empty()) // nothing left, just generate texture and return success
-            {
-                textures.emplace_back(std::move(texture));
-                return true;
-            } else if(maxTex) // maximum texture size reached and something still left
+    std::vector<glSmartBitmap*> notFitting;
+    std::vector<std::pair<glSmartBitmap*, Extent>> placed;
+    while(!left.empty())
+    {
+        // find space needed in total and biggest texture to store
+        Extent maxBmpSize(0, 0);
+        unsigned total = 0;
+        for(glSmartBitmap* bmp : left)
+        {
+            const Extent texSize = bmp->getRequiredTexSize();
+            maxBmpSize = elMax(maxBmpSize, texSize);
+            total += texSize.x * texSize.y;
+        }
+
+        Page* page = createPage(maxBmpSize, total);
+        if(!page)
+            return false;
+
+        // Draw everything fitting into one buffer so the page is uploaded only once
+        const Extent pageSize = page->packer.getSize();
+        libsiedler2::PixelBufferBGRA buffer(pageSize.x, pageSize.y);
+        notFitting.clear();
+        placed.clear();
+        for(glSmartBitmap* bmp : left)
+        {
+            const boost::optional<Extent> pos = page->packer.insert(bmp->getRequiredTexSize());
+            if(pos)
             {
-                textures.emplace_back(std::move(texture));
-                // recursively generate textures for what is left
-                return packHelper(left);
-            }
-
-            // our pre-estimated size if the big texture was not enough for the algorithm to fit all textures in
-            // delete buffer and try again with an increased big texture
-            left.clear();
+                bmp->drawTo(buffer, *pos);
+                placed.emplace_back(bmp, *pos);
+            } else
+                notFitting.push_back(bmp);
+        }
+        if((false))
+        {
+            bfs::path outFilepath = std::to_string(page->texture->get()) + "-" + std::to_string(pageSize.x) + "x"
+                                    + std::to_string(pageSize.y) + ".bmp";
+            saveBitmap(buffer, outFilepath);
         }
 
-        // increase width or height, try whether opengl is able to handle textures that big
-        const auto newSize =
-          (curSize.x <= curSize.y) ? Extent(curSize.x * 2, curSize.y) : Extent(curSize.x, curSize.y * 2);
-        if(!texture.checkSize(newSize))
-            maxTex = true;
-        else
-            curSize = newSize;
-    } while(true);
+        // On failure the bitmaps of this page will create their own textures
+        if(!page->texture->uploadData(buffer))
+        {
+            pages.pop_back();
+            return false;
+        }
+        for(const auto& bmpAndPos : placed)
+            assign(*bmpAndPos.first, Placement{page->texture, bmpAndPos.second});
+        std::swap(left, notFitting);
+    }
+
+    return true;
 }
 
-bool glTexturePacker::pack()
+bool glTexturePacker::insert(glSmartBitmap& bmp)
 {
-    std::sort(items.begin(), items.end(), isSizeGreater);
+    if(bmp.empty())
+        return false;
+    const Extent texSize = bmp.getRequiredTexSize();
+    libsiedler2::PixelBufferBGRA buffer(texSize.x, texSize.y);
+    bmp.drawTo(buffer);
+    const boost::optional<Placement> placement = insert(buffer);
+    if(!placement)
+        return false;
+    assign(bmp, *placement);
+    return true;
+}
 
-    if(packHelper(items))
-        return true;
+boost::optional<glTexturePacker::Placement> glTexturePacker::insert(const libsiedler2::PixelBufferBGRA& buffer)
+{
+    const Extent size(buffer.getWidth(), buffer.getHeight());
+    if(size.x == 0 || size.y == 0)
+        return boost::none;
+    releaseUnusedPages();
 
-    // reset glSmartBitmap textures
-    for(glSmartBitmap* bmp : items)
-        bmp->setSharedTexture(0);
+    Extent pos;
+    Page* page = insertIntoExistingPage(size, pos);
+    if(!page)
+    {
+        // Start small and grow the pages created here, so few images don't need a full sized page
+        // and many of them still need only a few pages
+        page = createPage(size, nextInsertPageArea);
+        if(!page)
+            return boost::none;
+        const boost::optional<Extent> newPos = page->packer.insert(size);
+        if(!newPos || !page->texture->allocate(page->packer.getSize()))
+        {
+            pages.pop_back();
+            return boost::none;
+        }
+        pos = *newPos;
+        nextInsertPageArea = std::min(nextInsertPageArea * 2, MAX_PAGE_SIZE * MAX_PAGE_SIZE);
+    }
+    page->texture->uploadSubData(buffer, pos);
+    return Placement{page->texture, pos};
+}
 
-    textures.clear();
+unsigned glTexturePacker::getNumBitmaps() const
+{
+    // Each bitmap on a page holds one reference to its texture
+    unsigned numBitmaps = 0;
+    for(const Page& page : pages)
+        numBitmaps += static_cast<unsigned>(page.texture.use_count() - 1);
+    return numBitmaps;
+}
 
-    return false;
+float glTexturePacker::getOccupancy() const
+{
+    unsigned usedArea = 0, totalArea = 0;
+    for(const Page& page : pages)
+    {
+        usedArea += page.packer.getUsedArea();
+        totalArea += prodOfComponents(page.packer.getSize());
+    }
+    return totalArea ? static_cast<float>(usedArea) / totalArea : 0.f;
 }
 
 glTexture::glTexture() : handle(VIDEODRIVER.GenerateTexture()), size(0, 0)
@@ -186,3 +288,25 @@ bool glTexture::uploadData(const libsiedler2::PixelBufferBGRA& buffer)
     glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &resultWidth);
     return resultWidth > 0;
 }
+
+bool glTexture::allocate(const Extent& newSize)
+{
+    if(!handle)
+        return false;
+    VIDEODRIVER.BindTexture(handle);
+    // Content is undefined and only the parts written by uploadSubData are used
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, newSize.x, newSize.y, 0, GL_BGRA, GL_UNSIGNED_BYTE, nullptr);
+    size = newSize;
+    int resultWidth;
+    glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &resultWidth);
+    return resultWidth > 0;
+}
+
+void glTexture::uploadSubData(const libsiedler2::PixelBufferBGRA& buffer, const Extent& pos)
+{
+    if(!handle)
+        return;
+    VIDEODRIVER.BindTexture(handle);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, pos.x, pos.y, buffer.getWidth(), buffer.getHeight(), GL_BGRA, GL_UNSIGNED_BYTE,
+                    buffer.getPixelPtr());
+}
@@ -5,6 +5,9 @@
 #pragma once
 
 #include "Point.h"
+#include "SkylinePacker.h"
+#include <boost/optional.hpp>
+#include <memory>
 #include <vector>
 
 class glSmartBitmap;
@@ -33,18 +36,67 @@ public:
     void bind() const;
     bool checkSize(const Extent&) const;
     bool uploadData(const libsiedler2::PixelBufferBGRA&);
+    /// Create storage of the given size without uploading any data
+    bool allocate(const Extent& size);
+    /// Replace a part of the already uploaded texture
+    void uploadSubData(const libsiedler2::PixelBufferBGRA&, const Extent& pos);
 };
 
+/// Packs glSmartBitmaps and other images into shared textures (atlas pages).
+/// Bitmaps can be added in bulk via add() + pack() or one at a time via insert() at any time later.
+/// Everything placed on a page keeps a reference to its texture. Once all of them are released the space is reused.
 class glTexturePacker
 {
-private:
-    std::vector<glTexture> textures;
-    std::vector<glSmartBitmap*> items;
+public:
+    /// Maximum size of a page. Bitmaps which are bigger get a page of their own
+    static constexpr unsigned MAX_PAGE_SIZE = 2048;
+    /// Size of the first page created by insert(). Each following one has double the area up to the maximum size
+    static constexpr unsigned MIN_INSERT_PAGE_SIZE = 256;
 
-    bool packHelper(std::vector<glSmartBitmap*>& list);
+    /// Place of an image on a page
+    struct Placement
+    {
+        std::shared_ptr<const glTexture> texture;
+        /// Position of the upper left corner on the texture in pixels
+        Extent pos;
+    };
 
-public:
-    bool pack();
+    /// Queue a bitmap for the next call to pack()
     void add(glSmartBitmap& bmp) { items.push_back(&bmp); }
-    const auto& getTextures() const { return textures; }
+    /// Put all queued bitmaps onto the pages, using free space of existing pages first.
+    /// Return false if not all of them could be packed. Those will then use their own texture.
+    bool pack();
+    /// Put a single bitmap onto a page. Return false if that was not possible
+    bool insert(glSmartBitmap& bmp);
+    /// Put the image onto a page. Return boost::none if that was not possible
+    boost::optional<Placement> insert(const libsiedler2::PixelBufferBGRA& buffer);
+
+    unsigned getNumPages() const { return static_cast<unsigned>(pages.size()); }
+    const glTexture& getTexture(unsigned page) const { return *pages[page].texture; }
+    /// Number of bitmaps and images stored on the pages
+    unsigned getNumBitmaps() const;
+    /// Fraction of the pages' area used by bitmaps
+    float getOccupancy() const;
+
+private:
+    struct Page
+    {
+        std::shared_ptr<glTexture> texture;
+        SkylinePacker packer;
+    };
+
+    std::vector<Page> pages;
+    std::vector<glSmartBitmap*> items;
+    /// Area wanted for the next page created by insert()
+    unsigned nextInsertPageArea = MIN_INSERT_PAGE_SIZE * MIN_INSERT_PAGE_SIZE;
+
+    /// Create a new page which can hold at least one bitmap of the given size and ideally the given area
+    Page* createPage(const Extent& minSize, unsigned wantedArea);
+    /// Make the space of pages which are not referenced by any bitmap available again
+    void releaseUnusedPages();
+    /// Reserve space for an image of the given size on an existing page.
+    /// Return that page and set pos to the position on it or return nullptr if there is not enough space left
+    Page* insertIntoExistingPage(const Extent& size, Extent& pos);
+    /// Make the bitmap use the given place on the page
+    static void assign(glSmartBitmap& bmp, const Placement& placement);
 };
@@ -10,32 +10,27 @@
 #include "pathfinding/PathfindingPoint.h"
 #include "world/GameWorldBase.h"
 #include "s25util/Log.h"
+#include <algorithm>
 
 //////////////////////////////////////////////////////////////////////////
 /// FreePathFinder implementation
 //////////////////////////////////////////////////////////////////////////
 
-/// MapNodes
-using MapNodes = std::vector<NewNode>;
-using FreePathNodes = std::vector<FreePathNode>;
-MapNodes nodes;
-FreePathNodes fpNodes;
-
 void FreePathFinder::Init(const MapExtent& mapSize)
 {
     currentVisit = 0;
     size_ = Extent(mapSize);
     // Reset nodes
-    nodes.clear();
-    fpNodes.clear();
-    nodes.resize(size_.x * size_.y);
-    fpNodes.resize(nodes.size());
+    nodes_.clear();
+    fpNodes_.clear();
+    nodes_.resize(size_.x * size_.y);
+    fpNodes_.resize(nodes_.size());
     RTTR_FOREACH_PT(MapPoint, size_)
     {
         const unsigned idx = gwb_.GetIdx(pt);
-        nodes[idx].mapPt = pt;
-        fpNodes[idx].lastVisited = 0;
-        fpNodes[idx].mapPt = pt;
+        nodes_[idx].mapPt = pt;
+        fpNodes_[idx].lastVisited = 0;
+        fpNodes_[idx].mapPt = pt;
     }
 }
 
@@ -44,12 +39,12 @@ void FreePathFinder::IncreaseCurrentVisit()
     // if the counter reaches its maxium, tidy up
     if(currentVisit == std::numeric_limits<unsigned>::max())
     {
-        for(auto& node : nodes)
+        for(auto& node : nodes_)
         {
             node.lastVisited = 0;
             node.lastVisitedEven = 0;
         }
-        for(auto& fpNode : fpNodes)
+        for(auto& fpNode : fpNodes_)
         {
             fpNode.lastVisited = 0;
         }
@@ -82,108 +77,132 @@ bool FreePathFinder::FindPathAlternatingConditions(const MapPoint start, const M
         return true;
     }
 
+    return FindPathToAnyAlternatingConditions(
+      start, {dest}, randomRoute, maxLength, IsNodeOK, IsNodeOKAlternate, IsNodeToDestOk, param,
+      [route, length, firstDir](unsigned /*targetIdx*/, const std::vector<Direction>& foundRoute) {
+          if(route)
+              *route = foundRoute;
+          if(length)
+              *length = foundRoute.size();
+          if(firstDir)
+              *firstDir = foundRoute.front();
+          return 0u;
+      });
+}
+
+/// Breadth-first search from start till all targets are reached or the remaining routes exceed the max length
+bool FreePathFinder::FindPathToAnyAlternatingConditions(const MapPoint start, const std::vector<MapPoint>& targets,
+                                                        const bool randomRoute, unsigned maxLength,
+                                                        FP_Node_OK_Callback IsNodeOK,
+                                                        FP_Node_OK_Callback IsNodeOKAlternate,
+                                                        FP_Node_OK_Callback IsNodeToDestOk, const void* param,
+                                                        const FP_Target_Reached_Callback& onTargetReached)
+{
+    // Node ids of the targets with their index, sorted for fast lookup
+    std::vector<std::pair<unsigned, unsigned>> targetIds;
+    targetIds.reserve(targets.size());
+    for(unsigned i = 0; i < targets.size(); i++)
+    {
+        if(targets[i] != start)
+            targetIds.emplace_back(gwb_.GetIdx(targets[i]), i);
+    }
+    if(targetIds.empty())
+        return false;
+    std::sort(targetIds.begin(), targetIds.end());
+    const auto findTarget = [&targetIds](const unsigned id) {
+        const auto it = std::lower_bound(targetIds.begin(), targetIds.end(), std::make_pair(id, 0u));
+        return (it != targetIds.end() && it->first == id) ? it : targetIds.end();
+    };
+    const auto isTarget = [&targetIds, &findTarget](const unsigned id) { return findTarget(id) != targetIds.end(); };
+    const auto isNextToTarget = [this, &isTarget](const MapPoint pt) {
+        for(const auto dir : helpers::EnumRange<Direction>{})
+        {
+            if(isTarget(gwb_.GetIdx(gwb_.GetNeighbour(pt, dir))))
+                return true;
+        }
+        return false;
+    };
+
     // increase currentVisit, so we don't have to clear the visited-states at every run
     IncreaseCurrentVisit();
 
     std::list<PathfindingPoint> todo;
-    const unsigned destId = gwb_.GetIdx(dest);
 
     bool prevStepEven = true; // flips between even and odd
     unsigned stepsTilSwitch = 1;
 
     // Add start node
-    unsigned startId = gwb_.GetIdx(start);
-    todo.push_back(PathfindingPoint(startId, gwb_.CalcDistance(start, dest), 0));
+    const unsigned startId = gwb_.GetIdx(start);
+    todo.push_back(PathfindingPoint(startId, 0, 0));
     // And init it
-    nodes[startId].prevEven = INVALID_PREV;
-    nodes[startId].lastVisitedEven = currentVisit;
-    nodes[startId].wayEven = 0;
-    // LOG.write(("pf: from %i, %i to %i, %i \n", x_start, y_start, x_dest, y_dest);
+    nodes_[startId].prevEven = INVALID_PREV;
+    nodes_[startId].lastVisitedEven = currentVisit;
+    nodes_[startId].wayEven = 0;
 
     // Start at random dir (so different jobs may use different roads)
     const Direction startDir =
       randomRoute ? convertToDirection(gwb_.GetIdx(start) * gwb_.GetEvMgr().GetCurrentGF()) : Direction::West;
 
+    bool targetReached = false;
+    std::vector<Direction> route;
     while(!todo.empty())
     {
         if(!stepsTilSwitch) // counter for next step and switch condition
         {
             prevStepEven = !prevStepEven;
             stepsTilSwitch = todo.size();
-            // prevstepEven ? LOG.write(("pf: even, to switch %i listsize %i ", stepsTilSwitch, todo.size()) :
-            // LOG.write(("pf: odd, to switch %i listsize %i ", stepsTilSwitch, todo.size());
         }
-        // else
-        // prevstepEven ? LOG.write(("pf: even, to switch %i listsize %i ", stepsTilSwitch, todo.size()) :
-        // LOG.write(("pf: odd, to switch %i listsize %i ", stepsTilSwitch, todo.size());
         stepsTilSwitch--;
 
         // Get node with lowest cost
-        PathfindingPoint best = *todo.begin();
-        // Knoten behandelt --> raus aus der todo Liste
-        todo.erase(todo.begin());
-
-        // printf("x: %u y: %u\n", best.x, best.y);
-
-        // ID des besten Punktes ausrechnen
-
-        unsigned bestId = best.id_;
-        // LOG.write((" now %i, %i id: %i \n", best.x, best.y, best_id);
-        // Dieser Knoten wurde aus dem set entfernt, daher wird der entsprechende Iterator
-        // auf das Ende (also nicht definiert) gesetzt, quasi als "nullptr"-Ersatz
-        // pf_nodes[best_id].it_p = todo.end();
+        const unsigned bestId = todo.front().id_;
+        todo.pop_front();
+        const unsigned curWay = prevStepEven ? nodes_[bestId].wayEven : nodes_[bestId].way;
+        // Nodes are handled in order of their way length, so all remaining ones are too far away
+        if(curWay > maxLength)
+            break;
 
-        // Ziel schon erreicht?
-        if(destId == bestId)
+        const auto itTarget = findTarget(bestId);
+        if(itTarget != targetIds.end())
         {
-            // Ziel erreicht!
-            // Return the values if requested
-            const unsigned routeLen = prevStepEven ? nodes[bestId].wayEven : nodes[bestId].way;
-            if(length)
-                *length = routeLen;
-            if(route)
-                route->resize(routeLen);
-
-            // Reconstruct route and get first direction (if requested)
+            targetReached = true;
+            // Reconstruct route
+            route.resize(curWay);
+            unsigned curId = bestId;
             bool alternate = prevStepEven;
-            for(unsigned z = routeLen - 1; bestId != startId; --z)
+            for(unsigned z = curWay; z > 0; --z)
             {
-                if(route)
-                    (*route)[z] = alternate ? nodes[bestId].dirEven : nodes[bestId].dir;
-                if(firstDir && z == 0)
-                    *firstDir = nodes[bestId].dirEven;
-
-                bestId = alternate ? nodes[bestId].prevEven : nodes[bestId].prev;
+                route[z - 1] = alternate ? nodes_[curId].dirEven : nodes_[curId].dir;
+                curId = alternate ? nodes_[curId].prevEven : nodes_[curId].prev;
                 alternate = !alternate;
             }
-
-            // Fertig, es wurde ein Pfad gefunden
-            return true;
+            maxLength = std::min(maxLength, onTargetReached(itTarget->second, route));
+            // Targets are end points, routes to other targets don't lead through them
+            continue;
         }
 
         // Maximaler Weg schon erreicht ? In dem Fall brauchen wir keine weiteren Knoten von diesem aus bilden
-        if((prevStepEven && nodes[bestId].wayEven == maxLength) || (!prevStepEven && nodes[bestId].way == maxLength))
+        if(curWay == maxLength)
             continue;
 
-        // LOG.write(("pf get neighbor nodes %i, %i id: %i \n", best.x, best.y, best_id);
         // Knoten in alle 6 Richtungen bilden
         for(const auto& dir : helpers::enumRange(startDir))
         {
             // Form coordinates of the corresponding surrounding point
-            const MapPoint& neighbourPos = gwb_.GetNeighbour(nodes[bestId].mapPt, dir);
+            const MapPoint& neighbourPos = gwb_.GetNeighbour(nodes_[bestId].mapPt, dir);
 
             // Form the ID of the surrounding node
-           const unsigned& nbId = gwb_.GetIdx(neighbourPos);
+            const unsigned& nbId = gwb_.GetIdx(neighbourPos);
 
             // Knot already formed in the field?
-            if((prevStepEven && nodes[nbId].lastVisited == currentVisit)
-               || (!prevStepEven && nodes[nbId].lastVisitedEven == currentVisit))
+            if((prevStepEven && nodes_[nbId].lastVisited == currentVisit)
+               || (!prevStepEven && nodes_[nbId].lastVisitedEven == currentVisit))
             {
                 continue;
             }
 
             // Check additional constraints for non-destination points
-            if(nbId != destId && ((prevStepEven && IsNodeOK) || (!prevStepEven && IsNodeOKAlternate)))
+            if(((prevStepEven && IsNodeOK) || (!prevStepEven && IsNodeOKAlternate)) && !isTarget(nbId))
             {
                 if(prevStepEven)
                 {
@@ -193,21 +212,21 @@ bool FreePathFinder::FindPathAlternatingConditions(const MapPoint start, const M
                 {
                     if(!IsNodeOKAlternate(gwb_, neighbourPos, dir, param))
                         continue;
-                    MapPoint p = nodes[bestId].mapPt;
+                    MapPoint p = nodes_[bestId].mapPt;
 
                     std::vector<MapPoint> evenLocationsOnRoute;
                     bool alternate = false;
                     unsigned back_id = bestId;
-                    for(unsigned i = nodes[bestId].way - 1; i > 1;
+                    for(unsigned i = nodes_[bestId].way - 1; i > 1;
                         i--) // backtrack the plannend route and check if another "even" position is too close
                     {
-                        const Direction& pdir = alternate ? nodes[back_id].dirEven : nodes[back_id].dir;
+                        const Direction& pdir = alternate ? nodes_[back_id].dirEven : nodes_[back_id].dir;
                         p = gwb_.GetNeighbour(p, pdir + 3u);
                         if(i % 2 == 0) // even step
                         {
                             evenLocationsOnRoute.push_back(p);
                         }
-                        back_id = alternate ? nodes[back_id].prevEven : nodes[back_id].prev;
+                        back_id = alternate ? nodes_[back_id].prevEven : nodes_[back_id].prev;
                         alternate = !alternate;
                     }
                     bool tooClose =
@@ -218,7 +237,7 @@ bool FreePathFinder::FindPathAlternatingConditions(const MapPoint start, const M
                         continue;
                     if(gwb_.CalcDistance(neighbourPos, start) < 2)
                         continue;
-                    if(gwb_.CalcDistance(neighbourPos, dest) < 2)
+                    if(isNextToTarget(neighbourPos))
                         continue;
                 }
             }
@@ -234,23 +253,21 @@ bool FreePathFinder::FindPathAlternatingConditions(const MapPoint start, const M
             unsigned way;
             if(prevStepEven)
             {
-                nodes[nbId].lastVisited = currentVisit;
-                way = nodes[nbId].way = nodes[bestId].wayEven + 1;
-                nodes[nbId].dir = dir;
-                nodes[nbId].prev = bestId;
+                nodes_[nbId].lastVisited = currentVisit;
+                way = nodes_[nbId].way = nodes_[bestId].wayEven + 1;
+                nodes_[nbId].dir = dir;
+                nodes_[nbId].prev = bestId;
             } else
             {
-                nodes[nbId].lastVisitedEven = currentVisit;
-                way = nodes[nbId].wayEven = nodes[bestId].way + 1;
-                nodes[nbId].dirEven = dir;
-                nodes[nbId].prevEven = bestId;
+                nodes_[nbId].lastVisitedEven = currentVisit;
+                way = nodes_[nbId].wayEven = nodes_[bestId].way + 1;
+                nodes_[nbId].dirEven = dir;
+                nodes_[nbId].prevEven = bestId;
             }
 
-            todo.push_back(PathfindingPoint(nbId, gwb_.CalcDistance(neighbourPos, dest), way));
-            // pf_nodes[xaid].it_p = ret.first;
+            todo.push_back(PathfindingPoint(nbId, 0, way));
         }
     }
 
-    // Liste leer und kein Ziel erreicht --> kein Weg
-    return false;
+    return targetReached;
 }
@@ -4,13 +4,18 @@
 
 #pragma once
 
+#include "pathfinding/NewNode.h"
 #include "gameTypes/Direction.h"
 #include "gameTypes/MapCoordinates.h"
+#include <functional>
 #include <vector>
 
 class GameWorldBase;
 
 using FP_Node_OK_Callback = bool (*)(const GameWorldBase&, const MapPoint, const Direction, const void*);
+/// Called with the index of the reached target and the route to it.
+/// Returns the maximum route length still of interest, so returning 0 stops the search
+using FP_Target_Reached_Callback = std::function<unsigned(unsigned targetIdx, const std::vector<Direction>& route)>;
 
 // There are 2 callback types:
 // IsNodeToDestOk: Called for every point to check if this node is usable
@@ -21,6 +26,9 @@ class FreePathFinder
     GameWorldBase& gwb_;
     unsigned currentVisit;
     Extent size_;
+    /// Nodes of the map used by the searches, owned by the world so multiple worlds can be searched independently
+    std::vector<NewNode> nodes_;
+    std::vector<FreePathNode> fpNodes_;
 
 public:
     FreePathFinder(GameWorldBase& gwb) : gwb_(gwb), currentVisit(0), size_(0, 0) {}
@@ -37,6 +45,13 @@ public:
                                        std::vector<Direction>* route, unsigned* length, Direction* firstDir,
                                        FP_Node_OK_Callback IsNodeOK, FP_Node_OK_Callback IsNodeOKAlternate,
                                        FP_Node_OK_Callback IsNodeToDestOk, const void* param);
+    /// Like FindPathAlternatingConditions but searches the routes to all targets at once.
+    /// onTargetReached is called for each reached target in order of increasing route lengths.
+    /// Returns true if any target was reached
+    bool FindPathToAnyAlternatingConditions(MapPoint start, const std::vector<MapPoint>& targets, bool randomRoute,
+                                            unsigned maxLength, FP_Node_OK_Callback IsNodeOK,
+                                            FP_Node_OK_Callback IsNodeOKAlternate, FP_Node_OK_Callback IsNodeToDestOk,
+                                            const void* param, const FP_Target_Reached_Callback& onTargetReached);
 
     /// Ermittelt, ob eine freie Route noch passierbar ist und gibt den Endpunkt der Route zurück
     template<class TNodeChecker>
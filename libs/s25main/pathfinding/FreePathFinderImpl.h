@@ -12,9 +12,6 @@
 #include "pathfinding/PathfindingPoint.h"
 #include "world/GameWorldBase.h"
 
-using FreePathNodes = std::vector<FreePathNode>;
-extern FreePathNodes fpNodes;
-
 struct NodePtrCmpGreater
 {
     bool operator()(const FreePathNode* const lhs, const FreePathNode* const rhs) const
@@ -50,8 +47,8 @@ bool FreePathFinder::FindPath(const MapPoint start, const MapPoint dest, bool ra
     QueueImpl todo;
     const unsigned startId = gwb_.GetIdx(start);
     const unsigned destId = gwb_.GetIdx(dest);
-    FreePathNode& startNode = fpNodes[startId];
-    FreePathNode& destNode = fpNodes[destId];
+    FreePathNode& startNode = fpNodes_[startId];
+    FreePathNode& destNode = fpNodes_[destId];
 
    // Insert start node and fill with appropriate values
     startNode.targetDistance = gwb_.CalcDistance(start, dest);
@@ -112,7 +109,7 @@ bool FreePathFinder::FindPath(const MapPoint start, const MapPoint dest, bool ra
 
             // Form the ID of the surrounding node
             unsigned nbId = gwb_.GetIdx(neighbourPos);
-            FreePathNode& neighbour = fpNodes[nbId];
+            FreePathNode& neighbour = fpNodes_[nbId];
 
             // Don't try to go back where we came from (would also bail out in the conditions below)
             if(best.prev == &neighbour)
@@ -6,8 +6,8 @@
 #include "EventManager.h"
 #include "RttrForeachPt.h"
 #include "buildings/nobHarborBuilding.h"
+#include "helpers/containerUtils.h"
 #include "pathfinding/OpenListPrioQueue.h"
-#include "pathfinding/OpenListVector.h"
 #include "world/GameWorldBase.h"
 #include "nodeObjs/noRoadNode.h"
 #include "gameData/GameConsts.h"
@@ -30,8 +30,6 @@ struct RoadNodeComperatorGreater
 };
 
 using QueueImpl = OpenListPrioQueue<const noRoadNode*, RoadNodeComperatorGreater>;
-using VecImpl = OpenListVector<const noRoadNode*>;
-VecImpl todo;
 
 // Namespace with all functors usable as additional cost functors
 namespace AdditonalCosts {
@@ -100,6 +98,23 @@ struct And : private T_Func1, private T_Func2
 };
 } // namespace SegmentConstraints
 
+void RoadPathFinder::IncreaseCurrentVisit()
+{
+    currentVisit++;
+
+    // if the counter reaches its maximum, tidy up
+    if(currentVisit == std::numeric_limits<unsigned>::max())
+    {
+        RTTR_FOREACH_PT(MapPoint, gwb_.GetSize())
+        {
+            auto* const node = gwb_.GetSpecObj<noRoadNode>(pt);
+            if(node)
+                node->last_visit = 0;
+        }
+        currentVisit = 1;
+    }
+}
+
 /// Wegfinden ( A* ), O(v lg v) --> Wegfindung auf Stra�en
 template<class T_AdditionalCosts, class T_SegmentConstraints>
 bool RoadPathFinder::FindPathImpl(const noRoadNode& start, const noRoadNode& goal, const unsigned max,
@@ -125,22 +140,10 @@ bool RoadPathFinder::FindPathImpl(const noRoadNode& start, const noRoadNode& goa
     }
 
     // increase current_visit_on_roads, so we don't have to clear the visited-states at every run
-    currentVisit++;
-
-    // if the counter reaches its maximum, tidy up
-    if(currentVisit == std::numeric_limits<unsigned>::max())
-    {
-        RTTR_FOREACH_PT(MapPoint, gwb_.GetSize())
-        {
-            auto* const node = gwb_.GetSpecObj<noRoadNode>(pt);
-            if(node)
-                node->last_visit = 0;
-        }
-        currentVisit = 1;
-    }
+    IncreaseCurrentVisit();
 
     // Add start node
-    todo.clear();
+    todo_.clear();
 
     const MapPoint goalPos = goal.GetPos();
     start.targetDistance = gwb_.CalcDistance(start.GetPos(), goalPos);
@@ -150,12 +153,12 @@ bool RoadPathFinder::FindPathImpl(const noRoadNode& start, const noRoadNode& goa
     start.cost = 0;
     start.dir_ = RoadPathDirection::None;
 
-    todo.push(&start);
+    todo_.push(&start);
 
-    while(!todo.empty())
+    while(!todo_.empty())
     {
         // Get node with current least estimate
-        const noRoadNode& best = *todo.pop();
+        const noRoadNode& best = *todo_.pop();
 
         // Reached goal
         if(&best == &goal)
@@ -231,7 +234,7 @@ bool RoadPathFinder::FindPathImpl(const noRoadNode& start, const noRoadNode& goa
                     neighbour->estimate = neighbour->targetDistance + cost;
                     neighbour->prev = &best;
                     neighbour->dir_ = toRoadPathDirection(dir);
-                    todo.rearrange(neighbour);
+                    todo_.rearrange(neighbour);
                 }
             } else
             {
@@ -243,7 +246,7 @@ bool RoadPathFinder::FindPathImpl(const noRoadNode& start, const noRoadNode& goa
                 neighbour->prev = &best;
                 neighbour->dir_ = toRoadPathDirection(dir);
 
-                todo.push(neighbour);
+                todo_.push(neighbour);
             }
         }
 
@@ -268,7 +271,7 @@ bool RoadPathFinder::FindPathImpl(const noRoadNode& start, const noRoadNode& goa
                     dest.estimate = dest.targetDistance + cost;
                     dest.prev = &best;
                     dest.dir_ = RoadPathDirection::Ship;
-                    todo.rearrange(&dest);
+                    todo_.rearrange(&dest);
                 }
             } else
             {
@@ -280,7 +283,7 @@ bool RoadPathFinder::FindPathImpl(const noRoadNode& start, const noRoadNode& goa
                 dest.prev = &best;
                 dest.dir_ = RoadPathDirection::Ship;
 
-                todo.push(&dest);
+                todo_.push(&dest);
             }
         }
     }
@@ -336,3 +339,106 @@ bool RoadPathFinder::PathExists(const noRoadNode& start, const noRoadNode& goal,
                                 SegmentConstraints::AvoidRoadType<RoadType::Water>());
     }
 }
+
+/// Dijkstra from start with the same rules as FindPathImpl without additional costs
+std::vector<unsigned> RoadPathFinder::FindPathLengths(const noRoadNode& start,
+                                                      const std::vector<const noRoadNode*>& goals, const unsigned max)
+{
+    constexpr unsigned noPath = std::numeric_limits<unsigned>::max();
+    std::vector<unsigned> lengths(goals.size(), noPath);
+    unsigned numGoalsLeft = goals.size();
+    if(!numGoalsLeft)
+        return lengths;
+    const auto isGoal = [&goals](const noRoadNode* node) { return helpers::contains(goals, node); };
+    const SegmentConstraints::AvoidRoadType<RoadType::Water> isSegmentAllowed;
+
+    IncreaseCurrentVisit();
+
+    todo_.clear();
+    start.targetDistance = 0;
+    start.estimate = 0;
+    start.last_visit = currentVisit;
+    start.prev = nullptr;
+    start.cost = 0;
+    start.dir_ = RoadPathDirection::None;
+    todo_.push(&start);
+
+    // Add the node to the list or update it if the costs are lower
+    const auto updateNode = [this](const noRoadNode& node, const noRoadNode& prev, const unsigned cost,
+                                   const RoadPathDirection dir) {
+        if(node.last_visit == currentVisit)
+        {
+            if(cost >= node.cost)
+                return;
+            node.cost = node.estimate = cost;
+            node.prev = &prev;
+            node.dir_ = dir;
+            todo_.rearrange(&node);
+        } else
+        {
+            node.cost = node.estimate = cost;
+            node.targetDistance = 0;
+            node.last_visit = currentVisit;
+            node.prev = &prev;
+            node.dir_ = dir;
+            todo_.push(&node);
+        }
+    };
+
+    while(!todo_.empty())
+    {
+        // Nodes are taken in order of their costs, so the costs of a goal are final when it is taken
+        const noRoadNode& best = *todo_.pop();
+        for(unsigned i = 0; i < goals.size(); i++)
+        {
+            if(goals[i] == &best && lengths[i] == noPath)
+            {
+                lengths[i] = best.cost;
+                numGoalsLeft--;
+            }
+        }
+        if(!numGoalsLeft)
+            break;
+
+        const helpers::EnumArray<RoadSegment*, Direction> routes = best.getRoutes();
+        const noRoadNode* prevNode = best.prev;
+
+        for(const auto dir : helpers::EnumRange<Direction>{})
+        {
+            const auto* route = routes[dir];
+            if(!route || !isSegmentAllowed(*route))
+                continue;
+
+            const noRoadNode* neighbour = route->GetF1();
+            if(neighbour == &best)
+                neighbour = route->GetF2();
+            if(neighbour == prevNode)
+                continue;
+
+            // No paths over buildings
+            if(dir == Direction::NorthWest && !isGoal(neighbour))
+            {
+                // Flags and harbors are allowed
+                const GO_Type got = neighbour->GetGOT();
+                if(got != GO_Type::Flag && got != GO_Type::NobHarborbuilding)
+                    continue;
+            }
+
+            const unsigned cost = best.cost + route->GetLength();
+            if(cost <= max)
+                updateNode(*neighbour, best, cost, toRoadPathDirection(dir));
+        }
+
+        // For harbors also consider ship connections
+        if(best.GetGOT() != GO_Type::NobHarborbuilding)
+            continue;
+        for(const auto& sc : static_cast<const nobHarborBuilding&>(best).GetShipConnections())
+        {
+            const unsigned cost = best.cost + sc.way_costs;
+            if(cost <= max)
+                updateNode(*sc.dest, best, cost, RoadPathDirection::Ship);
+        }
+    }
+
+    return lengths;
+}
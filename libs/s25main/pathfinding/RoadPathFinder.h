@@ -4,9 +4,11 @@
 
 #pragma once
 
+#include "pathfinding/OpenListVector.h"
 #include "gameTypes/MapCoordinates.h"
 #include "gameTypes/RoadPathDirection.h"
 #include <limits>
+#include <vector>
 
 class GameWorldBase;
 class noRoadNode;
@@ -16,6 +18,8 @@ class RoadPathFinder
 {
     GameWorldBase& gwb_;
     unsigned currentVisit;
+    /// Open list of the searches, kept to reuse its memory
+    OpenListVector<const noRoadNode*> todo_;
 
 public:
     RoadPathFinder(GameWorldBase& gwb) : gwb_(gwb), currentVisit(0) {}
@@ -43,7 +47,17 @@ public:
     bool PathExists(const noRoadNode& start, const noRoadNode& goal, bool allowWaterRoads,
                     unsigned max = std::numeric_limits<unsigned>::max(), const RoadSegment* forbidden = nullptr);
 
+    /// Calculates the costs of the best paths from start to each of the goals in one search.
+    /// Uses the same conditions as FindPath without wareMode, for which the costs are the same in both directions.
+    /// Stops as soon as all goals are reached
+    ///
+    /// @param max Maximum costs allowed
+    /// @return The costs for each goal, std::numeric_limits<unsigned>::max() for unreachable goals
+    std::vector<unsigned> FindPathLengths(const noRoadNode& start, const std::vector<const noRoadNode*>& goals,
+                                          unsigned max = std::numeric_limits<unsigned>::max());
+
 private:
+    void IncreaseCurrentVisit();
     template<class T_AdditionalCosts, class T_SegmentConstraints>
     bool FindPathImpl(const noRoadNode& start, const noRoadNode& goal, unsigned max, T_AdditionalCosts addCosts,
                       T_SegmentConstraints isSegmentAllowed, unsigned* length = nullptr,
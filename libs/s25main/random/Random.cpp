@@ -3,8 +3,13 @@
 // SPDX-License-Identifier: GPL-2.0-or-later
 
 #include "random/Random.h"
+#include "helpers/roundToNextPow2.h"
 #include "s25util/Serializer.h"
+#include <algorithm>
+#include <mutex>
+#include <set>
 #include <stdexcept>
+#include <type_traits>
 
 template<class T_PRNG>
 int calcRandValue(T_PRNG& rng, int maxExcl)
@@ -16,7 +21,7 @@ int calcRandValue(T_PRNG& rng, int maxExcl)
 }
 
 template<class T_PRNG>
-Random<T_PRNG>::Random()
+Random<T_PRNG>::Random() : history_(defaultHistorySize)
 {
     Init(123456789);
 }
@@ -32,12 +37,24 @@ void Random<T_PRNG>::ResetState(const PRNG& newState)
 {
     rng_ = newState;
     numInvocations_ = 0;
+    historyStart_ = 0;
+}
+
+template<class T_PRNG>
+void Random<T_PRNG>::SetHistorySize(unsigned size)
+{
+    history_.clear();
+    // Clamp before rounding which would overflow for huge values
+    const unsigned clampedSize = (size > maxHistorySize) ? static_cast<unsigned>(maxHistorySize) : std::max(size, 1u);
+    history_.resize(helpers::roundToNextPowerOfTwo(clampedSize));
+    historyStart_ = numInvocations_;
 }
 
 template<class T_PRNG>
 int Random<T_PRNG>::Rand(const RandomContext& context, const int maxExcl)
 {
-    history_[numInvocations_ % history_.size()] = RandomEntry(numInvocations_, maxExcl, rng_, context);
+    // Size is a power of 2 so masking is the same as the modulo
+    history_[numInvocations_ & (history_.size() - 1u)] = RandomEntry(numInvocations_, maxExcl, rng_, context);
     ++numInvocations_;
 
     return calcRandValue(rng_, maxExcl);
@@ -75,23 +92,13 @@ std::vector<typename Random<T_PRNG>::RandomEntry> Random<T_PRNG>::GetAsyncLog()
 {
     std::vector<RandomEntry> ret;
 
-    unsigned begin, end;
-    if(numInvocations_ > history_.size())
-    {
-        // Ringbuffer filled -> Start from next entry (which is the one written longest time ago)
-        // and go one full cycle (to the entry written last)
-        begin = numInvocations_;
-        end = numInvocations_ + history_.size();
-    } else
-    {
-        // Ringbuffer not filled -> Start from 0 till number of entries
-        begin = 0;
-        end = numInvocations_;
-    }
+    // Ringbuffer filled -> Start with the entry written longest time ago, else with the first one written
+    const unsigned end = numInvocations_;
+    const unsigned begin = std::max(historyStart_, end - std::min<unsigned>(end, history_.size()));
 
     ret.reserve(end - begin);
     for(unsigned i = begin; i < end; ++i)
-        ret.push_back(history_[i % history_.size()]);
+        ret.push_back(history_[i & (history_.size() - 1u)]);
 
     return ret;
 }
@@ -120,7 +127,7 @@ void Random<T_PRNG>::RandomEntry::Deserialize(Serializer& ser)
     if(name != T_PRNG::getName())
         throw std::runtime_error("Wrong random number generator");
     rngState.deserialize(ser);
-    srcName = ser.PopLongString();
+    srcName = internSrcName(ser.PopLongString());
     srcLine = ser.PopUnsignedInt();
     objId = ser.PopUnsignedInt();
 }
@@ -132,5 +139,15 @@ int Random<T_PRNG>::RandomEntry::GetValue() const
     return calcRandValue(tmpRng, maxExcl);
 }
 
+const char* internSrcName(const std::string& srcName)
+{
+    // Only a few distinct source files exist, so those are never freed. std::set keeps the strings at their address
+    static std::mutex mutex;
+    static std::set<std::string> names;
+    std::lock_guard<std::mutex> lock(mutex);
+    return names.insert(srcName).first->c_str();
+}
+
 // Instantiate the Random class with the used PRNG
 template class Random<UsedPRNG>;
+static_assert(std::is_trivially_copyable<RandomEntry>::value, "Recording an invocation must not allocate");
@@ -6,8 +6,6 @@
 
 #include "RTTR_Assert.h"
 #include "random/XorShift.h"
-#include "s25util/Singleton.h"
-#include <array>
 #include <cstddef>
 #include <limits>
 #include <string>
@@ -30,23 +28,25 @@ struct RandomContext
 ///        http://www.boost.org/doc/libs/1_61_0/doc/html/boost_random/reference.html#boost_random.reference.concepts.pseudo_random_number_generator
 /// Additionally it must implement Serialize and Deserialize functions and provide a static GetName function
 template<class T_PRNG>
-class Random : public Singleton<Random<T_PRNG>>
+class Random
 {
 public:
     /// The used random number generator type
     using PRNG = T_PRNG;
 
     /// Class for storing the invocation of the rng
+    /// Trivially copyable so recording an invocation never allocates
     struct RandomEntry
     {
         unsigned counter;
         int maxExcl;
         PRNG rngState;
-        std::string srcName;
+        /// Source file name from __FILE__ or interned on deserialization (see internSrcName), so always valid
+        const char* srcName;
         unsigned srcLine;
         unsigned objId;
 
-        RandomEntry() : counter(0), maxExcl(0), srcLine(0), objId(0){};
+        RandomEntry() : counter(0), maxExcl(0), srcName(""), srcLine(0), objId(0){};
         RandomEntry(unsigned counter, int maxExcl, const PRNG& rngState, const RandomContext& ctx)
             : counter(counter), maxExcl(maxExcl), rngState(rngState), srcName(ctx.srcName), srcLine(ctx.srcLine),
               objId(ctx.objId){};
@@ -72,24 +72,42 @@ public:
     /// Get current rng state
     const PRNG& GetCurrentState() const;
 
+    /// Get the recorded invocations starting with the oldest one
     std::vector<RandomEntry> GetAsyncLog();
 
+    static constexpr unsigned defaultHistorySize = 1024;
+    /// Larger history sizes are clamped to this
+    static constexpr unsigned maxHistorySize = 1u << 20;
+    /// Set the number of invocations recorded for the async log. Clamped to [1, maxHistorySize] and rounded up to a
+    /// power of 2. Clears the history
+    void SetHistorySize(unsigned size);
+    unsigned GetHistorySize() const { return static_cast<unsigned>(history_.size()); }
+
 private:
     PRNG rng_; /// the PRNG
     /// Number of invocations to the PRNG
     unsigned numInvocations_;
-    /// History
-    std::array<RandomEntry, 1024> history_; //-V730_NOINIT
+    /// Invocation number of the oldest entry in the history if it was not yet filled since the last clear
+    unsigned historyStart_;
+    /// Ringbuffer of the last invocations, size is a power of 2
+    std::vector<RandomEntry> history_;
 };
 
+/// Return a pointer to a copy of the source name which stays valid till the program ends.
+/// Equal names give the same pointer
+const char* internSrcName(const std::string& srcName);
+
 /// The actual PRNG used for the ingame RNG
 using UsedPRNG = XorShift;
 using UsedRandom = Random<UsedPRNG>;
 using RandomEntry = UsedRandom::RandomEntry;
 
+/// Return the RNG of the current game context (see GameContext)
+UsedRandom& getCurrentRandom();
+
 ///////////////////////////////////////////////////////////////////////////////
 // Macros / Defines
-#define RANDOM UsedRandom::inst()
+#define RANDOM getCurrentRandom()
 #define RANDOM_CONTEXT() \
     RandomContext { __FILE__, __LINE__, GetObjId() }
 #define RANDOM_CONTEXT2(objId) \
@@ -4,8 +4,28 @@
 
 #include "randomIO.h"
 #include "RttrConfig.h"
+#include "helpers/serializeVarInt.h"
+#include "s25util/Serializer.h"
 #include <boost/nowide/fstream.hpp>
 #include <iomanip>
+#include <iterator>
+#include <map>
+#include <stdexcept>
+
+namespace {
+const std::string binaryLogSignature = "RTTR_RNGLOG";
+constexpr uint8_t binaryLogVersion = 1;
+
+/// Read the number of the following elements of which each takes at least minBytesPerElement.
+/// Throws if there are not enough bytes left, so a corrupted count can't make us allocate more than the file size
+unsigned popElementCount(Serializer& ser, unsigned minBytesPerElement)
+{
+    const unsigned count = helpers::popVarUInt(ser);
+    if(count > ser.GetBytesLeft() / minBytesPerElement)
+        throw std::runtime_error("Invalid number of elements in random log");
+    return count;
+}
+} // namespace
 
 std::ostream& operator<<(std::ostream& os, const RandomEntry& entry)
 {
@@ -25,3 +45,77 @@ void saveRandomLog(const boost::filesystem::path& filepath, const std::vector<Ra
     for(const RandomEntry& curLog : log)
         file << curLog << std::endl;
 }
+
+bool saveRandomLogBinary(const boost::filesystem::path& filepath, const std::vector<RandomEntry>& log)
+{
+    // Assign an index to each distinct source file in order of first use
+    std::map<std::string, unsigned> srcIndices;
+    std::vector<const char*> srcNames;
+    for(const RandomEntry& entry : log)
+    {
+        if(srcIndices.emplace(entry.srcName, srcNames.size()).second)
+            srcNames.push_back(entry.srcName);
+    }
+
+    Serializer ser;
+    ser.PushRawData(binaryLogSignature.data(), binaryLogSignature.size());
+    ser.PushUnsignedChar(binaryLogVersion);
+    ser.PushLongString(UsedPRNG::getName());
+    helpers::pushVarUInt(ser, srcNames.size());
+    for(const char* srcName : srcNames)
+        ser.PushLongString(srcName);
+    helpers::pushVarUInt(ser, log.size());
+    // Counters are (mostly) consecutive so store the difference to the previous one
+    unsigned lastCounter = 0;
+    for(const RandomEntry& entry : log)
+    {
+        helpers::pushVarUInt(ser, entry.counter - lastCounter);
+        lastCounter = entry.counter;
+        helpers::pushVarUInt(ser, static_cast<uint32_t>(entry.maxExcl));
+        entry.rngState.serialize(ser);
+        helpers::pushVarUInt(ser, srcIndices[entry.srcName]);
+        helpers::pushVarUInt(ser, entry.srcLine);
+        helpers::pushVarUInt(ser, entry.objId);
+    }
+
+    boost::nowide::ofstream file(filepath, std::ios::binary);
+    return file && file.write(reinterpret_cast<const char*>(ser.GetData()), ser.GetLength());
+}
+
+std::vector<RandomEntry> loadRandomLogBinary(const boost::filesystem::path& filepath)
+{
+    boost::nowide::ifstream file(filepath, std::ios::binary);
+    if(!file)
+        throw std::runtime_error("Could not open " + filepath.string());
+    const std::vector<char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if(data.size() < binaryLogSignature.size())
+        throw std::runtime_error("Not a random log file");
+
+    Serializer ser(data.data(), data.size());
+    std::string signature(binaryLogSignature.size(), '\0');
+    ser.PopRawData(&signature[0], signature.size());
+    if(signature != binaryLogSignature)
+        throw std::runtime_error("Not a random log file");
+    if(ser.PopUnsignedChar() != binaryLogVersion)
+        throw std::runtime_error("Unsupported random log version");
+    if(ser.PopLongString() != UsedPRNG::getName())
+        throw std::runtime_error("Wrong random number generator");
+    // Each name has at least its length
+    std::vector<const char*> srcNames(popElementCount(ser, 4));
+    for(const char*& srcName : srcNames)
+        srcName = internSrcName(ser.PopLongString());
+
+    // Each entry has at least 5 variable length integers
+    std::vector<RandomEntry> log(popElementCount(ser, 5));
+    unsigned lastCounter = 0;
+    for(RandomEntry& entry : log)
+    {
+        entry.counter = lastCounter += helpers::popVarUInt(ser);
+        entry.maxExcl = static_cast<int>(helpers::popVarUInt(ser));
+        entry.rngState.deserialize(ser);
+        entry.srcName = srcNames.at(helpers::popVarUInt(ser));
+        entry.srcLine = helpers::popVarUInt(ser);
+        entry.objId = helpers::popVarUInt(ser);
+    }
+    return log;
+}
@@ -12,3 +12,7 @@ std::ostream& operator<<(std::ostream& os, const RandomEntry& entry);
 
 /// Save the log to a file
 void saveRandomLog(const boost::filesystem::path& filepath, const std::vector<RandomEntry>& log);
+/// Save the log in a compact binary format storing each source file name only once. Return false on failure
+bool saveRandomLogBinary(const boost::filesystem::path& filepath, const std::vector<RandomEntry>& log);
+/// Load a log saved by saveRandomLogBinary. Throws std::runtime_error if the file is invalid
+std::vector<RandomEntry> loadRandomLogBinary(const boost::filesystem::path& filepath);
@@ -1159,17 +1159,16 @@ void GameWorld::MakeVisible(const MapPoint pt, const unsigned char player)
 void GameWorld::RecalcVisibilitiesAroundPoint(const MapPoint pt, const MapCoord radius, const unsigned char player,
                                               const noBaseBuilding* const exception)
 {
-    std::vector<MapPoint> pts = GetPointsInRadiusWithCenter(pt, radius);
-    for(const MapPoint& pt : pts)
-        RecalcVisibility(pt, player, exception);
+    VisitPointsInRadius(
+      pt, radius,
+      [this, player, exception](const MapPoint curPt, unsigned) { RecalcVisibility(curPt, player, exception); }, true);
 }
 
 /// Setzt die Sichtbarkeiten um einen Punkt auf sichtbar (aus Performancegründen Alternative zu oberem)
 void GameWorld::MakeVisibleAroundPoint(const MapPoint pt, const MapCoord radius, const unsigned char player)
 {
-    std::vector<MapPoint> pts = GetPointsInRadiusWithCenter(pt, radius);
-    for(const MapPoint& curPt : pts)
-        MakeVisible(curPt, player);
+    VisitPointsInRadius(
+      pt, radius, [this, player](const MapPoint curPt, unsigned) { MakeVisible(curPt, player); }, true);
 }
 
 /// Bestimmt bei der Bewegung eines spähenden Objekts die Sichtbarkeiten an
@@ -32,12 +32,14 @@
 #include "s25util/warningSuppression.h"
 #include <glad/glad.h>
 #include <boost/format.hpp>
+#include <algorithm>
 #include <cmath>
+#include <tuple>
 
 GameWorldView::GameWorldView(const GameWorldViewer& gwv, const Position& pos, const Extent& size)
     : selPt(0, 0), show_bq(SETTINGS.ingame.showBQ), show_names(SETTINGS.ingame.showNames),
       show_productivity(SETTINGS.ingame.showProductivity), offset(0, 0), lastOffset(0, 0), gwv(gwv), origin_(pos),
-      size_(size), zoomFactor_(1.f), targetZoomFactor_(1.f), zoomSpeed_(0.f)
+      size_(size), zoomFactor_(1.f), targetZoomFactor_(1.f), zoomSpeed_(0.f), drawTimes_()
 {
     MoveTo(0, 0);
 }
@@ -103,19 +105,12 @@ float GameWorldView::GetCurrentTargetZoomFactor() const
     return targetZoomFactor_;
 }
 
-struct ObjectBetweenLines
-{
-    noBase& obj;
-    DrawPoint pos; // Zeichenposition
-
-    ObjectBetweenLines(noBase& obj, const DrawPoint& pos) : obj(obj), pos(pos) {}
-};
-
 void GameWorldView::Draw(const RoadBuildState& rb, const MapPoint selected, bool drawMouse, unsigned* water)
 {
+    using clock = DrawTimes::clock;
+
     SetNextZoomFactor();
 
-    int shortestDistToMouse = 100000;
     Position mousePos = VIDEODRIVER.GetMousePos();
     mousePos -= Position(origin_);
 
@@ -136,65 +131,84 @@ void GameWorldView::Draw(const RoadBuildState& rb, const MapPoint selected, bool
 
     glTranslatef(static_cast<GLfloat>(origin_.x) / zoomFactor_, static_cast<GLfloat>(origin_.y) / zoomFactor_, 0.0f);
 
+    const clock::time_point startTime = clock::now();
     glTranslatef(static_cast<GLfloat>(-offset.x), static_cast<GLfloat>(-offset.y), 0.0f);
     const TerrainRenderer& terrainRenderer = gwv.GetTerrainRenderer();
     terrainRenderer.Draw(GetFirstPt(), GetLastPt(), gwv, water);
     glTranslatef(static_cast<GLfloat>(offset.x), static_cast<GLfloat>(offset.y), 0.0f);
+    const clock::time_point terrainEndTime = clock::now();
+    drawTimes_.terrain = terrainEndTime - startTime;
+    drawTimes_.figures = clock::duration::zero();
+
+    CollectVisibleNodes(terrainRenderer, mousePos);
+    CollectFiguresFromBelow(terrainRenderer);
 
+    auto itFromBelow = figuresFromBelow_.cbegin();
+    unsigned nodeIdx = 0;
     for(int y = firstPt.y; y <= lastPt.y; ++y)
     {
         // Figuren speichern, die in dieser Zeile gemalt werden müssen
         // und sich zwischen zwei Zeilen befinden, da sie dazwischen laufen
-        std::vector<ObjectBetweenLines> between_lines;
+        betweenLines_.clear();
 
-        for(int x = firstPt.x; x <= lastPt.x; ++x)
+        for(int x = firstPt.x; x <= lastPt.x; ++x, ++nodeIdx)
         {
-            Position curOffset;
-            const MapPoint curPt = terrainRenderer.ConvertCoords(Position(x, y), &curOffset);
-            DrawPoint curPos = GetWorld().GetNodePos(curPt) - offset + curOffset;
-
-            Position mouseDist = mousePos - curPos;
-            mouseDist *= mouseDist;
-            if(std::abs(mouseDist.x) + std::abs(mouseDist.y) < shortestDistToMouse)
-            {
-                selPt = curPt;
-                selPtOffset = curOffset;
-                shortestDistToMouse = std::abs(mouseDist.x) + std::abs(mouseDist.y);
-            }
+            const VisibleNode& node = visibleNodes_[nodeIdx];
+            Visibility visibility = gwv.GetVisibility(node.pt);
 
-            Visibility visibility = gwv.GetVisibility(curPt);
-
-            DrawBoundaryStone(curPt, curPos, visibility);
+            DrawBoundaryStone(node.pt, node.pos, visibility);
 
             if(visibility == Visibility::Visible)
             {
-                DrawObject(curPt, curPos);
-                DrawMovingFiguresFromBelow(terrainRenderer, Position(x, y), between_lines);
-                DrawFigures(curPt, curPos, between_lines);
+                DrawObject(node.pt, node.pos);
+
+                // Figures moving towards invisible nodes are not drawn
+                while(itFromBelow != figuresFromBelow_.cend() && itFromBelow->nodeIdx < nodeIdx)
+                    ++itFromBelow;
+                const bool hasFiguresFromBelow =
+                  itFromBelow != figuresFromBelow_.cend() && itFromBelow->nodeIdx == nodeIdx;
+                if(hasFiguresFromBelow || !GetWorld().GetFigures(node.pt).empty())
+                {
+                    const clock::time_point figuresStartTime = clock::now();
+                    // First draw figures moving towards this point from below
+                    for(; itFromBelow != figuresFromBelow_.cend() && itFromBelow->nodeIdx == nodeIdx; ++itFromBelow)
+                        betweenLines_.push_back(ObjectBetweenLines(*itFromBelow->figure, itFromBelow->pos));
+                    DrawFigures(node.pt, node.pos, betweenLines_);
+                    drawTimes_.figures += clock::now() - figuresStartTime;
+                }
 
                 // Construction aid mode
                 if(show_bq)
-                    DrawConstructionAid(curPt, curPos);
+                    DrawConstructionAid(node.pt, node.pos);
             } else if(visibility == Visibility::FogOfWar)
             {
-                const FOWObject* fowobj = gwv.GetYoungestFOWObject(MapPoint(curPt));
+                const FOWObject* fowobj = gwv.GetYoungestFOWObject(node.pt);
                 if(fowobj)
-                    fowobj->Draw(curPos);
+                    fowobj->Draw(node.pos);
             }
 
             for(IDrawNodeCallback* callback : drawNodeCallbacks)
-                callback->onDraw(curPt, curPos);
+                callback->onDraw(node.pt, node.pos);
         }
 
         // Figuren zwischen den Zeilen zeichnen
-        for(auto& between_line : between_lines)
-            between_line.obj.Draw(between_line.pos);
+        if(!betweenLines_.empty())
+        {
+            const clock::time_point figuresStartTime = clock::now();
+            for(auto& between_line : betweenLines_)
+                between_line.obj.Draw(between_line.pos);
+            drawTimes_.figures += clock::now() - figuresStartTime;
+        }
     }
+    const clock::time_point objectsEndTime = clock::now();
+    drawTimes_.objects = objectsEndTime - terrainEndTime - drawTimes_.figures;
 
     if(show_names || show_productivity)
-        DrawNameProductivityOverlay(terrainRenderer);
+        DrawNameProductivityOverlay();
 
-    DrawGUI(rb, terrainRenderer, selected, drawMouse);
+    DrawGUI(rb, selected, drawMouse);
+    const clock::time_point guiEndTime = clock::now();
+    drawTimes_.gui = guiEndTime - objectsEndTime;
 
     // Umherfliegende Katapultsteine zeichnen
     for(auto* catapult_stone : GetWorld().catapult_stones)
@@ -203,6 +217,7 @@ void GameWorldView::Draw(const RoadBuildState& rb, const MapPoint selected, bool
            || gwv.GetVisibility(catapult_stone->dest_map) == Visibility::Visible)
             catapult_stone->Draw(offset);
     }
+    drawTimes_.objects += clock::now() - guiEndTime;
 
     if(zoomFactor_ != 1.f) //-V550
     {
@@ -215,8 +230,69 @@ void GameWorldView::Draw(const RoadBuildState& rb, const MapPoint selected, bool
     glScissor(0, 0, VIDEODRIVER.GetRenderSize().x, VIDEODRIVER.GetRenderSize().y);
 }
 
-void GameWorldView::DrawGUI(const RoadBuildState& rb, const TerrainRenderer& terrainRenderer,
-                            const MapPoint& selectedPt, bool drawMouse)
+void GameWorldView::CollectVisibleNodes(const TerrainRenderer& terrainRenderer, const Position& mousePos)
+{
+    visibleNodes_.clear();
+    int shortestDistToMouse = 100000;
+    for(int y = firstPt.y; y <= lastPt.y; ++y)
+    {
+        for(int x = firstPt.x; x <= lastPt.x; ++x)
+        {
+            Position curOffset;
+            const MapPoint curPt = terrainRenderer.ConvertCoords(Position(x, y), &curOffset);
+            const DrawPoint curPos = GetWorld().GetNodePos(curPt) - offset + curOffset;
+            visibleNodes_.push_back(VisibleNode{curPt, curPos});
+
+            Position mouseDist = mousePos - curPos;
+            mouseDist *= mouseDist;
+            if(std::abs(mouseDist.x) + std::abs(mouseDist.y) < shortestDistToMouse)
+            {
+                selPt = curPt;
+                selPtOffset = curOffset;
+                shortestDistToMouse = std::abs(mouseDist.x) + std::abs(mouseDist.y);
+            }
+        }
+    }
+}
+
+void GameWorldView::CollectFiguresFromBelow(const TerrainRenderer& terrainRenderer)
+{
+    figuresFromBelow_.clear();
+    const int rowSize = lastPt.x - firstPt.x + 1;
+    unsigned seqNr = 0;
+    // Those figures are in the row below their target and might be outside the visible area
+    for(int y = firstPt.y + 1; y <= lastPt.y + 1; ++y)
+    {
+        for(int x = firstPt.x - 1; x <= lastPt.x + 1; ++x)
+        {
+            const Position viewPt(x, y);
+            Position curOffset;
+            const MapPoint curPt = terrainRenderer.ConvertCoords(viewPt, &curOffset);
+            for(noBase& figure : GetWorld().GetFigures(curPt))
+            {
+                if(!figure.IsMoving())
+                    continue;
+                const Direction curMoveDir = static_cast<noMovable&>(figure).GetCurMoveDir();
+                if(curMoveDir != Direction::NorthEast && curMoveDir != Direction::NorthWest)
+                    continue;
+                const Position targetPt = GetNeighbour(viewPt, curMoveDir);
+                if(targetPt.x < firstPt.x || targetPt.x > lastPt.x || targetPt.y < firstPt.y)
+                    continue;
+                const unsigned nodeIdx = (targetPt.y - firstPt.y) * rowSize + targetPt.x - firstPt.x;
+                // Figures coming from the south west are drawn first
+                const unsigned order = (curMoveDir == Direction::NorthEast ? 0 : 1);
+                const DrawPoint figPos = GetWorld().GetNodePos(curPt) - offset + curOffset;
+                figuresFromBelow_.push_back(FigureFromBelow{nodeIdx, order, seqNr++, &figure, figPos});
+            }
+        }
+    }
+    std::sort(figuresFromBelow_.begin(), figuresFromBelow_.end(),
+              [](const FigureFromBelow& lhs, const FigureFromBelow& rhs) {
+                  return std::tie(lhs.nodeIdx, lhs.order, lhs.seqNr) < std::tie(rhs.nodeIdx, rhs.order, rhs.seqNr);
+              });
+}
+
+void GameWorldView::DrawGUI(const RoadBuildState& rb, const MapPoint& selectedPt, bool drawMouse)
 {
     // Falls im Straßenbaumodus: Punkte um den aktuellen Straßenbaupunkt herum ermitteln
     helpers::EnumArray<MapPoint, Direction> road_points;
@@ -232,14 +308,13 @@ void GameWorldView::DrawGUI(const RoadBuildState& rb, const TerrainRenderer& ter
         maxWaterWayLen = waterwayLengths[index];
     }
 
-    for(int x = firstPt.x; x <= lastPt.x; ++x)
+    const unsigned rowSize = lastPt.x - firstPt.x + 1;
+    for(unsigned x = 0; x < rowSize; ++x)
     {
-        for(int y = firstPt.y; y <= lastPt.y; ++y)
+        for(unsigned nodeIdx = x; nodeIdx < visibleNodes_.size(); nodeIdx += rowSize)
         {
-            // Coordinates transform
-            Position curOffset;
-            MapPoint curPt = terrainRenderer.ConvertCoords(Position(x, y), &curOffset);
-            Position curPos = GetWorld().GetNodePos(curPt) - offset + curOffset;
+            const MapPoint curPt = visibleNodes_[nodeIdx].pt;
+            const Position curPos = visibleNodes_[nodeIdx].pos;
 
             /// Current point indicated by Mouse
             if(drawMouse && selPt == curPt)
@@ -323,6 +398,8 @@ void GameWorldView::DrawGUI(const RoadBuildState& rb, const TerrainRenderer& ter
                     LOADER.GetMapImageN(id)->DrawFull(curPos);
                 else
                 {
+                    // Offset of the current point due to map wrapping
+                    const DrawPoint curOffset = curPos - (GetWorld().GetNodePos(curPt) - offset);
                     DrawPoint lastPos = GetWorld().GetNodePos(rb.point) - offset + curOffset;
                     DrawPoint halfWayPos = (curPos + lastPos) / 2;
                     LOADER.GetMapImageN(id)->DrawFull(halfWayPos);
@@ -333,15 +410,14 @@ void GameWorldView::DrawGUI(const RoadBuildState& rb, const TerrainRenderer& ter
     }
 }
 
-void GameWorldView::DrawNameProductivityOverlay(const TerrainRenderer& terrainRenderer)
+void GameWorldView::DrawNameProductivityOverlay()
 {
-    for(int x = firstPt.x; x <= lastPt.x; ++x)
+    const unsigned rowSize = lastPt.x - firstPt.x + 1;
+    for(unsigned x = 0; x < rowSize; ++x)
     {
-        for(int y = firstPt.y; y <= lastPt.y; ++y)
+        for(unsigned nodeIdx = x; nodeIdx < visibleNodes_.size(); nodeIdx += rowSize)
         {
-            // Coordinate transform
-            Position curOffset;
-            MapPoint pt = terrainRenderer.ConvertCoords(Position(x, y), &curOffset);
+            const MapPoint pt = visibleNodes_[nodeIdx].pt;
 
             const auto* no = GetWorld().GetSpecObj<noBaseBuilding>(pt);
             if(!no)
@@ -354,7 +430,7 @@ void GameWorldView::DrawNameProductivityOverlay(const TerrainRenderer& terrainRe
                    continue;
            }
 
-            Position curPos = GetWorld().GetNodePos(pt) - offset + curOffset;
+            Position curPos = visibleNodes_[nodeIdx].pos;
             curPos.y -= 22;
 
             // Draw object name
@@ -448,27 +524,6 @@ void GameWorldView::DrawFigures(const MapPoint& pt, const DrawPoint& curPos,
     }
 }
 
-void GameWorldView::DrawMovingFiguresFromBelow(const TerrainRenderer& terrainRenderer, const DrawPoint& curPos,
-                                               std::vector<ObjectBetweenLines>& between_lines)
-{
-    // First draw figures moving towards this point from below
-    static const std::array<Direction, 2> aboveDirs = {{Direction::NorthEast, Direction::NorthWest}};
-    for(Direction dir : aboveDirs)
-    {
-        // Get figures opposite the current dir and check if they are moving in this dir
-        // Coordinates transform
-        Position curOffset;
-        MapPoint curPt = terrainRenderer.ConvertCoords(GetNeighbour(curPos, dir + 3u), &curOffset);
-        Position figPos = GetWorld().GetNodePos(curPt) - offset + curOffset;
-
-        for(noBase& figure : GetWorld().GetFigures(curPt))
-        {
-            if(figure.IsMoving() && static_cast<noMovable&>(figure).GetCurMoveDir() == dir)
-                between_lines.push_back(ObjectBetweenLines(figure, figPos));
-        }
-    }
-}
-
 void GameWorldView::DrawConstructionAid(const MapPoint& pt, const DrawPoint& curPos)
 {
     BuildingQuality bq = gwv.GetBQ(pt);
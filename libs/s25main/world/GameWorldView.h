@@ -7,10 +7,12 @@
 #include "DrawPoint.h"
 #include "gameTypes/MapCoordinates.h"
 #include "gameTypes/MapTypes.h"
+#include <chrono>
 #include <vector>
 
 class GameWorldBase;
 class GameWorldViewer;
+class noBase;
 class noBaseBuilding;
 class SoundManager;
 class TerrainRenderer;
@@ -25,10 +27,41 @@ public:
     virtual void onDraw(const MapPoint& pt, const DrawPoint& displayPt) = 0;
 };
 
-struct ObjectBetweenLines;
+struct ObjectBetweenLines
+{
+    noBase& obj;
+    DrawPoint pos; // Zeichenposition
+
+    ObjectBetweenLines(noBase& obj, const DrawPoint& pos) : obj(obj), pos(pos) {}
+};
 
 class GameWorldView
 {
+public:
+    /// CPU time spent on the parts of the last Draw call
+    struct DrawTimes
+    {
+        using clock = std::chrono::steady_clock;
+        clock::duration terrain, objects, figures, gui;
+    };
+
+private:
+    struct VisibleNode
+    {
+        MapPoint pt;
+        DrawPoint pos;
+    };
+    /// Figure moving to a node from below, drawn after the object on that node
+    struct FigureFromBelow
+    {
+        /// Index of the target node in visibleNodes_
+        unsigned nodeIdx;
+        /// Sort keys to get the draw order: Coming from south west first, then original order
+        unsigned order, seqNr;
+        noBase* figure;
+        DrawPoint pos;
+    };
+
     /// Currently selected point (where the mouse points to)
     MapPoint selPt;
     /// Offset to selected point
@@ -65,6 +98,13 @@ class GameWorldView
     float targetZoomFactor_;
     float zoomSpeed_;
 
+    /// Nodes drawn in the current frame row by row. Buffers are kept to avoid allocations each frame
+    std::vector<VisibleNode> visibleNodes_;
+    /// Figures moving upwards sorted by the node they are drawn at
+    std::vector<FigureFromBelow> figuresFromBelow_;
+    std::vector<ObjectBetweenLines> betweenLines_;
+    DrawTimes drawTimes_;
+
 public:
     GameWorldView(const GameWorldViewer& gwv, const Position& pos, const Extent& size);
 
@@ -102,6 +142,8 @@ public:
     void ToggleShowNamesAndProductivity();
 
     void Draw(const RoadBuildState& rb, MapPoint selected, bool drawMouse, unsigned* water = nullptr);
+    /// Time breakdown of the last Draw call
+    const DrawTimes& GetDrawTimes() const { return drawTimes_; }
 
     /// Bewegt sich zu einer bestimmten Position in Pixeln auf der Karte
     void MoveTo(int x, int y, bool absolute = false);
@@ -135,13 +177,14 @@ private:
     void DrawObject(const MapPoint& pt, const DrawPoint& curPos);
     void DrawConstructionAid(const MapPoint& pt, const DrawPoint& curPos);
     void DrawFigures(const MapPoint& pt, const DrawPoint& curPos, std::vector<ObjectBetweenLines>& between_lines) const;
-    void DrawMovingFiguresFromBelow(const TerrainRenderer& terrainRenderer, const DrawPoint& curPos,
-                                    std::vector<ObjectBetweenLines>& between_lines);
+    /// Fill visibleNodes_ and update the selected point
+    void CollectVisibleNodes(const TerrainRenderer& terrainRenderer, const Position& mousePos);
+    /// Fill figuresFromBelow_ with the figures moving upwards to one of the visible nodes
+    void CollectFiguresFromBelow(const TerrainRenderer& terrainRenderer);
 
-    void DrawNameProductivityOverlay(const TerrainRenderer& terrainRenderer);
+    void DrawNameProductivityOverlay();
     void DrawProductivity(const noBaseBuilding& no, const DrawPoint& curPos);
-    void DrawGUI(const RoadBuildState& rb, const TerrainRenderer& terrainRenderer, const MapPoint& selectedPt,
-                 bool drawMouse);
+    void DrawGUI(const RoadBuildState& rb, const MapPoint& selectedPt, bool drawMouse);
 
     void SaveIngameSettingsValues() const;
 };
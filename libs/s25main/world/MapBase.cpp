@@ -9,6 +9,42 @@
 #include <stdexcept>
 #include <string>
 
+namespace {
+std::vector<detail::RadiusOffset> createRadiusOffsets(bool isOddRow)
+{
+    static_assert(detail::maxPrecomputedRadius <= 127, "Offsets must fit into int8_t");
+    std::vector<detail::RadiusOffset> offsets;
+    offsets.reserve(detail::getNumPointsInRadius(detail::maxPrecomputedRadius));
+    // Walk the rings exactly like MapBase::CheckPointsInRadius does for larger radii but on an unbounded map.
+    // As the map height is even the offsets are valid for any point in a row of the same parity
+    const Position center(0, isOddRow ? 1 : 0);
+    Position curStartPt = center;
+    for(unsigned r = 1; r <= detail::maxPrecomputedRadius; ++r)
+    {
+        curStartPt = ::GetNeighbour(curStartPt, Direction::West);
+        Position curPt = curStartPt;
+        for(const auto dir : helpers::enumRange(Direction::NorthEast))
+        {
+            for(unsigned step = 0; step < r; ++step)
+            {
+                const Position offset = curPt - center;
+                offsets.push_back({static_cast<int8_t>(offset.x), static_cast<int8_t>(offset.y),
+                                   static_cast<uint8_t>(r)});
+                curPt = ::GetNeighbour(curPt, dir);
+            }
+        }
+    }
+    return offsets;
+}
+} // namespace
+
+const std::vector<detail::RadiusOffset>& detail::getRadiusOffsets(bool isOddRow)
+{
+    static const std::array<std::vector<RadiusOffset>, 2> offsets = {
+      {createRadiusOffsets(false), createRadiusOffsets(true)}};
+    return offsets[isOddRow ? 1 : 0];
+}
+
 unsigned MapBase::CreateGUIID(MapPoint pt)
 {
     return pt.y * MAX_MAP_SIZE + pt.x;
@@ -10,7 +10,9 @@
 #include "gameTypes/Direction.h"
 #include "gameTypes/MapCoordinates.h"
 #include "gameTypes/ShipDirection.h"
+#include <algorithm>
 #include <array>
+#include <cstdint>
 #include <vector>
 
 struct AlwaysTrue
@@ -28,7 +30,25 @@ struct ReturnMapPoint
 namespace detail {
 template<typename T_TransformPt>
 using GetPointsResult_t = std::vector<decltype(std::declval<T_TransformPt>()(MapPoint{}, unsigned{}))>;
+
+/// Offset of a point to the center of a radius and its distance to it
+struct RadiusOffset
+{
+    int8_t dx, dy;
+    uint8_t radius;
+};
+/// Radius up to which the offsets of the points are precomputed. Larger radii are walked step by step
+constexpr unsigned maxPrecomputedRadius = 64;
+/// Number of points in the given radius excluding the center
+/// For every additional radius we get 6 * curRadius more points, hence 6 * sum(1..radius) = 3 * (radius^2 + radius)
+constexpr unsigned getNumPointsInRadius(unsigned radius)
+{
+    return (radius * radius + radius) * 3u;
 }
+/// Return the offsets of all points in a radius of 1..maxPrecomputedRadius around a point in an even or odd row.
+/// They are sorted by radius and in the order a ring is walked by MapBase::CheckPointsInRadius
+const std::vector<RadiusOffset>& getRadiusOffsets(bool isOddRow);
+} // namespace detail
 
 /// Base class for a map. A map has a size and functions for getting from one point to another in that map
 class MapBase
@@ -83,8 +103,22 @@ public:
     }
     /// Returns true, if the IsValid functor returns true for any point in the given radius
     /// If includePt is true, then the point itself is also checked
+    /// The functor takes a map point and its distance to pt. Points are checked in order of their distance
     template<class T_IsValidPt>
     bool CheckPointsInRadius(MapPoint pt, unsigned radius, T_IsValidPt&& isValid, bool includePt) const;
+    /// Call the functor with each point in the given radius and its distance to pt in the same order as
+    /// GetPointsInRadius. Does not allocate, so prefer this over iterating the result of GetPointsInRadius
+    template<class T_Functor>
+    void VisitPointsInRadius(MapPoint pt, unsigned radius, T_Functor&& functor, bool includePt = false) const
+    {
+        CheckPointsInRadius(
+          pt, radius,
+          [&functor](const MapPoint curPt, unsigned curRadius) {
+              functor(curPt, curRadius);
+              return false;
+          },
+          includePt);
+    }
 
     /// Return the distance between 2 points on the map (includes wrapping around map borders)
     unsigned CalcDistance(const Position& p1, const Position& p2) const;
@@ -121,43 +155,17 @@ detail::GetPointsResult_t<T_TransformPt> MapBase::GetPointsInRadius(const MapPoi
     if(T_maxResults > 0)
         result.reserve(T_maxResults);
     else if(std::is_same<T_IsValidPt, AlwaysTrue>::value)
-    {
-        // For every additional radius we get 6 * curRadius more points. Hence we have 6 * sum(1..radius) points + the
-        // center point if requested This can be reduced via the gauss formula to the following:
-        result.reserve((radius * radius + radius) * 3u + (includePt ? 1u : 0u));
-    }
-    if(includePt)
-    {
-        const auto el = transformPt(pt, 0);
-        if(isValid(el))
-        {
-            result.push_back(el);
-            if(T_maxResults == 1)
-                return result;
-        }
-    }
-    MapPoint curStartPt = pt;
-    for(unsigned r = 1; r <= radius; ++r)
-    {
-        // Go one level/hull to the left
-        curStartPt = GetNeighbour(curStartPt, Direction::West);
-        // Now iterate over the "circle" of radius r by going r steps in one direction, turn right and repeat
-        MapPoint curPt = curStartPt;
-        for(const auto dir : helpers::enumRange(Direction::NorthEast))
-        {
-            for(unsigned step = 0; step < r; ++step)
-            {
-                const auto el = transformPt(curPt, r);
-                if(isValid(el))
-                {
-                    result.push_back(el);
-                    if(T_maxResults > 0 && static_cast<int>(result.size()) >= T_maxResults)
-                        return result;
-                }
-                curPt = GetNeighbour(curPt, dir);
-            }
-        }
-    }
+        result.reserve(::detail::getNumPointsInRadius(radius) + (includePt ? 1u : 0u));
+    CheckPointsInRadius(
+      pt, radius,
+      [&](const MapPoint curPt, unsigned curRadius) {
+          const auto el = transformPt(curPt, curRadius);
+          if(!isValid(el))
+              return false;
+          result.push_back(el);
+          return T_maxResults > 0 && static_cast<int>(result.size()) >= T_maxResults;
+      },
+      includePt);
     return result;
 }
 
@@ -167,8 +175,29 @@ inline bool MapBase::CheckPointsInRadius(const MapPoint pt, unsigned radius, T_I
 {
     if(includePt && isValid(pt, 0))
         return true;
-    MapPoint curStartPt = pt;
-    for(unsigned r = 1; r <= radius; ++r)
+    const unsigned tableRadius = std::min(radius, detail::maxPrecomputedRadius);
+    const std::vector<detail::RadiusOffset>& offsets = detail::getRadiusOffsets((pt.y & 1) != 0);
+    const auto itEnd = offsets.begin() + detail::getNumPointsInRadius(tableRadius);
+    if(pt.x >= tableRadius && pt.y >= tableRadius && pt.x + tableRadius < size_.x && pt.y + tableRadius < size_.y)
+    {
+        // Far enough from the map border so no wrapping is required
+        for(auto it = offsets.begin(); it != itEnd; ++it)
+        {
+            if(isValid(MapPoint(static_cast<MapCoord>(pt.x + it->dx), static_cast<MapCoord>(pt.y + it->dy)),
+                       it->radius))
+                return true;
+        }
+    } else
+    {
+        for(auto it = offsets.begin(); it != itEnd; ++it)
+        {
+            if(isValid(MakeMapPoint(Position(pt.x + it->dx, pt.y + it->dy)), it->radius))
+                return true;
+        }
+    }
+    // Start the remaining rings from the leftmost point of the last precomputed one
+    MapPoint curStartPt = MakeMapPoint(Position(pt.x - static_cast<int>(tableRadius), pt.y));
+    for(unsigned r = tableRadius + 1; r <= radius; ++r)
     {
         // Go one level/hull to the left
         curStartPt = GetNeighbour(curStartPt, Direction::West);
@@ -0,0 +1,101 @@
+// Copyright (C) 2005 - 2021 Settlers Freaks (sf-team at siedler25.org)
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "world/RadiusSumMap.h"
+#include "RTTR_Assert.h"
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+
+namespace {
+/// Interpret the 16 bit value (modulo 2^16) as a signed one
+int toSigned(uint16_t value)
+{
+    return (value <= std::numeric_limits<int16_t>::max()) ? value : static_cast<int>(value) - 0x10000;
+}
+} // namespace
+
+void RadiusSumMap::Resize(const MapExtent& newSize)
+{
+    MapBase::Resize(newSize);
+    rowValues_.clear();
+    rowValues_.resize(prodOfComponents(newSize));
+    isRowChanged_.clear();
+    isRowChanged_.resize(newSize.y, true);
+}
+
+int RadiusSumMap::operator[](const MapPoint pt) const
+{
+    const unsigned idx = GetIdx(pt);
+    if(isRowChanged_[pt.y] || pt.x == 0)
+        return toSigned(rowValues_[idx]);
+    return toSigned(static_cast<uint16_t>(rowValues_[idx] - rowValues_[idx - 1]));
+}
+
+void RadiusSumMap::set(const MapPoint pt, int value)
+{
+    RTTR_Assert(value >= std::numeric_limits<int8_t>::min() && value <= std::numeric_limits<int8_t>::max());
+    if(!isRowChanged_[pt.y])
+    {
+        if((*this)[pt] == value)
+            return;
+        // Back to plain values
+        uint16_t* row = &rowValues_[GetIdx(MapPoint(0, pt.y))];
+        for(unsigned x = GetWidth() - 1; x > 0; x--)
+            row[x] = static_cast<uint16_t>(row[x] - row[x - 1]);
+        isRowChanged_[pt.y] = true;
+    }
+    rowValues_[GetIdx(pt)] = static_cast<uint16_t>(value);
+}
+
+int RadiusSumMap::getSum(const MapPoint pt, unsigned radius) const
+{
+    RTTR_Assert(radius <= maxRadius);
+    // In axial coordinates (q = x - floor(y / 2) for odd rows shifted right, r = y) the hexagon consists of all points
+    // with |dq|, |dr|, |dq + dr| <= radius. So the row at dr contains 2 * radius + 1 - |dr| points starting at
+    // dq = max(-radius, -radius - dr)
+    const int n = static_cast<int>(radius);
+    const int q0 = pt.x - (pt.y - (pt.y & 1)) / 2;
+    int sum = 0;
+    for(int dr = -n; dr <= n; ++dr)
+    {
+        const int y = pt.y + dr;
+        const int xStart = q0 + std::max(-n, -n - dr) + (y - (y & 1)) / 2;
+        sum += getRowSum(MakeMapPoint(Position(xStart, y)), 2 * n + 1 - std::abs(dr));
+    }
+    return sum;
+}
+
+int RadiusSumMap::getRowSum(const MapPoint startPt, unsigned count) const
+{
+    updatePrefixSums(startPt.y);
+    const unsigned width = GetWidth();
+    const uint16_t* prefixSums = &rowValues_[GetIdx(MapPoint(0, startPt.y))];
+    // Sum of the values before x
+    const auto getPrefixSum = [prefixSums](unsigned x) -> unsigned { return x ? prefixSums[x - 1] : 0u; };
+    // Unsigned overflow keeps the result correct modulo 2^16.
+    // The range may wrap around the map border, even multiple times on small maps
+    unsigned sum = (count / width) * prefixSums[width - 1];
+    const unsigned endX = startPt.x + count % width;
+    if(endX <= width)
+        sum += getPrefixSum(endX) - getPrefixSum(startPt.x);
+    else
+        sum += prefixSums[width - 1] - getPrefixSum(startPt.x) + getPrefixSum(endX - width);
+    return toSigned(static_cast<uint16_t>(sum));
+}
+
+void RadiusSumMap::updatePrefixSums(unsigned y) const
+{
+    if(!isRowChanged_[y])
+        return;
+    uint16_t* row = &rowValues_[GetIdx(MapPoint(0, y))];
+    for(unsigned x = 1; x < GetWidth(); x++)
+        row[x] = static_cast<uint16_t>(row[x] + row[x - 1]);
+    isRowChanged_[y] = false;
+}
+
+size_t RadiusSumMap::getMemoryUsage() const
+{
+    return rowValues_.size() * sizeof(uint16_t) + isRowChanged_.size() / 8u;
+}
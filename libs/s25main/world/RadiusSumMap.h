@@ -0,0 +1,48 @@
+// Copyright (C) 2005 - 2021 Settlers Freaks (sf-team at siedler25.org)
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "world/MapBase.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/// Map of values which returns the sum of the values of all points in a radius around any point.
+/// Every row of the hexagon is a consecutive range of the row of the map, so the sum takes O(radius) using prefix sums
+/// of the map rows.
+/// Values must fit into 8 bit. The prefix sums are stored modulo 2^16 only: The difference of 2 of them is still exact
+/// as the sum of up to 255 values fits into 16 bit.
+/// Changed rows are stored as plain values and turned into prefix sums when they are summed up the next time,
+/// so setting many values (e.g. all at the start) takes O(1) per value and O(width) per changed row.
+class RadiusSumMap : public MapBase
+{
+public:
+    /// Maximum radius for which getSum can be used
+    static constexpr unsigned maxRadius = 127;
+
+    void Resize(const MapExtent& newSize) override;
+
+    int operator[](MapPoint pt) const;
+    void set(MapPoint pt, int value);
+
+    /// Return the sum of the values of all points with a distance of at most radius to pt (including pt).
+    /// Equal to summing over GetPointsInRadiusWithCenter, i.e. points are counted multiple times if the radius wraps
+    /// around the map
+    int getSum(MapPoint pt, unsigned radius) const;
+
+    /// Return the number of bytes used by the map
+    size_t getMemoryUsage() const;
+
+private:
+    /// Return the sum of count values in the row starting at startPt and wrapping around the map border
+    int getRowSum(MapPoint startPt, unsigned count) const;
+    /// Turn the values of the row into prefix sums if they were changed
+    void updatePrefixSums(unsigned y) const;
+
+    /// For each row either the plain values or the sum of the values up to and including each point
+    mutable std::vector<uint16_t> rowValues_;
+    /// True for each row which contains plain values
+    mutable std::vector<bool> isRowChanged_;
+};
@@ -0,0 +1,474 @@
+// Copyright (C) 2005 - 2021 Settlers Freaks (sf-team at siedler25.org)
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "GlobalGameSettings.h"
+#include "RTTR_Version.h"
+#include "RttrConfig.h"
+#include "files.h"
+#include "helpers/chronoIO.h"
+#include "helpers/format.hpp"
+#include "network/CreateServerInfo.h"
+#include "network/GameServer.h"
+#include "addons/const_addons.h"
+#include "gameTypes/GameSettingTypes.h"
+#include "s25util/LocaleHelper.h"
+#include "s25util/Log.h"
+#include "s25util/Socket.h"
+#include "s25util/System.h"
+#include "s25util/strAlgos.h"
+#include <boost/filesystem.hpp>
+#include <boost/nowide/args.hpp>
+#include <boost/nowide/fstream.hpp>
+#include <boost/nowide/iostream.hpp>
+#include <boost/optional.hpp>
+#include <boost/program_options.hpp>
+#include <chrono>
+#include <csignal>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <vector>
+
+namespace bfs = boost::filesystem;
+namespace bnw = boost::nowide;
+namespace po = boost::program_options;
+
+namespace {
+
+volatile std::sig_atomic_t stopRequested = 0;
+
+void StopSignalHandler(int /*sig*/)
+{
+    stopRequested = 1;
+}
+
+std::string GetProgramDescription()
+{
+    std::stringstream s;
+    s << rttr::version::GetTitle() << " dedicated server v" << rttr::version::GetVersion() << "-"
+      << rttr::version::GetRevision() << "\n"
+      << "Compiled with " << System::getCompilerName() << " for " << System::getOSName();
+    return s.str();
+}
+
+/// Settings for a single hosted game
+struct GameConfig
+{
+    std::string name;
+    bfs::path mapPath;
+    MapType mapType = MapType::OldMap;
+    ServerType type = ServerType::Direct;
+    uint16_t port = 3665;
+    std::string password, hostPassword;
+    bool ipv6 = false;
+    bool useUpnp = false;
+    /// Game settings to use instead of the defaults (only for new games)
+    boost::optional<GlobalGameSettings> ggs;
+    /// Serve the game to spectators if set
+    boost::optional<SpectatorRelay::Config> spectatorConfig;
+    std::chrono::seconds spectatorSnapshotInterval{0};
+};
+
+po::options_description GetGameOptions()
+{
+    po::options_description desc("Game options");
+    // clang-format off
+    desc.add_options()
+        ("map,m", po::value<std::string>(), "Map or savegame to host")
+        ("name,n", po::value<std::string>()->default_value("Dedicated Server"), "Name of the game")
+        ("port,p", po::value<uint16_t>()->default_value(3665), "Port to listen on")
+        ("type", po::value<std::string>()->default_value("direct"), "Server type: direct or lan")
+        ("password", po::value<std::string>()->default_value(""), "Password required to join")
+        ("host-password", po::value<std::string>(),
+            "Password with which a player joins as the host who can change the settings and start the game")
+        ("ipv6", po::bool_switch(), "Use IPv6 instead of IPv4")
+        ("upnp", po::bool_switch(), "Forward the port via UPnP")
+        ("speed", po::value<unsigned>(), "Game speed from 0 (very slow) to 4 (very fast)")
+        ("addon", po::value<std::vector<std::string>>()->composing(),
+            "Addon setting as NAME=VALUE, e.g. INEXHAUSTIBLE_MINES=1. Can be given multiple times")
+        ("spectator-port", po::value<uint16_t>()->default_value(0),
+            "Port on which spectators can connect. 0 to disable spectating")
+        ("spectator-delay", po::value<unsigned>()->default_value(0),
+            "Seconds by which the game is delayed for spectators")
+        ("spectator-snapshot-interval", po::value<unsigned>()->default_value(60),
+            "Seconds between snapshots from which spectators joining a running game start watching. "
+            "0 to let them join only at the start")
+        ("max-spectators", po::value<unsigned>()->default_value(500), "Maximum number of spectators")
+        ;
+    // clang-format on
+    return desc;
+}
+
+boost::optional<AddonId> ParseAddonId(const std::string& name)
+{
+    for(const AddonId id : rttrEnum::values<AddonId>)
+    {
+        if(rttrEnum::toString(id) == name)
+            return id;
+    }
+    return boost::none;
+}
+
+/// Get the spectator settings from the parsed options or none if spectating is disabled
+boost::optional<SpectatorRelay::Config> GetSpectatorConfig(const po::variables_map& options)
+{
+    const uint16_t port = options["spectator-port"].as<uint16_t>();
+    if(port == 0)
+        return boost::none;
+    SpectatorRelay::Config cfg;
+    cfg.port = port;
+    cfg.ipv6 = options["ipv6"].as<bool>();
+    cfg.delay = std::chrono::seconds(options["spectator-delay"].as<unsigned>());
+    cfg.maxNumSpectators = options["max-spectators"].as<unsigned>();
+    return cfg;
+}
+
+/// Create the config of a game from the parsed options. Throws on invalid values
+GameConfig GetGameConfig(const po::variables_map& options)
+{
+    GameConfig cfg;
+    if(!options.count("map"))
+        throw std::runtime_error("No map given");
+    cfg.mapPath = options["map"].as<std::string>();
+    if(!bfs::is_regular_file(cfg.mapPath))
+        throw std::runtime_error(helpers::format("Map %1% does not exist", cfg.mapPath));
+    const std::string extension = s25util::toLower(cfg.mapPath.extension().string());
+    if(extension == ".sav")
+        cfg.mapType = MapType::Savegame;
+    else if(extension == ".swd" || extension == ".wld")
+        cfg.mapType = MapType::OldMap;
+    else
+        throw std::runtime_error(helpers::format("Unknown map type of %1%", cfg.mapPath));
+
+    cfg.name = options["name"].as<std::string>();
+    cfg.port = options["port"].as<uint16_t>();
+    const std::string type = s25util::toLower(options["type"].as<std::string>());
+    if(type == "direct")
+        cfg.type = ServerType::Direct;
+    else if(type == "lan")
+        cfg.type = ServerType::LAN;
+    else
+        throw std::runtime_error(helpers::format("Invalid server type: %1%", type));
+    cfg.password = options["password"].as<std::string>();
+    if(!options.count("host-password") || options["host-password"].as<std::string>().empty())
+        throw std::runtime_error("A host password is required so a player can configure and start the game");
+    cfg.hostPassword = options["host-password"].as<std::string>();
+    cfg.ipv6 = options["ipv6"].as<bool>();
+    cfg.useUpnp = options["upnp"].as<bool>();
+    cfg.spectatorConfig = GetSpectatorConfig(options);
+    cfg.spectatorSnapshotInterval = std::chrono::seconds(options["spectator-snapshot-interval"].as<unsigned>());
+
+    if(options.count("speed") || options.count("addon"))
+    {
+        if(cfg.mapType == MapType::Savegame)
+            throw std::runtime_error("Game settings cannot be changed for savegames");
+        GlobalGameSettings ggs;
+        if(options.count("speed"))
+        {
+            const unsigned speed = options["speed"].as<unsigned>();
+            if(speed > static_cast<unsigned>(maxEnumValue(GameSpeed{})))
+                throw std::runtime_error(helpers::format("Invalid speed: %1%", speed));
+            ggs.speed = GameSpeed(speed);
+        }
+        if(options.count("addon"))
+        {
+            for(const std::string& addon : options["addon"].as<std::vector<std::string>>())
+            {
+                const auto sepPos = addon.find('=');
+                if(sepPos == std::string::npos)
+                    throw std::runtime_error(helpers::format("Invalid addon setting: %1%", addon));
+                const std::string addonName = s25util::toUpper(addon.substr(0, sepPos));
+                const boost::optional<AddonId> id = ParseAddonId(addonName);
+                if(!id)
+                    throw std::runtime_error(helpers::format("Unknown addon: %1%", addonName));
+                ggs.setSelection(*id, std::stoul(addon.substr(sepPos + 1)));
+            }
+        }
+        cfg.ggs = ggs;
+    }
+    return cfg;
+}
+
+/// A game hosted by this server
+struct HostedGame
+{
+    GameConfig config;
+    GameServer server;
+    explicit HostedGame(GameConfig config) : config(std::move(config)) {}
+
+    bool Start()
+    {
+        const CreateServerInfo csi(config.type, config.port, config.name, config.password, config.ipv6,
+                                   config.useUpnp);
+        if(!server.Start(csi, config.mapPath, config.mapType, config.hostPassword))
+            return false;
+        if(config.ggs)
+            server.SetGGS(*config.ggs);
+        if(config.spectatorConfig
+           && !server.StartSpectatorRelay(*config.spectatorConfig, config.spectatorSnapshotInterval))
+            return false;
+        LOG.write("[%1%] Hosting %2% on port %3%\n") % config.name % config.mapPath % config.port;
+        return true;
+    }
+
+    void LogMetrics() const
+    {
+        const GameServer::Metrics& metrics = server.GetMetrics();
+        using std::chrono::duration_cast;
+        using std::chrono::milliseconds;
+        std::stringstream laggingPlayers;
+        for(unsigned i = 0; i < metrics.numLaggedNWFs.size(); i++)
+        {
+            if(metrics.numLaggedNWFs[i] > 0)
+                laggingPlayers << " " << i << ":" << metrics.numLaggedNWFs[i];
+        }
+        const milliseconds avgWaitTime =
+          duration_cast<milliseconds>(metrics.numDelayedNWFs ? metrics.nwfWaitTime / metrics.numDelayedNWFs :
+                                                               GameServer::SteadyClock::duration::zero());
+        LOG.write("[%1%] Players: %2%, GF: %3%, NWFs: %4% (%5% delayed, avg wait %6%, max wait %7%), "
+                  "lagging NWFs per player:%8%, sent: %9% msgs / %10% KiB\n")
+          % config.name % server.GetNumFilledSlots() % server.GetCurrentGF() % metrics.numNWFs % metrics.numDelayedNWFs
+          % helpers::withUnit(avgWaitTime) % helpers::withUnit(duration_cast<milliseconds>(metrics.maxNWFWaitTime))
+          % (laggingPlayers.str().empty() ? std::string(" none") : laggingPlayers.str()) % metrics.numMsgsSent
+          % (metrics.numBytesSent / 1024u);
+    }
+};
+
+bool InitLog()
+{
+    LOG.setLogFilepath(RTTRCONFIG.ExpandPath(s25::folders::logs));
+    try
+    {
+        bfs::create_directories(RTTRCONFIG.ExpandPath(s25::folders::logs));
+        LOG.open();
+        LOG.write("%1%\n\n", LogTarget::File) % GetProgramDescription();
+    } catch(const std::exception& e)
+    {
+        LOG.write("Error initializing log: %1%\n", LogTarget::Stderr) % e.what();
+        return false;
+    }
+    return true;
+}
+
+int RunServer(std::vector<GameConfig> gameConfigs, unsigned tickRate, std::chrono::seconds metricsInterval)
+{
+    std::vector<std::unique_ptr<HostedGame>> games;
+    for(GameConfig& cfg : gameConfigs)
+    {
+        games.push_back(std::make_unique<HostedGame>(std::move(cfg)));
+        if(!games.back()->Start())
+        {
+            LOG.write("Failed to start game %1%\n", LogTarget::Stderr) % games.back()->config.name;
+            return 1;
+        }
+    }
+
+    std::vector<const GameServer*> servers;
+    for(const auto& game : games)
+        servers.push_back(&game->server);
+
+    using Clock = GameServer::SteadyClock;
+    const auto maxWaitTime = std::chrono::duration_cast<Clock::duration>(std::chrono::seconds(1)) / tickRate;
+    auto nextMetricsTime = Clock::now() + metricsInterval;
+    while(!stopRequested)
+    {
+        // Sleep till there is something to do for any game
+        GameServer::WaitForEvents(servers, maxWaitTime);
+        bool anyRunning = false;
+        for(const auto& game : games)
+        {
+            game->server.Run();
+            anyRunning |= game->server.IsRunning();
+        }
+        if(!anyRunning)
+        {
+            LOG.write("All games have finished\n");
+            break;
+        }
+
+        const auto now = Clock::now();
+        if(metricsInterval.count() > 0 && now >= nextMetricsTime)
+        {
+            for(const auto& game : games)
+            {
+                if(game->server.IsInGame())
+                    game->LogMetrics();
+            }
+            nextMetricsTime = now + metricsInterval;
+        }
+    }
+
+    for(const auto& game : games)
+    {
+        if(game->server.IsInGame())
+            game->LogMetrics();
+        game->server.Stop();
+    }
+    return 0;
+}
+
+/// Pass the stream received from another relay or server on to more spectators
+int RunRelay(const std::string& upstream, const SpectatorRelay::Config& config, unsigned tickRate)
+{
+    const auto sepPos = upstream.rfind(':');
+    if(sepPos == std::string::npos)
+    {
+        LOG.write("Invalid upstream address %1%. Expected HOST:PORT\n", LogTarget::Stderr) % upstream;
+        return 1;
+    }
+    const int port = std::stoi(upstream.substr(sepPos + 1));
+    if(port <= 0 || port > std::numeric_limits<uint16_t>::max())
+    {
+        LOG.write("Invalid upstream port in %1%\n", LogTarget::Stderr) % upstream;
+        return 1;
+    }
+    SpectatorRelay relay(config);
+    if(!relay.Start() || !relay.ConnectUpstream(upstream.substr(0, sepPos), static_cast<uint16_t>(port)))
+        return 1;
+    LOG.write("Relaying %1% on port %2%\n") % upstream % config.port;
+
+    using Clock = SpectatorRelay::SteadyClock;
+    const auto maxWaitTime = std::chrono::duration_cast<Clock::duration>(std::chrono::seconds(1)) / tickRate;
+    // After the game ended the remaining delayed part is still sent
+    while(!stopRequested && (relay.IsUpstreamConnected() || relay.HasPendingMessages()))
+    {
+        relay.WaitForEvents(maxWaitTime);
+        relay.Run();
+    }
+    LOG.write("Relay finished\n");
+    relay.Stop();
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    bnw::args _(argc, argv);
+
+    po::options_description serverDesc("Server options");
+    // clang-format off
+    serverDesc.add_options()
+        ("help,h", "Show help")
+        ("version", "Show version information and exit")
+        ("config,c", po::value<std::string>(), "Read options from this file")
+        ("game,g", po::value<std::vector<std::string>>()->composing(),
+            "File with the game options of a hosted game. Can be given multiple times to host multiple games. "
+            "If not given, a single game is configured by the game options")
+        ("tick-rate", po::value<unsigned>()->default_value(10),
+            "Minimum number of server updates per second. Updates are also done on network activity and when a game "
+            "frame is due")
+        ("metrics-interval", po::value<unsigned>()->default_value(60),
+            "Seconds between writing the metrics of running games to the log. 0 to disable")
+        ("relay", po::value<std::string>(),
+            "Instead of hosting a game, act as a spectator relay for the game served at HOST:PORT. "
+            "Uses the spectator options")
+        ;
+    // clang-format on
+    const po::options_description gameDesc = GetGameOptions();
+    po::options_description desc;
+    desc.add(serverDesc).add(gameDesc);
+
+    po::variables_map options;
+    try
+    {
+        po::store(po::parse_command_line(argc, argv, desc), options);
+        if(options.count("config"))
+        {
+            bnw::ifstream file(options["config"].as<std::string>());
+            if(!file)
+                throw std::runtime_error("Could not open config file " + options["config"].as<std::string>());
+            po::store(po::parse_config_file(file, desc), options);
+        }
+        po::notify(options);
+        // Catch the generic stdlib exception as hidden visibility messes up boost typeinfo on OSX
+    } catch(const std::exception& e)
+    {
+        bnw::cerr << "Error: " << e.what() << "\n\n";
+        bnw::cerr << desc << "\n";
+        return 1;
+    }
+
+    if(options.count("help"))
+    {
+        bnw::cout << desc << "\n";
+        return 0;
+    }
+    if(options.count("version"))
+    {
+        bnw::cout << GetProgramDescription() << std::endl;
+        return 0;
+    }
+    const unsigned tickRate = options["tick-rate"].as<unsigned>();
+    if(tickRate == 0u)
+    {
+        bnw::cerr << "Error: The tick rate must be positive\n";
+        return 1;
+    }
+
+    std::vector<GameConfig> gameConfigs;
+    boost::optional<SpectatorRelay::Config> relayConfig;
+    try
+    {
+        if(options.count("relay"))
+        {
+            relayConfig = GetSpectatorConfig(options);
+            if(!relayConfig)
+                throw std::runtime_error("A spectator port is required for a relay");
+        } else if(options.count("game"))
+        {
+            for(const std::string& gameFilePath : options["game"].as<std::vector<std::string>>())
+            {
+                bnw::ifstream file(gameFilePath);
+                if(!file)
+                    throw std::runtime_error("Could not open game file " + gameFilePath);
+                po::variables_map gameOptions;
+                po::store(po::parse_config_file(file, gameDesc), gameOptions);
+                po::notify(gameOptions);
+                gameConfigs.push_back(GetGameConfig(gameOptions));
+            }
+        } else
+            gameConfigs.push_back(GetGameConfig(options));
+    } catch(const std::exception& e)
+    {
+        bnw::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+
+    LOG.write("%1%\n\n", LogTarget::Stdout) % GetProgramDescription();
+    if(!LocaleHelper::init())
+        return 1;
+    if(!RTTRCONFIG.Init())
+        return 1;
+    if(!InitLog())
+        return 1;
+    if(!Socket::Initialize())
+    {
+        LOG.write("Could not init sockets!\n", LogTarget::Stderr);
+        return 1;
+    }
+    std::signal(SIGINT, StopSignalHandler);
+    std::signal(SIGTERM, StopSignalHandler);
+#ifndef _WIN32
+    std::signal(SIGPIPE, SIG_IGN);
+#endif
+
+    int result;
+    try
+    {
+        if(relayConfig)
+            result = RunRelay(options["relay"].as<std::string>(), *relayConfig, tickRate);
+        else
+        {
+            result = RunServer(std::move(gameConfigs), tickRate,
+                               std::chrono::seconds(options["metrics-interval"].as<unsigned>()));
+        }
+    } catch(const std::exception& e)
+    {
+        LOG.write("An exception occurred: %1%\n", LogTarget::FileAndStderr) % e.what();
+        result = 1;
+    }
+    Socket::Shutdown();
+    return result;
+}
@@ -8,6 +8,7 @@
 #include "helpers/MaxEnumValue.h"
 #include "helpers/serializeContainers.h"
 #include "helpers/serializePoint.h"
+#include "helpers/serializeVarInt.h"
 #include <rttr/test/random.hpp>
 #include <s25util/Serializer.h>
 #include <boost/test/unit_test.hpp>
@@ -158,4 +159,27 @@ BOOST_AUTO_TEST_CASE(SerializePoints)
     BOOST_TEST_REQUIRE(helpers::popPoint<decltype(pt4)>(ser) == pt4);
 }
 
+BOOST_AUTO_TEST_CASE(SerializeVarUInts)
+{
+    const std::vector<std::pair<uint32_t, unsigned>> valuesAndSizes = {
+      {0u, 1u}, {1u, 1u}, {127u, 1u}, {128u, 2u}, {16383u, 2u}, {16384u, 3u}, {0xFFFFFFFFu, 5u}};
+    for(const auto& valueAndSize : valuesAndSizes)
+    {
+        Serializer ser;
+        helpers::pushVarUInt(ser, valueAndSize.first);
+        BOOST_TEST(ser.GetLength() == valueAndSize.second);
+        BOOST_TEST(helpers::popVarUInt(ser) == valueAndSize.first);
+    }
+    const auto value = rttr::test::randomValue<uint32_t>();
+    Serializer ser;
+    helpers::pushVarUInt(ser, value);
+    BOOST_TEST(helpers::popVarUInt(ser) == value);
+
+    // Continuation flag on all bytes is invalid
+    Serializer invalidSer;
+    for(unsigned i = 0; i < 5; i++)
+        invalidSer.PushUnsignedChar(0xFF);
+    BOOST_CHECK_THROW(helpers::popVarUInt(invalidSer), std::range_error);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,142 @@
+// Copyright (C) 2005 - 2021 Settlers Freaks (sf-team at siedler25.org)
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "FileChecksum.h"
+#include "network/MapCache.h"
+#include "rttr/test/TmpFolder.hpp"
+#include <boost/filesystem.hpp>
+#include <boost/nowide/fstream.hpp>
+#include <boost/test/unit_test.hpp>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace bfs = boost::filesystem;
+namespace bnw = boost::nowide;
+
+namespace {
+void writeFile(const bfs::path& filePath, const std::string& content)
+{
+    bnw::ofstream file(filePath, std::ios::binary);
+    file << content;
+}
+
+std::string readFile(const bfs::path& filePath)
+{
+    bnw::ifstream file(filePath, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(MapCacheTests)
+
+BOOST_AUTO_TEST_CASE(CachedMapsAreFoundByHash)
+{
+    rttr::test::TmpFolder tmpFolder;
+    MapCache cache(tmpFolder.get() / "cache");
+    const bfs::path mapPath = tmpFolder.get() / "map.swd";
+    const bfs::path restoredPath = tmpFolder.get() / "otherName.swd";
+    const std::string content = "Map content";
+    const uint32_t hash = CalcCRC32OfBuffer(content);
+    BOOST_TEST(!cache.restore(hash, content.size(), restoredPath));
+
+    writeFile(mapPath, content);
+    cache.add(mapPath);
+    // Original file might be overwritten later
+    writeFile(mapPath, "Other map");
+    BOOST_TEST(!cache.restore(hash + 1, content.size(), restoredPath));
+    BOOST_TEST(!cache.restore(hash, content.size() + 1, restoredPath));
+    // Unknown content is never cached
+    BOOST_TEST(!cache.restore(0, content.size(), restoredPath));
+    BOOST_TEST_REQUIRE(cache.restore(hash, content.size(), restoredPath));
+    BOOST_TEST(readFile(restoredPath) == content);
+    // Existing files are replaced
+    BOOST_TEST_REQUIRE(cache.restore(hash, content.size(), mapPath));
+    BOOST_TEST(readFile(mapPath) == content);
+}
+
+BOOST_AUTO_TEST_CASE(ReorderedContentIsNotConfused)
+{
+    rttr::test::TmpFolder tmpFolder;
+    MapCache cache(tmpFolder.get() / "cache");
+    const bfs::path mapPath = tmpFolder.get() / "map.swd";
+    const bfs::path restoredPath = tmpFolder.get() / "restored.swd";
+    // Same bytes and size -> Same additive checksum but different content
+    const std::string content = "Map AB";
+    const std::string reorderedContent = "Map BA";
+    BOOST_TEST_REQUIRE(CalcChecksumOfBuffer(content) == CalcChecksumOfBuffer(reorderedContent));
+    BOOST_TEST_REQUIRE(CalcCRC32OfBuffer(content) != CalcCRC32OfBuffer(reorderedContent));
+
+    writeFile(mapPath, content);
+    cache.add(mapPath);
+    BOOST_TEST(!cache.restore(CalcCRC32OfBuffer(reorderedContent), reorderedContent.size(), restoredPath));
+    writeFile(mapPath, reorderedContent);
+    cache.add(mapPath);
+    BOOST_TEST_REQUIRE(cache.restore(CalcCRC32OfBuffer(content), content.size(), restoredPath));
+    BOOST_TEST(readFile(restoredPath) == content);
+    BOOST_TEST_REQUIRE(cache.restore(CalcCRC32OfBuffer(reorderedContent), reorderedContent.size(), restoredPath));
+    BOOST_TEST(readFile(restoredPath) == reorderedContent);
+}
+
+BOOST_AUTO_TEST_CASE(ModifiedCacheFilesAreNotUsed)
+{
+    rttr::test::TmpFolder tmpFolder;
+    const bfs::path cacheDir = tmpFolder.get() / "cache";
+    MapCache cache(cacheDir);
+    const bfs::path mapPath = tmpFolder.get() / "map.swd";
+    const std::string content = "Map content";
+    writeFile(mapPath, content);
+    cache.add(mapPath);
+    for(const auto& entry : bfs::directory_iterator(cacheDir))
+        writeFile(entry.path(), "Map CONTENT");
+    BOOST_TEST(!cache.restore(CalcCRC32OfBuffer(content), content.size(), tmpFolder.get() / "restored.swd"));
+}
+
+BOOST_AUTO_TEST_CASE(PartialTransfersCanBeResumed)
+{
+    rttr::test::TmpFolder tmpFolder;
+    MapCache cache(tmpFolder.get() / "cache");
+    const std::vector<char> data = {'a', 'b', 'c', 'd', 'e', 'f'};
+    std::vector<char> loadedData(data.size());
+    BOOST_TEST(cache.loadPartial(42, loadedData) == 0u);
+
+    // Nothing or everything received is not stored
+    cache.storePartial(42, data, 0);
+    cache.storePartial(42, data, data.size());
+    BOOST_TEST(cache.loadPartial(42, loadedData) == 0u);
+
+    cache.storePartial(42, data, 4);
+    BOOST_TEST_REQUIRE(cache.loadPartial(42, loadedData) == 4u);
+    BOOST_TEST(std::vector<char>(loadedData.begin(), loadedData.begin() + 4)
+               == std::vector<char>(data.begin(), data.begin() + 4));
+    // Different checksum or size -> Different data
+    BOOST_TEST(cache.loadPartial(43, loadedData) == 0u);
+    std::vector<char> largerData(data.size() + 1);
+    BOOST_TEST(cache.loadPartial(42, largerData) == 0u);
+
+    cache.removePartial(42, data.size());
+    BOOST_TEST(cache.loadPartial(42, loadedData) == 0u);
+}
+
+BOOST_AUTO_TEST_CASE(CacheSizeIsLimited)
+{
+    rttr::test::TmpFolder tmpFolder;
+    MapCache cache(tmpFolder.get() / "cache", 2);
+    const bfs::path mapPath = tmpFolder.get() / "map.swd";
+    for(unsigned i = 1; i <= 3; i++)
+    {
+        writeFile(mapPath, "Map " + std::to_string(i));
+        cache.add(mapPath);
+    }
+    unsigned numCached = 0;
+    for(unsigned i = 1; i <= 3; i++)
+    {
+        const std::string content = "Map " + std::to_string(i);
+        if(cache.restore(CalcCRC32OfBuffer(content), content.size(), tmpFolder.get() / "restored.swd"))
+            ++numCached;
+    }
+    BOOST_TEST(numCached == 2u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,84 @@
+// Copyright (C) 2005 - 2021 Settlers Freaks (sf-team at siedler25.org)
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "Rect.h"
+#include "ogl/glArchivItem_Bitmap_Direct.h"
+#include "uiHelper/uiHelpers.hpp"
+#include <libsiedler2/PixelBufferBGRA.h>
+#include <rttr/test/stubFunction.hpp>
+#include <s25util/warningSuppression.h>
+#include <glad/glad.h>
+#include <boost/test/unit_test.hpp>
+#include <vector>
+
+static bool operator==(const Rect& lhs, const Rect& rhs)
+{
+    return lhs.getOrigin() == rhs.getOrigin() && lhs.getEndPt() == rhs.getEndPt();
+}
+
+// LCOV_EXCL_START
+static std::ostream& operator<<(std::ostream& os, const Rect& rect)
+{
+    return os << "(" << rect.left << "," << rect.top << ")-(" << rect.right << "," << rect.bottom << ")";
+}
+// LCOV_EXCL_STOP
+
+namespace rttrOglMockDirect {
+RTTR_IGNORE_DIAGNOSTIC("-Wmissing-declarations")
+
+std::vector<Rect> uploadedAreas;
+
+void APIENTRY glTexSubImage2D(GLenum, GLint, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum,
+                              GLenum, const void*)
+{
+    uploadedAreas.push_back(Rect(xoffset, yoffset, width, height));
+}
+
+RTTR_POP_DIAGNOSTIC
+} // namespace rttrOglMockDirect
+
+BOOST_FIXTURE_TEST_CASE(BitmapDirectUploadsOnlyDirtyTiles, uiHelper::Fixture)
+{
+    constexpr unsigned tileSize = glArchivItem_Bitmap_Direct::UPDATE_TILE_SIZE;
+    // Size not a multiple of the tile size to check clipping
+    const Extent size(tileSize * 4 + 5, tileSize * 3 + 7);
+    glArchivItem_Bitmap_Direct bmp;
+    libsiedler2::PixelBufferBGRA buffer(size.x, size.y);
+    bmp.create(buffer);
+    BOOST_TEST_REQUIRE(bmp.GetTexture() != 0u);
+
+    RTTR_STUB_FUNCTION(glTexSubImage2D, rttrOglMockDirect::glTexSubImage2D);
+    auto& uploadedAreas = rttrOglMockDirect::uploadedAreas;
+    const libsiedler2::ColorBGRA clr(0xFF112233);
+
+    // No change -> no upload
+    bmp.beginUpdate();
+    bmp.endUpdate();
+    BOOST_TEST(uploadedAreas.empty());
+
+    // Changes in opposite corners upload 2 tiles instead of the whole bounding box
+    bmp.beginUpdate();
+    bmp.updatePixel(DrawPoint(1, 2), clr);
+    bmp.updatePixel(DrawPoint(size.x - 1, size.y - 1), clr);
+    bmp.endUpdate();
+    BOOST_TEST_REQUIRE(uploadedAreas.size() == 2u);
+    BOOST_TEST(uploadedAreas[0] == Rect(0, 0, tileSize, tileSize));
+    BOOST_TEST(uploadedAreas[1] == Rect(tileSize * 4, tileSize * 3, 5, 7));
+    uploadedAreas.clear();
+
+    // Adjacent tiles in a row are uploaded together
+    bmp.beginUpdate();
+    bmp.updatePixel(DrawPoint(tileSize + 1, tileSize), clr);
+    bmp.updatePixel(DrawPoint(tileSize * 2 + 3, tileSize + 1), clr);
+    bmp.updatePixel(DrawPoint(tileSize * 3 + 3, tileSize + 1), clr);
+    bmp.endUpdate();
+    BOOST_TEST_REQUIRE(uploadedAreas.size() == 1u);
+    BOOST_TEST(uploadedAreas[0] == Rect(tileSize, tileSize, tileSize * 3, tileSize));
+    uploadedAreas.clear();
+
+    // Dirty state is reset after an update
+    bmp.beginUpdate();
+    bmp.endUpdate();
+    BOOST_TEST(uploadedAreas.empty());
+}
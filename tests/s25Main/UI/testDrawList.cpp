@@ -0,0 +1,48 @@
+// Copyright (C) 2005 - 2021 Settlers Freaks (sf-team at siedler25.org)
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "ogl/DrawList.h"
+#include "s25util/colors.h"
+#include <boost/test/unit_test.hpp>
+
+BOOST_AUTO_TEST_SUITE(DrawListSuite)
+
+BOOST_AUTO_TEST_CASE(RecordsPrimitives)
+{
+    DrawList list;
+    BOOST_TEST(list.empty());
+
+    list.addRect(Rect(DrawPoint(1, 2), Extent(3, 4)), MakeColor(255, 10, 20, 30));
+    BOOST_TEST(!list.empty());
+    BOOST_TEST_REQUIRE(list.getRectVertices().size() == 4u);
+    BOOST_TEST(list.getRectColors().size() == 4u);
+    BOOST_TEST(list.getRectVertices()[0] == DrawList::Vertex(1, 2));
+    BOOST_TEST(list.getRectVertices()[2] == DrawList::Vertex(4, 6));
+    const DrawList::Color expectedColor = {{10, 20, 30, 255}};
+    BOOST_TEST((list.getRectColors()[3] == expectedColor));
+
+    // Lines with the same width end up in the same batch
+    list.addLine(DrawPoint(0, 0), DrawPoint(5, 5), 1, COLOR_RED);
+    list.addLine(DrawPoint(1, 0), DrawPoint(5, 6), 2, COLOR_RED);
+    list.addLine(DrawPoint(2, 0), DrawPoint(5, 7), 1, COLOR_RED);
+    BOOST_TEST_REQUIRE(list.getNumLineBatches() == 2u);
+    BOOST_TEST(list.getLineBatches()[0].width == 1u);
+    BOOST_TEST(list.getLineBatches()[0].vertices.size() == 4u);
+    BOOST_TEST(list.getLineBatches()[0].colors.size() == 4u);
+    BOOST_TEST(list.getLineBatches()[1].width == 2u);
+    BOOST_TEST(list.getLineBatches()[1].vertices.size() == 2u);
+
+    // Clearing keeps the batches for reuse but they are not counted anymore
+    list.clear();
+    BOOST_TEST(list.empty());
+    BOOST_TEST(list.getRectVertices().empty());
+    BOOST_TEST(list.getNumLineBatches() == 0u);
+    BOOST_TEST(list.getLineBatches().size() == 2u);
+    list.addLine(DrawPoint(0, 0), DrawPoint(5, 5), 3, COLOR_RED);
+    BOOST_TEST_REQUIRE(list.getNumLineBatches() == 1u);
+    BOOST_TEST(list.getLineBatches()[0].width == 3u);
+    BOOST_TEST(list.getLineBatches()[0].vertices.size() == 2u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
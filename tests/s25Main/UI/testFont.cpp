@@ -6,6 +6,7 @@
 #include "ogl/glFont.h"
 #include "uiHelper/uiHelpers.hpp"
 #include <boost/test/unit_test.hpp>
+#include <string>
 
 BOOST_AUTO_TEST_SUITE(Font)
 
@@ -36,4 +37,30 @@ BOOST_FIXTURE_TEST_CASE(WrapInfoWithTrailingNewlines, uiHelper::Fixture)
     BOOST_TEST(wrapInfo.CreateSingleStrings(input) == output, boost::test_tools::per_element{});
 }
 
+BOOST_FIXTURE_TEST_CASE(TextLayoutCache, uiHelper::Fixture)
+{
+    LOADER.initResourceFolders();
+    BOOST_TEST(LOADER.LoadFonts());
+    // Fonts are freshly loaded so the cache is empty
+    const auto& font = *NormalFont;
+    BOOST_TEST(font.getNumCachedTexts() == 0u);
+    font.Draw(DrawPoint(10, 10), "Hello", FontStyle{});
+    BOOST_TEST(font.getNumCachedTexts() == 1u);
+    // Position, style and color don't matter
+    font.Draw(DrawPoint(20, 50), "Hello", FontStyle::CENTER | FontStyle::NO_OUTLINE, COLOR_RED);
+    BOOST_TEST(font.getNumCachedTexts() == 1u);
+    // Max width does
+    font.Draw(DrawPoint(10, 10), "Hello", FontStyle{}, COLOR_WHITE, 10);
+    BOOST_TEST(font.getNumCachedTexts() == 2u);
+    font.Draw(DrawPoint(10, 10), "World", FontStyle{});
+    BOOST_TEST(font.getNumCachedTexts() == 3u);
+    // Empty texts are not cached
+    font.Draw(DrawPoint(10, 10), "", FontStyle{});
+    BOOST_TEST(font.getNumCachedTexts() == 3u);
+    // Cache is limited
+    for(unsigned i = 0; i < glFont::MAX_CACHED_TEXTS + 10; i++)
+        font.Draw(DrawPoint(10, 10), std::to_string(i), FontStyle{});
+    BOOST_TEST(font.getNumCachedTexts() == glFont::MAX_CACHED_TEXTS);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
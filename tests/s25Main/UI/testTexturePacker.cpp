@@ -3,14 +3,17 @@
 // SPDX-License-Identifier: GPL-2.0-or-later
 
 #include "CollisionDetection.h"
+#include "ogl/SkylinePacker.h"
 #include "ogl/glSmartBitmap.h"
 #include "ogl/glTexturePacker.h"
 #include "uiHelper/uiHelpers.hpp"
 #include "libsiedler2/ArchivItem_Bitmap_Raw.h"
 #include "libsiedler2/PixelBufferBGRA.h"
+#include <boost/optional.hpp>
 #include <boost/test/unit_test.hpp>
 #include <Rect.h>
 #include <array>
+#include <vector>
 
 BOOST_FIXTURE_TEST_SUITE(TexturePacker, uiHelper::Fixture)
 
@@ -37,8 +40,8 @@ BOOST_AUTO_TEST_CASE(SizeAndPosCorrect)
     }
 
     // Sizes must be correct
-    BOOST_TEST_REQUIRE(packer.getTextures().size() == 1u);
-    const Point<float> size(packer.getTextures()[0].getSize());
+    BOOST_TEST_REQUIRE(packer.getNumPages() == 1u);
+    const Point<float> size(packer.getTexture(0).getSize());
     for(const auto& bmp : smartBmps)
     {
         const auto curTexSize = bmp.texCoords[2] - bmp.texCoords[0];
@@ -61,4 +64,114 @@ BOOST_AUTO_TEST_CASE(SizeAndPosCorrect)
     }
 }
 
+BOOST_AUTO_TEST_CASE(SkylineFillsArea)
+{
+    SkylinePacker packer(Extent(16, 8));
+    std::vector<Rect> rects;
+    // Mixed sizes exactly filling the area
+    for(const Extent& size : {Extent(8, 4), Extent(8, 4), Extent(4, 4), Extent(4, 4), Extent(4, 2), Extent(4, 2),
+                              Extent(4, 2), Extent(4, 2)})
+    {
+        const boost::optional<Extent> pos = packer.insert(size);
+        BOOST_TEST_REQUIRE(pos.is_initialized());
+        const Rect rect(Position(*pos), size);
+        BOOST_TEST(rect.right <= 16);
+        BOOST_TEST(rect.bottom <= 8);
+        for(const Rect& otherRect : rects)
+            BOOST_TEST(!DoRectsIntersect(rect, otherRect));
+        rects.push_back(rect);
+    }
+    BOOST_TEST(packer.getUsedArea() == 16u * 8u);
+    BOOST_TEST(!packer.insert(Extent(1, 1)));
+    // Empty items always fit
+    BOOST_TEST(packer.insert(Extent(0, 5)).is_initialized());
+
+    packer.clear();
+    BOOST_TEST(packer.getUsedArea() == 0u);
+    BOOST_TEST(!packer.insert(Extent(17, 1)));
+    BOOST_TEST(!packer.insert(Extent(1, 9)));
+    BOOST_TEST(packer.insert(Extent(16, 8)).is_initialized());
+}
+
+BOOST_AUTO_TEST_CASE(IncrementalInsert)
+{
+    std::array<libsiedler2::ArchivItem_Bitmap_Raw, 3> bmps;
+    std::array<glSmartBitmap, 3> smartBmps;
+    for(unsigned i = 0; i < bmps.size(); ++i)
+    {
+        libsiedler2::PixelBufferBGRA buffer(5 + i, 11 + i * 3, libsiedler2::ColorBGRA(0xFFFFFFFF));
+        bmps[i].create(buffer);
+        smartBmps[i].add(&bmps[i]);
+    }
+    glTexturePacker packer;
+    BOOST_TEST(packer.getOccupancy() == 0.f);
+    packer.add(smartBmps[0]);
+    BOOST_TEST_REQUIRE(packer.pack());
+    BOOST_TEST_REQUIRE(packer.getNumPages() == 1u);
+    const float initialOccupancy = packer.getOccupancy();
+    BOOST_TEST(initialOccupancy > 0.f);
+
+    // The first page is full -> A new page is created which is used for later bitmaps too
+    BOOST_TEST_REQUIRE(packer.insert(smartBmps[1]));
+    BOOST_TEST_REQUIRE(packer.getNumPages() == 2u);
+    // It is sized to need instead of the maximum
+    BOOST_TEST(packer.getTexture(1).getSize().x <= glTexturePacker::MIN_INSERT_PAGE_SIZE);
+    BOOST_TEST(packer.getTexture(1).getSize().y <= glTexturePacker::MIN_INSERT_PAGE_SIZE);
+    packer.add(smartBmps[2]);
+    BOOST_TEST_REQUIRE(packer.pack());
+    BOOST_TEST(packer.getNumPages() == 2u);
+    BOOST_TEST(packer.getNumBitmaps() == 3u);
+    BOOST_TEST(smartBmps[0].getTexture() == packer.getTexture(0).get());
+    BOOST_TEST(smartBmps[1].getTexture() == packer.getTexture(1).get());
+    BOOST_TEST(smartBmps[2].getTexture() == packer.getTexture(1).get());
+    BOOST_TEST(packer.getOccupancy() < initialOccupancy);
+
+    // Empty bitmaps are not added
+    glSmartBitmap emptyBmp;
+    BOOST_TEST(!packer.insert(emptyBmp));
+    BOOST_TEST(!packer.insert(libsiedler2::PixelBufferBGRA(0, 5)));
+}
+
+BOOST_AUTO_TEST_CASE(ReuseReleasedPages)
+{
+    glTexturePacker packer;
+    const libsiedler2::PixelBufferBGRA buffer(100, 100, libsiedler2::ColorBGRA(0xFFFFFFFF));
+    boost::optional<glTexturePacker::Placement> placement1 = packer.insert(buffer);
+    BOOST_TEST_REQUIRE(placement1.is_initialized());
+    BOOST_TEST_REQUIRE(packer.getNumPages() == 1u);
+    const Extent pageSize = packer.getTexture(0).getSize();
+    BOOST_TEST(placement1->texture.get() == &packer.getTexture(0));
+    BOOST_TEST(packer.getNumBitmaps() == 1u);
+
+    // Fill the page
+    std::vector<glTexturePacker::Placement> placements;
+    while(packer.getNumPages() == 1u)
+    {
+        boost::optional<glTexturePacker::Placement> placement = packer.insert(buffer);
+        BOOST_TEST_REQUIRE(placement.is_initialized());
+        placements.push_back(*placement);
+    }
+    // The next page is bigger
+    BOOST_TEST(prodOfComponents(packer.getTexture(1).getSize()) > prodOfComponents(pageSize));
+    BOOST_TEST(packer.getNumBitmaps() == placements.size() + 1u);
+    placements.pop_back();
+    BOOST_TEST(packer.getNumBitmaps() == placements.size() + 1u);
+
+    // The first page is still used by the first bitmap, the second one is empty -> Use that
+    placements.clear();
+    boost::optional<glTexturePacker::Placement> placement2 = packer.insert(buffer);
+    BOOST_TEST_REQUIRE(placement2.is_initialized());
+    BOOST_TEST(placement2->texture.get() != &packer.getTexture(0));
+    BOOST_TEST(packer.getNumBitmaps() == 2u);
+
+    // All bitmaps of the first page are released -> Its space is used again
+    placement1.reset();
+    const boost::optional<glTexturePacker::Placement> placement3 = packer.insert(buffer);
+    BOOST_TEST_REQUIRE(placement3.is_initialized());
+    BOOST_TEST(placement3->texture.get() == &packer.getTexture(0));
+    BOOST_TEST(placement3->pos == Extent(0, 0));
+    BOOST_TEST(packer.getNumPages() == 2u);
+    BOOST_TEST(packer.getNumBitmaps() == 2u);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -5,6 +5,7 @@
 #define BOOST_TEST_MODULE RTTR_AutoplayTest
 #include "EventManager.h"
 #include "Game.h"
+#include "GameContext.h"
 #include "GamePlayer.h"
 #include "Replay.h"
 #include "Timer.h"
@@ -20,6 +21,7 @@
 #include "s25util/tmpFile.h"
 #include <rttr/test/Fixture.hpp>
 #include <boost/test/unit_test.hpp>
+#include <memory>
 
 #if RTTR_HAS_VLD
 #    include <vld.h>
@@ -31,43 +33,51 @@ struct Fixture : rttr::test::Fixture
 };
 BOOST_GLOBAL_FIXTURE(Fixture);
 
-static void playReplay(const boost::filesystem::path& replayPath)
+namespace {
+/// Plays a replay GF by GF and checks the recorded checksums
+class ReplayPlayer
 {
-    Replay replay;
-    BOOST_TEST_REQUIRE(replay.LoadHeader(replayPath));
-    MapInfo mapInfo;
-    BOOST_TEST_REQUIRE(replay.LoadGameData(mapInfo));
-    BOOST_TEST_REQUIRE(!mapInfo.savegame); // Must be from start
-    TmpFile mapfile;
-    mapfile.close();
-    BOOST_TEST_REQUIRE(mapInfo.mapData.DecompressToFile(mapfile.filePath));
-
-    std::vector<PlayerInfo> players;
-    for(unsigned i = 0; i < replay.GetNumPlayers(); i++)
-        players.emplace_back(replay.GetPlayer(i));
-    Game game(replay.ggs, /*startGF*/ 0, players);
-    RANDOM.Init(replay.random_init);
-    GameWorld& gameWorld = game.world_;
-
-    for(unsigned i = 0; i < gameWorld.GetNumPlayers(); ++i)
-        gameWorld.GetPlayer(i).MakeStartPacts();
-
-    MapLoader loader(gameWorld);
-    BOOST_TEST_REQUIRE(loader.Load(mapfile.filePath));
-    gameWorld.SetupResources();
-    gameWorld.InitAfterLoad();
+public:
+    explicit ReplayPlayer(const boost::filesystem::path& replayPath)
+    {
+        BOOST_TEST_REQUIRE(replay.LoadHeader(replayPath));
+        MapInfo mapInfo;
+        BOOST_TEST_REQUIRE(replay.LoadGameData(mapInfo));
+        BOOST_TEST_REQUIRE(!mapInfo.savegame); // Must be from start
+        TmpFile mapfile;
+        mapfile.close();
+        BOOST_TEST_REQUIRE(mapInfo.mapData.DecompressToFile(mapfile.filePath));
 
-    bool endOfReplay = false;
-    unsigned nextGF;
-    BOOST_TEST_REQUIRE(replay.ReadGF(&nextGF));
+        std::vector<PlayerInfo> players;
+        for(unsigned i = 0; i < replay.GetNumPlayers(); i++)
+            players.emplace_back(replay.GetPlayer(i));
+        game = std::make_unique<Game>(replay.ggs, /*startGF*/ 0, players);
+        const GameContextScope contextScope(game->context_);
+        RANDOM.Init(replay.random_init);
+        GameWorld& gameWorld = game->world_;
 
-    const Timer timer(true);
-    do
+        for(unsigned i = 0; i < gameWorld.GetNumPlayers(); ++i)
+            gameWorld.GetPlayer(i).MakeStartPacts();
+
+        MapLoader loader(gameWorld);
+        BOOST_TEST_REQUIRE(loader.Load(mapfile.filePath));
+        gameWorld.SetupResources();
+        gameWorld.InitAfterLoad();
+
+        BOOST_TEST_REQUIRE(replay.ReadGF(&nextGF));
+    }
+
+    /// Execute the commands of the current GF and run it. Return false when the replay is finished
+    bool RunGF()
     {
-        unsigned curGF = game.em_->GetCurrentGF();
+        if(endOfReplay)
+            return false;
+        // Other games might run in this thread too
+        const GameContextScope contextScope(game->context_);
+        const unsigned curGF = game->em_->GetCurrentGF();
         AsyncChecksum checksum;
         if(nextGF == curGF)
-            checksum = AsyncChecksum::create(game);
+            checksum = AsyncChecksum::create(*game);
         while(nextGF == curGF)
         {
             BOOST_TEST_INFO("Current GF: " << curGF);
@@ -84,7 +94,7 @@ static void playReplay(const boost::filesystem::path& replayPath)
                 uint8_t gcPlayer;
                 replay.ReadGameCommand(gcPlayer, msg);
                 for(const gc::GameCommandPtr& gc : msg.gcs)
-                    gc->Execute(game.world_, gcPlayer);
+                    gc->Execute(game->world_, gcPlayer);
                 AsyncChecksum& msgChecksum = msg.checksum;
                 if(msgChecksum.randChecksum != 0)
                     BOOST_TEST_REQUIRE(msgChecksum == checksum);
@@ -96,8 +106,25 @@ static void playReplay(const boost::filesystem::path& replayPath)
             } else
                 BOOST_TEST_REQUIRE(nextGF <= replay.GetLastGF());
         }
-        game.RunGF();
-    } while(!endOfReplay);
+        game->RunGF();
+        return !endOfReplay;
+    }
+
+    unsigned GetCurrentGF() const { return game->em_->GetCurrentGF(); }
+
+private:
+    Replay replay;
+    std::unique_ptr<Game> game;
+    unsigned nextGF = 0;
+    bool endOfReplay = false;
+};
+} // namespace
+
+static void playReplay(const boost::filesystem::path& replayPath)
+{
+    ReplayPlayer player(replayPath);
+    const Timer timer(true);
+    while(player.RunGF()) {}
     const auto duration = std::chrono::duration_cast<std::chrono::duration<float>>(timer.getElapsed());
     std::cout << "Replay " << replayPath.filename() << " took " << helpers::withUnit(duration) << std::endl;
 }
@@ -121,3 +148,22 @@ BOOST_AUTO_TEST_CASE(PlaySeaReplay)
     const boost::filesystem::path replayPath = rttr::test::rttrBaseDir / "tests" / "testData" / "SeaMap300kGfs.rpl";
     playReplay(replayPath);
 }
+
+BOOST_AUTO_TEST_CASE(PlayReplaysInterleaved)
+{
+    // Both games run alternating in the same thread. They must not affect each other, so the checksums still match
+    const boost::filesystem::path testDataPath = rttr::test::rttrBaseDir / "tests" / "testData";
+    ReplayPlayer player1(testDataPath / "200kGFs.rpl");
+    ReplayPlayer player2(testDataPath / "SeaMap300kGfs.rpl");
+    constexpr unsigned numGFs = 50000;
+    bool running1 = true, running2 = true;
+    while((running1 || running2) && (player1.GetCurrentGF() < numGFs || player2.GetCurrentGF() < numGFs))
+    {
+        if(running1)
+            running1 = player1.RunGF();
+        if(running2)
+            running2 = player2.RunGF();
+    }
+    BOOST_TEST(player1.GetCurrentGF() >= numGFs);
+    BOOST_TEST(player2.GetCurrentGF() >= numGFs);
+}
@@ -0,0 +1,161 @@
+// Copyright (C) 2005 - 2021 Settlers Freaks (sf-team at siedler25.org)
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "BenchmarkGame.h"
+#include "GamePlayer.h"
+#include "RttrForeachPt.h"
+#include "ai/aijh/AIPlayerJH.h"
+#include "factories/AIFactory.h"
+#include "helpers/MaxEnumValue.h"
+#include "nodeObjs/noBase.h"
+#include "gameTypes/AIInfo.h"
+#include "gameTypes/BuildingQuality.h"
+#include "gameTypes/BuildingType.h"
+#include "gameData/MilitaryConsts.h"
+#include <rttr/test/Fixture.hpp>
+#include <benchmark/benchmark.h>
+#include <memory>
+
+namespace {
+std::shared_ptr<Game> initGame(benchmark::State& state, std::shared_ptr<Game> game)
+{
+    if(!state.error_occurred())
+        game->world_.InitAfterLoad();
+    return game;
+}
+
+std::shared_ptr<Game> createGame(benchmark::State& state)
+{
+    return initGame(state, createBenchmarkGame(state));
+}
+
+/// Game on the largest possible map
+std::shared_ptr<Game> createLargeGame(benchmark::State& state)
+{
+    return initGame(state, createRandomBenchmarkGame(state, MapExtent(256, 256)));
+}
+
+/// Place building sites on all building places in the territory of each player, so there are buildings to count.
+/// Return the number of sites placed
+unsigned addBuildingSites(GameWorld& world)
+{
+    unsigned numSites = 0;
+    for(unsigned playerId = 0; playerId < world.GetNumPlayers(); ++playerId)
+    {
+        const MapPoint hqPos = world.GetPlayer(playerId).GetHQPos();
+        if(!hqPos.isValid())
+            continue;
+        for(const MapPoint pt : world.GetPointsInRadius(hqPos, HQ_RADIUS))
+        {
+            if(!canUseBq(world.GetBQ(pt, playerId), BuildingQuality::Hut))
+                continue;
+            world.SetBuildingSite(BuildingType::Woodcutter, pt, playerId);
+            if(world.GetNO(pt)->GetType() == NodalObjectType::Buildingsite)
+                numSites++;
+        }
+    }
+    return numSites;
+}
+
+bool isBuildingPlace(BuildingQuality bq)
+{
+    return (bq >= BuildingQuality::Hut && bq <= BuildingQuality::Castle) || bq == BuildingQuality::Harbor;
+}
+
+bool isBuildingLike(const GameWorld& world, const MapPoint pt)
+{
+    const NodalObjectType nob = world.GetNO(pt)->GetType();
+    return nob == NodalObjectType::Building || nob == NodalObjectType::Buildingsite || nob == NodalObjectType::Extension
+           || nob == NodalObjectType::Fire || nob == NodalObjectType::CharburnerPile;
+}
+
+std::unique_ptr<AIPlayer> createAI(const GameWorld& world)
+{
+    return AIFactory::Create(AI::Info(AI::Type::Default, AI::Level::Hard), 0, world);
+}
+} // namespace
+
+/// Create the AI and report the memory used per map node
+static void BM_AIInit(benchmark::State& state)
+{
+    rttr::test::Fixture f;
+    const auto game = createGame(state);
+    if(state.error_occurred())
+        return;
+    std::unique_ptr<AIPlayer> ai;
+    for(auto _ : state)
+        ai = createAI(game->world_);
+    const size_t memoryUsage = static_cast<const AIJH::AIPlayerJH&>(*ai).GetMemoryUsage();
+    state.counters["bytes"] = memoryUsage;
+    state.counters["bytesPerNode"] = static_cast<double>(memoryUsage) / prodOfComponents(game->world_.GetSize());
+}
+BENCHMARK(BM_AIInit);
+
+/// Search a position for a building around the HQ using the resource map given as the argument
+static void BM_FindBestPosition(benchmark::State& state)
+{
+    rttr::test::Fixture f;
+    const auto game = createGame(state);
+    if(state.error_occurred())
+        return;
+    const auto ai = createAI(game->world_);
+    auto& aijh = static_cast<AIJH::AIPlayerJH&>(*ai);
+    const MapPoint hqPos = game->world_.GetPlayer(0).GetHQPos();
+    const auto res = static_cast<AIResource>(state.range(0));
+    for(auto _ : state)
+        benchmark::DoNotOptimize(aijh.FindBestPosition(hqPos, res, BuildingQuality::Hut, 11));
+}
+BENCHMARK(BM_FindBestPosition)->DenseRange(0, helpers::MaxEnumValue_v<AIResource>);
+
+/// Rate the building places around every node of the largest map with building sites as done when placing military
+/// buildings. The argument selects whether existing buildings are counted too (includeexisting)
+static void BM_BQsurroundcheck(benchmark::State& state)
+{
+    rttr::test::Fixture f;
+    const auto game = createLargeGame(state);
+    if(state.error_occurred())
+        return;
+    state.counters["buildingSites"] = addBuildingSites(game->world_);
+    const auto ai = createAI(game->world_);
+    auto& aijh = static_cast<AIJH::AIPlayerJH&>(*ai);
+    const bool includeexisting = state.range(0) != 0;
+    for(auto _ : state)
+    {
+        RTTR_FOREACH_PT(MapPoint, game->world_.GetSize())
+            benchmark::DoNotOptimize(aijh.BQsurroundcheck(pt, 6, includeexisting));
+    }
+    state.SetItemsProcessed(state.iterations() * prodOfComponents(game->world_.GetSize()));
+}
+BENCHMARK(BM_BQsurroundcheck)->Arg(0)->Arg(1);
+
+/// Reference for BM_BQsurroundcheck: Calculate the same result by visiting all nodes in the radius
+static void BM_BQsurroundcheckVisitAll(benchmark::State& state)
+{
+    rttr::test::Fixture f;
+    const auto game = createLargeGame(state);
+    if(state.error_occurred())
+        return;
+    state.counters["buildingSites"] = addBuildingSites(game->world_);
+    const GameWorld& world = game->world_;
+    const bool includeexisting = state.range(0) != 0;
+    constexpr unsigned range = 6;
+    for(auto _ : state)
+    {
+        RTTR_FOREACH_PT(MapPoint, world.GetSize())
+        {
+            unsigned count = 0;
+            if(isBuildingPlace(world.GetBQ(pt, 0)))
+                count++;
+            if(includeexisting && isBuildingLike(world, pt))
+                count++;
+            world.VisitPointsInRadius(pt, range, [&world, includeexisting, &count](const MapPoint curPt, unsigned) {
+                if(isBuildingPlace(world.GetNode(curPt).bq) || (includeexisting && isBuildingLike(world, curPt)))
+                    count++;
+            });
+            benchmark::DoNotOptimize(count * 100 / (6 * (2 << (range - 1)) - 5));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * prodOfComponents(world.GetSize()));
+}
+BENCHMARK(BM_BQsurroundcheckVisitAll)->Arg(0)->Arg(1);
@@ -0,0 +1,100 @@
+// Copyright (C) 2005 - 2021 Settlers Freaks (sf-team at siedler25.org)
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "BenchmarkGame.h"
+#include "GamePlayer.h"
+#include "ai/aijh/AIReachability.h"
+#include <rttr/test/Fixture.hpp>
+#include <benchmark/benchmark.h>
+#include <memory>
+#include <vector>
+
+namespace {
+constexpr unsigned territoryRadius = 40;
+
+/// Load a large map and give the first player a big territory around its HQ
+std::shared_ptr<Game> createGame(benchmark::State& state)
+{
+    auto game = createBenchmarkGame(state);
+    if(state.error_occurred())
+        return game;
+    GameWorld& world = game->world_;
+    for(const MapPoint pt : world.GetPointsInRadiusWithCenter(world.GetPlayer(0).GetHQPos(), territoryRadius))
+    {
+        if(world.GetNode(pt).owner == 0)
+            world.SetOwner(pt, 1);
+    }
+    return game;
+}
+
+/// Points inside the territory which are changed by the benchmarks
+std::vector<MapPoint> getChangedPoints(const GameWorld& world)
+{
+    std::vector<MapPoint> pts = world.GetPointsInRadius(world.GetPlayer(0).GetHQPos(), territoryRadius - 5);
+    std::vector<MapPoint> result;
+    for(unsigned i = 0; i < pts.size(); i += 97)
+        result.push_back(pts[i]);
+    return result;
+}
+} // namespace
+
+static void BM_ReachabilityInit(benchmark::State& state)
+{
+    rttr::test::Fixture f;
+    const auto game = createGame(state);
+    if(state.error_occurred())
+        return;
+    AIJH::AIMap aiMap;
+    aiMap.Resize(game->world_.GetSize());
+    AIJH::AIReachability reachability(game->world_, 0, aiMap);
+    double numNodesTouched = 0;
+    for(auto _ : state)
+    {
+        reachability.init();
+        numNodesTouched += reachability.getNumNodesTouched();
+    }
+    state.counters["nodesTouched"] = benchmark::Counter(numNodesTouched, benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_ReachabilityInit);
+
+/// Take away and give back small parts of the territory as done by border changes.
+/// The argument is the number of changes batched into one update
+static void BM_ReachabilityUpdate(benchmark::State& state)
+{
+    rttr::test::Fixture f;
+    const auto game = createGame(state);
+    if(state.error_occurred())
+        return;
+    GameWorld& world = game->world_;
+    AIJH::AIMap aiMap;
+    aiMap.Resize(world.GetSize());
+    AIJH::AIReachability reachability(world, 0, aiMap);
+    reachability.init();
+
+    const std::vector<MapPoint> changedPts = getChangedPoints(world);
+    const auto batchSize = static_cast<unsigned>(state.range(0));
+    unsigned curIdx = 0;
+    double numNodesTouched = 0;
+    unsigned numUpdates = 0;
+    for(auto _ : state)
+    {
+        for(const unsigned char newOwner : {0, 1})
+        {
+            for(unsigned i = 0; i < batchSize; i++)
+            {
+                const MapPoint pt = changedPts[(curIdx + i) % changedPts.size()];
+                for(const MapPoint curPt : world.GetPointsInRadiusWithCenter(pt, 2))
+                    world.SetOwner(curPt, newOwner);
+                reachability.addChangedPoints(world.GetPointsInRadiusWithCenter(pt, 3));
+            }
+            reachability.update();
+            numNodesTouched += reachability.getNumNodesTouched();
+            numUpdates++;
+        }
+        curIdx += batchSize;
+    }
+    state.counters["nodesTouched"] = benchmark::Counter(numNodesTouched / numUpdates);
+    state.counters["nodesTotal"] = prodOfComponents(world.GetSize());
+}
+BENCHMARK(BM_ReachabilityUpdate)->RangeMultiplier(4)->Range(1, 64);
@@ -0,0 +1,54 @@
+// Copyright (C) 2005 - 2021 Settlers Freaks (sf-team at siedler25.org)
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "Game.h"
+#include "PlayerInfo.h"
+#include "mapGenerator/RandomMap.h"
+#include "ogl/glAllocator.h"
+#include "world/MapLoader.h"
+#include "libsiedler2/libsiedler2.h"
+#include "rttr/test/TmpFolder.hpp"
+#include <boost/filesystem/path.hpp>
+#include <benchmark/benchmark.h>
+#include <memory>
+#include <test/testConfig.h>
+#include <vector>
+
+/// Create a game with 2 players on the given map.
+/// Requires an initialized rttr::test::Fixture. Reports an error to the state if the map can't be loaded
+inline std::shared_ptr<Game> loadBenchmarkGame(benchmark::State& state, const boost::filesystem::path& mapPath)
+{
+    libsiedler2::setAllocator(new GlAllocator);
+
+    std::vector<PlayerInfo> players(2);
+    for(auto& player : players)
+        player.ps = PlayerState::Occupied;
+    auto game = std::make_shared<Game>(GlobalGameSettings(), 0, players);
+    MapLoader loader(game->world_);
+    if(!loader.Load(mapPath))
+        state.SkipWithError("Map failed to load");
+    return game;
+}
+
+/// Create a game with 2 players on a large real map shared by the benchmarks.
+/// Requires an initialized rttr::test::Fixture. Reports an error to the state if the map can't be loaded
+inline std::shared_ptr<Game> createBenchmarkGame(benchmark::State& state)
+{
+    return loadBenchmarkGame(state, rttr::test::rttrBaseDir / "data/RTTR/MAPS/NEW/AM_FANGDERZEIT.SWD");
+}
+
+/// Create a game with 2 players on a generated map of the given size, e.g. the largest one of 256x256 nodes.
+/// Requires an initialized rttr::test::Fixture. Reports an error to the state if the map can't be loaded
+inline std::shared_ptr<Game> createRandomBenchmarkGame(benchmark::State& state, const MapExtent& size)
+{
+    rttr::test::TmpFolder tmpFolder;
+    const boost::filesystem::path mapPath = tmpFolder.get() / "map.swd";
+    rttr::mapGenerator::MapSettings settings;
+    settings.size = size;
+    settings.numPlayers = 2;
+    rttr::mapGenerator::CreateRandomMap(mapPath, settings);
+    return loadBenchmarkGame(state, mapPath);
+}
@@ -0,0 +1,90 @@
+// Copyright (C) 2005 - 2021 Settlers Freaks (sf-team at siedler25.org)
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "BenchmarkGame.h"
+#include "GameContext.h"
+#include "GameObject.h"
+#include "RttrForeachPt.h"
+#include "random/Random.h"
+#include <rttr/test/Fixture.hpp>
+#include <benchmark/benchmark.h>
+
+namespace {
+/// Accesses the world like game objects do: Via the proxy looking up the current context on each use
+struct WorldViaProxy : GameObject
+{
+    static const GameWorld& get() { return *world; }
+};
+
+enum class Access
+{
+    Direct,
+    CurrentContext
+};
+
+const char* getLabel(Access access)
+{
+    return (access == Access::Direct) ? "direct" : "current context";
+}
+} // namespace
+
+/// Sum up the altitudes of all nodes of the map. The argument selects whether the world is used directly
+/// or looked up via the GameObject::world proxy for each node
+static void BM_WorldAccess(benchmark::State& state)
+{
+    rttr::test::Fixture f;
+    const auto game = createBenchmarkGame(state);
+    if(state.error_occurred())
+        return;
+    const GameContextScope contextScope(game->context_);
+    const GameWorld& world = game->world_;
+    const auto access = static_cast<Access>(state.range(0));
+    state.SetLabel(getLabel(access));
+    for(auto _ : state)
+    {
+        unsigned sum = 0;
+        if(access == Access::Direct)
+        {
+            RTTR_FOREACH_PT(MapPoint, world.GetSize())
+                sum += world.GetNode(pt).altitude;
+        } else
+        {
+            RTTR_FOREACH_PT(MapPoint, world.GetSize())
+                sum += WorldViaProxy::get().GetNode(pt).altitude;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * prodOfComponents(world.GetSize()));
+}
+BENCHMARK(BM_WorldAccess)->Arg(static_cast<int>(Access::Direct))->Arg(static_cast<int>(Access::CurrentContext));
+
+/// Draw random numbers from the RNG of the game or via RANDOM which looks up the current context each time
+static void BM_RandomAccess(benchmark::State& state)
+{
+    rttr::test::Fixture f;
+    const auto game = createBenchmarkGame(state);
+    if(state.error_occurred())
+        return;
+    const GameContextScope contextScope(game->context_);
+    UsedRandom& random = game->context_.GetRandom();
+    const auto access = static_cast<Access>(state.range(0));
+    state.SetLabel(getLabel(access));
+    constexpr unsigned numValues = 1000;
+    for(auto _ : state)
+    {
+        int sum = 0;
+        if(access == Access::Direct)
+        {
+            for(unsigned i = 0; i < numValues; i++)
+                sum += random.Rand(RANDOM_CONTEXT2(i), 100);
+        } else
+        {
+            for(unsigned i = 0; i < numValues; i++)
+                sum += RANDOM.Rand(RANDOM_CONTEXT2(i), 100);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * numValues);
+}
+BENCHMARK(BM_RandomAccess)->Arg(static_cast<int>(Access::Direct))->Arg(static_cast<int>(Access::CurrentContext));
@@ -0,0 +1,132 @@
+// Copyright (C) 2005 - 2021 Settlers Freaks (sf-team at siedler25.org)
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "RTTR_Version.h"
+#include "mapGenerator/RandomMap.h"
+#include "network/CreateServerInfo.h"
+#include "network/GameMessage_Chat.h"
+#include "network/GameMessages.h"
+#include "network/GameServer.h"
+#include "network/MemoryConnection.h"
+#include "network/NetworkPlayer.h"
+#include "gameTypes/CompressedData.h"
+#include "rttr/test/TmpFolder.hpp"
+#include "s25util/Socket.h"
+#include <rttr/test/Fixture.hpp>
+#include <benchmark/benchmark.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+constexpr unsigned numClients = 4;
+
+/// Client which only counts the chat messages it receives
+struct RelayClient
+{
+    NetworkPlayer player{GameMessageWithPlayer::NO_PLAYER_ID};
+    unsigned numChats = 0;
+
+    explicit RelayClient(std::shared_ptr<MemoryConnection> connection)
+    {
+        player.setMemoryConnection(std::move(connection));
+    }
+
+    void run()
+    {
+        if(player.hasReceivedData())
+            player.receiveMsgs();
+        while(!player.recvQueue.empty())
+        {
+            std::unique_ptr<Message> msg(player.recvQueue.popFront());
+            if(msg->getId() == NMS_CHAT)
+                ++numChats;
+        }
+        player.sendMsgs(-1);
+    }
+};
+
+/// A server with all clients in the lobby, connected within the process so only the relay itself is measured
+struct RelayFixture
+{
+    rttr::test::Fixture f;
+    rttr::test::TmpFolder tmpFolder;
+    GameServer server;
+    std::vector<std::unique_ptr<RelayClient>> clients;
+
+    RelayFixture()
+    {
+        Socket::Initialize();
+        const boost::filesystem::path mapPath = tmpFolder.get() / "map.wld";
+        rttr::mapGenerator::MapSettings settings;
+        settings.size = MapExtent(64, 64);
+        settings.numPlayers = numClients;
+        rttr::mapGenerator::CreateRandomMap(mapPath, settings);
+        CompressedData mapData;
+        unsigned mapChecksum;
+        if(!mapData.CompressFromFile(mapPath, &mapChecksum)
+           || !server.Start(CreateServerInfo(ServerType::Direct, 0, "Benchmark"), mapPath, MapType::OldMap, "HostPw"))
+            return;
+        for(unsigned i = 0; i < numClients; i++)
+        {
+            MemoryConnection::Pair connection = MemoryConnection::createPair();
+            if(!server.ConnectLocal(std::move(connection.first)))
+                return;
+            clients.push_back(std::make_unique<RelayClient>(std::move(connection.second)));
+            MessageQueue& sendQueue = clients.back()->player.sendQueue;
+            sendQueue.push(new GameMessage_Server_Type(ServerType::Direct, rttr::version::GetRevision()));
+            sendQueue.push(new GameMessage_Server_Password(i == 0 ? "HostPw" : ""));
+            sendQueue.push(new GameMessage_Map_Checksum(mapChecksum, 0));
+        }
+        for(unsigned i = 0; i < 1000 && server.GetNumFilledSlots() < numClients; i++)
+            run();
+    }
+    ~RelayFixture()
+    {
+        clients.clear();
+        server.Stop();
+        Socket::Shutdown();
+    }
+
+    bool isReady() const { return server.GetNumFilledSlots() == numClients; }
+
+    void run()
+    {
+        server.Run();
+        for(auto& client : clients)
+            client->run();
+    }
+};
+} // namespace
+
+static void BM_RelayChatMessages(benchmark::State& state)
+{
+    RelayFixture fixture;
+    if(!fixture.isReady())
+    {
+        state.SkipWithError("Clients failed to join");
+        return;
+    }
+    const auto numMsgs = static_cast<unsigned>(state.range(0));
+    RelayClient& sender = *fixture.clients[1];
+    for(auto _ : state)
+    {
+        for(auto& client : fixture.clients)
+            client->numChats = 0;
+        for(unsigned i = 0; i < numMsgs; i++)
+            sender.player.sendQueue.push(
+              new GameMessage_Chat(GameMessageWithPlayer::NO_PLAYER_ID, ChatDestination::All, std::to_string(i)));
+        bool allReceived = false;
+        while(!allReceived)
+        {
+            fixture.run();
+            allReceived = true;
+            for(const auto& client : fixture.clients)
+                allReceived &= client->numChats >= numMsgs;
+        }
+    }
+    // Each message is sent to every client
+    state.SetItemsProcessed(state.iterations() * numMsgs * numClients);
+}
+BENCHMARK(BM_RelayChatMessages)->Arg(100)->Arg(1000)->Arg(5000);
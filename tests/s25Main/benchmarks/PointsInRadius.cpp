@@ -0,0 +1,99 @@
+// Copyright (C) 2005 - 2021 Settlers Freaks (sf-team at siedler25.org)
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "world/MapBase.h"
+#include "rttr/test/random.hpp"
+#include <benchmark/benchmark.h>
+#include <vector>
+
+namespace {
+MapBase createMap()
+{
+    MapBase map;
+    map.Resize(MapExtent(256, 256));
+    return map;
+}
+
+/// Random points, some of them close to the map border
+std::vector<MapPoint> getRandomPoints(const MapBase& map)
+{
+    std::vector<MapPoint> pts(256);
+    for(MapPoint& pt : pts)
+        pt = rttr::test::randomPoint<MapPoint>(0, map.GetWidth() - 1);
+    return pts;
+}
+
+/// Walk the rings by repeated neighbor lookups as done before the offset tables were used
+unsigned sumByRingWalk(const MapBase& map, const MapPoint pt, unsigned radius)
+{
+    unsigned sum = pt.x + pt.y;
+    MapPoint curStartPt = pt;
+    for(unsigned r = 1; r <= radius; ++r)
+    {
+        curStartPt = map.GetNeighbour(curStartPt, Direction::West);
+        MapPoint curPt = curStartPt;
+        for(const auto dir : helpers::enumRange(Direction::NorthEast))
+        {
+            for(unsigned step = 0; step < r; ++step)
+            {
+                sum += curPt.x + curPt.y;
+                curPt = map.GetNeighbour(curPt, dir);
+            }
+        }
+    }
+    return sum;
+}
+} // namespace
+
+static void BM_GetPointsInRadius(benchmark::State& state)
+{
+    const MapBase map = createMap();
+    const std::vector<MapPoint> pts = getRandomPoints(map);
+    const auto radius = static_cast<unsigned>(state.range(0));
+    for(auto _ : state)
+    {
+        for(const MapPoint pt : pts)
+        {
+            unsigned sum = 0;
+            for(const MapPoint curPt : map.GetPointsInRadiusWithCenter(pt, radius))
+                sum += curPt.x + curPt.y;
+            benchmark::DoNotOptimize(sum);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * pts.size());
+}
+BENCHMARK(BM_GetPointsInRadius)->DenseRange(1, 20);
+
+static void BM_VisitPointsInRadius(benchmark::State& state)
+{
+    const MapBase map = createMap();
+    const std::vector<MapPoint> pts = getRandomPoints(map);
+    const auto radius = static_cast<unsigned>(state.range(0));
+    for(auto _ : state)
+    {
+        for(const MapPoint pt : pts)
+        {
+            unsigned sum = 0;
+            map.VisitPointsInRadius(
+              pt, radius, [&sum](const MapPoint curPt, unsigned) { sum += curPt.x + curPt.y; }, true);
+            benchmark::DoNotOptimize(sum);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * pts.size());
+}
+BENCHMARK(BM_VisitPointsInRadius)->DenseRange(1, 20);
+
+static void BM_RingWalk(benchmark::State& state)
+{
+    const MapBase map = createMap();
+    const std::vector<MapPoint> pts = getRandomPoints(map);
+    const auto radius = static_cast<unsigned>(state.range(0));
+    for(auto _ : state)
+    {
+        for(const MapPoint pt : pts)
+            benchmark::DoNotOptimize(sumByRingWalk(map, pt, radius));
+    }
+    state.SetItemsProcessed(state.iterations() * pts.size());
+}
+BENCHMARK(BM_RingWalk)->DenseRange(1, 20);
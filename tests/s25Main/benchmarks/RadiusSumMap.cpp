@@ -0,0 +1,82 @@
+// Copyright (C) 2005 - 2021 Settlers Freaks (sf-team at siedler25.org)
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "RttrForeachPt.h"
+#include "world/RadiusSumMap.h"
+#include "rttr/test/random.hpp"
+#include <benchmark/benchmark.h>
+#include <vector>
+
+namespace {
+RadiusSumMap createMap()
+{
+    RadiusSumMap map;
+    map.Resize(MapExtent(256, 256));
+    RTTR_FOREACH_PT(MapPoint, map.GetSize())
+        map.set(pt, rttr::test::randomValue(-40, 40));
+    return map;
+}
+
+/// Random points, some of them close to the map border
+std::vector<MapPoint> getRandomPoints(const MapBase& map)
+{
+    std::vector<MapPoint> pts(256);
+    for(MapPoint& pt : pts)
+        pt = rttr::test::randomPoint<MapPoint>(0, map.GetWidth() - 1);
+    return pts;
+}
+} // namespace
+
+static void BM_RadiusSum(benchmark::State& state)
+{
+    const RadiusSumMap map = createMap();
+    const std::vector<MapPoint> pts = getRandomPoints(map);
+    const auto radius = static_cast<unsigned>(state.range(0));
+    for(auto _ : state)
+    {
+        for(const MapPoint pt : pts)
+            benchmark::DoNotOptimize(map.getSum(pt, radius));
+    }
+    state.SetItemsProcessed(state.iterations() * pts.size());
+}
+BENCHMARK(BM_RadiusSum)->DenseRange(1, 20);
+
+/// Reference for BM_RadiusSum: Add up all values in the radius
+static void BM_RadiusSumVisitAll(benchmark::State& state)
+{
+    const RadiusSumMap map = createMap();
+    const std::vector<MapPoint> pts = getRandomPoints(map);
+    const auto radius = static_cast<unsigned>(state.range(0));
+    for(auto _ : state)
+    {
+        for(const MapPoint pt : pts)
+        {
+            int sum = 0;
+            map.VisitPointsInRadius(
+              pt, radius, [&map, &sum](const MapPoint curPt, unsigned) { sum += map[curPt]; }, true);
+            benchmark::DoNotOptimize(sum);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * pts.size());
+}
+BENCHMARK(BM_RadiusSumVisitAll)->DenseRange(1, 20);
+
+/// Change a value and get a sum around it as done by the AI after a tree was cut
+static void BM_RadiusSumUpdate(benchmark::State& state)
+{
+    RadiusSumMap map = createMap();
+    const std::vector<MapPoint> pts = getRandomPoints(map);
+    int value = 0;
+    for(auto _ : state)
+    {
+        for(const MapPoint pt : pts)
+        {
+            value = -value + 1;
+            map.set(pt, value % 40);
+            benchmark::DoNotOptimize(map.getSum(pt, 8));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * pts.size());
+}
+BENCHMARK(BM_RadiusSumUpdate);
@@ -2,17 +2,11 @@
 //
 // SPDX-License-Identifier: GPL-2.0-or-later
 
-#include "Game.h"
-#include "PlayerInfo.h"
-#include "network/GameClient.h"
-#include "ogl/glAllocator.h"
-#include "world/MapLoader.h"
-#include "libsiedler2/libsiedler2.h"
+#include "BenchmarkGame.h"
 #include <rttr/test/Fixture.hpp>
 #include <benchmark/benchmark.h>
 #include <array>
-#include <test/testConfig.h>
-#include <utility>
+#include <tuple>
 
 constexpr std::array<std::tuple<const char*, MapPoint, MapPoint>, 7> routes = {{{"Simple 1", {85, 147}, {87, 150}},
                                                                                 {"Simple 2", {85, 147}, {85, 152}},
@@ -25,16 +19,10 @@ constexpr std::array<std::tuple<const char*, MapPoint, MapPoint>, 7> routes = {{
 static void BM_World(benchmark::State& state)
 {
     rttr::test::Fixture f;
-    libsiedler2::setAllocator(new GlAllocator);
-
-    std::vector<PlayerInfo> players(2);
-    for(auto& player : players)
-        player.ps = PlayerState::Occupied;
-    auto game = std::make_shared<Game>(GlobalGameSettings(), 0, players);
+    const auto game = createBenchmarkGame(state);
+    if(state.error_occurred())
+        return;
     GameWorld& world = game->world_;
-    MapLoader loader(world);
-    if(!loader.Load(rttr::test::rttrBaseDir / "data/RTTR/MAPS/NEW/AM_FANGDERZEIT.SWD"))
-        state.SkipWithError("Map failed to load");
 
     const auto& curValues = routes[static_cast<size_t>(state.range())];
     state.SetLabel(std::get<0>(curValues));
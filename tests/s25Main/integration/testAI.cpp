@@ -4,8 +4,10 @@
 
 #include "PointOutput.h"
 #include "RttrForeachPt.h"
+#include "ai/AIInterface.h"
 #include "ai/AIPlayer.h"
 #include "ai/aijh/AIPlayerJH.h"
+#include "ai/aijh/AIReachability.h"
 #include "buildings/noBuilding.h"
 #include "buildings/noBuildingSite.h"
 #include "buildings/nobBaseWarehouse.h"
@@ -19,14 +21,35 @@
 #include "nodeObjs/noTree.h"
 #include "gameTypes/GameTypesOutput.h"
 #include "gameData/BuildingProperties.h"
+#include "rttr/test/MockClock.hpp"
 #include "rttr/test/random.hpp"
 #include <boost/test/unit_test.hpp>
+#include <chrono>
+#include <cstdlib>
+#include <limits>
 #include <memory>
 #include <set>
+#include <utility>
 
 namespace {
 // We need border land
 using BiggerWorldWithGCExecution = WorldWithGCExecution<1, 24, 22>;
+
+/// Clock which advances by 1us each time it is queried, so time passes only while the AI works
+struct TickingClock : BaseClock
+{
+    duration& currentTime;
+    explicit TickingClock(duration& timeRef) : currentTime(timeRef) {}
+    duration time_since_epoch() override { return currentTime += std::chrono::microseconds(1); }
+};
+
+struct TickingClockFixture : BiggerWorldWithGCExecution
+{
+    BaseClock::duration currentTime{0};
+
+    TickingClockFixture() { Clock::setClock(std::make_unique<TickingClock>(currentTime)); }
+    ~TickingClockFixture() { Clock::setClock(std::make_unique<BaseClock>()); }
+};
 using EmptyWorldFixture1P = WorldFixture<CreateEmptyWorld, 1>;
 using EmptyWorldFixture2P = WorldFixture<CreateEmptyWorld, 2>;
 
@@ -264,6 +287,88 @@ BOOST_FIXTURE_TEST_CASE(KeepBQUpdated, BiggerWorldWithGCExecution)
     assertBqEqualOnWholeMap(__LINE__);
 }
 
+BOOST_FIXTURE_TEST_CASE(FindBestPositionMatchesScan, BiggerWorldWithGCExecution)
+{
+    RTTR_FOREACH_PT(MapPoint, world.GetSize())
+    {
+        if((pt.x + pt.y) % 3 == 0 && world.GetNode(pt).bq == BuildingQuality::Castle
+           && world.CalcDistance(pt, hqPos) > 4)
+            world.SetNO(pt, new noTree(pt, 0, 3));
+    }
+    world.InitAfterLoad();
+    auto ai = AIFactory::Create(AI::Info(AI::Type::Default, AI::Level::Hard), curPlayer, world);
+    for(unsigned gf = 0; gf < 100; ++gf)
+    {
+        em.ExecuteNextGF();
+        ai->RunGF(em.GetCurrentGF(), true);
+    }
+    const AIJH::AIPlayerJH& aijh = static_cast<AIJH::AIPlayerJH&>(*ai);
+
+    // Reference: Take the first valid point with the highest value
+    const auto findBestByScan = [this](const AIJH::AIResourceMap& resMap, const MapPoint center,
+                                       BuildingQuality size, unsigned radius, int minimum) {
+        MapPoint best = MapPoint::Invalid();
+        int bestValue = (minimum == std::numeric_limits<int>::min()) ? minimum : minimum - 1;
+        for(const MapPoint pt : world.GetPointsInRadiusWithCenter(center, radius))
+        {
+            if(resMap[pt] > bestValue && resMap.isValidPosition(pt, size))
+            {
+                best = pt;
+                bestValue = resMap[pt];
+            }
+        }
+        return best;
+    };
+    // Reference: The valid point closest to the middle of the range, the last visited one on an exact match
+    const auto findBestRangedByScan = [this](const AIJH::AIResourceMap& resMap, const MapPoint center,
+                                             BuildingQuality size, unsigned radius, int minimum, int maximum) {
+        if(minimum > maximum)
+            maximum = minimum;
+        const int targetValue = minimum + (maximum - minimum) / 2;
+        MapPoint best = MapPoint::Invalid();
+        int diff = maximum;
+        for(const MapPoint pt : world.GetPointsInRadiusWithCenter(center, radius))
+        {
+            const int value = resMap[pt];
+            if(value >= minimum && value <= maximum
+               && (value == targetValue || std::abs(value - targetValue) < diff)
+               && resMap.isValidPosition(pt, size))
+            {
+                best = pt;
+                diff = std::abs(value - targetValue);
+            }
+        }
+        return best;
+    };
+    for(const AIResource res : {AIResource::Wood, AIResource::Stones, AIResource::Plantspace, AIResource::Borderland})
+    {
+        const AIJH::AIResourceMap& resMap = aijh.GetResMap(res);
+        for(unsigned i = 0; i < 30; i++)
+        {
+            const MapPoint center = rttr::test::randomPoint<MapPoint>(0, world.GetHeight() - 1);
+            // Radius 11 wraps around the map
+            for(unsigned radius = 1; radius <= 11; radius++)
+            {
+                for(const int minimum : {std::numeric_limits<int>::min(), 0, 10})
+                {
+                    BOOST_TEST_INFO(center << " r=" << radius << " min=" << minimum);
+                    BOOST_TEST_REQUIRE(resMap.findBestPosition(center, BuildingQuality::Hut, radius, minimum)
+                                       == findBestByScan(resMap, center, BuildingQuality::Hut, radius, minimum));
+                }
+                for(const auto& range : {std::make_pair(0, 20), std::make_pair(10, 10), std::make_pair(-5, 50),
+                                         std::make_pair(30, 5)})
+                {
+                    BOOST_TEST_INFO(center << " r=" << radius << " range=" << range.first << "-" << range.second);
+                    BOOST_TEST_REQUIRE(
+                      resMap.findBestPositionRanged(center, BuildingQuality::Hut, radius, range.first, range.second)
+                      == findBestRangedByScan(resMap, center, BuildingQuality::Hut, radius, range.first,
+                                              range.second));
+                }
+            }
+        }
+    }
+}
+
 BOOST_FIXTURE_TEST_CASE(BuildWoodIndustry, WorldWithGCExecution<1>)
 {
     // Place a few trees
@@ -333,4 +438,321 @@ BOOST_FIXTURE_TEST_CASE(ExpandWhenNoSpace, BiggerWorldWithGCExecution)
       (containsBldType(bldSites, BuildingType::Barracks) || containsBldType(bldSites, BuildingType::Guardhouse)));
 }
 
+BOOST_FIXTURE_TEST_CASE(FreePathToAnyMatchesSingleSearches, BiggerWorldWithGCExecution)
+{
+    // Scatter some flags around the HQ
+    std::vector<MapPoint> flagPositions;
+    for(const MapPoint pt : world.GetPointsInRadius(hqPos, 7))
+    {
+        if((pt.x + pt.y) % 3 == 0 && world.GetBQ(pt, curPlayer) != BuildingQuality::Nothing && !world.IsFlagAround(pt))
+        {
+            this->SetFlag(pt);
+            if(world.GetSpecObj<noFlag>(pt))
+                flagPositions.push_back(pt);
+        }
+    }
+    BOOST_TEST_REQUIRE(flagPositions.size() > 5u);
+    const MapPoint startPos = flagPositions.back();
+    flagPositions.pop_back();
+
+    std::vector<gc::GameCommandPtr> gcs;
+    const AIInterface aii(world, gcs, curPlayer);
+    constexpr unsigned noPath = std::numeric_limits<unsigned>::max();
+    std::vector<unsigned> lengths(flagPositions.size(), noPath);
+    unsigned lastLength = 0;
+    BOOST_TEST_REQUIRE(aii.FindFreePathForNewRoadToAny(
+      startPos, flagPositions, [&](const unsigned idx, const std::vector<Direction>& route) {
+          BOOST_TEST_REQUIRE(lengths[idx] == noPath);
+          BOOST_TEST(route.size() >= lastLength);
+          lastLength = lengths[idx] = route.size();
+          MapPoint curPos = startPos;
+          for(const Direction dir : route)
+              curPos = world.GetNeighbour(curPos, dir);
+          BOOST_TEST(curPos == flagPositions[idx]);
+          return 100u;
+      }));
+    unsigned minLength = noPath;
+    for(unsigned i = 0; i < flagPositions.size(); i++)
+    {
+        unsigned length;
+        const bool pathFound = aii.FindFreePathForNewRoad(startPos, flagPositions[i], nullptr, &length);
+        BOOST_TEST(pathFound == (lengths[i] != noPath));
+        if(pathFound)
+        {
+            BOOST_TEST(length == lengths[i]);
+            minLength = std::min(minLength, length);
+        }
+    }
+
+    // Stop after the first target
+    unsigned numTargetsReached = 0;
+    aii.FindFreePathForNewRoadToAny(startPos, flagPositions, [&](const unsigned, const std::vector<Direction>& route) {
+        numTargetsReached++;
+        BOOST_TEST(route.size() == minLength);
+        return 0u;
+    });
+    BOOST_TEST(numTargetsReached == 1u);
+}
+
+BOOST_FIXTURE_TEST_CASE(IncrementalReachabilityMatchesInit, BiggerWorldWithGCExecution)
+{
+    AIJH::AIMap aiMap, expectedAiMap;
+    aiMap.Resize(world.GetSize());
+    expectedAiMap.Resize(world.GetSize());
+    AIJH::AIReachability reachability(world, curPlayer, aiMap);
+    AIJH::AIReachability expectedReachability(world, curPlayer, expectedAiMap);
+    reachability.init();
+
+    const auto checkReachability = [&]() {
+        expectedReachability.init();
+        RTTR_FOREACH_PT(MapPoint, world.GetSize())
+        {
+            BOOST_TEST_INFO(pt);
+            BOOST_TEST(aiMap[pt].reachable == expectedAiMap[pt].reachable);
+        }
+    };
+    checkReachability();
+
+    // Place and remove flags and roads which block the nodes they go through
+    const std::vector<MapPoint> area = world.GetPointsInRadius(hqPos, 8);
+    for(unsigned i = 0; i < 60; i++)
+    {
+        const MapPoint pt = area[rttr::test::randomValue<size_t>(0, area.size() - 1)];
+        if(world.GetSpecObj<noFlag>(pt) && rttr::test::randomBool())
+            this->DestroyFlag(pt);
+        else
+        {
+            this->SetFlag(pt);
+            const std::vector<Direction> route(rttr::test::randomValue(2u, 4u), rttr::test::randomEnum<Direction>());
+            this->BuildRoad(pt, false, route);
+        }
+        reachability.addChangedPoints(world.GetPointsInRadiusWithCenter(pt, 5));
+        // Batch multiple changes into one update
+        if(i % 3 == 2)
+        {
+            reachability.update();
+            BOOST_TEST(!reachability.hasChanges());
+            checkReachability();
+        }
+    }
+}
+
+BOOST_FIXTURE_TEST_CASE(BQsurroundcheckMatchesScan, BiggerWorldWithGCExecution)
+{
+    // Place some trees to reduce BQ at some points
+    RTTR_FOREACH_PT(MapPoint, world.GetSize())
+    {
+        if((pt.x + 2 * pt.y) % 5 == 0 && world.GetNode(pt).bq == BuildingQuality::Castle
+           && world.CalcDistance(pt, hqPos) > 6)
+            world.SetNO(pt, new noTree(pt, 0, 3));
+    }
+    world.InitAfterLoad();
+    auto ai = AIFactory::Create(AI::Info(AI::Type::Default, AI::Level::Hard), curPlayer, world);
+    AIJH::AIPlayerJH& aijh = static_cast<AIJH::AIPlayerJH&>(*ai);
+    const auto runGF = [this, &ai]() {
+        em.ExecuteNextGF();
+        ai->RunGF(em.GetCurrentGF(), true);
+    };
+    for(unsigned gf = 0; gf < 100; ++gf)
+        runGF();
+
+    // Reference: Visit all points in the range as done before using the building place maps
+    const auto bqSurroundcheckByScan = [this](const MapPoint center, unsigned range, bool includeexisting) {
+        const auto isBuildingPlace = [](BuildingQuality bq) {
+            return (bq >= BuildingQuality::Hut && bq <= BuildingQuality::Castle) || bq == BuildingQuality::Harbor;
+        };
+        const auto isBuildingLike = [this](const MapPoint pt) {
+            const NodalObjectType nob = world.GetNO(pt)->GetType();
+            return nob == NodalObjectType::Building || nob == NodalObjectType::Buildingsite
+                   || nob == NodalObjectType::Extension || nob == NodalObjectType::Fire
+                   || nob == NodalObjectType::CharburnerPile;
+        };
+        unsigned count = 0;
+        if(isBuildingPlace(world.GetBQ(center, curPlayer)))
+            count++;
+        if(includeexisting && isBuildingLike(center))
+            count++;
+        for(const MapPoint pt : world.GetPointsInRadius(center, range))
+        {
+            if(isBuildingPlace(world.GetNode(pt).bq) || (includeexisting && isBuildingLike(pt)))
+                count++;
+        }
+        return count * 100 / (6 * (2 << (range - 1)) - 5);
+    };
+    const auto checkAllNodes = [&](const unsigned lineNr) {
+        BOOST_TEST_CONTEXT("Line #" << lineNr)
+        RTTR_FOREACH_PT(MapPoint, world.GetSize())
+        {
+            // Range 11 wraps around the map
+            for(const unsigned range : {1u, 6u, 11u})
+            {
+                for(const bool includeexisting : {false, true})
+                {
+                    BOOST_TEST_INFO(pt << " r=" << range << " existing=" << includeexisting);
+                    BOOST_TEST_REQUIRE(aijh.BQsurroundcheck(pt, range, includeexisting)
+                                       == bqSurroundcheckByScan(pt, range, includeexisting));
+                }
+            }
+        }
+    };
+    checkAllNodes(__LINE__);
+
+    // Finish a building
+    const MapPoint bldPos = world.MakeMapPoint(hqPos + Position(5, 0));
+    const MapPoint bldFlagPos = world.GetNeighbour(bldPos, Direction::SouthEast);
+    this->SetBuildingSite(bldPos, BuildingType::Barracks);
+    BOOST_TEST_REQUIRE(world.GetSpecObj<noBuildingSite>(bldPos));
+    runGF();
+    checkAllNodes(__LINE__);
+    this->BuildRoad(bldFlagPos, false, std::vector<Direction>(5, Direction::West));
+    RTTR_EXEC_TILL(2000, world.GetSpecObj<noBuilding>(bldPos));
+    runGF();
+    checkAllNodes(__LINE__);
+
+    // Change the BQ by placing and removing flags and roads
+    const std::vector<MapPoint> area = world.GetPointsInRadius(hqPos, 8);
+    for(unsigned i = 0; i < 10; i++)
+    {
+        const MapPoint pt = area[rttr::test::randomValue<size_t>(0, area.size() - 1)];
+        if(pt != bldFlagPos && world.GetSpecObj<noFlag>(pt) && rttr::test::randomBool())
+            this->DestroyFlag(pt);
+        else
+        {
+            this->SetFlag(pt);
+            const std::vector<Direction> route(rttr::test::randomValue(2u, 4u), rttr::test::randomEnum<Direction>());
+            this->BuildRoad(pt, false, route);
+        }
+        runGF();
+        checkAllNodes(__LINE__);
+    }
+
+    // Place building sites and remove them again
+    std::vector<MapPoint> sitePositions;
+    for(const MapPoint pt : area)
+    {
+        if(sitePositions.size() == 5u || !canUseBq(world.GetBQ(pt, curPlayer), BuildingQuality::Hut))
+            continue;
+        this->SetBuildingSite(pt, BuildingType::Woodcutter);
+        if(world.GetSpecObj<noBuildingSite>(pt))
+            sitePositions.push_back(pt);
+    }
+    BOOST_TEST_REQUIRE(!sitePositions.empty());
+    runGF();
+    checkAllNodes(__LINE__);
+    for(const MapPoint pt : sitePositions)
+        this->DestroyBuilding(pt);
+    runGF();
+    checkAllNodes(__LINE__);
+
+    // Burn down the building and let the fire burn out, which doesn't need to change the BQ
+    this->DestroyBuilding(bldPos);
+    BOOST_TEST_REQUIRE(world.GetNO(bldPos)->GetType() == NodalObjectType::Fire);
+    runGF();
+    checkAllNodes(__LINE__);
+    RTTR_EXEC_TILL(10000, world.GetNO(bldPos)->GetType() != NodalObjectType::Fire);
+    runGF();
+    checkAllNodes(__LINE__);
+}
+
+BOOST_FIXTURE_TEST_CASE(SchedulerCarriesOverWork, rttr::test::MockClockFixture)
+{
+    AIJH::AIScheduler scheduler;
+    std::vector<unsigned> executed;
+    // Does 3 steps of which each uses up the whole budget
+    const auto addSteppedTask = [this, &scheduler, &executed](unsigned id) {
+        return scheduler.add(id, [this, &scheduler, &executed, id, numSteps = 0u]() mutable {
+            BOOST_TEST(!scheduler.isBudgetUsedUp());
+            currentTime += std::chrono::microseconds(10);
+            BOOST_TEST(scheduler.isBudgetUsedUp());
+            executed.push_back(id);
+            return ++numSteps == 3u;
+        });
+    };
+    BOOST_TEST(addSteppedTask(0));
+    // Not running -> Nothing used
+    BOOST_TEST(!scheduler.isBudgetUsedUp());
+    BOOST_TEST(scheduler.add(1, [&executed]() {
+        executed.push_back(1);
+        return true;
+    }));
+    BOOST_TEST(scheduler.getBacklog() == 2u);
+    scheduler.setBudget(std::chrono::microseconds(10));
+    // Already queued
+    BOOST_TEST(!addSteppedTask(0));
+    BOOST_TEST(scheduler.getBacklog() == 2u);
+
+    // One step per run, the other task waits till the first is done
+    scheduler.run();
+    BOOST_TEST(executed == std::vector<unsigned>({0}));
+    scheduler.run();
+    scheduler.run();
+    BOOST_TEST(executed == std::vector<unsigned>({0, 0, 0}));
+    BOOST_TEST(scheduler.getBacklog() == 1u);
+    scheduler.run();
+    BOOST_TEST(executed == std::vector<unsigned>({0, 0, 0, 1}));
+    BOOST_TEST(scheduler.getBacklog() == 0u);
+    BOOST_TEST(scheduler.getStats().numRuns == 4u);
+    BOOST_TEST(scheduler.getStats().maxBacklog == 2u);
+    // Each step took exactly the budget
+    BOOST_TEST(scheduler.getStats().numOverruns == 0u);
+    BOOST_TEST(scheduler.getStats().timeUsed == std::chrono::microseconds(30));
+
+    // A task taking longer than the budget is finished but reported
+    BOOST_TEST(scheduler.add(1, [this]() {
+        currentTime += std::chrono::microseconds(25);
+        return true;
+    }));
+    scheduler.run();
+    BOOST_TEST(scheduler.getBacklog() == 0u);
+    BOOST_TEST(scheduler.getStats().numOverruns == 1u);
+    BOOST_TEST(scheduler.getStats().maxOverrun == std::chrono::microseconds(15));
+
+    // Unlimited budget -> Everything is done in one run
+    scheduler.setBudget(std::chrono::microseconds(0));
+    executed.clear();
+    BOOST_TEST(scheduler.add(1, [&executed]() {
+        executed.push_back(1);
+        return true;
+    }));
+    BOOST_TEST(scheduler.add(2, [&executed]() {
+        executed.push_back(2);
+        return true;
+    }));
+    scheduler.run();
+    BOOST_TEST(executed == std::vector<unsigned>({1, 2}));
+    BOOST_TEST(scheduler.getBacklog() == 0u);
+}
+
+BOOST_FIXTURE_TEST_CASE(ExpandWithTinyTimeBudget, TickingClockFixture)
+{
+    const GamePlayer& player = world.GetPlayer(curPlayer);
+    auto ai = AIFactory::Create(AI::Info(AI::Type::Default, AI::Level::Hard), curPlayer, world);
+    AIJH::AIScheduler& scheduler = static_cast<AIJH::AIPlayerJH&>(*ai).GetScheduler();
+    // Only (a step of) a single task fits into a GF as the first check of the budget uses it up
+    scheduler.setBudget(std::chrono::microseconds(1));
+    const std::list<noBuildingSite*>& bldSites = player.GetBuildingRegister().GetBuildingSites();
+    for(unsigned gf = 0; gf < 2000 && bldSites.empty();)
+    {
+        std::vector<gc::GameCommandPtr> aiGcs = ai->FetchGameCommands();
+        for(unsigned i = 0; i < 5; i++, gf++)
+        {
+            em.ExecuteNextGF();
+            ai->RunGF(em.GetCurrentGF(), i == 0);
+        }
+        for(gc::GameCommandPtr& gc : aiGcs)
+        {
+            gc->Execute(world, curPlayer);
+        }
+    }
+    // Work is delayed but still done
+    BOOST_TEST(!bldSites.empty());
+    const AIJH::AIScheduler::Stats& stats = scheduler.getStats();
+    BOOST_TEST(stats.numRuns > 0u);
+    // Time passes with each query, so a run of a task takes at least the start, one check of the budget and the end
+    BOOST_TEST(stats.numOverruns > 0u);
+    // Periodic tasks are not queued again while waiting -> Backlog is bounded by the number of different tasks
+    BOOST_TEST(stats.maxBacklog > 0u);
+    BOOST_TEST(stats.maxBacklog <= 7u);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,71 @@
+// Copyright (C) 2005 - 2021 Settlers Freaks (sf-team at siedler25.org)
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "RttrConfig.h"
+#include "ai/AIMatch.h"
+#include "files.h"
+#include <boost/test/unit_test.hpp>
+
+namespace {
+AIMatchConfig createConfig()
+{
+    AIMatchConfig config;
+    config.mapPath = RTTRCONFIG.ExpandPath(s25::folders::mapsRttr) / "Bergruft.swd";
+    config.players.assign(2, AI::Info(AI::Type::Default, AI::Level::Hard));
+    config.seed = 42;
+    config.maxGF = 3000;
+    config.statisticInterval = 500;
+    return config;
+}
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(AIMatchSuite)
+
+BOOST_AUTO_TEST_CASE(InvalidMapFails)
+{
+    AIMatchConfig config = createConfig();
+    config.mapPath = "invalid.swd";
+    BOOST_TEST(!playAIMatch(config));
+}
+
+BOOST_AUTO_TEST_CASE(PlaysTillMaxGF)
+{
+    const AIMatchConfig config = createConfig();
+    const auto result = playAIMatch(config);
+    BOOST_TEST_REQUIRE(result.is_initialized());
+    BOOST_TEST(result->numGFs == config.maxGF);
+    // Nobody can be defeated that early
+    BOOST_TEST(result->winners.empty());
+    BOOST_TEST(result->getGFsPerSecond() > 0.);
+    BOOST_TEST_REQUIRE(result->players.size() == 2u);
+    for(const AIMatchResult::Player& player : result->players)
+    {
+        BOOST_TEST(!player.defeatGF);
+        BOOST_TEST_REQUIRE(player.statistic.size() == config.maxGF / config.statisticInterval + 1u);
+        BOOST_TEST(player.statistic.back()[StatisticType::Country] > 0u);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(SameSeedGivesSameGame)
+{
+    AIMatchConfig config = createConfig();
+    config.maxGF = 1500;
+    const auto result1 = playAIMatch(config);
+    const auto result2 = playAIMatch(config);
+    BOOST_TEST_REQUIRE(result1.is_initialized());
+    BOOST_TEST_REQUIRE(result2.is_initialized());
+    for(unsigned i = 0; i < result1->players.size(); i++)
+    {
+        const auto& statistic1 = result1->players[i].statistic;
+        const auto& statistic2 = result2->players[i].statistic;
+        BOOST_TEST_REQUIRE(statistic1.size() == statistic2.size());
+        for(unsigned j = 0; j < statistic1.size(); j++)
+        {
+            BOOST_TEST_INFO("Player " << i << " sample " << j);
+            BOOST_TEST(statistic1[j] == statistic2[j], boost::test_tools::per_element());
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,78 @@
+// Copyright (C) 2005 - 2021 Settlers Freaks (sf-team at siedler25.org)
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "Game.h"
+#include "GameContext.h"
+#include "GameObject.h"
+#include "PlayerInfo.h"
+#include "random/Random.h"
+#include "worldFixtures/CreateEmptyWorld.h"
+#include <boost/test/unit_test.hpp>
+#include <memory>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(GameContextSuite)
+
+BOOST_AUTO_TEST_CASE(GamesUseOwnContext)
+{
+    PlayerInfo player;
+    player.ps = PlayerState::Occupied;
+    const std::vector<PlayerInfo> players(1, player);
+
+    Game game1(GlobalGameSettings(), 0u, players);
+    // A new game becomes the current one
+    BOOST_TEST(&GameContext::Current() == &game1.context_);
+    BOOST_TEST(GameObject::GetWorld() == &game1.world_);
+    BOOST_TEST_REQUIRE(CreateEmptyWorld(MapExtent(12, 10))(game1.world_));
+    const unsigned numObjs1 = GameObject::GetNumObjs();
+    const unsigned objIdCounter1 = GameObject::GetObjIDCounter();
+    BOOST_TEST(numObjs1 > 0u);
+
+    {
+        Game game2(GlobalGameSettings(), 0u, players);
+        BOOST_TEST(&GameContext::Current() == &game2.context_);
+        BOOST_TEST(GameObject::GetWorld() == &game2.world_);
+        BOOST_TEST(GameObject::GetNumObjs() == 0u);
+        BOOST_TEST(GameObject::GetObjIDCounter() == 0u);
+        BOOST_TEST_REQUIRE(CreateEmptyWorld(MapExtent(12, 10))(game2.world_));
+        // The first game is unaffected
+        BOOST_TEST(game1.context_.GetNumObjs() == numObjs1);
+        BOOST_TEST(game1.context_.GetObjIDCounter() == objIdCounter1);
+        {
+            const GameContextScope contextScope(game1.context_);
+            BOOST_TEST(GameObject::GetWorld() == &game1.world_);
+            BOOST_TEST(GameObject::GetNumObjs() == numObjs1);
+            RANDOM.Init(1337);
+            BOOST_TEST(RANDOM.GetChecksum() == game1.context_.GetRandom().GetChecksum());
+        }
+        BOOST_TEST(&GameContext::Current() == &game2.context_);
+        BOOST_TEST(RANDOM.GetChecksum() != game1.context_.GetRandom().GetChecksum());
+    }
+    // Destroying the second game removed its objects from its own context only
+    BOOST_TEST(game1.context_.GetNumObjs() == numObjs1);
+    BOOST_TEST(game1.context_.GetObjIDCounter() == objIdCounter1);
+    // and made the first one current again
+    BOOST_TEST(&GameContext::Current() == &game1.context_);
+    BOOST_TEST(GameObject::GetWorld() == &game1.world_);
+}
+
+BOOST_AUTO_TEST_CASE(DestroyingContextRestoresLastAliveOne)
+{
+    PlayerInfo player;
+    player.ps = PlayerState::Occupied;
+    const std::vector<PlayerInfo> players(1, player);
+
+    Game game1(GlobalGameSettings(), 0u, players);
+    auto game2 = std::make_unique<Game>(GlobalGameSettings(), 0u, players);
+    auto game3 = std::make_unique<Game>(GlobalGameSettings(), 0u, players);
+    BOOST_TEST(&GameContext::Current() == &game3->context_);
+    // Not the current one, so nothing changes
+    game2.reset();
+    BOOST_TEST(&GameContext::Current() == &game3->context_);
+    // The second game is gone, so the first one becomes current
+    game3.reset();
+    BOOST_TEST(&GameContext::Current() == &game1.context_);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
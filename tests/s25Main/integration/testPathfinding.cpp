@@ -4,8 +4,10 @@
 
 #include "RttrForeachPt.h"
 #include "helpers/OptionalIO.h"
+#include "pathfinding/RoadPathFinder.h"
 #include "worldFixtures/CreateEmptyWorld.h"
 #include "worldFixtures/WorldFixture.h"
+#include "nodeObjs/noFlag.h"
 #include "nodeObjs/noGranite.h"
 #include "gameTypes/GameTypesOutput.h"
 #include "gameData/GameConsts.h"
@@ -13,6 +15,7 @@
 #include <rttr/test/testHelpers.hpp>
 #include <boost/range/adaptor/reversed.hpp>
 #include <boost/test/unit_test.hpp>
+#include <limits>
 #include <vector>
 
 // Tests are designed to check for every possible direction and terrain distribution
@@ -290,4 +293,51 @@ BOOST_FIXTURE_TEST_CASE(BlockedPaths, WorldFixtureEmpty0P)
     BOOST_TEST_REQUIRE(world.FindHumanPath(startPt, surroundingPts2[0]));
 }
 
+BOOST_FIXTURE_TEST_CASE(RoadPathLengthsToMultipleGoals, WorldFixtureEmpty1P)
+{
+    const MapPoint hqFlagPos = world.GetNeighbour(world.GetPlayer(0).GetHQPos(), Direction::SouthEast);
+    const auto walk = [this](MapPoint pt, Direction dir, unsigned numSteps) {
+        for(unsigned i = 0; i < numSteps; i++)
+            pt = world.GetNeighbour(pt, dir);
+        return pt;
+    };
+    // 2 flags in a row to the east, one to the south west and an unconnected one
+    const MapPoint flag1Pos = walk(hqFlagPos, Direction::East, 2);
+    const MapPoint flag2Pos = walk(flag1Pos, Direction::East, 2);
+    const MapPoint flag3Pos = walk(hqFlagPos, Direction::SouthWest, 2);
+    const MapPoint flag4Pos = walk(hqFlagPos, Direction::SouthEast, 3);
+    world.BuildRoad(0, false, hqFlagPos, std::vector<Direction>(2, Direction::East));
+    world.BuildRoad(0, false, flag1Pos, std::vector<Direction>(2, Direction::East));
+    world.BuildRoad(0, false, hqFlagPos, std::vector<Direction>(2, Direction::SouthWest));
+    world.SetFlag(flag4Pos, 0);
+    std::vector<const noRoadNode*> goals;
+    for(const MapPoint pt : {hqFlagPos, flag1Pos, flag2Pos, flag3Pos, flag4Pos})
+    {
+        goals.push_back(world.GetSpecObj<noFlag>(pt));
+        BOOST_TEST_REQUIRE(goals.back());
+    }
+
+    RoadPathFinder& pathFinder = world.GetRoadPathFinder();
+    constexpr unsigned noPath = std::numeric_limits<unsigned>::max();
+    const std::vector<unsigned> lengths = pathFinder.FindPathLengths(*goals[2], goals);
+    BOOST_TEST(lengths == std::vector<unsigned>({4, 2, 0, 6, noPath}), boost::test_tools::per_element());
+    // Same as single searches
+    for(unsigned i = 0; i < goals.size(); i++)
+    {
+        if(i == 2)
+            continue;
+        unsigned length;
+        const bool pathFound = pathFinder.FindPath(*goals[2], *goals[i], false, noPath, nullptr, &length);
+        BOOST_TEST(pathFound == (lengths[i] != noPath));
+        if(pathFound)
+            BOOST_TEST(length == lengths[i]);
+    }
+    // Limited costs
+    BOOST_TEST(pathFinder.FindPathLengths(*goals[2], goals, 4) == std::vector<unsigned>({4, 2, 0, noPath, noPath}),
+               boost::test_tools::per_element());
+    BOOST_TEST(pathFinder.FindPathLengths(*goals[4], goals)
+                 == std::vector<unsigned>({noPath, noPath, noPath, noPath, 0}),
+               boost::test_tools::per_element());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,387 @@
+// Copyright (C) 2005 - 2021 Settlers Freaks (sf-team at siedler25.org)
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "NetworkSimulation.h"
+#include "Game.h"
+#include "GameLobby.h"
+#include "GameLobbyController.h"
+#include "JoinPlayerInfo.h"
+#include "NWFInfo.h"
+#include "mapGenerator/RandomMap.h"
+#include "network/CreateServerInfo.h"
+#include "network/GameMessages.h"
+#include "gameTypes/AIInfo.h"
+#include "rttr/test/MockClock.hpp"
+#include <boost/test/unit_test.hpp>
+#include <algorithm>
+#include <numeric>
+#include <ostream>
+
+using namespace std::chrono;
+
+namespace netsim {
+
+namespace {
+    const std::string hostPw = "HostPw";
+} // namespace
+
+SimulatedLink::SimulatedLink(const LinkConfig& config, unsigned seed) : config_(config), rng_(seed)
+{
+    MemoryConnection::Pair clientConnection = MemoryConnection::createPair();
+    MemoryConnection::Pair serverConnection = MemoryConnection::createPair();
+    clientEnd_ = std::move(clientConnection.first);
+    toClient_.connection = std::move(clientConnection.second);
+    serverEnd_ = std::move(serverConnection.first);
+    toServer_.connection = std::move(serverConnection.second);
+}
+
+void SimulatedLink::setGameStarted()
+{
+    if(!gameStartTime_)
+        gameStartTime_ = Clock::now();
+}
+
+bool SimulatedLink::run()
+{
+    if(!isConnected())
+    {
+        close();
+        return false;
+    }
+    if(config_.disconnectAfter && gameStartTime_ && Clock::now() - *gameStartTime_ >= *config_.disconnectAfter)
+    {
+        close();
+        return false;
+    }
+    receive(*toClient_.connection, toServer_);
+    receive(*toServer_.connection, toClient_);
+    if(!deliver(toServer_) || !deliver(toClient_))
+    {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void SimulatedLink::close()
+{
+    toServer_.connection->close();
+    toClient_.connection->close();
+    toServer_.packets.clear();
+    toClient_.packets.clear();
+}
+
+void SimulatedLink::receive(MemoryConnection& from, Direction& dir)
+{
+    const auto now = Clock::now();
+    while(from.hasPackets())
+    {
+        Packet packet{Clock::time_point(), from.popPacket()};
+        // The message occupies the link for its transmission time, then it takes the latency to arrive
+        dir.nextSendTime = std::max(dir.nextSendTime, now);
+        if(config_.bandwidth > 0)
+        {
+            const duration<double> transmitTime(static_cast<double>(packet.packet.data.size()) / config_.bandwidth);
+            dir.nextSendTime += duration_cast<Clock::duration>(transmitTime);
+        }
+        Clock::duration delay = config_.latency;
+        if(config_.jitter > Clock::duration::zero())
+            delay += Clock::duration(std::uniform_int_distribution<Clock::rep>(0, config_.jitter.count())(rng_));
+        // Messages can't overtake each other
+        packet.deliveryTime = std::max(dir.lastDeliveryTime, dir.nextSendTime + delay);
+        dir.lastDeliveryTime = packet.deliveryTime;
+        dir.packets.push_back(std::move(packet));
+    }
+}
+
+bool SimulatedLink::deliver(Direction& dir)
+{
+    const auto now = Clock::now();
+    while(!dir.packets.empty() && dir.packets.front().deliveryTime <= now)
+    {
+        if(!dir.connection->sendPacket(std::move(dir.packets.front().packet)))
+            return false;
+        dir.packets.pop_front();
+    }
+    return true;
+}
+
+SimulatedClient::SimulatedClient(std::shared_ptr<MemoryConnection> connection, const std::string& password,
+                                 bool isHost)
+    : password_(password), isHost_(isHost)
+{
+    client_.SetInterface(this);
+    BOOST_TEST_REQUIRE(client_.ConnectLocal(std::move(connection), password_, ServerType::Direct, isHost_));
+}
+
+SimulatedClient::~SimulatedClient()
+{
+    client_.Stop();
+    client_.RemoveInterface(this);
+}
+
+void SimulatedClient::run()
+{
+    client_.Run();
+    const ClientState state = client_.GetState();
+    if(state == ClientState::Config)
+    {
+        // When rejoining the client only waits for the snapshot of the game
+        if(numRejoins_ > 0)
+            return;
+        // Set ready again when it was reset by the server
+        if(client_.GetGameLobby()->getPlayer(client_.GetPlayerId()).isReady)
+            isReadyRequested_ = false;
+        else if(!isReadyRequested_)
+        {
+            client_.Command_SetReady(true);
+            isReadyRequested_ = true;
+        }
+    } else if(state == ClientState::Loading)
+    {
+        // Done by the loading screen otherwise
+        const GameContextScope contextScope(game_.lock()->context_);
+        client_.GameLoaded();
+    } else if(state == ClientState::Game)
+    {
+        wasInGame_ = true;
+        // Done by the game interface once it is shown
+        if(!isGameStarted_)
+        {
+            const GameContextScope contextScope(game_.lock()->context_);
+            client_.OnGameStart();
+            isGameStarted_ = true;
+        }
+    }
+}
+
+void SimulatedClient::rejoin(std::shared_ptr<MemoryConnection> connection)
+{
+    RTTR_Assert(client_.GetState() == ClientState::Stopped);
+    // The client still knows its rejoin token and sends it to the server first
+    BOOST_TEST_REQUIRE(client_.ConnectLocal(std::move(connection), password_, ServerType::Direct, isHost_));
+    ++numRejoins_;
+}
+
+bool SimulatedClient::isWaitingForNWF() const
+{
+    const auto nwfInfo = client_.GetNWFInfo();
+    return isInGame() && nwfInfo && client_.GetGFNumber() == nwfInfo->getNextNWF();
+}
+
+AsyncChecksum SimulatedClient::getChecksum() const
+{
+    RTTR_Assert(isInGame());
+    return AsyncChecksum::create(*game_.lock());
+}
+
+ClientStats SimulatedClient::getStats() const
+{
+    ClientStats stats;
+    if(isInGame())
+        stats.gf = client_.GetGFNumber();
+    const FramesInfoClient& framesInfo = client_.GetFramesInfo();
+    stats.numForcePauses = framesInfo.numForcePauses;
+    stats.forcePauseTime = framesInfo.sumForcePauseLen;
+    stats.numAsyncs = numAsyncs_;
+    stats.wasDisconnected = wasInGame_ && client_.GetState() == ClientState::Stopped;
+    stats.numRejoins = numRejoins_;
+    return stats;
+}
+
+void SimulatedClient::CI_GameLoading(std::shared_ptr<Game> game)
+{
+    game_ = game;
+    isGameStarted_ = false;
+}
+
+void SimulatedClient::CI_Async(const std::string& /*checksums*/)
+{
+    ++numAsyncs_;
+}
+
+unsigned SimulationResult::getNumAsyncs() const
+{
+    return std::accumulate(clients.begin(), clients.end(), 0u,
+                           [](unsigned sum, const ClientStats& stats) { return sum + stats.numAsyncs; });
+}
+
+bool SimulationResult::isInSync() const
+{
+    return !checksums.empty()
+           && std::all_of(checksums.begin(), checksums.end(),
+                          [this](const AsyncChecksum& checksum) { return checksum == checksums.front(); });
+}
+
+std::ostream& operator<<(std::ostream& os, const SimulationResult& result)
+{
+    const auto toMs = [](Clock::duration value) { return duration_cast<milliseconds>(value).count(); };
+    os << result.numGFs << " GFs in " << toMs(result.duration) << "ms, server: " << result.serverMetrics.numNWFs
+       << " NWFs, " << result.serverMetrics.numDelayedNWFs << " delayed (" << toMs(result.serverMetrics.nwfWaitTime)
+       << "ms, max " << toMs(result.serverMetrics.maxNWFWaitTime) << "ms), " << result.serverMetrics.numBytesSent
+       << " bytes sent";
+    for(unsigned i = 0; i < result.clients.size(); i++)
+    {
+        const ClientStats& stats = result.clients[i];
+        os << "\nClient " << i << ": GF " << stats.gf << ", " << stats.numForcePauses << " forced pauses ("
+           << toMs(stats.forcePauseTime) << "ms), " << stats.numAsyncs << " asyncs";
+        if(stats.numRejoins)
+            os << ", rejoined " << stats.numRejoins << " times";
+        if(stats.wasDisconnected)
+            os << ", disconnected";
+    }
+    os << "\nGame states of " << result.checksums.size() << " clients " << (result.isInSync() ? "match" : "differ");
+    return os;
+}
+
+boost::optional<SimulationResult> runSimulation(const SimulationConfig& config, const boost::filesystem::path& tmpDir)
+{
+    // Time only advances between the iterations, so nothing depends on how long the real computations take
+    rttr::test::MockClockFixture mockClock;
+    // Start later so no time point is the default constructed one which is used for unset times
+    mockClock.currentTime = duration_cast<Clock::duration>(hours(1));
+
+    const unsigned numClients = config.links.size();
+    const boost::filesystem::path mapPath = tmpDir / "map.wld";
+    rttr::mapGenerator::MapSettings settings;
+    settings.size = MapExtent(64, 64);
+    settings.numPlayers = numClients + config.numAIs;
+    rttr::mapGenerator::CreateRandomMap(mapPath, settings);
+
+    GameServer server;
+    if(!server.Start(CreateServerInfo(ServerType::Direct, 0, "Simulation"), mapPath, MapType::OldMap, hostPw))
+        return boost::none;
+
+    std::vector<std::unique_ptr<SimulatedLink>> links;
+    std::vector<std::unique_ptr<SimulatedClient>> clients;
+    for(unsigned i = 0; i < numClients; i++)
+    {
+        links.push_back(std::make_unique<SimulatedLink>(config.links[i], config.seed + i));
+        // Players get the slots in the order they connect, so the remaining ones are for the AIs
+        BOOST_TEST_REQUIRE(server.ConnectLocal(links.back()->takeServerEnd()));
+        const bool isHost = i == 0;
+        clients.push_back(
+          std::make_unique<SimulatedClient>(links.back()->takeClientEnd(), isHost ? hostPw : "", isHost));
+    }
+    GameClient& host = clients.front()->getClient();
+
+    bool isServerRunning = true;
+    std::vector<boost::optional<Clock::time_point>> disconnectTimes(numClients);
+    const auto handleRejoins = [&]() {
+        const auto now = Clock::now();
+        for(unsigned i = 1; i < numClients; i++)
+        {
+            if(clients[i]->getClient().GetState() != ClientState::Stopped || !clients[i]->getStats().wasDisconnected)
+                continue;
+            if(!disconnectTimes[i])
+                disconnectTimes[i] = now;
+            if(now - *disconnectTimes[i] < *config.rejoinAfter)
+                continue;
+            LinkConfig linkConfig = config.links[i];
+            linkConfig.disconnectAfter.reset();
+            auto link = std::make_unique<SimulatedLink>(linkConfig, config.seed + numClients + i);
+            // Fails till the server noticed that the player is gone
+            if(!server.ConnectLocal(link->takeServerEnd()))
+                continue;
+            clients[i]->rejoin(link->takeClientEnd());
+            link->setGameStarted();
+            links[i] = std::move(link);
+            disconnectTimes[i].reset();
+        }
+    };
+    const auto runUntil = [&](auto&& condition, Clock::duration timeout) {
+        const auto endTime = Clock::now() + timeout;
+        while(Clock::now() < endTime)
+        {
+            mockClock.currentTime += config.timeStep;
+            if(isServerRunning)
+            {
+                server.Run();
+                if(config.rejoinAfter)
+                    handleRejoins();
+            }
+            for(auto& link : links)
+                link->run();
+            for(auto& client : clients)
+                client->run();
+            if(condition())
+                return true;
+        }
+        return false;
+    };
+
+    if(!runUntil([&host]() { return host.GetState() == ClientState::Config; }, seconds(30)))
+        return boost::none;
+    {
+        GameLobbyController lobbyController(host.GetGameLobby(), host.GetMainPlayer());
+        for(unsigned id = numClients; id < lobbyController.GetMaxNumPlayers(); id++)
+            lobbyController.SetPlayerState(id, PlayerState::AI, AI::Info(AI::Type::Default, AI::Level::Easy));
+        const auto isLobbyReady = [&host, numClients]() {
+            if(host.GetState() != ClientState::Config)
+                return false;
+            const GameLobby& lobby = *host.GetGameLobby();
+            for(unsigned id = 0; id < lobby.getNumPlayers(); id++)
+            {
+                const JoinPlayerInfo& player = lobby.getPlayer(id);
+                if(id < numClients ? !player.isReady : player.ps != PlayerState::AI)
+                    return false;
+            }
+            return true;
+        };
+        if(!runUntil(isLobbyReady, seconds(30)))
+            return boost::none;
+        lobbyController.StartCountdown(0);
+    }
+    const auto allInGame = [&clients]() {
+        return std::all_of(clients.begin(), clients.end(), [](const auto& client) { return client->isInGame(); });
+    };
+    if(!runUntil(allInGame, seconds(30)))
+        return boost::none;
+    const auto startTime = Clock::now();
+    for(auto& link : links)
+        link->setGameStarted();
+    // Same as changing the speed in the game
+    host.GetMainPlayer().sendMsgAsync(new GameMessage_Speed(static_cast<uint32_t>(config.gfLength.count())));
+
+    // Allow for a lot of waiting but don't hang when the game got stuck, e.g. after an async
+    const auto timeout = config.numGFs * config.gfLength * 10 + seconds(30);
+    runUntil([&server, &config]() { return server.GetCurrentGF() >= config.numGFs; }, timeout);
+
+    SimulationResult result;
+    result.numGFs = server.GetCurrentGF();
+    result.duration = Clock::now() - startTime;
+    result.serverMetrics = server.GetMetrics();
+    for(const auto& client : clients)
+        result.clients.push_back(client->getStats());
+
+    // Without the server the clients stop at the last NWF it announced, which is the same for all of them
+    isServerRunning = false;
+    const auto allAtLastNWF = [&links, &clients]() {
+        boost::optional<unsigned> gf;
+        for(unsigned i = 0; i < clients.size(); i++)
+        {
+            if(!links[i]->isIdle())
+                return false;
+            const SimulatedClient& client = *clients[i];
+            if(!client.isInGame())
+                continue;
+            if(!client.isWaitingForNWF() || (gf && *gf != client.getClient().GetGFNumber()))
+                return false;
+            gf = client.getClient().GetGFNumber();
+        }
+        return true;
+    };
+    if(runUntil(allAtLastNWF, seconds(30)))
+    {
+        for(const auto& client : clients)
+        {
+            if(client->isInGame())
+                result.checksums.push_back(client->getChecksum());
+        }
+    }
+    server.Stop();
+    return result;
+}
+
+} // namespace netsim
@@ -0,0 +1,174 @@
+// Copyright (C) 2005 - 2021 Settlers Freaks (sf-team at siedler25.org)
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "AsyncChecksum.h"
+#include "Clock.h"
+#include "network/ClientInterface.h"
+#include "network/GameClient.h"
+#include "network/GameServer.h"
+#include "network/MemoryConnection.h"
+#include <boost/filesystem/path.hpp>
+#include <boost/optional.hpp>
+#include <chrono>
+#include <deque>
+#include <iosfwd>
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+class Game;
+
+/// Network games simulated in this process. The server, the clients and the links all use the global Clock,
+/// which is advanced by a fixed step per iteration instead of following the wall clock.
+/// So the outcome of a run only depends on its configuration and not on the speed or load of the machine
+namespace netsim {
+
+/// Conditions of the connection between a client and the server (each direction)
+struct LinkConfig
+{
+    /// Minimum time a message takes
+    Clock::duration latency = Clock::duration::zero();
+    /// Additional delay chosen uniformly from [0, jitter] for each message. The order is kept as with TCP
+    Clock::duration jitter = Clock::duration::zero();
+    /// Bytes per second, 0 for unlimited
+    unsigned bandwidth = 0;
+    /// Cut the connection after this time since the game was started
+    boost::optional<Clock::duration> disconnectAfter;
+};
+
+/// In-memory connection between a client and the server which delivers the messages according to the link config.
+/// The random delays are taken from a seeded generator so a run can be repeated with the same conditions
+class SimulatedLink
+{
+public:
+    SimulatedLink(const LinkConfig& config, unsigned seed);
+    /// Ends to be used by the client and the server. The link does not keep them, so each can be taken only once
+    std::shared_ptr<MemoryConnection> takeClientEnd() { return std::move(clientEnd_); }
+    std::shared_ptr<MemoryConnection> takeServerEnd() { return std::move(serverEnd_); }
+    /// Start counting the time till the link is cut (if configured)
+    void setGameStarted();
+    /// Forward due messages. Return false when the link is closed
+    bool run();
+    bool isConnected() const { return toClient_.connection->isConnected() && toServer_.connection->isConnected(); }
+    /// True if no messages are on the way
+    bool isIdle() const { return toClient_.packets.empty() && toServer_.packets.empty(); }
+
+private:
+    struct Packet
+    {
+        Clock::time_point deliveryTime;
+        MemoryConnection::Packet packet;
+    };
+    struct Direction
+    {
+        /// Link end messages are delivered to
+        std::shared_ptr<MemoryConnection> connection;
+        std::deque<Packet> packets;
+        /// Time at which the link is free to send the next message (bandwidth limit) and of the last delivery
+        Clock::time_point nextSendTime, lastDeliveryTime;
+    };
+
+    void close();
+    void receive(MemoryConnection& from, Direction& dir);
+    bool deliver(Direction& dir);
+
+    LinkConfig config_;
+    std::shared_ptr<MemoryConnection> clientEnd_, serverEnd_;
+    Direction toServer_, toClient_;
+    boost::optional<Clock::time_point> gameStartTime_;
+    std::mt19937 rng_;
+};
+
+/// Statistics collected from a simulated client
+struct ClientStats
+{
+    /// Current GF of the client, 0 if it is not in the game (anymore)
+    unsigned gf = 0;
+    /// Pauses forced at NWFs for which the commands were missing (see FramesInfoClient) and their total length
+    unsigned numForcePauses = 0;
+    Clock::duration forcePauseTime{};
+    /// Number of asyncs the server reported
+    unsigned numAsyncs = 0;
+    /// Lost the connection and was not in the game at the end
+    bool wasDisconnected = false;
+    /// Number of times the client joined the running game again
+    unsigned numRejoins = 0;
+};
+
+/// A GameClient which is run headless. Does what the GUI does otherwise: Set the player ready and start the game
+/// once it is loaded
+class SimulatedClient : public ClientInterface
+{
+public:
+    SimulatedClient(std::shared_ptr<MemoryConnection> connection, const std::string& password, bool isHost);
+    ~SimulatedClient() override;
+
+    void run();
+    /// Connect to the running game again after the connection was lost
+    void rejoin(std::shared_ptr<MemoryConnection> connection);
+    GameClient& getClient() { return client_; }
+    const GameClient& getClient() const { return client_; }
+    bool isInGame() const { return client_.GetState() == ClientState::Game && !client_.IsCatchingUp(); }
+    /// Is the client at a NWF it can't execute, i.e. no further GFs can be run without new messages
+    bool isWaitingForNWF() const;
+    /// Checksum of the current state of the game. Only valid if in game
+    AsyncChecksum getChecksum() const;
+    ClientStats getStats() const;
+
+private:
+    void CI_GameLoading(std::shared_ptr<Game> game) override;
+    void CI_Async(const std::string& checksums) override;
+
+    GameClient client_;
+    std::string password_;
+    bool isHost_;
+    std::weak_ptr<Game> game_;
+    bool isGameStarted_ = false, isReadyRequested_ = false, wasInGame_ = false;
+    unsigned numAsyncs_ = 0, numRejoins_ = 0;
+};
+
+struct SimulationConfig
+{
+    /// One link per client. The first client is the host
+    std::vector<LinkConfig> links;
+    /// Number of additional AI players run by the host
+    unsigned numAIs = 1;
+    /// Length of a GF during the game
+    std::chrono::milliseconds gfLength{5};
+    /// Stop after this number of GFs executed by the server
+    unsigned numGFs = 2000;
+    /// Let clients which lost their connection rejoin the game after this time via a new link without disconnect
+    boost::optional<Clock::duration> rejoinAfter;
+    /// Simulated time passing per iteration in which the server, all links and all clients run once
+    std::chrono::microseconds timeStep{500};
+    unsigned seed = 42;
+};
+
+struct SimulationResult
+{
+    /// GFs executed by the server
+    unsigned numGFs = 0;
+    /// Simulated time the game ran
+    Clock::duration duration{};
+    GameServer::Metrics serverMetrics;
+    std::vector<ClientStats> clients;
+    /// Checksums of the games of the clients still connected at the end, all taken at the same GF
+    std::vector<AsyncChecksum> checksums;
+
+    unsigned getNumAsyncs() const;
+    /// True if all clients still connected at the end have the same game state
+    bool isInSync() const;
+};
+std::ostream& operator<<(std::ostream& os, const SimulationResult& result);
+
+/// Run a game on a random map with a GameServer and GameClients connected via the simulated links in this process.
+/// At the end the server is stopped and the clients run till they reach the last announced NWF to compare their state.
+/// Returns boost::none if the game could not be started or did not finish in time
+boost::optional<SimulationResult> runSimulation(const SimulationConfig& config, const boost::filesystem::path& tmpDir);
+
+} // namespace netsim
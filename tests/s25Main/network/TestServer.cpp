@@ -4,6 +4,7 @@
 
 #include "TestServer.h"
 #include "RTTR_Assert.h"
+#include "network/SocketUtils.h"
 #include "s25util/Message.h"
 #include "s25util/SocketSet.h"
 
@@ -76,3 +77,8 @@ bool TestServer::listen(int16_t port)
 {
     return socket.Listen(port, false, false);
 }
+
+uint16_t TestServer::getPort() const
+{
+    return getLocalPort(socket);
+}
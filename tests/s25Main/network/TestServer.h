@@ -22,6 +22,8 @@ class TestServer
 public:
     virtual ~TestServer() = default;
     bool listen(int16_t port);
+    /// Port listened on, e.g. the one chosen by the OS when listening on port 0
+    uint16_t getPort() const;
     bool run(bool waitForConnection = false);
     bool stop();
     virtual void handleMessages() {}
@@ -0,0 +1,256 @@
+// Copyright (C) 2005 - 2021 Settlers Freaks (sf-team at siedler25.org)
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "TestServer.h"
+#include "factories/GameCommandFactory.h"
+#include "network/GameMessage_GameCommand.h"
+#include "network/SerializedGameMessage.h"
+#include "s25util/Serializer.h"
+#include <boost/test/unit_test.hpp>
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+namespace {
+constexpr unsigned numPlayers = 4;
+
+struct CmdCreator : GameCommandFactory
+{
+    std::vector<gc::GameCommandPtr> gcs;
+
+protected:
+    bool AddGC(gc::GameCommandPtr gc) override
+    {
+        gcs.push_back(gc);
+        return true;
+    }
+};
+
+/// Commands of all players for some NWFs. Most NWFs contain no commands as in a real game
+std::vector<std::vector<PlayerGameCommands>> createCmds(unsigned numNWFs)
+{
+    std::vector<std::vector<PlayerGameCommands>> result(numNWFs);
+    for(unsigned nwf = 0; nwf < numNWFs; nwf++)
+    {
+        const AsyncChecksum checksum(nwf * 1337u, 1000 + nwf, 2000 + nwf, 3000 + nwf, 4000 + nwf);
+        for(unsigned player = 0; player < numPlayers; player++)
+        {
+            CmdCreator creator;
+            if((nwf + player) % 5 == 0)
+            {
+                const MapPoint pt(10 + player, nwf % 64);
+                creator.SetFlag(pt);
+                creator.BuildRoad(pt, false, {Direction::East, Direction::SouthEast, Direction::East});
+            }
+            result[nwf].emplace_back(checksum, std::move(creator.gcs));
+        }
+    }
+    return result;
+}
+
+GameMessage_GameCommand createBatchMsg(const std::vector<PlayerGameCommands>& cmds)
+{
+    std::vector<GameMessage_GameCommand::PlayerCmds> playerCmds;
+    for(unsigned player = 0; player < cmds.size(); player++)
+        playerCmds.push_back({static_cast<uint8_t>(player), cmds[player]});
+    return GameMessage_GameCommand(std::move(playerCmds));
+}
+
+unsigned getSerializedSize(const Message& msg)
+{
+    Serializer ser;
+    msg.Serialize(ser);
+    return ser.GetLength();
+}
+
+bool isSameSerialization(const Message& lhs, const Message& rhs)
+{
+    Serializer serLhs, serRhs;
+    lhs.Serialize(serLhs);
+    rhs.Serialize(serRhs);
+    return serLhs.GetLength() == serRhs.GetLength()
+           && std::equal(serLhs.GetData(), serLhs.GetData() + serLhs.GetLength(), serRhs.GetData());
+}
+
+struct GameMsgServer : TestServer
+{
+    Connection acceptConnection(unsigned /*id*/, const Socket& so) override
+    {
+        return Connection(GameMessage::create_game, so);
+    }
+};
+} // namespace
+
+BOOST_AUTO_TEST_CASE(GameCommandMsgSerialization)
+{
+    const auto cmds = createCmds(10);
+    for(const std::vector<PlayerGameCommands>& nwfCmds : cmds)
+    {
+        const GameMessage_GameCommand msg = createBatchMsg(nwfCmds);
+        Serializer ser;
+        msg.Serialize(ser);
+        GameMessage_GameCommand readMsg;
+        readMsg.Deserialize(ser);
+        BOOST_TEST(ser.GetBytesLeft() == 0u);
+        BOOST_TEST_REQUIRE(readMsg.playerCmds.size() == numPlayers);
+        for(unsigned player = 0; player < numPlayers; player++)
+        {
+            BOOST_TEST(readMsg.playerCmds[player].player == player);
+            BOOST_TEST(readMsg.playerCmds[player].cmds.checksum == nwfCmds[player].checksum);
+            BOOST_TEST(readMsg.playerCmds[player].cmds.gcs.size() == nwfCmds[player].gcs.size());
+        }
+        BOOST_TEST(isSameSerialization(readMsg, msg));
+    }
+    // Differing checksums are kept
+    auto nwfCmds = cmds.front();
+    nwfCmds[2].checksum.objCt++;
+    GameMessage_GameCommand msg = createBatchMsg(nwfCmds);
+    Serializer ser;
+    msg.Serialize(ser);
+    GameMessage_GameCommand readMsg;
+    readMsg.Deserialize(ser);
+    BOOST_TEST(readMsg.playerCmds[1].cmds.checksum == nwfCmds[1].checksum);
+    BOOST_TEST(readMsg.playerCmds[2].cmds.checksum == nwfCmds[2].checksum);
+}
+
+BOOST_AUTO_TEST_CASE(ForwardedGameCommandsAreNotDeserialized)
+{
+    const auto cmds = createCmds(10);
+    for(const std::vector<PlayerGameCommands>& nwfCmds : cmds)
+    {
+        const GameMessage_GameCommand msg = createBatchMsg(nwfCmds);
+        Serializer ser;
+        msg.Serialize(ser);
+        std::unique_ptr<Message> readMsg(GameMessage::create_forwarding(msg.getId()));
+        auto* cmdMsg = dynamic_cast<GameMessage_GameCommand*>(readMsg.get());
+        BOOST_TEST_REQUIRE(cmdMsg);
+        cmdMsg->Deserialize(ser);
+        BOOST_TEST(ser.GetBytesLeft() == 0u);
+        BOOST_TEST_REQUIRE(cmdMsg->playerCmds.size() == numPlayers);
+        for(unsigned player = 0; player < numPlayers; player++)
+        {
+            const PlayerGameCommands& readCmds = cmdMsg->playerCmds[player].cmds;
+            BOOST_TEST(readCmds.checksum == nwfCmds[player].checksum);
+            BOOST_TEST(readCmds.gcs.empty());
+            BOOST_TEST(readCmds.getNumGCs() == nwfCmds[player].gcs.size());
+        }
+        // Forwarded as received
+        BOOST_TEST(isSameSerialization(*cmdMsg, msg));
+        // Replay format is the same too
+        Serializer serOrig, serForwarded;
+        nwfCmds[1].Serialize(serOrig);
+        cmdMsg->playerCmds[1].cmds.Serialize(serForwarded);
+        BOOST_TEST(serOrig.GetLength() == serForwarded.GetLength());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(InvalidForwardedGameCommandsAreRejected)
+{
+    const auto cmds = createCmds(1);
+    const PlayerGameCommands& validCmds = cmds.front().front();
+    BOOST_TEST_REQUIRE(validCmds.gcs.size() == 2u);
+    Serializer gcSer;
+    validCmds.SerializeGCs(gcSer);
+    const std::vector<char> validData(gcSer.GetData(), gcSer.GetData() + gcSer.GetLength());
+
+    const auto readForwarded = [](const std::vector<char>& data, unsigned numGCs) {
+        PlayerGameCommands cmds;
+        cmds.serializedGCs = std::make_shared<std::vector<char>>(data);
+        cmds.numSerializedGCs = numGCs;
+        const GameMessage_GameCommand msg(std::vector<GameMessage_GameCommand::PlayerCmds>{{0, cmds}});
+        Serializer ser;
+        msg.Serialize(ser);
+        std::unique_ptr<Message> readMsg(GameMessage::create_forwarding(msg.getId()));
+        readMsg->Deserialize(ser);
+    };
+    BOOST_CHECK_NO_THROW(readForwarded(validData, 2));
+    // Count does not match the data
+    BOOST_CHECK_THROW(readForwarded(validData, 1), std::exception);
+    BOOST_CHECK_THROW(readForwarded(validData, 3), std::exception);
+    BOOST_CHECK_THROW(readForwarded(validData, 1000000), std::exception);
+    // Truncated command
+    BOOST_CHECK_THROW(readForwarded(std::vector<char>(validData.begin(), validData.end() - 1), 2), std::exception);
+    // Invalid type
+    std::vector<char> invalidData = validData;
+    invalidData.front() = static_cast<char>(0xFF);
+    BOOST_CHECK_THROW(readForwarded(invalidData, 2), std::exception);
+}
+
+BOOST_AUTO_TEST_CASE(SerializedMsgIsSentAsOriginal)
+{
+    const GameMessage_GameCommand msg = createBatchMsg(createCmds(1).front());
+    const SerializedGameMessage serializedMsg(msg);
+    BOOST_TEST(serializedMsg.getId() == msg.getId());
+    BOOST_TEST(serializedMsg.getSize() == getSerializedSize(msg));
+    BOOST_TEST(isSameSerialization(serializedMsg, msg));
+    // Copies share the data
+    const SerializedGameMessage copiedMsg(serializedMsg);
+    BOOST_TEST(isSameSerialization(copiedMsg, msg));
+    // A clone is created from the id and deserialized, so it is the original message which can be run
+    const std::unique_ptr<Message> clonedMsg(serializedMsg.clone());
+    const auto* clonedCmdMsg = dynamic_cast<const GameMessage_GameCommand*>(clonedMsg.get());
+    BOOST_TEST_REQUIRE(clonedCmdMsg);
+    BOOST_TEST(isSameSerialization(*clonedCmdMsg, msg));
+    BOOST_TEST(clonedCmdMsg->playerCmds.size() == msg.playerCmds.size());
+}
+
+BOOST_AUTO_TEST_CASE(BatchedGameCommandsUseLessBandwidth)
+{
+    constexpr unsigned numNWFs = 200;
+    const auto cmds = createCmds(numNWFs);
+
+    unsigned oldNumMsgs = 0, oldNumBytes = 0, newNumMsgs = 0, newNumBytes = 0;
+    for(const std::vector<PlayerGameCommands>& nwfCmds : cmds)
+    {
+        // Old protocol: 1 message per player with a player byte and fixed size fields, relayed to all players
+        for(const PlayerGameCommands& playerCmds : nwfCmds)
+        {
+            Serializer ser;
+            ser.PushUnsignedChar(0);
+            playerCmds.Serialize(ser);
+            oldNumMsgs += numPlayers;
+            oldNumBytes += ser.GetLength() * numPlayers;
+        }
+        // New protocol: 1 message with all players relayed to all players
+        newNumMsgs += numPlayers;
+        newNumBytes += getSerializedSize(createBatchMsg(nwfCmds)) * numPlayers;
+    }
+    BOOST_TEST_MESSAGE("Relayed game commands for " << numNWFs << " NWFs and " << numPlayers
+                                                    << " players: " << oldNumMsgs << " msgs/" << oldNumBytes
+                                                    << " bytes before, " << newNumMsgs << " msgs/" << newNumBytes
+                                                    << " bytes now");
+    BOOST_TEST(newNumMsgs * numPlayers == oldNumMsgs);
+    BOOST_TEST(newNumBytes * 2 < oldNumBytes);
+}
+
+BOOST_AUTO_TEST_CASE(BatchedGameCommandsOverLoopback)
+{
+    GameMsgServer server;
+    BOOST_TEST_REQUIRE(server.listen(0));
+    const uint16_t port = server.getPort();
+    BOOST_TEST_REQUIRE(port != 0u);
+    Connection client(GameMessage::create_game);
+    BOOST_TEST_REQUIRE(client.so.Connect("localhost", port, false));
+    BOOST_TEST_REQUIRE(server.run(true));
+    BOOST_TEST_REQUIRE(server.connections.size() == 1u);
+
+    const auto cmds = createCmds(50);
+    for(const std::vector<PlayerGameCommands>& nwfCmds : cmds)
+        client.sendQueue.push(new GameMessage_GameCommand(createBatchMsg(nwfCmds)));
+    client.sendQueue.send(client.so, -1);
+
+    MessageQueue& recvQueue = server.connections.front().recvQueue;
+    const auto endTime = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while(recvQueue.size() < cmds.size() && std::chrono::steady_clock::now() < endTime)
+        BOOST_TEST_REQUIRE(server.run());
+    BOOST_TEST_REQUIRE(recvQueue.size() == cmds.size());
+    for(const std::vector<PlayerGameCommands>& nwfCmds : cmds)
+    {
+        std::unique_ptr<Message> msg(recvQueue.popFront());
+        const auto* cmdMsg = dynamic_cast<const GameMessage_GameCommand*>(msg.get());
+        BOOST_TEST_REQUIRE(cmdMsg);
+        BOOST_TEST(isSameSerialization(*cmdMsg, createBatchMsg(nwfCmds)));
+    }
+}
@@ -0,0 +1,516 @@
+// Copyright (C) 2005 - 2021 Settlers Freaks (sf-team at siedler25.org)
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "FileChecksum.h"
+#include "RTTR_Version.h"
+#include "TestServer.h"
+#include "helpers/containerUtils.h"
+#include "helpers/mathFuncs.h"
+#include "mapGenerator/RandomMap.h"
+#include "network/CreateServerInfo.h"
+#include "network/GameMessage_Chat.h"
+#include "network/GameMessage_GameCommand.h"
+#include "network/GameMessages.h"
+#include "network/GameServer.h"
+#include "network/SocketUtils.h"
+#include "gameTypes/CompressedData.h"
+#include "rttr/test/TmpFolder.hpp"
+#include "s25util/SocketSet.h"
+#include <boost/optional.hpp>
+#include <boost/test/unit_test.hpp>
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace std::chrono;
+
+namespace {
+constexpr unsigned numClients = 4;
+const std::string hostPw = "HostPw";
+
+/// Snapshot sent by the clients on a resync. Random data doesn't compress, so it is sent in multiple parts
+std::vector<char> createSnapshotData()
+{
+    std::mt19937 rng(42);
+    std::vector<char> data(3 * MAP_PART_SIZE + 42);
+    for(char& c : data)
+        c = static_cast<char>(rng());
+    return data;
+}
+
+const std::vector<char> snapshotData = createSnapshotData();
+const std::vector<char> snapshot = CompressedData::compress(snapshotData);
+const unsigned snapshotChecksum = CalcChecksumOfBuffer(snapshotData);
+
+/// Simulated client which counts the received chat messages.
+/// Ingame it sends empty commands for every NWF as if it would execute it right away
+struct TestClient : Connection
+{
+    std::vector<std::string> receivedChats;
+    bool isInGame = false, isCatchingUp = false;
+    /// True for the host which runs the AI of kicked players
+    bool runsAI = false;
+    /// AI players this client sends commands for
+    std::vector<uint8_t> aiPlayers;
+    /// Number of NWFs executed
+    unsigned numNWFs = 0;
+    /// Players joined during the game
+    std::vector<uint8_t> newPlayers;
+    /// Map (or snapshot) as announced by the server
+    std::unique_ptr<GameMessage_Map_Info> mapInfo;
+    /// Received map data. Can be prefilled to resume an interrupted transfer
+    std::vector<char> mapData;
+    /// Number of received parts, offset of the first received part
+    unsigned numMapParts = 0, firstMapOffset = 0;
+    /// Acknowledge received map data
+    bool sendsMapAcks = true;
+    /// Id assigned by the server
+    boost::optional<unsigned> playerId;
+    /// Token received on game start
+    std::string rejoinToken;
+    /// Compressed size announced for snapshots instead of the real one
+    boost::optional<uint32_t> announcedSnapshotSize;
+
+    explicit TestClient(Socket socket) : Connection(GameMessage::create_game, std::move(socket)) {}
+
+    void run()
+    {
+        if(!so.isValid())
+            return;
+        SocketSet set;
+        set.Add(so);
+        // Closed by the server, e.g. when it rejected us
+        if(set.Select(0, 0) > 0 && recvQueue.recvAll(so) < 0)
+            so.Close();
+        while(!recvQueue.empty())
+        {
+            std::unique_ptr<Message> msg(recvQueue.popFront());
+            if(const auto* chatMsg = dynamic_cast<const GameMessage_Chat*>(msg.get()))
+                receivedChats.push_back(chatMsg->text);
+            else if(const auto* idMsg = dynamic_cast<const GameMessage_Player_Id*>(msg.get()))
+                playerId = idMsg->player;
+            else if(const auto* tokenMsg = dynamic_cast<const GameMessage_RejoinToken*>(msg.get()))
+                rejoinToken = tokenMsg->token;
+            else if(dynamic_cast<const GameMessage_Server_Start*>(msg.get()))
+            {
+                // Game loaded
+                isInGame = true;
+                sendQueue.push(new GameMessage_GameCommand(0xFF, AsyncChecksum(), {}));
+            } else if(dynamic_cast<const GameMessage_Server_NWFDone*>(msg.get()))
+                executeNWF();
+            else if(const auto* kickMsg = dynamic_cast<const GameMessage_Player_Kicked*>(msg.get()))
+            {
+                if(runsAI)
+                {
+                    aiPlayers.push_back(kickMsg->player);
+                    sendQueue.push(new GameMessage_GameCommand(kickMsg->player, AsyncChecksum(), {}));
+                }
+            } else if(const auto* newMsg = dynamic_cast<const GameMessage_Player_New*>(msg.get()))
+            {
+                newPlayers.push_back(newMsg->player);
+                helpers::erase(aiPlayers, newMsg->player);
+            } else if(const auto* requestMsg = dynamic_cast<const GameMessage_ResyncRequest*>(msg.get()))
+            {
+                const unsigned snapshotSize =
+                  announcedSnapshotSize ? *announcedSnapshotSize : static_cast<unsigned>(snapshot.size());
+                sendQueue.push(new GameMessage_Resync_Info(requestMsg->nwf, snapshotChecksum, snapshotData.size(),
+                                                           snapshotSize, UsedPRNG()));
+                for(unsigned curPos = 0; curPos < snapshot.size(); curPos += MAP_PART_SIZE)
+                {
+                    const unsigned chunkSize = std::min<unsigned>(MAP_PART_SIZE, snapshot.size() - curPos);
+                    sendQueue.push(new GameMessage_Map_Data(true, curPos, &snapshot[curPos], chunkSize));
+                }
+            } else if(const auto* infoMsg = dynamic_cast<const GameMessage_Map_Info*>(msg.get()))
+            {
+                mapInfo = std::make_unique<GameMessage_Map_Info>(*infoMsg);
+                sendQueue.push(new GameMessage_MapRequest(false, mapData.size()));
+            } else if(const auto* dataMsg = dynamic_cast<const GameMessage_Map_Data*>(msg.get()))
+            {
+                BOOST_TEST_REQUIRE(dataMsg->isMapData);
+                BOOST_TEST_REQUIRE(dataMsg->offset == mapData.size());
+                if(numMapParts++ == 0)
+                    firstMapOffset = dataMsg->offset;
+                mapData.insert(mapData.end(), dataMsg->data.begin(), dataMsg->data.end());
+                if(mapData.size() == mapInfo->mapCompressedLen)
+                {
+                    const auto checksum = CalcChecksumOfBuffer(CompressedData::decompress(mapData, mapInfo->mapLen));
+                    sendQueue.push(new GameMessage_Map_Checksum(checksum, 0));
+                } else if(sendsMapAcks && numMapParts % MAP_ACK_INTERVAL == 0)
+                    sendQueue.push(new GameMessage_Map_DataAck(mapData.size()));
+            } else if(const auto* resyncMsg = dynamic_cast<const GameMessage_Server_Resync*>(msg.get()))
+            {
+                numNWFs = resyncMsg->numNWFs;
+                isCatchingUp = true;
+            }
+        }
+        // Executes all received NWFs at once
+        if(isCatchingUp)
+        {
+            isCatchingUp = false;
+            isInGame = true;
+            sendQueue.push(new GameMessage_ResyncDone(numNWFs));
+        }
+        if(so.isValid())
+            sendQueue.send(so, -1);
+    }
+
+    void executeNWF()
+    {
+        ++numNWFs;
+        if(!isInGame)
+            return;
+        std::vector<GameMessage_GameCommand::PlayerCmds> playerCmds;
+        for(uint8_t player : aiPlayers)
+            playerCmds.push_back({player, PlayerGameCommands()});
+        playerCmds.push_back({0xFF, PlayerGameCommands()});
+        sendQueue.push(new GameMessage_GameCommand(std::move(playerCmds)));
+    }
+};
+
+struct GameServerFixture
+{
+    rttr::test::TmpFolder tmpFolder;
+    boost::filesystem::path mapPath;
+    GameServer server;
+    /// Port chosen by the OS
+    uint16_t serverPort = 0;
+    std::vector<TestClient> clients;
+    /// Number of Run calls of the server in the last call to runUntil
+    unsigned numServerRuns = 0;
+
+    explicit GameServerFixture(const MapExtent& mapSize = MapExtent(64, 64)) : mapPath(tmpFolder.get() / "map.wld")
+    {
+        rttr::mapGenerator::MapSettings settings;
+        settings.size = mapSize;
+        settings.numPlayers = numClients;
+        rttr::mapGenerator::CreateRandomMap(mapPath, settings);
+        BOOST_TEST_REQUIRE(
+          server.Start(CreateServerInfo(ServerType::Direct, 0, "Test"), mapPath, MapType::OldMap, hostPw));
+        serverPort = server.GetPort();
+        BOOST_TEST_REQUIRE(serverPort != 0u);
+    }
+
+    /// Run server and clients till the condition is met. Return false on timeout
+    template<class T_Pred>
+    bool runUntil(T_Pred&& condition)
+    {
+        numServerRuns = 0;
+        const auto endTime = steady_clock::now() + seconds(10);
+        while(steady_clock::now() < endTime)
+        {
+            server.WaitForEvents(milliseconds(10));
+            server.Run();
+            ++numServerRuns;
+            for(TestClient& client : clients)
+                client.run();
+            if(condition())
+                return true;
+        }
+        return false;
+    }
+
+    /// Connect all clients and let them join the game
+    void joinClients()
+    {
+        CompressedData mapData;
+        unsigned mapChecksum;
+        BOOST_TEST_REQUIRE(mapData.CompressFromFile(mapPath, &mapChecksum));
+        for(unsigned i = 0; i < numClients; i++)
+        {
+            Socket socket;
+            BOOST_TEST_REQUIRE(socket.Connect("localhost", serverPort, false));
+            clients.emplace_back(socket);
+            TestClient& client = clients.back();
+            client.sendQueue.push(new GameMessage_Server_Type(ServerType::Direct, rttr::version::GetRevision()));
+            client.sendQueue.push(new GameMessage_Server_Password(i == 0 ? hostPw : ""));
+            client.sendQueue.push(new GameMessage_Map_Checksum(mapChecksum, 0));
+        }
+        BOOST_TEST_REQUIRE(runUntil([this]() { return server.GetNumFilledSlots() == numClients; }));
+    }
+
+    /// Let all clients join and start the game
+    void startGame()
+    {
+        joinClients();
+        for(TestClient& client : clients)
+            client.sendQueue.push(new GameMessage_Player_Ready(GameMessageWithPlayer::NO_PLAYER_ID, true));
+        clients.front().runsAI = true;
+        clients.front().sendQueue.push(new GameMessage_Countdown(0));
+        BOOST_TEST_REQUIRE(runUntil([this]() { return server.IsInGame(); }));
+    }
+
+    /// Connect to the running game with the token of a dropped player
+    TestClient& reconnectClient(const std::string& rejoinToken)
+    {
+        Socket socket;
+        BOOST_TEST_REQUIRE(socket.Connect("localhost", serverPort, false));
+        clients.emplace_back(socket);
+        TestClient& client = clients.back();
+        client.sendQueue.push(new GameMessage_RejoinToken(rejoinToken));
+        return client;
+    }
+
+    bool allClientsReceived(unsigned numChats) const
+    {
+        return std::all_of(clients.begin(), clients.end(),
+                           [numChats](const TestClient& client) { return client.receivedChats.size() >= numChats; });
+    }
+};
+/// Map which needs many parts to be sent
+struct LargeMapFixture : GameServerFixture
+{
+    LargeMapFixture() : GameServerFixture(MapExtent(256, 256)) {}
+
+    TestClient& connectClient()
+    {
+        Socket socket;
+        BOOST_TEST_REQUIRE(socket.Connect("localhost", serverPort, false));
+        clients.emplace_back(socket);
+        TestClient& client = clients.back();
+        client.sendQueue.push(new GameMessage_Server_Type(ServerType::Direct, rttr::version::GetRevision()));
+        client.sendQueue.push(new GameMessage_Server_Password(""));
+        return client;
+    }
+};
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(GameServerTests, GameServerFixture)
+
+BOOST_AUTO_TEST_CASE(ServerWakesUpOnConnection)
+{
+    // Nothing happens -> Nothing to do after waiting
+    server.WaitForEvents(milliseconds(10));
+    server.Run();
+    BOOST_TEST(server.GetNumFilledSlots() == 0u);
+
+    // A new connection wakes the server up. Otherwise this would block till the test times out
+    Socket socket;
+    BOOST_TEST_REQUIRE(socket.Connect("localhost", serverPort, false));
+    server.WaitForEvents(hours(1));
+    // and is accepted by the next run which sends the player id
+    server.Run();
+    SocketSet set;
+    set.Add(socket);
+    BOOST_TEST(set.Select(10000, 0) > 0);
+}
+
+BOOST_AUTO_TEST_CASE(PollSetReportsSocketState)
+{
+    Socket socket;
+    BOOST_TEST_REQUIRE(socket.Connect("localhost", serverPort, false));
+    SocketPollSet set;
+    BOOST_TEST(set.Add(socket, true) == 0u);
+    // Nothing received yet but data can be sent
+    BOOST_TEST(set.Poll(10000) > 0);
+    BOOST_TEST(set.IsWritable(0));
+    BOOST_TEST(!set.IsReadable(0));
+    BOOST_TEST(!set.HasError(0));
+
+    // The server sends the player id after accepting the connection
+    server.WaitForEvents(hours(1));
+    server.Run();
+    set.Clear();
+    BOOST_TEST(set.Add(socket) == 0u);
+    BOOST_TEST(set.Poll(10000) > 0);
+    BOOST_TEST(set.IsReadable(0));
+}
+
+BOOST_AUTO_TEST_CASE(RelayedMessagesAreSentAtOnce)
+{
+    joinClients();
+    for(TestClient& client : clients)
+        client.receivedChats.clear();
+
+    // Many more messages than were sent per run before
+    constexpr unsigned numMsgs = 100;
+    const uint64_t numMsgsSent = server.GetMetrics().numMsgsSent;
+    for(unsigned i = 0; i < numMsgs; i++)
+        clients[1].sendQueue.push(new GameMessage_Chat(GameMessageWithPlayer::NO_PLAYER_ID, ChatDestination::All,
+                                                       std::to_string(i)));
+    BOOST_TEST_REQUIRE(runUntil([this]() { return allClientsReceived(numMsgs); }));
+    BOOST_TEST_MESSAGE("Relayed " << numMsgs << " messages in " << numServerRuns << " server runs");
+    // Each message was sent to every client (plus maybe ping results)
+    BOOST_TEST(server.GetMetrics().numMsgsSent >= numMsgsSent + static_cast<uint64_t>(numMsgs) * numClients);
+    for(const TestClient& client : clients)
+    {
+        BOOST_TEST_REQUIRE(client.receivedChats.size() == numMsgs);
+        for(unsigned i = 0; i < numMsgs; i++)
+            BOOST_TEST(client.receivedChats[i] == std::to_string(i));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(MeasureRelayLatency)
+{
+    joinClients();
+    for(TestClient& client : clients)
+        client.receivedChats.clear();
+
+    constexpr unsigned numRounds = 50;
+    steady_clock::duration totalLatency{}, maxLatency{};
+    for(unsigned i = 0; i < numRounds; i++)
+    {
+        TestClient& sender = clients[i % clients.size()];
+        sender.sendQueue.push(
+          new GameMessage_Chat(GameMessageWithPlayer::NO_PLAYER_ID, ChatDestination::All, std::to_string(i)));
+        const auto sendTime = steady_clock::now();
+        sender.sendQueue.send(sender.so, -1);
+        BOOST_TEST_REQUIRE(runUntil([this, i]() { return allClientsReceived(i + 1); }));
+        const auto latency = steady_clock::now() - sendTime;
+        totalLatency += latency;
+        maxLatency = std::max(maxLatency, latency);
+        // Relayed before the next message is sent
+        for(const TestClient& client : clients)
+            BOOST_TEST(client.receivedChats.back() == std::to_string(i));
+    }
+    // Latencies depend on the machine, so they are only reported
+    const auto avgLatency = duration_cast<microseconds>(totalLatency / numRounds);
+    BOOST_TEST_MESSAGE("Relay latency with " << numClients << " clients: avg " << avgLatency.count() << "us, max "
+                                             << duration_cast<microseconds>(maxLatency).count() << "us");
+}
+
+BOOST_AUTO_TEST_CASE(DroppedPlayerRejoins)
+{
+    startGame();
+    BOOST_TEST_REQUIRE(runUntil([this]() { return server.GetCurrentGF() >= 20u; }));
+
+    // Player loses the connection and is replaced by an AI run by the host
+    const uint8_t droppedPlayer = numClients - 1;
+    const std::string rejoinToken = clients.back().rejoinToken;
+    BOOST_TEST_REQUIRE(!rejoinToken.empty());
+    clients.pop_back();
+    BOOST_TEST_REQUIRE(runUntil([this]() { return !clients.front().aiPlayers.empty(); }));
+    BOOST_TEST(clients.front().aiPlayers == std::vector<uint8_t>{droppedPlayer});
+    unsigned curGF = server.GetCurrentGF();
+    BOOST_TEST_REQUIRE(runUntil([this, curGF]() { return server.GetCurrentGF() >= curGF + 10; }));
+
+    // Reconnect and receive the snapshot taken by another player
+    TestClient& rejoiner = reconnectClient(rejoinToken);
+    rejoiner.sendQueue.push(new GameMessage_Server_Type(ServerType::Direct, rttr::version::GetRevision()));
+    rejoiner.sendQueue.push(new GameMessage_Server_Password(""));
+    rejoiner.sendQueue.push(new GameMessage_Player_Name(GameMessageWithPlayer::NO_PLAYER_ID, "Rejoiner"));
+    rejoiner.sendQueue.push(new GameMessage_MapRequest(true));
+    // Everyone is notified when the player took over from the AI
+    BOOST_TEST_REQUIRE(runUntil([this, droppedPlayer]() {
+        return std::all_of(clients.begin(), clients.end(), [droppedPlayer](const TestClient& client) {
+            return client.newPlayers == std::vector<uint8_t>{droppedPlayer};
+        });
+    }));
+    BOOST_TEST(clients.back().mapInfo->mt == MapType::Savegame);
+    BOOST_TEST(clients.back().mapData == snapshot);
+    BOOST_TEST(clients.front().aiPlayers.empty());
+    BOOST_TEST(server.GetNumFilledSlots() == numClients);
+
+    // And the game continues with the commands of the player
+    curGF = server.GetCurrentGF();
+    BOOST_TEST_REQUIRE(runUntil([this, curGF]() { return server.GetCurrentGF() >= curGF + 20; }));
+    BOOST_TEST(server.GetNumFilledSlots() == numClients);
+}
+
+BOOST_AUTO_TEST_CASE(OversizedSnapshotIsRejected)
+{
+    startGame();
+    const std::string rejoinToken = clients.back().rejoinToken;
+    clients.pop_back();
+    BOOST_TEST_REQUIRE(runUntil([this]() { return !clients.front().aiPlayers.empty(); }));
+
+    // The player providing the snapshot announces a size which would exhaust the memory of the server
+    for(TestClient& client : clients)
+        client.announcedSnapshotSize = std::numeric_limits<uint32_t>::max();
+    TestClient& rejoiner = reconnectClient(rejoinToken);
+    rejoiner.sendQueue.push(new GameMessage_Server_Type(ServerType::Direct, rttr::version::GetRevision()));
+    rejoiner.sendQueue.push(new GameMessage_Server_Password(""));
+    rejoiner.sendQueue.push(new GameMessage_Player_Name(GameMessageWithPlayer::NO_PLAYER_ID, "Rejoiner"));
+    rejoiner.sendQueue.push(new GameMessage_MapRequest(true));
+    // It gets kicked and the rejoining fails
+    BOOST_TEST_REQUIRE(runUntil([this]() {
+        return std::any_of(clients.begin(), clients.end() - 1,
+                           [](const TestClient& client) { return !client.so.isValid(); });
+    }));
+    BOOST_TEST_REQUIRE(runUntil([this]() { return !clients.back().so.isValid(); }));
+    BOOST_TEST(!clients.back().mapInfo);
+}
+
+BOOST_AUTO_TEST_CASE(RejoinRequiresOwnToken)
+{
+    startGame();
+    // Every player got its own secret
+    for(const TestClient& client : clients)
+    {
+        BOOST_TEST(client.rejoinToken.size() >= 16u);
+        BOOST_TEST(std::count_if(clients.begin(), clients.end(), [&client](const TestClient& other) {
+                       return other.rejoinToken == client.rejoinToken;
+                   })
+                   == 1);
+    }
+    // Two players lose the connection
+    const std::string token1 = clients[1].rejoinToken;
+    const std::string token2 = clients[2].rejoinToken;
+    clients.erase(clients.begin() + 1, clients.begin() + 3);
+    BOOST_TEST_REQUIRE(runUntil([this]() { return clients.front().aiPlayers.size() == 2u; }));
+
+    // Knowing the game password is not enough
+    reconnectClient("invalid");
+    BOOST_TEST_REQUIRE(runUntil([this]() { return clients.back().playerId.is_initialized(); }));
+    BOOST_TEST(*clients.back().playerId == GameMessageWithPlayer::NO_PLAYER_ID);
+    clients.pop_back();
+
+    // The player who dropped last gets its own slot even though another one is free
+    reconnectClient(token2);
+    BOOST_TEST_REQUIRE(runUntil([this]() { return clients.back().playerId.is_initialized(); }));
+    BOOST_TEST(*clients.back().playerId == 2u);
+    // The token can't be used twice
+    reconnectClient(token2);
+    BOOST_TEST_REQUIRE(runUntil([this]() { return clients.back().playerId.is_initialized(); }));
+    BOOST_TEST(*clients.back().playerId == GameMessageWithPlayer::NO_PLAYER_ID);
+    clients.pop_back();
+    reconnectClient(token1);
+    BOOST_TEST_REQUIRE(runUntil([this]() { return clients.back().playerId.is_initialized(); }));
+    BOOST_TEST(*clients.back().playerId == 1u);
+}
+
+BOOST_FIXTURE_TEST_CASE(MapTransferIsFlowControlled, LargeMapFixture)
+{
+    CompressedData mapData;
+    BOOST_TEST_REQUIRE(mapData.CompressFromFile(mapPath));
+    BOOST_TEST_REQUIRE(mapData.data.size() > 2 * MAP_SEND_WINDOW);
+
+    TestClient& client = connectClient();
+    client.sendsMapAcks = false;
+    client.sendQueue.push(new GameMessage_MapRequest(true));
+    BOOST_TEST_REQUIRE(runUntil([&client]() { return client.mapData.size() >= MAP_SEND_WINDOW; }));
+    // Nothing more is sent without acknowledgement, so other messages are not queued behind the whole map
+    for(unsigned i = 0; i < 20; i++)
+    {
+        server.Run();
+        client.run();
+    }
+    BOOST_TEST(client.mapData.size() == MAP_SEND_WINDOW);
+    client.sendQueue.push(new GameMessage_Map_DataAck(client.mapData.size()));
+    client.sendsMapAcks = true;
+    BOOST_TEST_REQUIRE(runUntil([this]() { return server.GetNumFilledSlots() == 1u; }));
+    BOOST_TEST(client.mapData == mapData.data);
+}
+
+BOOST_FIXTURE_TEST_CASE(MapTransferIsResumed, LargeMapFixture)
+{
+    CompressedData mapData;
+    BOOST_TEST_REQUIRE(mapData.CompressFromFile(mapPath));
+
+    // Client got a part of the map before the connection was lost
+    const unsigned numReceivedBytes = mapData.data.size() / 2;
+    TestClient& client = connectClient();
+    client.mapData.assign(mapData.data.begin(), mapData.data.begin() + numReceivedBytes);
+    client.sendQueue.push(new GameMessage_MapRequest(true));
+    BOOST_TEST_REQUIRE(runUntil([this]() { return server.GetNumFilledSlots() == 1u; }));
+    // Only the remainder was sent and the complete map is accepted
+    BOOST_TEST(client.firstMapOffset == numReceivedBytes);
+    BOOST_TEST(client.numMapParts == helpers::divCeil(mapData.data.size() - numReceivedBytes, MAP_PART_SIZE));
+    BOOST_TEST(client.mapData == mapData.data);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,111 @@
+// Copyright (C) 2005 - 2021 Settlers Freaks (sf-team at siedler25.org)
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "NetworkSimulation.h"
+#include "rttr/test/TmpFolder.hpp"
+#include <boost/test/unit_test.hpp>
+#include <chrono>
+
+using namespace std::chrono;
+using namespace netsim;
+namespace utf = boost::unit_test;
+
+namespace {
+constexpr unsigned numClients = 3;
+
+SimulationConfig createConfig(const LinkConfig& link, unsigned numGFs = 2000)
+{
+    SimulationConfig config;
+    config.links.assign(numClients, link);
+    config.numGFs = numGFs;
+    return config;
+}
+
+SimulationResult runChecked(const SimulationConfig& config)
+{
+    rttr::test::TmpFolder tmpFolder;
+    const auto result = runSimulation(config, tmpFolder.get());
+    BOOST_TEST_REQUIRE(result.is_initialized());
+    BOOST_TEST_MESSAGE(*result);
+    BOOST_TEST(result->getNumAsyncs() == 0u);
+    BOOST_TEST(result->numGFs >= config.numGFs);
+    BOOST_TEST(result->isInSync());
+    return *result;
+}
+} // namespace
+
+// The long runs take several seconds of real time each and are disabled by default.
+// Run them with e.g. `--run_test=@netsim`
+BOOST_AUTO_TEST_SUITE(NetworkSimulationTests)
+
+BOOST_AUTO_TEST_CASE(ShortGameStaysInSync)
+{
+    LinkConfig link;
+    link.latency = milliseconds(5);
+    link.jitter = milliseconds(5);
+    const SimulationResult result = runChecked(createConfig(link, 200));
+    BOOST_TEST(result.checksums.size() == numClients);
+    for(const ClientStats& stats : result.clients)
+        BOOST_TEST(!stats.wasDisconnected);
+}
+
+BOOST_AUTO_TEST_CASE(IdealLinks, *utf::label("netsim") * utf::disabled())
+{
+    const SimulationResult result = runChecked(createConfig(LinkConfig()));
+    BOOST_TEST(result.checksums.size() == numClients);
+    for(const ClientStats& stats : result.clients)
+    {
+        BOOST_TEST(stats.gf > 0u);
+        BOOST_TEST(!stats.wasDisconnected);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(LatencyAndJitter, *utf::label("netsim") * utf::disabled())
+{
+    LinkConfig link;
+    link.latency = milliseconds(30);
+    link.jitter = milliseconds(20);
+    const SimulationResult result = runChecked(createConfig(link));
+    BOOST_TEST(result.checksums.size() == numClients);
+}
+
+BOOST_AUTO_TEST_CASE(LimitedBandwidth, *utf::label("netsim") * utf::disabled())
+{
+    LinkConfig link;
+    link.latency = milliseconds(10);
+    link.bandwidth = 8 * 1024;
+    const SimulationResult result = runChecked(createConfig(link));
+    BOOST_TEST(result.checksums.size() == numClients);
+}
+
+BOOST_AUTO_TEST_CASE(DisconnectedPlayerIsReplaced, *utf::label("netsim") * utf::disabled())
+{
+    LinkConfig link;
+    link.latency = milliseconds(5);
+    SimulationConfig config = createConfig(link);
+    config.links.back().disconnectAfter = seconds(2);
+    const SimulationResult result = runChecked(config);
+    BOOST_TEST(result.clients.back().wasDisconnected);
+    // The others continue with the dropped player replaced by an AI of the host and stay in sync
+    for(unsigned i = 0; i + 1 < numClients; i++)
+        BOOST_TEST(!result.clients[i].wasDisconnected);
+    BOOST_TEST(result.checksums.size() == numClients - 1u);
+}
+
+BOOST_AUTO_TEST_CASE(DisconnectedPlayerRejoinsInSync)
+{
+    LinkConfig link;
+    link.latency = milliseconds(5);
+    SimulationConfig config = createConfig(link, 800);
+    config.links.back().disconnectAfter = milliseconds(500);
+    config.rejoinAfter = milliseconds(200);
+    // The rejoining client loads the snapshot of the host, catches up and must then have the same game state
+    const SimulationResult result = runChecked(config);
+    BOOST_TEST(result.clients.back().numRejoins == 1u);
+    for(const ClientStats& stats : result.clients)
+        BOOST_TEST(!stats.wasDisconnected);
+    BOOST_TEST(result.checksums.size() == numClients);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,254 @@
+// Copyright (C) 2005 - 2021 Settlers Freaks (sf-team at siedler25.org)
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "FileChecksum.h"
+#include "RTTR_Version.h"
+#include "TestServer.h"
+#include "factories/GameCommandFactory.h"
+#include "network/GameMessage_Chat.h"
+#include "network/GameMessage_GameCommand.h"
+#include "network/GameMessages.h"
+#include "network/SpectatorRelay.h"
+#include "s25util/SocketSet.h"
+#include "rttr/test/random.hpp"
+#include <boost/test/unit_test.hpp>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+using namespace std::chrono;
+
+namespace {
+/// Spectator which joins, receives the snapshot and records the NWFs of the stream
+struct TestSpectator : Connection
+{
+    std::unique_ptr<GameMessage_Map_Info> mapInfo;
+    std::vector<char> mapData;
+    bool isChecksumOk = false, isStarted = false;
+    /// GFs of the received NWFDone messages
+    std::vector<unsigned> nwfs;
+    unsigned numOtherMsgs = 0;
+    /// Simulates a slow spectator which doesn't read anything
+    bool isPaused = false;
+
+    explicit TestSpectator(uint16_t relayPort) : Connection(GameMessage::create_game)
+    {
+        BOOST_TEST_REQUIRE(so.Connect("localhost", relayPort, false));
+    }
+
+    void run()
+    {
+        if(isPaused)
+            return;
+        SocketSet set;
+        set.Add(so);
+        if(set.Select(0, 0) > 0)
+            BOOST_TEST_REQUIRE(recvQueue.recvAll(so) >= 0);
+        while(!recvQueue.empty())
+        {
+            std::unique_ptr<Message> msg(recvQueue.popFront());
+            if(dynamic_cast<const GameMessage_Player_Id*>(msg.get()))
+                sendQueue.push(new GameMessage_Server_Type(ServerType::Direct, rttr::version::GetRevision()));
+            else if(dynamic_cast<const GameMessage_Server_TypeOK*>(msg.get()))
+                sendQueue.push(new GameMessage_MapRequest(true));
+            else if(const auto* infoMsg = dynamic_cast<const GameMessage_Map_Info*>(msg.get()))
+            {
+                mapInfo = std::make_unique<GameMessage_Map_Info>(*infoMsg);
+                sendQueue.push(new GameMessage_MapRequest(false));
+            } else if(const auto* dataMsg = dynamic_cast<const GameMessage_Map_Data*>(msg.get()))
+            {
+                mapData.insert(mapData.end(), dataMsg->data.begin(), dataMsg->data.end());
+                if(mapData.size() == mapInfo->mapCompressedLen)
+                {
+                    const auto checksum = CalcChecksumOfBuffer(CompressedData::decompress(mapData, mapInfo->mapLen));
+                    sendQueue.push(new GameMessage_Map_Checksum(checksum, 0));
+                }
+            } else if(const auto* checksumMsg = dynamic_cast<const GameMessage_Map_ChecksumOK*>(msg.get()))
+                isChecksumOk = checksumMsg->correct;
+            else if(dynamic_cast<const GameMessage_Server_Start*>(msg.get()))
+                isStarted = true;
+            else if(const auto* nwfMsg = dynamic_cast<const GameMessage_Server_NWFDone*>(msg.get()))
+                nwfs.push_back(nwfMsg->gf);
+            else if(!dynamic_cast<const GameMessage_Ping*>(msg.get()))
+                ++numOtherMsgs;
+        }
+        sendQueue.send(so, -1);
+    }
+};
+
+struct SpectatorRelayFixture
+{
+    SpectatorRelay relay;
+    std::vector<std::unique_ptr<TestSpectator>> spectators;
+    /// Compressed size and hash of the last added snapshot
+    size_t snapshotCompressedSize = 0;
+    uint32_t snapshotHash = 0;
+
+    explicit SpectatorRelayFixture(SpectatorRelay::SteadyClock::duration delay = seconds(0))
+        : relay(createConfig(delay))
+    {
+        BOOST_TEST_REQUIRE(relay.Start());
+        BOOST_TEST_REQUIRE(relay.GetPort() != 0u);
+    }
+
+    static SpectatorRelay::Config createConfig(SpectatorRelay::SteadyClock::duration delay)
+    {
+        SpectatorRelay::Config config;
+        // Let the OS choose a free port
+        config.port = 0;
+        config.delay = delay;
+        return config;
+    }
+
+    void addSnapshot()
+    {
+        // Random data doesn't compress, so it is sent in multiple parts
+        std::vector<char> data(3 * MAP_PART_SIZE + 42);
+        for(char& c : data)
+            c = static_cast<char>(rttr::test::randomValue<int>(0, 255));
+        auto snapshot = std::make_unique<SpectatorRelay::Snapshot>();
+        snapshot->mapName = "map.swd";
+        snapshot->mapData.data = CompressedData::compress(data);
+        snapshot->mapData.uncompressedLength = data.size();
+        snapshot->mapChecksum = CalcChecksumOfBuffer(data);
+        snapshot->mapHash = CalcCRC32OfBuffer(data);
+        snapshotCompressedSize = snapshot->mapData.data.size();
+        snapshotHash = snapshot->mapHash;
+        snapshot->startMsgs.emplace_back(new GameMessage_Server_Start(42, 5, 3));
+        snapshot->streamPos = relay.GetStreamSize();
+        relay.AddSnapshot(std::move(snapshot));
+    }
+
+    /// Run relay and spectators till the condition is met. Return false on timeout
+    template<class T_Pred>
+    bool runUntil(T_Pred&& condition, SpectatorRelay::SteadyClock::duration timeout = seconds(10))
+    {
+        const auto endTime = steady_clock::now() + timeout;
+        while(steady_clock::now() < endTime)
+        {
+            relay.WaitForEvents(milliseconds(10));
+            relay.Run();
+            for(auto& spectator : spectators)
+                spectator->run();
+            if(condition())
+                return true;
+        }
+        return false;
+    }
+};
+
+struct CmdCreator : GameCommandFactory
+{
+    std::vector<gc::GameCommandPtr> gcs;
+
+protected:
+    bool AddGC(gc::GameCommandPtr gc) override
+    {
+        gcs.push_back(gc);
+        return true;
+    }
+};
+
+struct DelayedRelayFixture : SpectatorRelayFixture
+{
+    DelayedRelayFixture() : SpectatorRelayFixture(hours(1)) {}
+};
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(SpectatorRelayTests, SpectatorRelayFixture)
+
+BOOST_AUTO_TEST_CASE(OnlyGameStateMsgsAreRelayed)
+{
+    BOOST_TEST(SpectatorRelay::isRelayed(NMS_SERVER_NWF_DONE));
+    BOOST_TEST(SpectatorRelay::isRelayed(NMS_GAMECOMMANDS));
+    BOOST_TEST(!SpectatorRelay::isRelayed(NMS_CHAT));
+    BOOST_TEST(!SpectatorRelay::isRelayed(NMS_PING));
+
+    relay.AddMessage(GameMessage_Chat(0, ChatDestination::All, "Secret"));
+    BOOST_TEST(relay.GetStreamSize() == 0u);
+    relay.AddMessage(GameMessage_Server_NWFDone(5, 20, 10));
+    BOOST_TEST(relay.GetStreamSize() == 1u);
+}
+
+BOOST_AUTO_TEST_CASE(SpectatorsStartAtSnapshot)
+{
+    // Sent before the snapshot -> Already contained in it
+    relay.AddMessage(GameMessage_Server_NWFDone(0, 20, 5));
+    addSnapshot();
+    relay.AddMessage(GameMessage_Server_NWFDone(5, 20, 10));
+    relay.AddMessage(GameMessage_Chat(0, ChatDestination::All, "Secret"));
+
+    spectators.push_back(std::make_unique<TestSpectator>(relay.GetPort()));
+    TestSpectator& spectator = *spectators.back();
+    BOOST_TEST_REQUIRE(runUntil([&spectator]() { return !spectator.nwfs.empty(); }));
+    BOOST_TEST(spectator.isChecksumOk);
+    BOOST_TEST(spectator.isStarted);
+    BOOST_TEST(spectator.mapData.size() == snapshotCompressedSize);
+    BOOST_TEST(spectator.mapInfo->mapHash == snapshotHash);
+    BOOST_TEST(relay.GetNumSpectators() == 1u);
+
+    // New messages are passed on, chats are not
+    relay.AddMessage(GameMessage_Server_NWFDone(10, 20, 15));
+    BOOST_TEST_REQUIRE(runUntil([&spectator]() { return spectator.nwfs.size() == 2u; }));
+    BOOST_TEST(spectator.nwfs == std::vector<unsigned>({5, 10}));
+    BOOST_TEST(spectator.numOtherMsgs == 0u);
+    BOOST_TEST(!relay.HasPendingMessages());
+}
+
+BOOST_AUTO_TEST_CASE(LaterSnapshotsAreUsedForNewSpectators)
+{
+    addSnapshot();
+    relay.AddMessage(GameMessage_Server_NWFDone(5, 20, 10));
+    spectators.push_back(std::make_unique<TestSpectator>(relay.GetPort()));
+    BOOST_TEST_REQUIRE(runUntil([this]() { return spectators[0]->nwfs.size() == 1u; }));
+
+    addSnapshot();
+    relay.AddMessage(GameMessage_Server_NWFDone(10, 20, 15));
+    spectators.push_back(std::make_unique<TestSpectator>(relay.GetPort()));
+    BOOST_TEST_REQUIRE(runUntil([this]() { return spectators[1]->nwfs.size() == 1u; }));
+    BOOST_TEST_REQUIRE(runUntil([this]() { return spectators[0]->nwfs.size() == 2u; }));
+    BOOST_TEST(spectators[0]->nwfs == std::vector<unsigned>({5, 10}));
+    BOOST_TEST(spectators[1]->nwfs == std::vector<unsigned>({10}));
+}
+
+BOOST_AUTO_TEST_CASE(SlowSpectatorDoesNotBlockOthers)
+{
+    addSnapshot();
+    relay.AddMessage(GameMessage_Server_NWFDone(5, 20, 10));
+    spectators.push_back(std::make_unique<TestSpectator>(relay.GetPort()));
+    spectators.push_back(std::make_unique<TestSpectator>(relay.GetPort()));
+    BOOST_TEST_REQUIRE(
+      runUntil([this]() { return spectators[0]->nwfs.size() == 1u && spectators[1]->nwfs.size() == 1u; }));
+
+    // Send more than the socket buffers can hold while the first spectator doesn't read anything
+    spectators[0]->isPaused = true;
+    CmdCreator creator;
+    for(unsigned i = 0; i < 8; i++)
+        creator.BuildRoad(MapPoint(i, 0), false, std::vector<Direction>(1000, Direction::East));
+    const GameMessage_GameCommand cmdMsg(0, AsyncChecksum(), creator.gcs);
+    for(unsigned i = 0; i < 2500; i++)
+        relay.AddMessage(cmdMsg);
+    relay.AddMessage(GameMessage_Server_NWFDone(10, 20, 15));
+    BOOST_TEST_REQUIRE(runUntil([this]() { return spectators[1]->nwfs.size() == 2u; }, seconds(30)));
+    BOOST_TEST(spectators[1]->numOtherMsgs == 2500u);
+    BOOST_TEST(spectators[0]->nwfs.size() == 1u);
+    BOOST_TEST(relay.GetNumSpectators() == 2u);
+}
+
+BOOST_FIXTURE_TEST_CASE(StreamIsDelayed, DelayedRelayFixture)
+{
+    relay.AddMessage(GameMessage_Server_NWFDone(0, 20, 5));
+    addSnapshot();
+    relay.AddMessage(GameMessage_Server_NWFDone(5, 20, 10));
+
+    // The snapshot is only released with all messages before it
+    spectators.push_back(std::make_unique<TestSpectator>(relay.GetPort()));
+    TestSpectator& spectator = *spectators.back();
+    BOOST_TEST(!runUntil([&spectator]() { return spectator.mapInfo != nullptr; }, milliseconds(200)));
+    BOOST_TEST(spectator.nwfs.empty());
+    BOOST_TEST(relay.HasPendingMessages());
+    BOOST_TEST(relay.GetTimeToNextEvent() <= seconds(1));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -120,6 +120,47 @@ BOOST_AUTO_TEST_CASE(GetMatchingPointsInRadius)
     BOOST_TEST(firstEvenPt.front() == evenPts.front());
 }
 
+BOOST_AUTO_TEST_CASE(VisitPointsInRadiusMatchesRingWalk)
+{
+    MapBase world;
+    world.Resize(MapExtent(150, 140));
+    // Reference: Walk the rings step by step
+    const auto getRingPoints = [&world](const MapPoint pt, unsigned radius) {
+        std::vector<std::pair<MapPoint, unsigned>> result{{pt, 0u}};
+        MapPoint curStartPt = pt;
+        for(unsigned r = 1; r <= radius; ++r)
+        {
+            curStartPt = world.GetNeighbour(curStartPt, Direction::West);
+            MapPoint curPt = curStartPt;
+            for(const auto dir : helpers::enumRange(Direction::NorthEast))
+            {
+                for(unsigned step = 0; step < r; ++step)
+                {
+                    result.emplace_back(curPt, r);
+                    curPt = world.GetNeighbour(curPt, dir);
+                }
+            }
+        }
+        return result;
+    };
+    // Center, points at the border in even and odd rows and radii below and above the precomputed ones
+    const std::vector<MapPoint> testPoints{MapPoint(75, 70), MapPoint(75, 71),  MapPoint(0, 0),
+                                           MapPoint(149, 1), MapPoint(3, 139),  MapPoint(148, 138),
+                                           MapPoint(70, 2),  MapPoint(5, 60)};
+    for(const MapPoint& pt : testPoints)
+    {
+        for(unsigned radius : {1u, 2u, 7u, 20u, detail::maxPrecomputedRadius, detail::maxPrecomputedRadius + 3u})
+        {
+            std::vector<std::pair<MapPoint, unsigned>> visitedPts;
+            world.VisitPointsInRadius(
+              pt, radius, [&visitedPts](const MapPoint curPt, unsigned r) { visitedPts.emplace_back(curPt, r); },
+              true);
+            BOOST_TEST_REQUIRE(visitedPts.size() == 1u + detail::getNumPointsInRadius(radius));
+            BOOST_TEST_REQUIRE((visitedPts == getRingPoints(pt, radius)));
+        }
+    }
+}
+
 BOOST_AUTO_TEST_CASE(GetIdx)
 {
     MapBase world;
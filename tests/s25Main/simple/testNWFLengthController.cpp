@@ -0,0 +1,69 @@
+// Copyright (C) 2005 - 2021 Settlers Freaks (sf-team at siedler25.org)
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "network/NWFLengthController.h"
+#include <boost/test/unit_test.hpp>
+
+using ms = FramesInfo::milliseconds32_t;
+
+BOOST_AUTO_TEST_SUITE(NWFLengthControllerSuite)
+
+BOOST_AUTO_TEST_CASE(NWFLengthFollowsLatency)
+{
+    NWFLengthController controller;
+    const ms gfLength(50);
+    constexpr unsigned cmdDelay = 3;
+    // LAN: Shortest possible NWFs
+    controller.setLatency(ms(2), ms(1));
+    BOOST_TEST(controller.getNWFLength(gfLength, cmdDelay, gfLength) == 1u);
+    // Required time (400ms + 2 * 50ms) is split over 2 NWFs -> 250ms = 5 GFs
+    controller.setLatency(ms(400), ms(50));
+    BOOST_TEST(controller.getNWFLength(gfLength, cmdDelay, gfLength) == 5u);
+    // Faster speed -> more GFs for the same time
+    BOOST_TEST(controller.getNWFLength(ms(25), cmdDelay, gfLength) == 10u);
+    // Very slow connections are limited
+    controller.setLatency(ms(10000), ms(1000));
+    BOOST_TEST(controller.getNWFLength(gfLength, cmdDelay, gfLength) == NWFLengthController::maxNWFLength);
+}
+
+BOOST_AUTO_TEST_CASE(NWFLengthDecreasesGradually)
+{
+    NWFLengthController controller;
+    const ms gfLength(50);
+    controller.setLatency(ms(2), ms(1));
+    unsigned nwfLength = 10;
+    for(unsigned expected = 9; expected >= 1; expected--)
+    {
+        nwfLength = controller.getNWFLength(gfLength, 3, nwfLength * gfLength);
+        BOOST_TEST(nwfLength == expected);
+    }
+    BOOST_TEST(controller.getNWFLength(gfLength, 3, nwfLength * gfLength) == 1u);
+}
+
+BOOST_AUTO_TEST_CASE(MarginAdaptsToStallRate)
+{
+    NWFLengthController controller(0.1);
+    const double initialFactor = controller.getJitterFactor();
+    // Too many stalls -> larger margin
+    for(unsigned i = 0; i < NWFLengthController::stallWindowSize; i++)
+        controller.onNWFExecuted(i % 5 == 0);
+    BOOST_TEST(controller.getJitterFactor() > initialFactor);
+    const double increasedFactor = controller.getJitterFactor();
+    controller.setLatency(ms(100), ms(20));
+    BOOST_TEST(controller.getRequiredCmdTime().count() == 100 + 20 * increasedFactor);
+    // Stall rate in between the limits -> unchanged
+    for(unsigned i = 0; i < NWFLengthController::stallWindowSize; i++)
+        controller.onNWFExecuted(i % 13 == 0);
+    BOOST_TEST(controller.getJitterFactor() == increasedFactor);
+    // No stalls -> margin decreases till the minimum
+    for(unsigned i = 0; i < 100 * NWFLengthController::stallWindowSize; i++)
+        controller.onNWFExecuted(false);
+    BOOST_TEST(controller.getJitterFactor() == NWFLengthController::minJitterFactor);
+    // Reset restores the initial state
+    controller.reset();
+    BOOST_TEST(controller.getJitterFactor() == initialFactor);
+    BOOST_TEST(controller.getRequiredCmdTime().count() == 0u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,70 @@
+// Copyright (C) 2005 - 2021 Settlers Freaks (sf-team at siedler25.org)
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "RttrForeachPt.h"
+#include "world/RadiusSumMap.h"
+#include <rttr/test/random.hpp>
+#include <boost/test/unit_test.hpp>
+
+namespace {
+int calcSumByVisiting(const RadiusSumMap& map, const MapPoint pt, unsigned radius)
+{
+    int sum = 0;
+    map.VisitPointsInRadius(
+      pt, radius, [&map, &sum](const MapPoint curPt, unsigned) { sum += map[curPt]; }, true);
+    return sum;
+}
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(RadiusSumMapSuite)
+
+BOOST_AUTO_TEST_CASE(SumsMatchPointsInRadius)
+{
+    RadiusSumMap map;
+    // Small map so larger radii wrap around (multiple times)
+    map.Resize(MapExtent(13, 10));
+    RTTR_FOREACH_PT(MapPoint, map.GetSize())
+        map.set(pt, rttr::test::randomValue(-40, 40));
+    RTTR_FOREACH_PT(MapPoint, map.GetSize())
+    {
+        for(unsigned radius = 0; radius <= 15; radius++)
+            BOOST_TEST_REQUIRE(map.getSum(pt, radius) == calcSumByVisiting(map, pt, radius));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(SumsAreUpdated)
+{
+    RadiusSumMap map;
+    map.Resize(MapExtent(40, 30));
+    const MapPoint center(20, 15);
+    BOOST_TEST(map.getSum(center, 8) == 0);
+    for(unsigned i = 0; i < 50; i++)
+    {
+        const MapPoint pt = rttr::test::randomPoint<MapPoint>(0, 29);
+        map.set(pt, rttr::test::randomValue(-40, 40));
+        BOOST_TEST_REQUIRE(map[pt] == map.getSum(pt, 0));
+        for(unsigned radius : {1u, 2u, 8u})
+            BOOST_TEST_REQUIRE(map.getSum(center, radius) == calcSumByVisiting(map, center, radius));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(LargeSumsAreExact)
+{
+    // The prefix sums of the rows overflow 16 bit but the sums must not
+    RadiusSumMap map;
+    map.Resize(MapExtent(1024, 260));
+    for(const int value : {127, -128})
+    {
+        RTTR_FOREACH_PT(MapPoint, map.GetSize())
+            map.set(pt, value);
+        for(const MapPoint pt : {MapPoint(0, 0), MapPoint(500, 130), MapPoint(1023, 259)})
+        {
+            BOOST_TEST_REQUIRE(map[pt] == value);
+            for(unsigned radius : {1u, 8u, RadiusSumMap::maxRadius})
+                BOOST_TEST_REQUIRE(map.getSum(pt, radius) == static_cast<int>(3 * radius * (radius + 1) + 1) * value);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
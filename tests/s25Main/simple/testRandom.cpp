@@ -3,11 +3,17 @@
 // SPDX-License-Identifier: GPL-2.0-or-later
 
 #include "helpers/EnumArray.h"
+#include "helpers/serializeVarInt.h"
 #include "random/DefaultLCG.h"
 #include "random/Random.h"
 #include "random/XorShift.h"
+#include "random/randomIO.h"
+#include "rttr/test/TmpFolder.hpp"
 #include "s25util/Serializer.h"
+#include <boost/filesystem/operations.hpp>
+#include <boost/nowide/fstream.hpp>
 #include <boost/test/unit_test.hpp>
+#include <cstring>
 #include <limits>
 #include <random>
 #include <utility>
@@ -262,4 +268,78 @@ BOOST_AUTO_TEST_CASE(RandomElement)
     }
 }
 
+BOOST_AUTO_TEST_CASE(AsyncLogKeepsLastInvocations)
+{
+    const auto GetObjId = []() { return 42u; }; // Fake function for RANDOM_RAND
+    RANDOM.SetHistorySize(100);
+    BOOST_TEST(RANDOM.GetHistorySize() == 128u);
+    RANDOM.Init(0x1337);
+    BOOST_TEST(RANDOM.GetAsyncLog().empty());
+    std::vector<int> values;
+    for(int i = 0; i < 200; i++)
+        values.push_back(RANDOM_RAND(i + 1));
+    const std::vector<RandomEntry> log = RANDOM.GetAsyncLog();
+    BOOST_TEST_REQUIRE(log.size() == 128u);
+    for(unsigned i = 0; i < log.size(); i++)
+    {
+        const unsigned counter = 200 - 128 + i;
+        BOOST_TEST(log[i].counter == counter);
+        BOOST_TEST(log[i].maxExcl == static_cast<int>(counter + 1));
+        BOOST_TEST(log[i].GetValue() == values[counter]);
+        BOOST_TEST(std::strcmp(log[i].srcName, __FILE__) == 0);
+        BOOST_TEST(log[i].objId == 42u);
+    }
+    // Huge sizes are clamped instead of overflowing
+    RANDOM.SetHistorySize(std::numeric_limits<unsigned>::max());
+    BOOST_TEST(RANDOM.GetHistorySize() == UsedRandom::maxHistorySize);
+    RANDOM.SetHistorySize(UsedRandom::defaultHistorySize);
+}
+
+BOOST_AUTO_TEST_CASE(AsyncLogBinaryRoundtrip)
+{
+    const auto GetObjId = []() { return 7u; }; // Fake function for RANDOM_RAND
+    RANDOM.Init(0x1337);
+    for(int i = 0; i < 50; i++)
+        RANDOM_RAND(i % 3 == 0 ? 1000 : 10);
+    RANDOM.Rand(RandomContext{"other/file.cpp", 1337, 99}, 5);
+    const std::vector<RandomEntry> log = RANDOM.GetAsyncLog();
+
+    rttr::test::TmpFolder tmpFolder;
+    const boost::filesystem::path filepath = tmpFolder.get() / "random.rnglog";
+    BOOST_TEST_REQUIRE(saveRandomLogBinary(filepath, log));
+    const std::vector<RandomEntry> loadedLog = loadRandomLogBinary(filepath);
+    BOOST_TEST_REQUIRE(loadedLog.size() == log.size());
+    for(unsigned i = 0; i < log.size(); i++)
+    {
+        BOOST_TEST(loadedLog[i].counter == log[i].counter);
+        BOOST_TEST(loadedLog[i].maxExcl == log[i].maxExcl);
+        BOOST_TEST(loadedLog[i].rngState == log[i].rngState);
+        BOOST_TEST(loadedLog[i].srcName == internSrcName(log[i].srcName));
+        BOOST_TEST(loadedLog[i].srcLine == log[i].srcLine);
+        BOOST_TEST(loadedLog[i].objId == log[i].objId);
+    }
+    // Each source name is stored only once
+    BOOST_TEST(boost::filesystem::file_size(filepath) < log.size() * 20u);
+}
+
+BOOST_AUTO_TEST_CASE(AsyncLogWithInvalidSizeIsRejected)
+{
+    // Valid header claiming a huge number of entries
+    Serializer ser;
+    const std::string signature = "RTTR_RNGLOG";
+    ser.PushRawData(signature.data(), signature.size());
+    ser.PushUnsignedChar(1);
+    ser.PushLongString(UsedPRNG::getName());
+    helpers::pushVarUInt(ser, 0);
+    helpers::pushVarUInt(ser, std::numeric_limits<uint32_t>::max());
+
+    rttr::test::TmpFolder tmpFolder;
+    const boost::filesystem::path filepath = tmpFolder.get() / "random.rnglog";
+    {
+        boost::nowide::ofstream file(filepath, std::ios::binary);
+        file.write(reinterpret_cast<const char*>(ser.GetData()), ser.GetLength());
+    }
+    BOOST_CHECK_THROW(loadRandomLogBinary(filepath), std::runtime_error);
+}
+
 BOOST_AUTO_TEST_SUITE_END()